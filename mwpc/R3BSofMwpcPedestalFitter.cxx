@@ -0,0 +1,221 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                  R3BSofMwpcPedestalFitter                  -----
+// -----      Parallel fit of the pedestal spectra of MWPC pads     -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofMwpcPedestalFitter.h"
+
+#include "FairLogger.h"
+#include "TF1.h"
+#include "TH1F.h"
+#include "TMath.h"
+
+#include <thread>
+#include <vector>
+
+// R3BSofMwpcPedestalFitter: Default Constructor --------------------------
+R3BSofMwpcPedestalFitter::R3BSofMwpcPedestalFitter()
+    : TObject()
+    , fNumThreads(0)
+    , fMinStatistics(100)
+    , fFitRange(80.)
+    , fNumNewtonSteps(1)
+    , fNumPads(0)
+    , fNumFallback(0)
+    , fMean(NULL)
+    , fSigma(NULL)
+    , fStatus(NULL)
+{
+}
+
+// R3BSofMwpcPedestalFitter: Standard Constructor --------------------------
+R3BSofMwpcPedestalFitter::R3BSofMwpcPedestalFitter(Int_t numThreads)
+    : TObject()
+    , fNumThreads(numThreads)
+    , fMinStatistics(100)
+    , fFitRange(80.)
+    , fNumNewtonSteps(1)
+    , fNumPads(0)
+    , fNumFallback(0)
+    , fMean(NULL)
+    , fSigma(NULL)
+    , fStatus(NULL)
+{
+}
+
+// Virtual R3BSofMwpcPedestalFitter: Destructor
+R3BSofMwpcPedestalFitter::~R3BSofMwpcPedestalFitter()
+{
+    if (fMean)
+        delete[] fMean;
+    if (fSigma)
+        delete[] fSigma;
+    if (fStatus)
+        delete[] fStatus;
+}
+
+// -----   Public method Fit   ------------------------------------------------
+Int_t R3BSofMwpcPedestalFitter::Fit(TH1F** histos, Int_t numPads)
+{
+    if (numPads != fNumPads)
+    {
+        if (fMean)
+            delete[] fMean;
+        if (fSigma)
+            delete[] fSigma;
+        if (fStatus)
+            delete[] fStatus;
+        fNumPads = numPads;
+        fMean = new Double_t[numPads];
+        fSigma = new Double_t[numPads];
+        fStatus = new Int_t[numPads];
+    }
+
+    // Statistics are checked here, the threads only read the bin contents
+    for (Int_t i = 0; i < numPads; i++)
+    {
+        fMean[i] = -1.;
+        fSigma[i] = 0.;
+        fStatus[i] = histos[i]->GetEntries() > fMinStatistics ? kAnalytic : kDead;
+    }
+
+    Int_t nThreads = fNumThreads > 0 ? fNumThreads : (Int_t)std::thread::hardware_concurrency();
+    nThreads = TMath::Max(1, TMath::Min(nThreads, numPads));
+    if (nThreads == 1)
+        FitAnalytic(histos, 0, 1);
+    else
+    {
+        std::vector<std::thread> workers;
+        for (Int_t t = 0; t < nThreads; t++)
+            workers.push_back(std::thread(&R3BSofMwpcPedestalFitter::FitAnalytic, this, histos, t, nThreads));
+        for (Int_t t = 0; t < nThreads; t++)
+            workers[t].join();
+    }
+
+    // Fallback to the fit of ROOT for the failed estimates, one TF1 for all
+    fNumFallback = 0;
+    TF1* fgaus = NULL;
+    Int_t nfit = 0;
+    for (Int_t i = 0; i < numPads; i++)
+    {
+        if (fStatus[i] == kTF1)
+        {
+            if (!fgaus)
+                fgaus = new TF1("fPedestalFit", "gaus", histos[i]->GetXaxis()->GetXmin(),
+                                histos[i]->GetXaxis()->GetXmax());
+            Double_t peak = histos[i]->GetBinCenter(histos[i]->GetMaximumBin());
+            fgaus->SetRange(histos[i]->GetXaxis()->GetXmin(), histos[i]->GetXaxis()->GetXmax());
+            Int_t res = histos[i]->Fit(fgaus, "QON", "", peak - fFitRange, peak + fFitRange);
+            fNumFallback++;
+            if (res == 0)
+            {
+                fMean[i] = fgaus->GetParameter(1);
+                fSigma[i] = fgaus->GetParameter(2);
+            }
+            else
+                fStatus[i] = kFailed;
+        }
+        if (fStatus[i] == kAnalytic || fStatus[i] == kTF1)
+            nfit++;
+    }
+    if (fgaus)
+        delete fgaus;
+
+    LOG(INFO) << "R3BSofMwpcPedestalFitter: " << nfit << " of " << numPads << " pads fitted with " << nThreads
+              << " threads, " << fNumFallback << " with TF1";
+    return nfit;
+}
+
+// -----   Private method FitAnalytic   ---------------------------------------
+void R3BSofMwpcPedestalFitter::FitAnalytic(TH1F** histos, Int_t first, Int_t stride)
+{
+    for (Int_t i = first; i < fNumPads; i += stride)
+    {
+        if (fStatus[i] != kAnalytic)
+            continue;
+
+        const TH1F* h = histos[i];
+        const Float_t* y = h->GetArray(); // bin 0 is the underflow
+        const Int_t nbins = h->GetNbinsX();
+        const Double_t xmin = h->GetXaxis()->GetXmin();
+        const Double_t width = (h->GetXaxis()->GetXmax() - xmin) / nbins;
+
+        // Maximum bin, the first one as TH1::GetMaximumBin
+        Int_t bmax = 1;
+        for (Int_t b = 2; b <= nbins; b++)
+            if (y[b] > y[bmax])
+                bmax = b;
+
+        // Bins with the center within the fit range, as TH1::Fit
+        const Double_t peak = xmin + (bmax - 0.5) * width;
+        const Int_t bfirst = TMath::Max(1, TMath::CeilNint((peak - fFitRange - xmin) / width + 0.5));
+        const Int_t blast = TMath::Min(nbins, TMath::FloorNint((peak + fFitRange - xmin) / width + 0.5));
+
+        // Moments around the peak
+        Double_t s0 = 0., s1 = 0., s2 = 0.;
+        for (Int_t b = bfirst; b <= blast; b++)
+        {
+            Double_t dx = (b - bmax) * width;
+            s0 += y[b];
+            s1 += y[b] * dx;
+            s2 += y[b] * dx * dx;
+        }
+        Double_t mu = s1 / s0;
+        // Sheppard correction for the binning
+        Double_t var = s2 / s0 - mu * mu - width * width / 12.;
+        if (!(s0 > 0.) || !(var > 0.))
+        {
+            fStatus[i] = kTF1;
+            continue;
+        }
+        Double_t sigma = TMath::Sqrt(var);
+        Double_t amp = s0 / (TMath::Sqrt(2. * TMath::Pi()) * sigma / width);
+
+        // Gauss-Newton steps of chi2 = sum (y - f)^2 / y over the non empty bins
+        for (Int_t step = 0; step < fNumNewtonSteps; step++)
+        {
+            Double_t m[3][3] = { { 0. } }, v[3] = { 0. };
+            for (Int_t b = bfirst; b <= blast; b++)
+            {
+                if (y[b] <= 0.)
+                    continue;
+                Double_t u = ((b - bmax) * width - mu) / sigma;
+                Double_t e = TMath::Exp(-0.5 * u * u);
+                Double_t j[3] = { e, amp * e * u / sigma, amp * e * u * u / sigma };
+                Double_t w = 1. / y[b];
+                Double_t r = y[b] - amp * e;
+                for (Int_t k = 0; k < 3; k++)
+                {
+                    v[k] += w * j[k] * r;
+                    for (Int_t l = 0; l <= k; l++)
+                        m[k][l] += w * j[k] * j[l];
+                }
+            }
+            // Solution of the symmetric 3x3 system by Cramer's rule
+            Double_t c00 = m[1][1] * m[2][2] - m[2][1] * m[2][1];
+            Double_t c01 = m[2][1] * m[2][0] - m[1][0] * m[2][2];
+            Double_t c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+            Double_t det = m[0][0] * c00 + m[1][0] * c01 + m[2][0] * c02;
+            if (!(TMath::Abs(det) > 0.))
+                break;
+            Double_t c11 = m[0][0] * m[2][2] - m[2][0] * m[2][0];
+            Double_t c12 = m[1][0] * m[2][0] - m[0][0] * m[2][1];
+            Double_t c22 = m[0][0] * m[1][1] - m[1][0] * m[1][0];
+            Double_t damp = (c00 * v[0] + c01 * v[1] + c02 * v[2]) / det;
+            Double_t dmu = (c01 * v[0] + c11 * v[1] + c12 * v[2]) / det;
+            Double_t dsigma = (c02 * v[0] + c12 * v[1] + c22 * v[2]) / det;
+            // Steps leaving the fit range are not taken
+            if (!(TMath::Abs(dmu) < fFitRange) || !(sigma + dsigma > 0.) || !(amp + damp > 0.))
+                break;
+            amp += damp;
+            mu += dmu;
+            sigma += dsigma;
+        }
+
+        fMean[i] = peak + mu;
+        fSigma[i] = sigma;
+    }
+}
+
+ClassImp(R3BSofMwpcPedestalFitter)
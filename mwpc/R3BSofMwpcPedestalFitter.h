@@ -0,0 +1,83 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                  R3BSofMwpcPedestalFitter                  -----
+// -----      Parallel fit of the pedestal spectra of MWPC pads     -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofMwpcPedestalFitter_H
+#define R3BSofMwpcPedestalFitter_H
+
+#include "TObject.h"
+
+class TH1F;
+
+/**
+ * Fits the pedestal spectra of all the pads of a chamber at once.
+ * Each spectrum is first estimated with the moments of the bins around the
+ * maximum (with the Sheppard correction of the binning), which is then
+ * refined with Gauss-Newton steps of the same chi2 minimized by TH1::Fit.
+ * The pads are shared out among several threads, the histograms are only
+ * read. Only the pads where the analytic estimator fails are fitted with a
+ * TF1, serially afterwards.
+ **/
+class R3BSofMwpcPedestalFitter : public TObject
+{
+
+  public:
+    enum EStatus
+    {
+        kDead = 0,  // Not enough statistics
+        kAnalytic,  // Moments and Gauss-Newton steps
+        kTF1,       // Fallback to TH1::Fit
+        kFailed     // Also the fallback failed
+    };
+
+    /** Default constructor **/
+    R3BSofMwpcPedestalFitter();
+
+    /** Standard constructor
+     *@param numThreads  Number of threads, 0 for the number of cores
+     **/
+    R3BSofMwpcPedestalFitter(Int_t numThreads);
+
+    /** Destructor **/
+    virtual ~R3BSofMwpcPedestalFitter();
+
+    /** Method to fit numPads spectra, returns the number of fitted pads **/
+    Int_t Fit(TH1F** histos, Int_t numPads);
+
+    /** Results of the last Fit() **/
+    Double_t GetMean(Int_t index) const { return fMean[index]; }
+    Double_t GetSigma(Int_t index) const { return fSigma[index]; }
+    Int_t GetStatus(Int_t index) const { return fStatus[index]; }
+    Int_t GetNumFallback() const { return fNumFallback; }
+
+    /** Modifiers **/
+    void SetNumThreads(Int_t numThreads) { fNumThreads = numThreads; }
+    void SetMinStatistics(Int_t minStat) { fMinStatistics = minStat; }
+    void SetFitRange(Double_t range) { fFitRange = range; }
+    void SetNumNewtonSteps(Int_t steps) { fNumNewtonSteps = steps; }
+
+  private:
+    Int_t fNumThreads;     // Number of threads, 0 for the number of cores
+    Int_t fMinStatistics;  // Minimum number of entries of a spectrum
+    Double_t fFitRange;    // Half width of the fit range around the maximum
+    Int_t fNumNewtonSteps; // Refinement steps after the moments
+
+    Int_t fNumPads;
+    Int_t fNumFallback;
+    Double_t* fMean;  //!
+    Double_t* fSigma; //!
+    Int_t* fStatus;   //!
+
+    /** Analytic estimate of the pads first, first+stride, ... **/
+    void FitAnalytic(TH1F** histos, Int_t first, Int_t stride);
+
+    R3BSofMwpcPedestalFitter(const R3BSofMwpcPedestalFitter&);
+    R3BSofMwpcPedestalFitter& operator=(const R3BSofMwpcPedestalFitter&);
+
+  public:
+    ClassDef(R3BSofMwpcPedestalFitter, 1)
+};
+
+#endif
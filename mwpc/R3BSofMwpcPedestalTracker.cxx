@@ -0,0 +1,194 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                 R3BSofMwpcPedestalTracker                  -----
+// -----         Online tracking of the pedestals of MWPC pads      -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofMwpcPedestalTracker.h"
+#include "R3BSofMwpcPadImage.h"
+#include "R3BSofMwpcZeroSuppression.h"
+
+#include "FairLogger.h"
+#include "TArrayI.h"
+#include "TMath.h"
+
+// R3BSofMwpcPedestalTracker: Default Constructor --------------------------
+R3BSofMwpcPedestalTracker::R3BSofMwpcPedestalTracker()
+    : TObject()
+    , fAlpha(0.001)
+    , fPublishInterval(1000)
+    , fWindow(3.)
+    , fMinSigma(1.)
+    , fNumSigmas(0.)
+    , fNumPads(0)
+    , fNumEvents(0)
+    , fNumPublished(0)
+    , fMean(NULL)
+    , fVar(NULL)
+    , fActive(NULL)
+    , fBack(0)
+    , fFront(1)
+    , fMiddle(2)
+{
+    for (Int_t b = 0; b < kNumBuffers; b++)
+        fBuffer[b] = NULL;
+}
+
+// R3BSofMwpcPedestalTracker: Standard Constructor --------------------------
+R3BSofMwpcPedestalTracker::R3BSofMwpcPedestalTracker(Double_t alpha, Int_t interval, Float_t window)
+    : TObject()
+    , fAlpha(alpha)
+    , fPublishInterval(interval)
+    , fWindow(window)
+    , fMinSigma(1.)
+    , fNumSigmas(0.)
+    , fNumPads(0)
+    , fNumEvents(0)
+    , fNumPublished(0)
+    , fMean(NULL)
+    , fVar(NULL)
+    , fActive(NULL)
+    , fBack(0)
+    , fFront(1)
+    , fMiddle(2)
+{
+    for (Int_t b = 0; b < kNumBuffers; b++)
+        fBuffer[b] = NULL;
+}
+
+// Virtual R3BSofMwpcPedestalTracker: Destructor
+R3BSofMwpcPedestalTracker::~R3BSofMwpcPedestalTracker()
+{
+    if (fMean)
+        delete[] fMean;
+    if (fVar)
+        delete[] fVar;
+    if (fActive)
+        delete[] fActive;
+    for (Int_t b = 0; b < kNumBuffers; b++)
+        if (fBuffer[b])
+            delete[] fBuffer[b];
+}
+
+// -----   Public method Init   -----------------------------------------------
+void R3BSofMwpcPedestalTracker::Init(const TArrayI* params, Int_t numPads, Int_t numParams, Float_t numSigmas)
+{
+    if (fMean)
+        delete[] fMean;
+    if (fVar)
+        delete[] fVar;
+    if (fActive)
+        delete[] fActive;
+    for (Int_t b = 0; b < kNumBuffers; b++)
+        if (fBuffer[b])
+            delete[] fBuffer[b];
+
+    fNumPads = numPads;
+    fNumSigmas = numSigmas;
+    fNumEvents = 0;
+    fNumPublished = 0;
+    fMean = new Double_t[numPads];
+    fVar = new Double_t[numPads];
+    fActive = new Bool_t[numPads];
+    for (Int_t b = 0; b < kNumBuffers; b++)
+        fBuffer[b] = new Int_t[2 * numPads];
+    fBack = 0;
+    fFront = 1;
+    fMiddle.store(2);
+
+    for (Int_t i = 0; i < numPads; i++)
+    {
+        fMean[i] = params->GetAt(i * numParams);
+        Double_t sigma = numParams > 1 ? params->GetAt(i * numParams + 1) : 0.;
+        sigma = TMath::Max(sigma, fMinSigma);
+        fVar[i] = sigma * sigma;
+        // Pads without pedestal in the parameters (-1) are dead
+        fActive[i] = fMean[i] >= 0.;
+    }
+
+    LOG(INFO) << "R3BSofMwpcPedestalTracker: tracking " << numPads << " pads, alpha " << fAlpha
+              << ", publication every " << fPublishInterval << " events";
+}
+
+// -----   Public method GetSigma   -------------------------------------------
+Double_t R3BSofMwpcPedestalTracker::GetSigma(Int_t index) const { return TMath::Sqrt(fVar[index]); }
+
+// -----   Public method Fill   -----------------------------------------------
+void R3BSofMwpcPedestalTracker::Fill(const R3BSofMwpcPadImage* image)
+{
+    if (!fMean || image->GetNumPads() != fNumPads)
+        return;
+
+    // Loop over the fired pads only
+    const ULong64_t* fired = image->GetFiredBitmap();
+    for (Int_t w = 0; w < image->GetNumWords(); w++)
+    {
+        ULong64_t bits = fired[w];
+        while (bits)
+        {
+            Int_t i = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (!fActive[i])
+                continue;
+
+            Double_t delta = image->GetQ(i) - fMean[i];
+            Double_t window = fWindow * fWindow * TMath::Max(fVar[i], fMinSigma * fMinSigma);
+            // Pads with signal are not used
+            if (delta * delta > window)
+                continue;
+
+            fMean[i] += fAlpha * delta;
+            fVar[i] = (1. - fAlpha) * (fVar[i] + fAlpha * delta * delta);
+        }
+    }
+
+    if (++fNumEvents >= fPublishInterval)
+    {
+        Publish();
+        fNumEvents = 0;
+    }
+}
+
+// -----   Public method Publish   --------------------------------------------
+void R3BSofMwpcPedestalTracker::Publish()
+{
+    if (!fMean)
+        return;
+
+    Int_t* table = fBuffer[fBack];
+    for (Int_t i = 0; i < fNumPads; i++)
+    {
+        if (fActive[i])
+        {
+            table[i] = TMath::Nint(fMean[i]);
+            table[fNumPads + i] = (Int_t)(fNumSigmas * TMath::Sqrt(fVar[i]));
+        }
+        else
+        {
+            table[i] = -1;
+            table[fNumPads + i] = 0;
+        }
+    }
+
+    // The filled buffer becomes the middle one, the previous middle one is reused
+    fBack = fMiddle.exchange(fBack | kDirty, std::memory_order_acq_rel) & kIndexMask;
+    fNumPublished++;
+}
+
+// -----   Public method Fetch   ----------------------------------------------
+Bool_t R3BSofMwpcPedestalTracker::Fetch(R3BSofMwpcZeroSuppression* zs)
+{
+    if (!(fMiddle.load(std::memory_order_acquire) & kDirty))
+        return kFALSE;
+
+    fFront = fMiddle.exchange(fFront, std::memory_order_acq_rel) & kIndexMask;
+    const Int_t* table = fBuffer[fFront];
+    for (Int_t i = 0; i < fNumPads && i < zs->GetNumPads(); i++)
+    {
+        zs->SetPedestal(i, table[i]);
+        zs->SetThreshold(i, table[fNumPads + i]);
+    }
+    return kTRUE;
+}
+
+ClassImp(R3BSofMwpcPedestalTracker)
@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                 R3BSofMwpcPedestalTracker                  -----
+// -----         Online tracking of the pedestals of MWPC pads      -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofMwpcPedestalTracker_H
+#define R3BSofMwpcPedestalTracker_H
+
+#include "TObject.h"
+
+#include <atomic>
+
+class TArrayI;
+class R3BSofMwpcPadImage;
+class R3BSofMwpcZeroSuppression;
+
+/**
+ * Follows the drift of the pedestal of each pad during the data taking.
+ * The mean and sigma of each pad are updated with exponential moving moments
+ * using only the pads without signal, i.e. those whose charge lies within a
+ * window of n sigmas around the current pedestal.
+ * Every fPublishInterval events a new table of pedestals and thresholds is
+ * published through a lock-free triple buffer. The Mapped2Cal stage fetches
+ * the latest table with Fetch(), which never blocks the producer.
+ **/
+class R3BSofMwpcPedestalTracker : public TObject
+{
+
+  public:
+    /** Default constructor **/
+    R3BSofMwpcPedestalTracker();
+
+    /** Standard constructor
+     *@param alpha     Weight of each new sample in the moving moments
+     *@param interval  Number of events between two publications
+     *@param window    Charges within window*sigma of the pedestal are used
+     **/
+    R3BSofMwpcPedestalTracker(Double_t alpha, Int_t interval = 1000, Float_t window = 3.);
+
+    /** Destructor **/
+    virtual ~R3BSofMwpcPedestalTracker();
+
+    /** Method to start from the pedestals of the calibration parameters
+     *@param params     (mean, sigma, ...) per pad
+     *@param numPads    Number of pads
+     *@param numParams  Number of parameters per pad
+     *@param numSigmas  Threshold in units of sigma for the zero suppression
+     **/
+    void Init(const TArrayI* params, Int_t numPads, Int_t numParams, Float_t numSigmas);
+
+    /** Method to update the moments with the pads of one event (producer) **/
+    void Fill(const R3BSofMwpcPadImage* image);
+
+    /** Method to publish the current pedestals (producer) **/
+    void Publish();
+
+    /** Method to copy the latest published table, if any, into the zero
+     *  suppression (consumer). Returns kTRUE if the pedestals changed **/
+    Bool_t Fetch(R3BSofMwpcZeroSuppression* zs);
+
+    /** Accessors **/
+    Double_t GetMean(Int_t index) const { return fMean[index]; }
+    Double_t GetSigma(Int_t index) const;
+    Int_t GetNumPublished() const { return fNumPublished; }
+
+    void SetAlpha(Double_t alpha) { fAlpha = alpha; }
+    void SetPublishInterval(Int_t interval) { fPublishInterval = interval; }
+    void SetWindow(Float_t window) { fWindow = window; }
+    void SetMinSigma(Double_t sigma) { fMinSigma = sigma; }
+
+  private:
+    enum
+    {
+        kNumBuffers = 3,
+        kDirty = 4,
+        kIndexMask = 3
+    };
+
+    Double_t fAlpha;        // Weight of each new sample
+    Int_t fPublishInterval; // Events between publications
+    Float_t fWindow;        // Acceptance window in units of sigma
+    Double_t fMinSigma;     // Lower bound of sigma, to keep the window open
+    Float_t fNumSigmas;     // Threshold of the published tables in units of sigma
+
+    Int_t fNumPads;
+    Int_t fNumEvents;
+    Int_t fNumPublished;
+    Double_t* fMean; //!
+    Double_t* fVar;  //!
+    Bool_t* fActive; //! Dead pads are not tracked
+
+    // Triple buffer of (pedestal, threshold) tables
+    Int_t* fBuffer[kNumBuffers]; //! 2*fNumPads values each
+    Int_t fBack;                 //! Buffer owned by the producer
+    Int_t fFront;                //! Buffer owned by the consumer
+    std::atomic<Int_t> fMiddle;  //! Buffer in between, with the kDirty flag
+
+    R3BSofMwpcPedestalTracker(const R3BSofMwpcPedestalTracker&);
+    R3BSofMwpcPedestalTracker& operator=(const R3BSofMwpcPedestalTracker&);
+
+  public:
+    ClassDef(R3BSofMwpcPedestalTracker, 1)
+};
+
+#endif
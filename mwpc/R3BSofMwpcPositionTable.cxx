@@ -0,0 +1,145 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                  R3BSofMwpcPositionTable                   -----
+// -----    Lookup table for the hyperbolic-secant (sech^2) method  -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofMwpcPositionTable.h"
+
+#include "FairLogger.h"
+#include "TMath.h"
+
+// R3BSofMwpcPositionTable: Default Constructor --------------------------
+R3BSofMwpcPositionTable::R3BSofMwpcPositionTable()
+    : TObject()
+    , fPadWidth(0.)
+    , fTolerance(0.005)
+    , fNbins(256)
+    , fRatioMin(0.01)
+    , fInvStep(0.)
+    , fMaxDeviation(0.)
+    , fNumAnalyticCells(0)
+    , fNodes(NULL)
+    , fAnalytic(NULL)
+{
+}
+
+// R3BSofMwpcPositionTable: Standard Constructor --------------------------
+R3BSofMwpcPositionTable::R3BSofMwpcPositionTable(Double_t padWidth,
+                                                 Double_t tolerance,
+                                                 Int_t nbins,
+                                                 Double_t ratioMin)
+    : TObject()
+    , fPadWidth(padWidth)
+    , fTolerance(tolerance)
+    , fNbins(nbins)
+    , fRatioMin(ratioMin)
+    , fInvStep(0.)
+    , fMaxDeviation(0.)
+    , fNumAnalyticCells(0)
+    , fNodes(NULL)
+    , fAnalytic(NULL)
+{
+    Build();
+}
+
+// Virtual R3BSofMwpcPositionTable: Destructor
+R3BSofMwpcPositionTable::~R3BSofMwpcPositionTable()
+{
+    if (fNodes)
+        delete[] fNodes;
+    if (fAnalytic)
+        delete[] fAnalytic;
+}
+
+// -----   Public method Build   --------------------------------------------
+void R3BSofMwpcPositionTable::Build()
+{
+    if (fNodes)
+        delete[] fNodes;
+    if (fAnalytic)
+        delete[] fAnalytic;
+
+    const Int_t nodes = fNbins + 1;
+    const Double_t step = (1. - fRatioMin) / fNbins;
+    fInvStep = 1. / step;
+    fNodes = new Double_t[nodes * nodes];
+    fAnalytic = new Bool_t[fNbins * fNbins];
+    fMaxDeviation = 0.;
+    fNumAnalyticCells = 0;
+
+    // Ratios are used directly as charges with qmax = 1
+    for (Int_t i = 0; i < nodes; i++)
+        for (Int_t j = 0; j < nodes; j++)
+            fNodes[i * nodes + j] =
+                GetDisplacementAnalytic(fPadWidth, 1., fRatioMin + i * step, fRatioMin + j * step);
+
+    // Check each cell against the analytic formula at its center and at the middle of its edges
+    const Double_t checks[5][2] = { { 0.5, 0.5 }, { 0.5, 0. }, { 0., 0.5 }, { 0.5, 1. }, { 1., 0.5 } };
+    for (Int_t i = 0; i < fNbins; i++)
+    {
+        for (Int_t j = 0; j < fNbins; j++)
+        {
+            Bool_t analytic = kFALSE;
+            Double_t maxdev = 0.;
+            for (Int_t k = 0; k < 5 && !analytic; k++)
+            {
+                Double_t exact = GetDisplacementAnalytic(
+                    fPadWidth, 1., fRatioMin + (i + checks[k][0]) * step, fRatioMin + (j + checks[k][1]) * step);
+                Double_t dev = TMath::Abs(Interpolate(i, j, checks[k][0], checks[k][1]) - exact);
+                // NaN values (formula not defined) also end up here
+                if (!(dev <= fTolerance))
+                    analytic = kTRUE;
+                else if (dev > maxdev)
+                    maxdev = dev;
+            }
+            fAnalytic[i * fNbins + j] = analytic;
+            if (analytic)
+                fNumAnalyticCells++;
+            else if (maxdev > fMaxDeviation)
+                fMaxDeviation = maxdev;
+        }
+    }
+
+    LOG(DEBUG) << "R3BSofMwpcPositionTable: pad width " << fPadWidth << " mm, " << fNbins << "x" << fNbins
+               << " cells, " << fNumAnalyticCells << " evaluated analytically, max deviation " << fMaxDeviation
+               << " mm";
+}
+
+// -----   Private method Interpolate   --------------------------------------
+Double_t R3BSofMwpcPositionTable::Interpolate(Int_t i, Int_t j, Double_t du, Double_t dv) const
+{
+    const Double_t* n0 = fNodes + i * (fNbins + 1) + j;
+    const Double_t* n1 = n0 + fNbins + 1;
+    return (1. - du) * ((1. - dv) * n0[0] + dv * n0[1]) + du * ((1. - dv) * n1[0] + dv * n1[1]);
+}
+
+// -----   Public method GetDisplacement   -----------------------------------
+Double_t R3BSofMwpcPositionTable::GetDisplacement(Double_t qmax, Double_t qleft, Double_t qright) const
+{
+    Double_t u = (qleft / qmax - fRatioMin) * fInvStep;
+    Double_t v = (qright / qmax - fRatioMin) * fInvStep;
+    if (!fAnalytic || u < 0. || v < 0. || u > fNbins || v > fNbins)
+        return GetDisplacementAnalytic(fPadWidth, qmax, qleft, qright);
+
+    Int_t i = TMath::Min((Int_t)u, fNbins - 1);
+    Int_t j = TMath::Min((Int_t)v, fNbins - 1);
+    if (fAnalytic[i * fNbins + j])
+        return GetDisplacementAnalytic(fPadWidth, qmax, qleft, qright);
+
+    return Interpolate(i, j, u - i, v - j);
+}
+
+// -----   Public method GetDisplacementAnalytic   ---------------------------
+Double_t R3BSofMwpcPositionTable::GetDisplacementAnalytic(Double_t padWidth,
+                                                          Double_t qmax,
+                                                          Double_t qleft,
+                                                          Double_t qright)
+{
+    Double_t a3 =
+        TMath::Pi() * padWidth / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qleft) + TMath::Sqrt(qmax / qright))));
+    return (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qleft) - TMath::Sqrt(qmax / qright)) /
+                                             (2 * TMath::SinH(TMath::Pi() * padWidth / a3)));
+}
+
+ClassImp(R3BSofMwpcPositionTable)
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                  R3BSofMwpcPositionTable                   -----
+// -----    Lookup table for the hyperbolic-secant (sech^2) method  -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofMwpcPositionTable_H
+#define R3BSofMwpcPositionTable_H
+
+#include "TObject.h"
+
+/**
+ * Precomputed displacement of the hit with respect to the center of the pad
+ * with the maximum charge, as given by the three-pad sech^2 method.
+ * The table is built in (qleft/qmax, qright/qmax) space and evaluated with a
+ * bilinear interpolation. Cells where the interpolation deviates more than
+ * the tolerance from the analytic formula (or where the formula is not
+ * defined) are flagged and evaluated analytically, as well as the ratios
+ * outside the table range.
+ **/
+class R3BSofMwpcPositionTable : public TObject
+{
+
+  public:
+    /** Default constructor **/
+    R3BSofMwpcPositionTable();
+
+    /** Standard constructor
+     *@param padWidth   Pad width [mm]
+     *@param tolerance  Maximum deviation with respect to the analytic formula [mm]
+     *@param nbins      Number of bins per ratio axis
+     *@param ratioMin   Lowest ratio q/qmax included in the table
+     **/
+    R3BSofMwpcPositionTable(Double_t padWidth,
+                            Double_t tolerance = 0.005,
+                            Int_t nbins = 256,
+                            Double_t ratioMin = 0.01);
+
+    /** Destructor **/
+    virtual ~R3BSofMwpcPositionTable();
+
+    /** Method to (re)build the table **/
+    void Build();
+
+    /** Displacement [mm] obtained from the table **/
+    Double_t GetDisplacement(Double_t qmax, Double_t qleft, Double_t qright) const;
+
+    /** Displacement [mm] obtained from the analytic formula **/
+    static Double_t GetDisplacementAnalytic(Double_t padWidth, Double_t qmax, Double_t qleft, Double_t qright);
+
+    /** Accessors **/
+    Double_t GetPadWidth() const { return fPadWidth; }
+    Double_t GetTolerance() const { return fTolerance; }
+    Int_t GetNbins() const { return fNbins; }
+    Double_t GetRatioMin() const { return fRatioMin; }
+    Double_t GetMaxDeviation() const { return fMaxDeviation; }
+    Int_t GetNumAnalyticCells() const { return fNumAnalyticCells; }
+
+    /** Modifiers, the table has to be rebuilt afterwards **/
+    void SetPadWidth(Double_t width) { fPadWidth = width; }
+    void SetTolerance(Double_t tolerance) { fTolerance = tolerance; }
+    void SetNbins(Int_t nbins) { fNbins = nbins; }
+    void SetRatioMin(Double_t ratio) { fRatioMin = ratio; }
+
+  private:
+    Double_t fPadWidth;     // Pad width [mm]
+    Double_t fTolerance;    // Maximum deviation allowed for interpolated cells [mm]
+    Int_t fNbins;           // Number of bins per ratio axis
+    Double_t fRatioMin;     // Lower edge of the table in q/qmax
+    Double_t fInvStep;      // Inverse of the bin width in q/qmax
+    Double_t fMaxDeviation; // Maximum deviation found in the interpolated cells [mm]
+    Int_t fNumAnalyticCells;
+
+    Double_t* fNodes;   //! (fNbins+1)*(fNbins+1) displacements at the nodes
+    Bool_t* fAnalytic;  //! fNbins*fNbins cells evaluated with the analytic formula
+
+    Double_t Interpolate(Int_t i, Int_t j, Double_t du, Double_t dv) const;
+
+    R3BSofMwpcPositionTable(const R3BSofMwpcPositionTable&);
+    R3BSofMwpcPositionTable& operator=(const R3BSofMwpcPositionTable&);
+
+  public:
+    ClassDef(R3BSofMwpcPositionTable, 1)
+};
+
+#endif
@@ -0,0 +1,113 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                 R3BSofMwpcZeroSuppression                  -----
+// -----      Pedestal subtraction and zero suppression of MWPCs    -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofMwpcZeroSuppression.h"
+#include "R3BSofMwpcPadImage.h"
+
+#include "FairLogger.h"
+
+// R3BSofMwpcZeroSuppression: Default Constructor --------------------------
+R3BSofMwpcZeroSuppression::R3BSofMwpcZeroSuppression()
+    : TObject()
+    , fNumPads(0)
+    , fSize(0)
+    , fPedestal(NULL)
+    , fThreshold(NULL)
+    , fCharge(NULL)
+    , fSelIndex(NULL)
+    , fSelQ(NULL)
+{
+}
+
+// R3BSofMwpcZeroSuppression: Standard Constructor --------------------------
+R3BSofMwpcZeroSuppression::R3BSofMwpcZeroSuppression(Int_t numPads)
+    : TObject()
+    , fNumPads(0)
+    , fSize(0)
+    , fPedestal(NULL)
+    , fThreshold(NULL)
+    , fCharge(NULL)
+    , fSelIndex(NULL)
+    , fSelQ(NULL)
+{
+    SetNumPads(numPads);
+}
+
+// Virtual R3BSofMwpcZeroSuppression: Destructor
+R3BSofMwpcZeroSuppression::~R3BSofMwpcZeroSuppression()
+{
+    if (fPedestal)
+        delete[] fPedestal;
+    if (fThreshold)
+        delete[] fThreshold;
+    if (fCharge)
+        delete[] fCharge;
+    if (fSelIndex)
+        delete[] fSelIndex;
+    if (fSelQ)
+        delete[] fSelQ;
+}
+
+// -----   Public method SetNumPads   ----------------------------------------
+void R3BSofMwpcZeroSuppression::SetNumPads(Int_t numPads)
+{
+    if (fPedestal)
+        delete[] fPedestal;
+    if (fThreshold)
+        delete[] fThreshold;
+    if (fCharge)
+        delete[] fCharge;
+    if (fSelIndex)
+        delete[] fSelIndex;
+    if (fSelQ)
+        delete[] fSelQ;
+
+    fNumPads = numPads;
+    fSize = (numPads + 7) & ~7;
+    fPedestal = new Int_t[fSize];
+    fThreshold = new Int_t[fSize];
+    fCharge = new Int_t[fSize];
+    // One extra slot for the unconditional store of the compaction
+    fSelIndex = new Int_t[fSize + 1];
+    fSelQ = new Int_t[fSize + 1];
+    for (Int_t i = 0; i < fSize; i++)
+    {
+        fPedestal[i] = 0;
+        fThreshold[i] = 0;
+    }
+}
+
+// -----   Public method Process   -------------------------------------------
+Int_t R3BSofMwpcZeroSuppression::Process(const R3BSofMwpcPadImage* image)
+{
+    if (image->GetNumPads() != fNumPads)
+    {
+        LOG(ERROR) << "R3BSofMwpcZeroSuppression: image with " << image->GetNumPads() << " pads, expected "
+                   << fNumPads;
+        return 0;
+    }
+
+    const Int_t* q = image->GetQArray();
+    const Int_t* ped = fPedestal;
+    const Int_t* thr = fThreshold;
+    Int_t* charge = fCharge;
+
+    // Pedestal subtraction, empty pads stay far below any threshold
+    for (Int_t i = 0; i < fSize; i++)
+        charge[i] = q[i] - ped[i];
+
+    // Stream compaction of the pads above threshold
+    Int_t n = 0;
+    for (Int_t i = 0; i < fSize; i++)
+    {
+        fSelIndex[n] = i;
+        fSelQ[n] = charge[i];
+        n += (charge[i] > thr[i]);
+    }
+    return n;
+}
+
+ClassImp(R3BSofMwpcZeroSuppression)
@@ -0,0 +1,70 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                 R3BSofMwpcZeroSuppression                  -----
+// -----      Pedestal subtraction and zero suppression of MWPCs    -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofMwpcZeroSuppression_H
+#define R3BSofMwpcZeroSuppression_H
+
+#include "TObject.h"
+
+class R3BSofMwpcPadImage;
+
+/**
+ * Subtracts the pedestals from a dense pad image in a single pass over all
+ * the pads and compacts the pads above threshold into a list. Both loops are
+ * free of branches and run over arrays padded to a multiple of 8 pads, so
+ * that the compiler can vectorize them.
+ * Pad indices follow the layout of R3BSofMwpcPadImage and of the calibration
+ * parameters (plane 1, plane 2, plane 3).
+ **/
+class R3BSofMwpcZeroSuppression : public TObject
+{
+
+  public:
+    /** Default constructor **/
+    R3BSofMwpcZeroSuppression();
+
+    /** Standard constructor **/
+    R3BSofMwpcZeroSuppression(Int_t numPads);
+
+    /** Destructor **/
+    virtual ~R3BSofMwpcZeroSuppression();
+
+    /** Method to allocate the tables, pedestals and thresholds are set to zero **/
+    void SetNumPads(Int_t numPads);
+
+    /** Method to subtract the pedestals and to select the pads above threshold,
+     *  returns the number of selected pads **/
+    Int_t Process(const R3BSofMwpcPadImage* image);
+
+    /** Accessors **/
+    inline Int_t GetNumPads() const { return fNumPads; }
+    inline Int_t GetPedestal(Int_t index) const { return fPedestal[index]; }
+    inline Int_t GetThreshold(Int_t index) const { return fThreshold[index]; }
+    /** Index and charge of the i-th selected pad **/
+    inline Int_t GetIndex(Int_t i) const { return fSelIndex[i]; }
+    inline Int_t GetQ(Int_t i) const { return fSelQ[i]; }
+
+    /** Modifiers **/
+    inline void SetPedestal(Int_t index, Int_t pedestal) { fPedestal[index] = pedestal; }
+    inline void SetThreshold(Int_t index, Int_t threshold) { fThreshold[index] = threshold; }
+
+  private:
+    Int_t fNumPads;
+    Int_t fSize;       // Allocated size, multiple of 8
+    Int_t* fPedestal;  //! Pedestal per pad
+    Int_t* fThreshold; //! Minimum charge after pedestal subtraction (excluded)
+    Int_t* fCharge;    //! Charges after pedestal subtraction
+    Int_t* fSelIndex;  //! Indices of the selected pads
+    Int_t* fSelQ;      //! Charges of the selected pads
+
+    R3BSofMwpcZeroSuppression(const R3BSofMwpcZeroSuppression&);
+    R3BSofMwpcZeroSuppression& operator=(const R3BSofMwpcZeroSuppression&);
+
+  public:
+    ClassDef(R3BSofMwpcZeroSuppression, 1)
+};
+
+#endif
@@ -7,6 +7,10 @@
 #pragma link off all functions;
 
 #pragma link C++ class R3BSofMwpcDigitizer + ;
+#pragma link C++ class R3BSofMwpcPositionTable + ;
+#pragma link C++ class R3BSofMwpcZeroSuppression + ;
+#pragma link C++ class R3BSofMwpcPedestalTracker + ;
+#pragma link C++ class R3BSofMwpcPedestalFitter + ;
 
 #pragma link C++ class R3BSofMwpc0 + ;
 #pragma link C++ class R3BSofMwpc0ContFact + ;
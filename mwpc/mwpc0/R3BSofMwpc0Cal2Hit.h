@@ -17,6 +17,7 @@
 #define Mw0PadsY 64
 
 class TClonesArray;
+class R3BSofMwpcPositionTable;
 
 class R3BSofMwpc0Cal2Hit : public FairTask
 {
@@ -49,6 +50,10 @@ class R3BSofMwpc0Cal2Hit : public FairTask
 
     void SetOnline(Bool_t option) { fOnline = option; }
 
+    /** Accessors to obtain the positions from a lookup table **/
+    void SetUseLookupTable(Bool_t option) { fUseTable = option; }
+    void SetLookupTableTolerance(Double_t tolerance) { fTableTolerance = tolerance; }
+
   private:
     Double_t fSize; // Detector size in X and Y
     Double_t fwx;   // Pad width in X
@@ -57,6 +62,11 @@ class R3BSofMwpc0Cal2Hit : public FairTask
 
     Bool_t fOnline; // Don't store data for online
 
+    Bool_t fUseTable;                 // Positions from a lookup table
+    Double_t fTableTolerance;         // Tolerance of the lookup table [mm]
+    R3BSofMwpcPositionTable* fTableX; // Lookup table for the X plane
+    R3BSofMwpcPositionTable* fTableY; // Lookup table for the Y plane
+
     TClonesArray* fMwpcCalDataCA; /**< Array with Cal input data. >*/
     TClonesArray* fMwpcHitDataCA; /**< Array with Hit output data. >*/
 
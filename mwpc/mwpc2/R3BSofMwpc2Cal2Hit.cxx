@@ -19,6 +19,7 @@
 #include "R3BSofMwpc2Cal2Hit.h"
 #include "R3BSofMwpcCalData.h"
 #include "R3BSofMwpcHitData.h"
+#include "R3BSofMwpcPositionTable.h"
 
 // R3BSofMwpc2Cal2Hit: Default Constructor --------------------------
 R3BSofMwpc2Cal2Hit::R3BSofMwpc2Cal2Hit()
@@ -29,6 +30,10 @@ R3BSofMwpc2Cal2Hit::R3BSofMwpc2Cal2Hit()
     , fwy(5.000)   // in mm
     , fSize(200.0) // in mm
     , fOnline(kFALSE)
+    , fUseTable(kFALSE)
+    , fTableTolerance(0.005)
+    , fTableX(NULL)
+    , fTableY(NULL)
 {
 }
 
@@ -41,6 +46,10 @@ R3BSofMwpc2Cal2Hit::R3BSofMwpc2Cal2Hit(const char* name, Int_t iVerbose)
     , fwy(5.000)   // in mm
     , fSize(200.0) // in mm
     , fOnline(kFALSE)
+    , fUseTable(kFALSE)
+    , fTableTolerance(0.005)
+    , fTableX(NULL)
+    , fTableY(NULL)
 {
 }
 
@@ -52,6 +61,10 @@ R3BSofMwpc2Cal2Hit::~R3BSofMwpc2Cal2Hit()
         delete fMwpcCalDataCA;
     if (fMwpcHitDataCA)
         delete fMwpcHitDataCA;
+    if (fTableX)
+        delete fTableX;
+    if (fTableY)
+        delete fTableY;
 }
 
 // -----   Public method Init   --------------------------------------------
@@ -85,6 +98,18 @@ InitStatus R3BSofMwpc2Cal2Hit::Init()
         rootManager->Register("Mwpc2HitData", "MWPC2 Hit", fMwpcHitDataCA, kFALSE);
     }
 
+    // Lookup tables for the sech^2 method, those of a former Init freed
+    delete fTableX;
+    delete fTableY;
+    fTableX = fTableY = NULL;
+    if (fUseTable)
+    {
+        fTableX = new R3BSofMwpcPositionTable(fwx, fTableTolerance);
+        fTableY = new R3BSofMwpcPositionTable(fwy, fTableTolerance);
+        LOG(INFO) << "R3BSofMwpc2Cal2Hit: Lookup tables built, max deviation " << fTableX->GetMaxDeviation()
+                  << " mm in X and " << fTableY->GetMaxDeviation() << " mm in Y";
+    }
+
     return kSUCCESS;
 }
 
@@ -167,10 +192,11 @@ void R3BSofMwpc2Cal2Hit::Exec(Option_t* option)
 // -----   Protected method to obtain the position X ----------------------------
 Double_t R3BSofMwpc2Cal2Hit::GetPostionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright)
 {
-    Double_t a3 = TMath::Pi() * fwx / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qleft) + TMath::Sqrt(qmax / qright))));
-    // Double_t a2 = gRandom->Uniform(-fwx / 2,fwx / 2);
-    Double_t a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qleft) - TMath::Sqrt(qmax / qright)) /
-                                                    (2 * TMath::SinH(TMath::Pi() * fwx / a3)));
+    Double_t a2;
+    if (fTableX)
+        a2 = fTableX->GetDisplacement(qmax, qleft, qright);
+    else
+        a2 = R3BSofMwpcPositionTable::GetDisplacementAnalytic(fwx, qmax, qleft, qright);
 
     return (-1. * padmax * fwx + (fSize / 2) - (fwx / 2) - a2); // Left is positive and right negative
 }
@@ -178,10 +204,11 @@ Double_t R3BSofMwpc2Cal2Hit::GetPostionX(Double_t qmax, Int_t padmax, Double_t q
 // -----   Protected method to obtain the position Y ----------------------------
 Double_t R3BSofMwpc2Cal2Hit::GetPostionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup)
 {
-    Double_t a3 = TMath::Pi() * fwy / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qdown) + TMath::Sqrt(qmax / qup))));
-    // Double_t a2 = gRandom->Uniform(-fwy / 2, fwy / 2);
-    Double_t a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qdown) - TMath::Sqrt(qmax / qup)) /
-                                                    (2 * TMath::SinH(TMath::Pi() * fwy / a3)));
+    Double_t a2;
+    if (fTableY)
+        a2 = fTableY->GetDisplacement(qmax, qdown, qup);
+    else
+        a2 = R3BSofMwpcPositionTable::GetDisplacementAnalytic(fwy, qmax, qdown, qup);
 
     return (padmax * fwy - (fSize / 2) + (fwy / 2) + a2);
 }
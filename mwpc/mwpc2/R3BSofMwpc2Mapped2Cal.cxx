@@ -21,6 +21,9 @@
 #include "R3BSofMwpc2Mapped2Cal.h"
 #include "R3BSofMwpcCalData.h"
 #include "R3BSofMwpcMappedData.h"
+#include "R3BSofMwpcPadImage.h"
+#include "R3BSofMwpcPedestalTracker.h"
+#include "R3BSofMwpcZeroSuppression.h"
 
 // R3BSofMwpc2Mapped2Cal: Default Constructor --------------------------
 R3BSofMwpc2Mapped2Cal::R3BSofMwpc2Mapped2Cal()
@@ -33,6 +36,11 @@ R3BSofMwpc2Mapped2Cal::R3BSofMwpc2Mapped2Cal()
     , fMwpcMappedDataCA(NULL)
     , fMwpcCalDataCA(NULL)
     , fOnline(kFALSE)
+    , fNumSigmas(0.)
+    , fPadImage(NULL)
+    , fExternalImage(kFALSE)
+    , fZeroSuppression(NULL)
+    , fPedTracker(NULL)
 {
 }
 
@@ -47,6 +55,11 @@ R3BSofMwpc2Mapped2Cal::R3BSofMwpc2Mapped2Cal(const char* name, Int_t iVerbose)
     , fMwpcMappedDataCA(NULL)
     , fMwpcCalDataCA(NULL)
     , fOnline(kFALSE)
+    , fNumSigmas(0.)
+    , fPadImage(NULL)
+    , fExternalImage(kFALSE)
+    , fZeroSuppression(NULL)
+    , fPedTracker(NULL)
 {
 }
 
@@ -58,6 +71,12 @@ R3BSofMwpc2Mapped2Cal::~R3BSofMwpc2Mapped2Cal()
         delete fMwpcMappedDataCA;
     if (fMwpcCalDataCA)
         delete fMwpcCalDataCA;
+    if (fPadImage && !fExternalImage)
+        delete fPadImage;
+    if (fZeroSuppression)
+        delete fZeroSuppression;
+    if (fPedTracker)
+        delete fPedTracker;
 }
 
 void R3BSofMwpc2Mapped2Cal::SetParContainers()
@@ -94,10 +113,20 @@ void R3BSofMwpc2Mapped2Cal::SetParameter()
     LOG(INFO) << "R3BSofMwpc2Mapped2Cal: NumPadY: " << NumPadY;
     LOG(INFO) << "R3BSofMwpc2Mapped2Cal: Number of fit parameters: " << NumParams;
 
-    CalParams = new TArrayI();
-    Int_t array_size = (NumPadX + NumPadY) * NumParams;
-    CalParams->Set(array_size);
     CalParams = fCal_Par->GetPadCalParams(); // Array with the Cal parameters
+
+    // Pedestals and thresholds for the zero suppression
+    if (!fZeroSuppression)
+        fZeroSuppression = new R3BSofMwpcZeroSuppression();
+    fZeroSuppression->SetNumPads(NumPadX + NumPadY);
+    for (Int_t i = 0; i < NumPadX + NumPadY; i++)
+    {
+        fZeroSuppression->SetPedestal(i, CalParams->GetAt(i * NumParams));
+        if (NumParams > 1)
+            fZeroSuppression->SetThreshold(i, (Int_t)(fNumSigmas * CalParams->GetAt(i * NumParams + 1)));
+    }
+    if (fPedTracker)
+        fPedTracker->Init(CalParams, NumPadX + NumPadY, NumParams, fNumSigmas);
 }
 
 // -----   Public method Init   --------------------------------------------
@@ -112,10 +141,16 @@ InitStatus R3BSofMwpc2Mapped2Cal::Init()
         return kFATAL;
     }
 
-    fMwpcMappedDataCA = (TClonesArray*)rootManager->GetObject("Mwpc2MappedData");
-    if (!fMwpcMappedDataCA)
+    // Pad image written by the reader, otherwise it is filled from the mapped data
+    fPadImage = (R3BSofMwpcPadImage*)rootManager->GetObject("Mwpc2PadImage");
+    fExternalImage = fPadImage != NULL;
+    if (!fExternalImage)
     {
-        return kFATAL;
+        fMwpcMappedDataCA = (TClonesArray*)rootManager->GetObject("Mwpc2MappedData");
+        if (!fMwpcMappedDataCA)
+        {
+            return kFATAL;
+        }
     }
 
     // OUTPUT DATA
@@ -132,6 +167,20 @@ InitStatus R3BSofMwpc2Mapped2Cal::Init()
     }
 
     SetParameter();
+
+    // Dense image of the pad charges
+    if (!fExternalImage)
+    {
+        delete fPadImage; // of a former Init
+        fPadImage = new R3BSofMwpcPadImage("Mwpc2PadImage", NumPadX / 2, NumPadX / 2, NumPadY);
+    }
+    else if (fPadImage->GetNumPads(1) != NumPadX / 2 || fPadImage->GetNumPads(2) != NumPadX / 2 ||
+             fPadImage->GetNumPads(3) != NumPadY)
+    {
+        LOG(ERROR) << "R3BSofMwpc2Mapped2Cal::Init() Pad image of the reader does not match the "
+                   << "mwpc2CalPar container";
+        return kFATAL;
+    }
     return kSUCCESS;
 }
 
@@ -154,45 +203,43 @@ void R3BSofMwpc2Mapped2Cal::Exec(Option_t* option)
     }
 
     // Reading the Input -- Mapped Data --
-    Int_t nHits = fMwpcMappedDataCA->GetEntries();
+    Int_t nHits = fExternalImage ? fPadImage->GetNumFired() : fMwpcMappedDataCA->GetEntries();
     if (nHits > (NumPadX + NumPadY) && nHits > 0)
         LOG(WARNING) << "R3BSofMwpc2Mapped2Cal: nHits>(NumPadX+NumPadY)";
     if (!nHits)
         return;
 
-    R3BSofMwpcMappedData** mappedData;
-    mappedData = new R3BSofMwpcMappedData*[nHits];
-    Int_t planeId;
-    Int_t padId;
-    Int_t charge;
-    Int_t pedestal = 0;
-    Int_t nbpad = 0;
-
-    for (Int_t i = 0; i < nHits; i++)
+    // Dense image of the pad charges
+    if (!fExternalImage)
     {
-        mappedData[i] = (R3BSofMwpcMappedData*)(fMwpcMappedDataCA->At(i));
-        planeId = mappedData[i]->GetPlane();
-        padId = mappedData[i]->GetPad();
-        if (planeId == 1) // Xup
-            nbpad = padId * NumParams;
-        else if (planeId == 2) // Xdown
-            nbpad = (padId + NumPadX / 2) * NumParams;
-        else if (planeId == 3) // Y
-            nbpad = (padId + NumPadX) * NumParams;
-        else
-            LOG(ERROR) << "Plane " << planeId << " does not exist in MWPC2";
-
-        pedestal = CalParams->GetAt(nbpad);
-        charge = mappedData[i]->GetQ() - pedestal;
-
-        // We accept the hit if the charge is larger than zero
-        if (charge > 0)
+        for (Int_t i = 0; i < nHits; i++)
         {
-            AddCalData(planeId, padId, charge);
+            R3BSofMwpcMappedData* mappedData = (R3BSofMwpcMappedData*)(fMwpcMappedDataCA->At(i));
+            Int_t planeId = mappedData->GetPlane();
+            Int_t padId = mappedData->GetPad();
+            if (fPadImage->IsValid(planeId, padId))
+                fPadImage->SetQ(planeId, padId, mappedData->GetQ());
+            else
+                LOG(ERROR) << "Plane " << planeId << " and pad " << padId << " do not exist in MWPC2";
         }
     }
-    if (mappedData)
-        delete mappedData;
+
+    // Online tracking of the pedestals, new tables are used from the next event
+    if (fPedTracker)
+    {
+        fPedTracker->Fetch(fZeroSuppression);
+        fPedTracker->Fill(fPadImage);
+    }
+
+    // Pedestal subtraction, we accept the hit if the charge is larger than the threshold
+    Int_t nPads = fZeroSuppression->Process(fPadImage);
+    for (Int_t i = 0; i < nPads; i++)
+    {
+        Int_t index = fZeroSuppression->GetIndex(i);
+        AddCalData(fPadImage->GetPlane(index), fPadImage->GetPad(index), fZeroSuppression->GetQ(i));
+    }
+    if (!fExternalImage)
+        fPadImage->Clear();
     return;
 }
 
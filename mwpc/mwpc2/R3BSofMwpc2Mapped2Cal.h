@@ -15,6 +15,9 @@
 
 class TClonesArray;
 class R3BSofMwpc2CalPar;
+class R3BSofMwpcPadImage;
+class R3BSofMwpcZeroSuppression;
+class R3BSofMwpcPedestalTracker;
 
 class R3BSofMwpc2Mapped2Cal : public FairTask
 {
@@ -49,6 +52,12 @@ class R3BSofMwpc2Mapped2Cal : public FairTask
 
     void SetOnline(Bool_t option) { fOnline = option; }
 
+    /** Accessor to set the threshold in units of the pedestal sigma **/
+    void SetNumSigmas(Float_t n) { fNumSigmas = n; }
+
+    /** Accessor to follow the pedestals online, the task takes ownership of the tracker **/
+    void SetPedestalTracker(R3BSofMwpcPedestalTracker* tracker) { fPedTracker = tracker; }
+
   private:
     void SetParameter();
 
@@ -57,7 +66,13 @@ class R3BSofMwpc2Mapped2Cal : public FairTask
     Int_t NumParams;
     TArrayI* CalParams;
 
-    Bool_t fOnline; // Don't store data for online
+    Bool_t fOnline;     // Don't store data for online
+    Float_t fNumSigmas; // Threshold in units of the pedestal sigma
+
+    R3BSofMwpcPadImage* fPadImage;               // Dense image of the pad charges
+    Bool_t fExternalImage;                       // Image written by the reader, not owned
+    R3BSofMwpcZeroSuppression* fZeroSuppression; // Pedestal subtraction and zero suppression
+    R3BSofMwpcPedestalTracker* fPedTracker;      // Online tracking of the pedestals
 
     R3BSofMwpc2CalPar* fCal_Par;     /**< Parameter container. >*/
     TClonesArray* fMwpcMappedDataCA; /**< Array with Mapped- input data. >*/
@@ -55,6 +55,7 @@ class R3BSofMwpc2Mapped2CalPar : public FairTask
     const Int_t GetCalRange_right() { return fMapHistos_right; }
     const Int_t GetCalRange_bins() { return fMapHistos_bins; }
     const Int_t GetMinStadistics() { return fMinStadistics; }
+    const Int_t GetNumThreads() { return fNumThreads; }
 
     void SetNumPadsX(Int_t numberPadsX) { fNumPadX = numberPadsX; }
     void SetNumPadsY(Int_t numberPadsY) { fNumPadY = numberPadsY; }
@@ -63,6 +64,8 @@ class R3BSofMwpc2Mapped2CalPar : public FairTask
     void SetCalRange_right(Int_t Histos_right) { fMapHistos_right = Histos_right; }
     void SetCalRange_bins(Int_t Histos_bins) { fMapHistos_bins = Histos_bins; }
     void SetMinStadistics(Int_t minstad) { fMinStadistics = minstad; }
+    /* Number of threads for the pedestal fits, 0 for the number of cores */
+    void SetNumThreads(Int_t numThreads) { fNumThreads = numThreads; }
 
   protected:
     // Number of histograms, limits and bining
@@ -75,6 +78,7 @@ class R3BSofMwpc2Mapped2CalPar : public FairTask
 
     // Minimum stadistics and parameters
     Int_t fMinStadistics;
+    Int_t fNumThreads;
 
     R3BSofMwpc2CalPar* fPad_Par;     /**< Parameter container. >*/
     TClonesArray* fMwpcMappedDataCA; /**< Array with Mapped-input data. >*/
@@ -6,6 +6,7 @@
 #include "R3BSofMwpc3Mapped2CalPar.h"
 #include "R3BEventHeader.h"
 #include "R3BSofMwpc3CalPar.h"
+#include "R3BSofMwpcPedestalFitter.h"
 #include "R3BSofMwpcMappedData.h"
 
 #include "FairLogger.h"
@@ -37,6 +38,7 @@ R3BSofMwpc3Mapped2CalPar::R3BSofMwpc3Mapped2CalPar()
     , fNumPadY(120)
     , fNumParams(2)
     , fMinStadistics(100)
+    , fNumThreads(0)
     , fMapHistos_left(0)
     , fMapHistos_right(270000)
     , fMapHistos_bins(27000)
@@ -52,6 +54,7 @@ R3BSofMwpc3Mapped2CalPar::R3BSofMwpc3Mapped2CalPar(const char* name, Int_t iVerb
     , fNumPadY(120)
     , fNumParams(2)
     , fMinStadistics(100)
+    , fNumThreads(0)
     , fMapHistos_left(0)
     , fMapHistos_right(270000)
     , fMapHistos_bins(27000)
@@ -173,19 +176,22 @@ void R3BSofMwpc3Mapped2CalPar::SearchPedestals()
     fPad_Par->SetNumParametersFit(fNumParams);
     fPad_Par->GetPadCalParams()->Set(fNumParams * (fNumPadX + fNumPadY));
 
+    // All the spectra are fitted at once
+    R3BSofMwpcPedestalFitter fitter(fNumThreads);
+    fitter.SetMinStatistics(fMinStadistics);
+    fitter.Fit(fh_Map_q_pad, fNumPadX + fNumPadY);
+
     Int_t nbpad = 0;
 
     for (Int_t i = 0; i < fNumPadX + fNumPadY; i++)
     {
 
         nbpad = i * fNumParams;
-        if (fh_Map_q_pad[i]->GetEntries() > fMinStadistics)
+        if (fitter.GetStatus(i) == R3BSofMwpcPedestalFitter::kAnalytic ||
+            fitter.GetStatus(i) == R3BSofMwpcPedestalFitter::kTF1)
         {
-            Int_t tmp = fh_Map_q_pad[i]->GetMaximumBin() * 10;
-            TF1* f1 = new TF1("f1", "gaus", fMapHistos_left, fMapHistos_right);
-            fh_Map_q_pad[i]->Fit("f1", "QON", "", tmp - 80, tmp + 80);
-            fPad_Par->SetPadCalParams(f1->GetParameter(1), nbpad);
-            fPad_Par->SetPadCalParams(f1->GetParameter(2), nbpad + 1);
+            fPad_Par->SetPadCalParams(fitter.GetMean(i), nbpad);
+            fPad_Par->SetPadCalParams(fitter.GetSigma(i), nbpad + 1);
         }
         else
         {
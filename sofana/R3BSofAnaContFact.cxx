@@ -36,6 +36,11 @@ void R3BSofAnaContFact::setAllContainers()
     p2->addContext("SofFragmentParContext");
 
     containers->Add(p2);
+
+    FairContainer* p3 = new FairContainer("sofGladLookupPar", "GLAD Brho Lookup Table", "SofGladLookupParContext");
+    p3->addContext("SofGladLookupParContext");
+
+    containers->Add(p3);
 }
 
 FairParSet* R3BSofAnaContFact::createContainer(FairContainer* c)
@@ -57,6 +62,11 @@ FairParSet* R3BSofAnaContFact::createContainer(FairContainer* c)
         p = new R3BSofFragmentAnaPar(c->getConcatName().Data(), c->GetTitle(), c->getContext());
     }
 
+    if (strcmp(name, "sofGladLookupPar") == 0)
+    {
+        p = new R3BSofGladLookupPar(c->getConcatName().Data(), c->GetTitle(), c->getContext());
+    }
+
     return p;
 }
 
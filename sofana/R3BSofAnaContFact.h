@@ -9,6 +9,7 @@
 
 #include "R3BSofFrsAnaPar.h"
 #include "R3BSofFragmentAnaPar.h"
+#include "R3BSofGladLookupPar.h"
 
 #include "TClass.h"
 
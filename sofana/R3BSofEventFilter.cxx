@@ -0,0 +1,225 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofEventFilter                      -----
+// -----     Skips the analysis of the events failing cheap cuts    -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofEventFilter.h"
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include "FairRun.h"
+
+#include "R3BEventHeader.h"
+#include "R3BSofSciSingleTcalData.h"
+#include "R3BSofTwimHitData.h"
+
+#include "TClonesArray.h"
+#include "TList.h"
+#include "TObjString.h"
+
+R3BSofEventFilter::R3BSofEventFilter()
+    : FairTask("R3BSofEventFilter", 1)
+    , fTpatMask(0)
+    , fCaveCMultMin(0)
+    , fCaveCMultMax(-1)
+    , fIdCaveC(4)
+    , fUseTwim(kFALSE)
+    , fTwimZMin(0.)
+    , fTwimZMax(0.)
+    , fSkipFill(kFALSE)
+    , fEventHeader(NULL)
+    , fSciSingleTcalCA(NULL)
+    , fTwimHitDataCA(NULL)
+    , fNumBranches(0)
+    , fNumEvents(0)
+    , fNumAccepted(0)
+{
+    for (Int_t c = 0; c < kNumCuts; c++)
+        fNumRejected[c] = 0;
+}
+
+R3BSofEventFilter::R3BSofEventFilter(const char* name, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+    , fTpatMask(0)
+    , fCaveCMultMin(0)
+    , fCaveCMultMax(-1)
+    , fIdCaveC(4)
+    , fUseTwim(kFALSE)
+    , fTwimZMin(0.)
+    , fTwimZMax(0.)
+    , fSkipFill(kFALSE)
+    , fEventHeader(NULL)
+    , fSciSingleTcalCA(NULL)
+    , fTwimHitDataCA(NULL)
+    , fNumBranches(0)
+    , fNumEvents(0)
+    , fNumAccepted(0)
+{
+    for (Int_t c = 0; c < kNumCuts; c++)
+        fNumRejected[c] = 0;
+}
+
+R3BSofEventFilter::~R3BSofEventFilter() {}
+
+void R3BSofEventFilter::Guard(FairRun* run)
+{
+    TList* list = run->GetMainTask()->GetListOfTasks();
+    Int_t index = list->IndexOf(this);
+    if (index < 0)
+    {
+        LOG(ERROR) << "R3BSofEventFilter::Guard() the filter is not a task of the run";
+        return;
+    }
+    fGuarded.clear();
+    for (Int_t t = index + 1; t < list->GetEntries(); t++)
+        fGuarded.push_back((TTask*)list->At(t));
+    LOG(INFO) << "R3BSofEventFilter::Guard() " << fGuarded.size() << " tasks behind the filter";
+}
+
+InitStatus R3BSofEventFilter::Init()
+{
+    LOG(INFO) << "R3BSofEventFilter::Init()";
+    FairRootManager* mgr = FairRootManager::Instance();
+    if (!mgr)
+    {
+        return kFATAL;
+    }
+
+    // --- Inputs of the conditions in use --- //
+    if (fTpatMask != 0)
+    {
+        fEventHeader = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+        if (!fEventHeader)
+        {
+            LOG(ERROR) << "R3BSofEventFilter::Init() R3BEventHeader not found";
+            return kFATAL;
+        }
+    }
+    if (fCaveCMultMax >= 0)
+    {
+        fSciSingleTcalCA = (TClonesArray*)mgr->GetObject("SofSciSingleTcalData");
+        if (!fSciSingleTcalCA)
+        {
+            LOG(ERROR) << "R3BSofEventFilter::Init() SofSciSingleTcalData not found";
+            return kFATAL;
+        }
+    }
+    if (fUseTwim)
+    {
+        fTwimHitDataCA = (TClonesArray*)mgr->GetObject("TwimHitData");
+        if (!fTwimHitDataCA)
+        {
+            LOG(ERROR) << "R3BSofEventFilter::Init() TwimHitData not found";
+            return kFATAL;
+        }
+    }
+
+    // --- The guarded tasks are initialized after the filter: their outputs are the branches registered then --- //
+    fNumBranches = mgr->GetBranchNameList()->GetEntries();
+    fOutputs.clear();
+    return kSUCCESS;
+}
+
+void R3BSofEventFilter::FindOutputs()
+{
+    FairRootManager* mgr = FairRootManager::Instance();
+    TList* branches = mgr->GetBranchNameList();
+    for (Int_t b = fNumBranches; b < branches->GetEntries(); b++)
+    {
+        TObject* obj = mgr->GetObject(((TObjString*)branches->At(b))->GetString());
+        if (obj)
+            fOutputs.push_back(obj);
+    }
+    fNumBranches = -1;
+    LOG(INFO) << "R3BSofEventFilter: " << fGuarded.size() << " tasks, " << fOutputs.size()
+              << " outputs behind the filter";
+}
+
+Int_t R3BSofEventFilter::Check() const
+{
+    if (fEventHeader && (fEventHeader->GetTpat() & fTpatMask) == 0)
+        return kTpat;
+
+    if (fSciSingleTcalCA)
+    {
+        Int_t mult = 0;
+        Int_t nHits = fSciSingleTcalCA->GetEntriesFast();
+        for (Int_t i = 0; i < nHits; i++)
+        {
+            R3BSofSciSingleTcalData* hit = (R3BSofSciSingleTcalData*)fSciSingleTcalCA->UncheckedAt(i);
+            if (hit && hit->GetDetector() == fIdCaveC)
+                mult++;
+        }
+        if (mult < fCaveCMultMin || mult > fCaveCMultMax)
+            return kCaveC;
+    }
+
+    if (fTwimHitDataCA)
+    {
+        Bool_t found = kFALSE;
+        Int_t nHits = fTwimHitDataCA->GetEntriesFast();
+        for (Int_t i = 0; i < nHits && !found; i++)
+        {
+            R3BSofTwimHitData* hit = (R3BSofTwimHitData*)fTwimHitDataCA->UncheckedAt(i);
+            found = hit && hit->GetZcharge() >= fTwimZMin && hit->GetZcharge() <= fTwimZMax;
+        }
+        if (!found)
+            return kTwim;
+    }
+    return kNumCuts;
+}
+
+void R3BSofEventFilter::Restore()
+{
+    for (size_t t = 0; t < fDisabled.size(); t++)
+        fDisabled[t]->SetActive(kTRUE);
+    fDisabled.clear();
+}
+
+void R3BSofEventFilter::Exec(Option_t* option)
+{
+    Restore();
+    if (fNumBranches >= 0)
+        FindOutputs();
+
+    fNumEvents++;
+    Int_t cut = Check();
+    if (cut == kNumCuts)
+    {
+        fNumAccepted++;
+        return;
+    }
+    fNumRejected[cut]++;
+
+    // The run skips the inactive tasks, they are reactivated in FinishEvent
+    for (size_t t = 0; t < fGuarded.size(); t++)
+        if (fGuarded[t]->IsActive())
+        {
+            fGuarded[t]->SetActive(kFALSE);
+            fDisabled.push_back(fGuarded[t]);
+        }
+    // Nothing from the previous event in the outputs
+    for (size_t i = 0; i < fOutputs.size(); i++)
+        fOutputs[i]->Clear();
+    if (fSkipFill)
+        FairRun::Instance()->MarkFill(kFALSE);
+}
+
+void R3BSofEventFilter::FinishEvent()
+{
+    Restore();
+    if (fSkipFill)
+        FairRun::Instance()->MarkFill(kTRUE);
+}
+
+void R3BSofEventFilter::FinishTask()
+{
+    Restore();
+    const char* names[kNumCuts] = { "tpat", "SofSci Cave C multiplicity", "TWIM Z" };
+    LOG(INFO) << "R3BSofEventFilter: " << fNumAccepted << " of " << fNumEvents << " events accepted";
+    for (Int_t c = 0; c < kNumCuts; c++)
+        LOG(INFO) << "R3BSofEventFilter: rejected by " << names[c] << ": " << fNumRejected[c];
+}
+
+ClassImp(R3BSofEventFilter)
@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofEventFilter                      -----
+// -----     Skips the analysis of the events failing cheap cuts    -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofEventFilter_H
+#define R3BSofEventFilter_H
+
+#include "FairTask.h"
+
+#include <vector>
+
+class FairRun;
+class TClonesArray;
+class R3BEventHeader;
+
+/**
+ * Evaluates cheap conditions on the event and executes the tasks behind it
+ * only if they are all fulfilled:
+ *  - trigger pattern: tpat & mask != 0 (SetTpatMask, 0: no condition),
+ *  - number of SofSci Cave C hits in SofSciSingleTcalData in [min, max],
+ *  - at least one TWIM section with Z in [min, max] (TwimHitData).
+ * Usage, after the tasks giving SofSciSingleTcalData and TwimHitData:
+ *   R3BSofEventFilter* filter = new R3BSofEventFilter();
+ *   filter->SetCaveCMult(1, 1, 4); // SofSci Cave C is detector 4
+ *   filter->SetTwimZRange(10., 40.);
+ *   run->AddTask(filter);
+ *   ... AddTask of MWPC, ToF-Wall, FragmentAnalysis, online spectra ...
+ *   filter->Guard(run); // after the last AddTask, before Init
+ * Guard records the tasks added after the filter, they stay tasks of the run
+ * (FairRun::GetTask finds them, Init and FinishTask as usual). For a rejected
+ * event they are deactivated until the end of the event and every object
+ * they registered is cleared (arrays, fired paddles, pad images, ...). With
+ * SetSkipFill(kTRUE) the event is not written to the output tree.
+ **/
+class R3BSofEventFilter : public FairTask
+{
+  public:
+    /** Default constructor **/
+    R3BSofEventFilter();
+
+    /** Standard constructor **/
+    R3BSofEventFilter(const char* name, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofEventFilter();
+
+    /** Records the tasks added after the filter **/
+    void Guard(FairRun* run);
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Conditions, the guarded tasks are deactivated for a rejected event **/
+    virtual void Exec(Option_t* option);
+
+    /** Virtual method FinishEvent **/
+    virtual void FinishEvent();
+
+    /** Virtual method FinishTask **/
+    virtual void FinishTask();
+
+    /** Conditions **/
+    void SetTpatMask(Int_t mask) { fTpatMask = mask; }
+    void SetCaveCMult(Int_t min, Int_t max, Int_t idCaveC)
+    {
+        fCaveCMultMin = min;
+        fCaveCMultMax = max;
+        fIdCaveC = idCaveC;
+    }
+    void SetTwimZRange(Double_t min, Double_t max)
+    {
+        fUseTwim = kTRUE;
+        fTwimZMin = min;
+        fTwimZMax = max;
+    }
+    void SetSkipFill(Bool_t skip) { fSkipFill = skip; }
+
+    ULong64_t GetNumEvents() const { return fNumEvents; }
+    ULong64_t GetNumAccepted() const { return fNumAccepted; }
+
+  private:
+    enum ECut
+    {
+        kTpat,
+        kCaveC,
+        kTwim,
+        kNumCuts
+    };
+
+    Int_t fTpatMask;
+    Int_t fCaveCMultMin, fCaveCMultMax, fIdCaveC; // fCaveCMultMax < 0: no condition
+    Bool_t fUseTwim;
+    Double_t fTwimZMin, fTwimZMax;
+    Bool_t fSkipFill;
+
+    R3BEventHeader* fEventHeader;
+    TClonesArray* fSciSingleTcalCA; /**< Array with SofSci single tcal data. >*/
+    TClonesArray* fTwimHitDataCA;   /**< Array with Twim Hit data. >*/
+
+    std::vector<TTask*> fGuarded;    //!
+    std::vector<TTask*> fDisabled;   //! guarded tasks deactivated for the current event
+    std::vector<TObject*> fOutputs;  //! objects registered by the guarded tasks
+    Int_t fNumBranches;              // registered before the guarded tasks, -1 once fOutputs is filled
+
+    ULong64_t fNumEvents, fNumAccepted;
+    ULong64_t fNumRejected[kNumCuts];
+
+    Int_t Check() const; // kNumCuts if accepted, else the first failing cut
+    void Restore();      // reactivates the guarded tasks
+    void FindOutputs();
+
+  public:
+    ClassDef(R3BSofEventFilter, 1)
+};
+
+#endif
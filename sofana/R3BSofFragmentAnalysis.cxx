@@ -28,7 +28,17 @@ R3BSofFragmentAnalysis::R3BSofFragmentAnalysis()
     , fTwimHitDataCA(NULL)
     , fTrackingDataCA(NULL)
     , fOnline(kFALSE)
+    , fGladLookup(kFALSE)
+    , fGladPar(NULL)
+    , fGladFieldScale(0.)
+    , fPairing(kFALSE)
+    , fMaxDx12(50.)
+    , fMaxDy12(50.)
+    , fTofWOffsetX(0.)
+    , fTofWWindow(150.)
 {
+    for (Int_t sec = 0; sec < kMaxTwimSections; sec++)
+        fTwimSide[sec] = sec < kMaxTwimSections / 2 ? 0 : 1;
 }
 
 // R3BSofFragmentAnalysisPar: Standard Constructor --------------------------
@@ -50,7 +60,17 @@ R3BSofFragmentAnalysis::R3BSofFragmentAnalysis(const TString& name, Int_t iVerbo
     , fTwimHitDataCA(NULL)
     , fTrackingDataCA(NULL)
     , fOnline(kFALSE)
+    , fGladLookup(kFALSE)
+    , fGladPar(NULL)
+    , fGladFieldScale(0.)
+    , fPairing(kFALSE)
+    , fMaxDx12(50.)
+    , fMaxDy12(50.)
+    , fTofWOffsetX(0.)
+    , fTofWWindow(150.)
 {
+    for (Int_t sec = 0; sec < kMaxTwimSections; sec++)
+        fTwimSide[sec] = sec < kMaxTwimSections / 2 ? 0 : 1;
 }
 
 // Virtual R3BSofFragmentAnalysis: Destructor
@@ -115,29 +135,21 @@ void R3BSofFragmentAnalysis::SetParContainers()
     Int_t fNumAnodes = fTwimPar->GetNumAnodes();  // Number of anodes
     Int_t fNumParams = fTwimPar->GetNumParZFit(); // Number of TwimParameters
 
-    // Anodes that don't work set to zero
-    TArrayF* TwimCalZParams = new TArrayF();
-    Int_t array_size = fNumSec * fNumParams;
-    TwimCalZParams->Set(array_size);
-    TwimCalZParams = fTwimPar->GetZHitPar(); // Array with the Cal parameters
+    // Z polynomial of any order in sqrt(E) * beta, parameters of the first section,
+    // the array belongs to the container
+    fTwimZCal.SetPolynomial(fTwimPar->GetZHitPar(), fNumParams);
+    LOG(INFO) << "R3BSofFragmentAnalysis: TWIM charge-Z from " << fNumParams << " parameters of " << fNumSec
+              << " sections, " << fNumAnodes << " anodes";
 
-    // Parameters detector
-    for (Int_t s = 0; s < fNumSec; s++)
-        // Parameters detector
-        if (fNumParams == 2)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-        }
-        else if (fNumParams == 3)
+    // Brho and path length through GLAD from the lookup table
+    if (fGladLookup)
+    {
+        fGladPar = (R3BSofGladLookupPar*)rtdb->getContainer("sofGladLookupPar");
+        if (!fGladPar)
         {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-            fTwimZ2 = TwimCalZParams->GetAt(2);
+            LOG(ERROR) << "R3BSofFragmentAnalysis::SetParContainers() Couldn't get handle on sofGladLookupPar";
         }
-        else
-            LOG(INFO) << "R3BSofTwimCal2Hit parameters for charge-Z cannot be used here, number of parameters: "
-                      << fNumParams;
+    }
 }
 
 void R3BSofFragmentAnalysis::SetParameter()
@@ -211,6 +223,23 @@ InitStatus R3BSofFragmentAnalysis::Init()
     }
     ReInit();
     SetParameter();
+
+    // the table is only valid for the field it was built with
+    if (fGladPar)
+    {
+        if (fGladFieldScale == 0.)
+            LOG(WARNING) << "R3BSofFragmentAnalysis::Init() GLAD field of the run not given (SetGladFieldScale), "
+                         << "sofGladLookupPar built for the scale " << fGladPar->GetFieldScale() << " is used";
+        else if (TMath::Abs(fGladPar->GetFieldScale() - fGladFieldScale) > 1.e-3 * TMath::Abs(fGladFieldScale))
+        {
+            LOG(ERROR) << "R3BSofFragmentAnalysis::Init() sofGladLookupPar built for the GLAD field scale "
+                       << fGladPar->GetFieldScale() << ", the field of the run is " << fGladFieldScale;
+            return kFATAL;
+        }
+    }
+    if (fPairing)
+        LOG(INFO) << "R3BSofFragmentAnalysis: pairing of the fragments, windows dx12 " << fMaxDx12 << " dy12 "
+                  << fMaxDy12 << " ToF-Wall " << fTofWWindow << " mm (SetMaxFragments(2) of the ToF-Wall hits)";
     return kSUCCESS;
 }
 
@@ -224,68 +253,67 @@ InitStatus R3BSofFragmentAnalysis::ReInit()
 // -----   Public method Execution   --------------------------------------------
 void R3BSofFragmentAnalysis::Exec(Option_t* option)
 {
-    // Reset entries in output arrays, local arrays
+    if (fMwpc0HitDataCA->GetEntries() < 1 || fMwpc1HitDataCA->GetEntries() < 1 || fMwpc2HitDataCA->GetEntries() < 1 ||
+        fMwpc3HitDataCA->GetEntries() < 1 || fTofWHitDataCA->GetEntries() < 1 || fTwimHitDataCA->GetEntries() < 1)
+        return;
+    if (fPairing)
+        ExecPairing();
+    else
+        ExecSingle();
+}
+
+// -----   Private method ExecSingle: one fragment, last hit of every detector   ---
+void R3BSofFragmentAnalysis::ExecSingle()
+{
     Double_t fZ = 0., fE = 0., fAq = 0.;
     Double_t Beta = 0., Brho_Cave = 0., Length = 0.;
     Double_t ToF_Cave = 0.;
     Double_t mw[4][4] = { { -5000. } }; // mwpc[ID:0-4][x,y,a,b]
     Int_t Paddle = 0;
 
-    Int_t nHitMwpc0 = fMwpc0HitDataCA->GetEntries();
-    Int_t nHitMwpc1 = fMwpc1HitDataCA->GetEntries();
-    Int_t nHitMwpc2 = fMwpc2HitDataCA->GetEntries();
-    Int_t nHitMwpc3 = fMwpc3HitDataCA->GetEntries();
-    Int_t nHitTofW = fTofWHitDataCA->GetEntries();
-    Int_t nHitTwim = fTwimHitDataCA->GetEntries();
-    HitTofW = new R3BSofTofWHitData*[nHitTofW];
-    HitTwim = new R3BSofTwimHitData*[nHitTwim];
-    HitMwpc0 = new R3BSofMwpcHitData*[nHitMwpc0];
-    HitMwpc1 = new R3BSofMwpcHitData*[nHitMwpc1];
-    HitMwpc2 = new R3BSofMwpcHitData*[nHitMwpc2];
-    HitMwpc3 = new R3BSofMwpcHitData*[nHitMwpc3];
-
-    if (nHitMwpc0 < 1 || nHitMwpc1 < 1 || nHitMwpc2 < 1 || nHitMwpc3 < 1 || nHitTofW < 1 || nHitTwim < 1)
-        return;
-    // LOG(INFO) << "R3BSofFragmentAnalysis: nTwim: "<< nHitTwim << ", nTofW: " << nHitTofW << ", nMwpc: " << nHitMwpc ;
-
-    for (Int_t i = 0; i < nHitMwpc1; i++)
-    {
-        HitMwpc1[i] = (R3BSofMwpcHitData*)(fMwpc1HitDataCA->At(i));
-        mw[1][0] = HitMwpc1[i]->GetX();
-        mw[1][1] = HitMwpc1[i]->GetY();
-    }
-    for (Int_t i = 0; i < nHitMwpc2; i++)
-    {
-        HitMwpc2[i] = (R3BSofMwpcHitData*)(fMwpc2HitDataCA->At(i));
-        mw[2][0] = HitMwpc2[i]->GetX();
-        mw[2][1] = HitMwpc2[i]->GetY();
-    }
+    R3BSofMwpcHitData* hitMwpc = (R3BSofMwpcHitData*)(fMwpc1HitDataCA->At(fMwpc1HitDataCA->GetEntries() - 1));
+    mw[1][0] = hitMwpc->GetX();
+    mw[1][1] = hitMwpc->GetY();
+    hitMwpc = (R3BSofMwpcHitData*)(fMwpc2HitDataCA->At(fMwpc2HitDataCA->GetEntries() - 1));
+    mw[2][0] = hitMwpc->GetX();
+    mw[2][1] = hitMwpc->GetY();
     // Calculate raw angle /mm
     mw[1][2] = mw[2][0] - mw[1][0];
     mw[1][3] = mw[2][1] - mw[1][1];
     //
-    for (Int_t i = 0; i < nHitMwpc3; i++)
+    hitMwpc = (R3BSofMwpcHitData*)(fMwpc3HitDataCA->At(fMwpc3HitDataCA->GetEntries() - 1));
+    mw[3][0] = hitMwpc->GetX();
+    mw[3][1] = hitMwpc->GetY();
+    if (fGladPar)
     {
-        HitMwpc3[i] = (R3BSofMwpcHitData*)(fMwpc3HitDataCA->At(i));
-        mw[3][0] = HitMwpc3[i]->GetX();
-        mw[3][1] = HitMwpc3[i]->GetY();
+        if (!fGladPar->Interpolate(mw[2][0], mw[1][2], mw[3][0], Brho_Cave, Length))
+            return;
+    }
+    else
+    {
+        Double_t Dispersion_MW3 = (mw[3][0] - 107.612277 - mw[1][2] * (7.969415)) +
+                                  (-10.967255 - mw[1][0] * (2.033001)) + (-3.300145 - mw[1][3] * (0.076592)) +
+                                  (-1.705562 - mw[1][1] * (0.096213));
+        Brho_Cave = (Dispersion_MW3 + 2152.65) / 247.966 + 0.3;
     }
-    Double_t Dispersion_MW3 = (mw[3][0] - 107.612277 - mw[1][2] * (7.969415)) + (-10.967255 - mw[1][0] * (2.033001)) +
-                              (-3.300145 - mw[1][3] * (0.076592)) + (-1.705562 - mw[1][1] * (0.096213));
-    Brho_Cave = (Dispersion_MW3 + 2152.65) / 247.966 + 0.3;
 
     ////
     // Time from TofW
-    for (Int_t i = 0; i < nHitTofW; i++)
+    Int_t nHits = fTofWHitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
     {
-        HitTofW[i] = (R3BSofTofWHitData*)(fTofWHitDataCA->At(i));
-        Paddle = HitTofW[i]->GetPaddle();
+        R3BSofTofWHitData* hitTofW = (R3BSofTofWHitData*)(fTofWHitDataCA->At(i));
+        Paddle = hitTofW->GetPaddle();
         if (fFragPar->GetInUse(Paddle) != 1)
             continue;
-        ToF_Cave = HitTofW[i]->GetTof() - fFragPar->GetTofWOffset(Paddle);
+        ToF_Cave = hitTofW->GetTof() - fFragPar->GetTofWOffset(Paddle);
+        if (fGladPar)
+        {
+            Beta = Length / (ToF_Cave * c * 10.); // Length in mm, ToF in ns
+            continue;
+        }
         Beta = fFragPar->GetEffectivLength(Paddle) / ToF_Cave;
         Length = fFragPar->GetEffectivLength(Paddle) * 2.998e2; // in mm. 0th order approx. To be modified later.
-        // std::cout <<" init: "<< HitTofW[i]->GetPaddle() << " "<< ToF_Cave << std::endl;
     }
 
     if (ToF_Cave <= 0.)
@@ -296,25 +324,171 @@ void R3BSofFragmentAnalysis::Exec(Option_t* option)
 
     // Z from twim-music ------------------------------------
     Double_t countz = 0;
-    for (Int_t i = 0; i < nHitTwim; i++)
+    nHits = fTwimHitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
     {
-        HitTwim[i] = (R3BSofTwimHitData*)(fTwimHitDataCA->At(i));
-        if (HitTwim[i]->GetZcharge() > 1)
+        R3BSofTwimHitData* hitTwim = (R3BSofTwimHitData*)(fTwimHitDataCA->At(i));
+        if (hitTwim->GetZcharge() > 1)
         {
-            // fZ = fZ + HitTwim[i]->GetZcharge();
-            fE = fE + HitTwim[i]->GetEave();
+            fE = fE + hitTwim->GetEave();
             countz++;
         }
     }
     if (countz > 0)
     {
         fE = fE / countz;
-        fZ = fTwimZ0 + fTwimZ1 * TMath::Sqrt(fE) * Beta + fTwimZ2 * fE * Beta * Beta;
+        fZ = fTwimZCal.Eval(fE, Beta);
     }
 
     // Fill the data
-    if (true) // if (fZ > 1 && fAq > 1. && Brho_Cave > 0. && Beta > 0.)
+    AddData(fZ + fOffsetZ, fAq + fOffsetAq, Beta, Length, Brho_Cave, Paddle);
+}
+
+// -----   Private method ExecPairing: one fragment on each side of the beam   ---
+void R3BSofFragmentAnalysis::ExecPairing()
+{
+    // Hits sorted by side of the beam
+    R3BSofMwpcHitData* hitMwpc1[kNumSides][kMaxHitsPerSide];
+    R3BSofMwpcHitData* hitMwpc2[kNumSides][kMaxHitsPerSide];
+    R3BSofMwpcHitData* hitMwpc3[kNumSides][kMaxHitsPerSide];
+    R3BSofTofWHitData* hitTofW[kNumSides][kMaxHitsPerSide];
+    Int_t nMwpc1[kNumSides] = { 0 }, nMwpc2[kNumSides] = { 0 }, nMwpc3[kNumSides] = { 0 }, nTofW[kNumSides] = { 0 };
+    Double_t twimE[kNumSides] = { 0. };
+    Int_t twimCount[kNumSides] = { 0 };
+
+    Int_t nHits = fMwpc1HitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofMwpcHitData* hit = (R3BSofMwpcHitData*)(fMwpc1HitDataCA->At(i));
+        Int_t side = GetSide(hit->GetX());
+        if (nMwpc1[side] < kMaxHitsPerSide)
+            hitMwpc1[side][nMwpc1[side]++] = hit;
+    }
+    nHits = fMwpc2HitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofMwpcHitData* hit = (R3BSofMwpcHitData*)(fMwpc2HitDataCA->At(i));
+        Int_t side = GetSide(hit->GetX());
+        if (nMwpc2[side] < kMaxHitsPerSide)
+            hitMwpc2[side][nMwpc2[side]++] = hit;
+    }
+    nHits = fMwpc3HitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofMwpcHitData* hit = (R3BSofMwpcHitData*)(fMwpc3HitDataCA->At(i));
+        Int_t side = GetSide(hit->GetX());
+        if (nMwpc3[side] < kMaxHitsPerSide)
+            hitMwpc3[side][nMwpc3[side]++] = hit;
+    }
+    nHits = fTofWHitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofTofWHitData* hit = (R3BSofTofWHitData*)(fTofWHitDataCA->At(i));
+        if (fFragPar->GetInUse(hit->GetPaddle()) != 1)
+            continue;
+        Int_t side = GetSide(hit->GetX());
+        if (nTofW[side] < kMaxHitsPerSide)
+            hitTofW[side][nTofW[side]++] = hit;
+    }
+    nHits = fTwimHitDataCA->GetEntries();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofTwimHitData* hit = (R3BSofTwimHitData*)(fTwimHitDataCA->At(i));
+        if (hit->GetZcharge() <= 1)
+            continue;
+        Int_t sec = hit->GetSecID();
+        if (sec < 0 || sec >= kMaxTwimSections)
+            continue;
+        Int_t side = fTwimSide[sec];
+        if (side < 0 || side >= kNumSides)
+            continue;
+        twimE[side] += hit->GetEave();
+        twimCount[side]++;
+    }
+
+    for (Int_t side = 0; side < kNumSides; side++)
+    {
+        // MWPC1-MWPC2: pair closest to the beam direction inside the windows
+        Double_t mw[4][4] = { { -5000. } }; // mwpc[ID:0-4][x,y,a,b]
+        Double_t best = -1.;
+        for (Int_t i = 0; i < nMwpc1[side]; i++)
+            for (Int_t j = 0; j < nMwpc2[side]; j++)
+            {
+                Double_t dx = hitMwpc2[side][j]->GetX() - hitMwpc1[side][i]->GetX();
+                Double_t dy = hitMwpc2[side][j]->GetY() - hitMwpc1[side][i]->GetY();
+                if (TMath::Abs(dx) > fMaxDx12 || TMath::Abs(dy) > fMaxDy12)
+                    continue;
+                if (best >= 0. && TMath::Abs(dx) + TMath::Abs(dy) >= best)
+                    continue;
+                best = TMath::Abs(dx) + TMath::Abs(dy);
+                mw[1][0] = hitMwpc1[side][i]->GetX();
+                mw[1][1] = hitMwpc1[side][i]->GetY();
+                mw[2][0] = hitMwpc2[side][j]->GetX();
+                mw[2][1] = hitMwpc2[side][j]->GetY();
+            }
+        if (best < 0.)
+            continue;
+        // Calculate raw angle /mm
+        mw[1][2] = mw[2][0] - mw[1][0];
+        mw[1][3] = mw[2][1] - mw[1][1];
+
+        // MWPC3-ToF-Wall: paddle closest to the position at MWPC3
+        R3BSofTofWHitData* tofw = NULL;
+        best = -1.;
+        for (Int_t k = 0; k < nMwpc3[side]; k++)
+            for (Int_t p = 0; p < nTofW[side]; p++)
+            {
+                Double_t dx = TMath::Abs(hitTofW[side][p]->GetX() - hitMwpc3[side][k]->GetX() - fTofWOffsetX);
+                if (dx > fTofWWindow || (best >= 0. && dx >= best))
+                    continue;
+                best = dx;
+                mw[3][0] = hitMwpc3[side][k]->GetX();
+                mw[3][1] = hitMwpc3[side][k]->GetY();
+                tofw = hitTofW[side][p];
+            }
+        if (!tofw)
+            continue;
+
+        Double_t Brho_Cave = 0., Length = 0.;
+        if (fGladPar)
+        {
+            if (!fGladPar->Interpolate(mw[2][0], mw[1][2], mw[3][0], Brho_Cave, Length))
+                continue;
+        }
+        else
+        {
+            Double_t Dispersion_MW3 = (mw[3][0] - 107.612277 - mw[1][2] * (7.969415)) +
+                                      (-10.967255 - mw[1][0] * (2.033001)) + (-3.300145 - mw[1][3] * (0.076592)) +
+                                      (-1.705562 - mw[1][1] * (0.096213));
+            Brho_Cave = (Dispersion_MW3 + 2152.65) / 247.966 + 0.3;
+        }
+
+        // Time from TofW
+        Int_t Paddle = tofw->GetPaddle();
+        Double_t ToF_Cave = tofw->GetTof() - fFragPar->GetTofWOffset(Paddle);
+        if (ToF_Cave <= 0.)
+            continue;
+        Double_t Beta = 0.;
+        if (fGladPar)
+            Beta = Length / (ToF_Cave * c * 10.); // Length in mm, ToF in ns
+        else
+        {
+            Beta = fFragPar->GetEffectivLength(Paddle) / ToF_Cave;
+            Length = fFragPar->GetEffectivLength(Paddle) * 2.998e2; // in mm. 0th order approx. To be modified later.
+        }
+
+        double gamma = 1. / sqrt(1. - Beta * Beta);
+        Double_t fAq = Brho_Cave / (3.10716 * Beta * gamma);
+
+        // Z from twim-music, sections of this side ----------------
+        if (twimCount[side] < 1)
+            continue;
+        Double_t fE = twimE[side] / twimCount[side];
+        Double_t fZ = fTwimZCal.Eval(fE, Beta);
+
+        // Fill the data
         AddData(fZ + fOffsetZ, fAq + fOffsetAq, Beta, Length, Brho_Cave, Paddle);
+    }
     return;
 }
 
@@ -326,19 +500,6 @@ void R3BSofFragmentAnalysis::Reset()
 {
     LOG(DEBUG) << "Clearing SofTrackingData Structure";
 
-    if (HitTofW)
-        delete HitTofW;
-    if (HitMwpc0)
-        delete HitMwpc0;
-    if (HitMwpc1)
-        delete HitMwpc1;
-    if (HitMwpc2)
-        delete HitMwpc2;
-    if (HitMwpc3)
-        delete HitMwpc3;
-    if (HitTwim)
-        delete HitTwim;
-
     if (fTrackingDataCA)
         fTrackingDataCA->Clear();
 }
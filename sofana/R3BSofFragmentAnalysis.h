@@ -33,6 +33,8 @@
 #include "R3BSofTwimHitData.h"
 #include "R3BSofTwimHitPar.h"
 #include "R3BSofFragmentAnaPar.h"
+#include "R3BSofGladLookupPar.h"
+#include "R3BSofZCalibration.h"
 
 class TClonesArray;
 
@@ -82,17 +84,57 @@ class R3BSofFragmentAnalysis : public FairTask
     void SetOffsetZ(Double_t theZ) { fOffsetZ = theZ; }
     void SetTofWPos(Double_t pos) { fTofWPos = pos; }
 
+    /** Brho and path length from R3BSofGladLookupPar instead of the dispersion at MWPC3 **/
+    void SetGladLookup(Bool_t option) { fGladLookup = option; }
+    /** Scale of the GLAD field of the run (current of GLAD over the current of the map),
+     *  Init fails if the table was built for another one **/
+    void SetGladFieldScale(Double_t scale) { fGladFieldScale = scale; }
+
+    /** Pairing of the two fission fragments, one on each side of the beam (x > 0: left, x < 0: right).
+     *  The s444/s467 ToF-Wall profiles keep one paddle per event unless
+     *  R3BSofTofWSingleTCal2Hit::SetMaxFragments(2). Without pairing, the last hit of
+     *  every detector gives one fragment and the windows below are not applied. **/
+    void SetPairing(Bool_t option) { fPairing = option; }
+    void SetTwimSectionSide(Int_t sec, Int_t side)
+    {
+        if (sec >= 0 && sec < kMaxTwimSections)
+            fTwimSide[sec] = side;
+    }
+
+    /** Windows of the association of hits with pairing [mm] **/
+    void SetMaxDx12(Double_t dx) { fMaxDx12 = dx; }
+    void SetMaxDy12(Double_t dy) { fMaxDy12 = dy; }
+    void SetTofWWindow(Double_t offset, Double_t window)
+    {
+        fTofWOffsetX = offset;
+        fTofWWindow = window;
+    }
+
   private:
+    static const Int_t kNumSides = 2;
+    static const Int_t kMaxHitsPerSide = 8; // more hits on one side are ignored
+    static const Int_t kMaxTwimSections = 4;
+
     void SetParameter();
+    void ExecSingle();
+    void ExecPairing();
+    Int_t GetSide(Double_t x) const { return (fPairing && x < 0.) ? 1 : 0; }
 
     // Parameters set with accessor functions
     Double_t frho_Cave, fBfield_Glad, fTimeOffset, fTofWPos;
     Bool_t fOnline; // Don't store data for online    
     R3BSofFragmentAnaPar* fFragPar;
     R3BSofTwimHitPar* fTwimPar;
+    Bool_t fGladLookup;
+    R3BSofGladLookupPar* fGladPar;
+    Double_t fGladFieldScale; // 0 if not given, the scale of the table is then not checked
+    Bool_t fPairing;
+    Int_t fTwimSide[kMaxTwimSections];
+    Double_t fMaxDx12, fMaxDy12;        // MWPC2 - MWPC1
+    Double_t fTofWOffsetX, fTofWWindow; // ToF-Wall - MWPC3
     
     // Parameters from par file
-    Float_t fTwimZ0 = 0., fTwimZ1 = 0., fTwimZ2 = 0.; // CalibPar for Twim
+    R3BSofZCalibration fTwimZCal; //! CalibPar for Twim
     Double_t fOffsetAq, fOffsetZ; // Offsets in A/q and Z
     // Double_t fDist_mw3_tof;
     // Double_t fDist_start_glad;
@@ -106,13 +148,6 @@ class R3BSofFragmentAnalysis : public FairTask
     TClonesArray* fTofWHitDataCA;  /**< Array with ToF Hit-input data. >*/
     TClonesArray* fTrackingDataCA; /**< Array with Tracking-output data. >*/
 
-    R3BSofTofWHitData** HitTofW;
-    R3BSofTwimHitData** HitTwim;
-    R3BSofMwpcHitData** HitMwpc0;
-    R3BSofMwpcHitData** HitMwpc1;
-    R3BSofMwpcHitData** HitMwpc2;
-    R3BSofMwpcHitData** HitMwpc3;
-
     /** Private method TrackingData **/
     //** Adds a TrackingData to the analysis
     R3BSofTrackingData* AddData(Double_t z, Double_t aq, Double_t beta, Double_t length, Double_t brho, Int_t paddle);
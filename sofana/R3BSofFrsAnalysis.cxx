@@ -104,25 +104,10 @@ void R3BSofFrsAnalysis::SetParContainers()
     //--- Parameter Container ---
     fNumMusicParams = fCal_Par->GetNumParZFit(); // Number of Parameters
     LOG(INFO) << "R3BSofFrsAnalysisPar:: R3BMusicCal2Hit: Nb parameters for charge-Z: " << (Int_t)fNumMusicParams;
-    CalZParams = new TArrayF();
-    CalZParams->Set(fNumMusicParams);
-    CalZParams = fCal_Par->GetZHitPar(); // Array with the Cal parameters
-    // Parameters detector
-    if (fNumMusicParams == 2)
-    {
-        fZ0 = CalZParams->GetAt(0);
-        fZ1 = CalZParams->GetAt(1);
-    }
-    else if (fNumMusicParams == 3)
-    {
-        fZ0 = CalZParams->GetAt(0);
-        fZ1 = CalZParams->GetAt(1);
-        fZ2 = CalZParams->GetAt(2);
-    }
-    else
-        LOG(INFO) << "R3BSofFrsAnalysisPar:: R3BMusicCal2Hit parameters for charge-Z cannot be used here, number of "
-                     "parameters: "
-                  << fNumMusicParams;
+    // Z polynomial of any order in sqrt(E) * beta, the array belongs to the container
+    R3BSofZCalibration zCal;
+    zCal.SetPolynomial(fCal_Par->GetZHitPar(), fNumMusicParams);
+    fIdKernel.SetZCalibration(zCal);
 }
 
 void R3BSofFrsAnalysis::SetParameter()
@@ -132,17 +117,19 @@ void R3BSofFrsAnalysis::SetParameter()
     fNbTof = fFrs_Par->GetNumTof();
     fStaId = new UChar_t[fNbTof];
     fStoId = new UChar_t[fNbTof];
-    fPathLength = new Double_t[fNbTof];
-    fTofOffset = new Double_t[fNbTof];
-    fUseS2x = new Int_t[fNbTof];
+    fIdKernel.SetNumPaths(fNbTof);
     for (Int_t i = 0; i < fNbTof; i++)
     {
         fStaId[i] = fFrs_Par->GetStaSciId(i);
         fStoId[i] = fFrs_Par->GetStoSciId(i);
-        fPathLength[i] = fFrs_Par->GetPathLength(i);
-        fTofOffset[i] = fFrs_Par->GetTofOffset(i);
-        fUseS2x[i] = fFrs_Par->GetUseS2x(i);
+        fIdKernel.SetPath(i, fFrs_Par->GetPathLength(i), fFrs_Par->GetTofOffset(i), fFrs_Par->GetUseS2x(i) != 0);
     }
+    fIdKernel.SetBrho0(fBrho0);
+    fTof.assign(fNbTof, -5000.);
+    fBeta.assign(fNbTof, 0.);
+    fBrho.assign(fNbTof, 0.);
+    fAoq.assign(fNbTof, 0.);
+    fZ.assign(fNbTof, 0.);
     fS2SciCoef0 = fFrs_Par->GetS2PosOffset();
     fS2SciCoef1 = fFrs_Par->GetS2PosCoef();
 }
@@ -277,17 +264,17 @@ void R3BSofFrsAnalysis::Exec(Option_t* option)
             tof = Tof_wTref_S2_S8;
         if (fStaId[i] == fIdS8 && fStoId[i] == fIdCave)
             tof = Tof_wTref_S8_Cave;
-        if (tof < 0)
+        fTof[i] = tof;
+    }
+    Double_t xs2 = xpos[fIdS2 - 1];
+    fIdKernel.Identify(1, fTof.data(), &xs2, &MusicE, fBeta.data(), fBrho.data(), fAoq.data(), fZ.data());
+    for (Int_t i = 0; i < fNbTof; i++)
+    {
+        if (fTof[i] < 0)
             continue;
-        Double_t beta = fPathLength[i] / (tof + fTofOffset[i]); // ToFCalib
-        Double_t gamma = 1. / (TMath::Sqrt(1. - beta * beta));
-        Double_t brho = fBrho0 * (1 + (fUseS2x[i] != 0 ? xpos[fIdS2 - 1] : 0.) / 726.);
-        Double_t aoq = brho / (3.10716 * gamma * beta);
-        if (beta > 0.)
-        {
-            MusicZ = fZ0 + fZ1 * TMath::Sqrt(MusicE) * beta + fZ2 * MusicE * beta * beta;
-        }
-        AddData(fStaId[i], fStoId[i], MusicZ, aoq, beta, brho, xpos[fIdS2 - 1], xpos[fIdCave - 1]);
+        if (fBeta[i] > 0.)
+            MusicZ = fZ[i];
+        AddData(fStaId[i], fStoId[i], MusicZ, fAoq[i], fBeta[i], fBrho[i], xpos[fIdS2 - 1], xpos[fIdCave - 1]);
     }
     return;
 }
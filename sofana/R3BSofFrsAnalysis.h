@@ -26,8 +26,11 @@
 // SOFIA headers
 #include "R3BSofFrsAnaPar.h"
 #include "R3BSofFrsData.h"
+#include "R3BSofFrsIdKernel.h"
 #include "R3BSofSciSingleTcalData.h"
 
+#include <vector>
+
 class TClonesArray;
 
 class R3BSofFrsAnalysis : public FairTask
@@ -79,6 +82,9 @@ class R3BSofFrsAnalysis : public FairTask
     UChar_t GetIdS2() {return fIdS2;}
     UChar_t GetIdS8() {return fIdS8;}
 
+    /** Identification with the parameters of the run, e.g. for blocks of events offline **/
+    const R3BSofFrsIdKernel& GetIdKernel() const { return fIdKernel; }
+
   private:
     TClonesArray* fSingleTcalItemsSci; /**< Array with tcal items. */
     //TClonesArray* fMwpcHitDataCA;  /**< Array with Mwpc Hit-input data. >*/
@@ -101,15 +107,14 @@ class R3BSofFrsAnalysis : public FairTask
     Double_t fBrho0;  //Brho setting in FRS S2-S8
     UChar_t* fStaId;
     UChar_t* fStoId;
-    Double_t* fPathLength;
-    Double_t* fTofOffset;
-    Int_t* fUseS2x;
     Double_t fS2SciCoef0, fS2SciCoef1;
+    R3BSofFrsIdKernel fIdKernel; // path lengths, ToF offsets, Brho0 and Z calibration
+
+    // One entry per ToF path, for the kernel
+    std::vector<Double_t> fTof, fBeta, fBrho, fAoq, fZ; //!
 
     // Parameter containers for R3BMusicPar
     UChar_t fNumMusicParams;
-    TArrayF* CalZParams;
-    Float_t fZ0 = 0., fZ1 = 0. , fZ2 = 0.; // CalibPar for R3BMUSIC
     Double_t MusicZ = -5000., MusicE = -5000.;
     
     Double_t* xpos;
@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofFrsIdKernel                      -----
+// -----        Batched beta, Brho, A/q and Z for the FRS ToFs      -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofFrsIdKernel.h"
+
+#include <cmath>
+
+R3BSofFrsIdKernel::R3BSofFrsIdKernel()
+    : TObject()
+    , fNumPaths(0)
+    , fBrho0(0.)
+    , fS2Dispersion(726.)
+{
+}
+
+R3BSofFrsIdKernel::~R3BSofFrsIdKernel() {}
+
+void R3BSofFrsIdKernel::SetNumPaths(Int_t n)
+{
+    fNumPaths = n;
+    fLength.assign(n, 0.);
+    fTofOffset.assign(n, 0.);
+    fUseS2x.assign(n, 0.);
+}
+
+void R3BSofFrsIdKernel::SetPath(Int_t p, Double_t length, Double_t tofOffset, Bool_t useS2x)
+{
+    if (p < 0 || p >= fNumPaths)
+        return;
+    fLength[p] = length;
+    fTofOffset[p] = tofOffset;
+    fUseS2x[p] = useS2x ? 1. : 0.;
+}
+
+// One path: constant parameters, contiguous data, outputs not overlapping the inputs
+static void IdentifyPath(Int_t n,
+                         Double_t length,
+                         Double_t offset,
+                         Double_t brho0,
+                         Double_t slope,
+                         const Double_t* tof,
+                         const Double_t* xs2,
+                         Double_t* __restrict beta,
+                         Double_t* __restrict brho,
+                         Double_t* __restrict aoq)
+{
+    const Double_t invAoq = 1. / 3.10716;
+    for (Int_t e = 0; e < n; e++)
+    {
+        const Double_t be = length / (tof[e] + offset);
+        const Double_t br = brho0 + slope * xs2[e];
+        beta[e] = be;
+        brho[e] = br;
+        aoq[e] = br * std::sqrt(1. - be * be) / be * invAoq;
+    }
+}
+
+void R3BSofFrsIdKernel::Identify(Int_t n,
+                                 const Double_t* tof,
+                                 const Double_t* xs2,
+                                 const Double_t* musicE,
+                                 Double_t* beta,
+                                 Double_t* brho,
+                                 Double_t* aoq,
+                                 Double_t* z) const
+{
+    for (Int_t p = 0; p < fNumPaths; p++)
+    {
+        const Int_t first = p * n;
+        IdentifyPath(n,
+                     fLength[p],
+                     fTofOffset[p],
+                     fBrho0,
+                     fUseS2x[p] * fBrho0 / fS2Dispersion,
+                     tof + first,
+                     xs2,
+                     beta + first,
+                     brho + first,
+                     aoq + first);
+        fZCal.Eval(n, musicE, beta + first, z + first);
+    }
+}
+
+ClassImp(R3BSofFrsIdKernel)
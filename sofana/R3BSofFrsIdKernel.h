@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofFrsIdKernel                      -----
+// -----        Batched beta, Brho, A/q and Z for the FRS ToFs      -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofFrsIdKernel_H
+#define R3BSofFrsIdKernel_H
+
+#include "TObject.h"
+
+#include "R3BSofZCalibration.h"
+
+#include <vector>
+
+/**
+ * Identification in the FRS for all the ToF paths (S2-Cave, S2-S8, S8-Cave)
+ * of a block of events. The parameters of the paths are packed in arrays at
+ * the initialisation (R3BSofFrsAnalysis::SetParameter) and the data of the
+ * block are laid out path by path, so that the inner loop runs over
+ * contiguous events with constant parameters and is vectorised by the
+ * compiler:
+ *   tof[p * n + e], with p the path and e the event of the block,
+ *   xs2[e] position at S2 [mm], musicE[e] energy in R3B-Music.
+ * A/q uses gamma*beta = beta/sqrt(1-beta^2), one square root per entry,
+ * and Z comes from the calibration of R3B-Music (R3BSofZCalibration).
+ * Entries with a ToF < 0 (missing) give meaningless values, they are
+ * selected by the caller. The output arrays must not overlap the inputs.
+ **/
+class R3BSofFrsIdKernel : public TObject
+{
+  public:
+    /** Default constructor **/
+    R3BSofFrsIdKernel();
+
+    /** Destructor **/
+    virtual ~R3BSofFrsIdKernel();
+
+    /** Parameters of the paths **/
+    void SetNumPaths(Int_t n);
+    void SetPath(Int_t p, Double_t length, Double_t tofOffset, Bool_t useS2x);
+    void SetBrho0(Double_t brho) { fBrho0 = brho; }
+    void SetS2Dispersion(Double_t dispersion) { fS2Dispersion = dispersion; } // [mm]
+    void SetZCalibration(const R3BSofZCalibration& cal) { fZCal = cal; }
+
+    Int_t GetNumPaths() const { return fNumPaths; }
+    Double_t GetBrho0() const { return fBrho0; }
+    const R3BSofZCalibration& GetZCalibration() const { return fZCal; }
+
+    /** Identification of n events for all the paths, outputs laid out as tof **/
+    void Identify(Int_t n,
+                  const Double_t* tof,
+                  const Double_t* xs2,
+                  const Double_t* musicE,
+                  Double_t* beta,
+                  Double_t* brho,
+                  Double_t* aoq,
+                  Double_t* z) const;
+
+  private:
+    Int_t fNumPaths;
+    Double_t fBrho0;        // Brho setting in FRS S2-S8 [Tm]
+    Double_t fS2Dispersion; // Brho = Brho0 * (1 + x_S2 / dispersion)
+    R3BSofZCalibration fZCal; //! Z of R3B-Music
+
+    std::vector<Double_t> fLength;    //! path lengths / c [ns]
+    std::vector<Double_t> fTofOffset; //! [ns]
+    std::vector<Double_t> fUseS2x;    //! 1 if the position at S2 corrects Brho, else 0
+
+  public:
+    ClassDef(R3BSofFrsIdKernel, 1)
+};
+
+#endif
@@ -0,0 +1,232 @@
+// ------------------------------------------------------------------
+// -----         R3BSofGladLookupBuilder source file            -----
+// -----   Fills R3BSofGladLookupPar by tracking through GLAD   -----
+// ------------------------------------------------------------------
+
+#include "R3BSofGladLookupBuilder.h"
+#include "R3BSofGladLookupPar.h"
+
+#include "FairField.h"
+#include "FairLogger.h"
+
+#include "TMath.h"
+
+#include <vector>
+
+R3BSofGladLookupBuilder::R3BSofGladLookupBuilder()
+    : TObject()
+    , fField(NULL)
+    , fFieldScale(1.)
+    , fStartZ(0.)
+    , fMwpc1Z(160.)
+    , fMwpc2Z(950.)
+    , fNumBrho(200)
+    , fBrhoMin(6.)
+    , fBrhoMax(14.)
+    , fStep(10.)
+    , fMaxLength(20000.)
+{
+    SetMwpc3(-2430., 0., 6890., -29.);
+    SetTofW(-2570., 0., 7100., -29.);
+    SetGrid(0, 41, -100., 100.);
+    SetGrid(1, 21, -20., 20.);
+    SetGrid(2, 121, -600., 600.);
+}
+
+R3BSofGladLookupBuilder::R3BSofGladLookupBuilder(FairField* field)
+    : TObject()
+    , fField(field)
+    , fFieldScale(1.)
+    , fStartZ(0.)
+    , fMwpc1Z(160.)
+    , fMwpc2Z(950.)
+    , fNumBrho(200)
+    , fBrhoMin(6.)
+    , fBrhoMax(14.)
+    , fStep(10.)
+    , fMaxLength(20000.)
+{
+    SetMwpc3(-2430., 0., 6890., -29.);
+    SetTofW(-2570., 0., 7100., -29.);
+    SetGrid(0, 41, -100., 100.);
+    SetGrid(1, 21, -20., 20.);
+    SetGrid(2, 121, -600., 600.);
+}
+
+R3BSofGladLookupBuilder::~R3BSofGladLookupBuilder() {}
+
+void R3BSofGladLookupBuilder::SetPlane(Plane& plane, Double_t x, Double_t y, Double_t z, Double_t angle)
+{
+    // Rotation around y as TGeoRotation::RotateY(angle)
+    Double_t a = angle * TMath::DegToRad();
+    plane.c[0] = x;
+    plane.c[1] = y;
+    plane.c[2] = z;
+    plane.u[0] = TMath::Cos(a);
+    plane.u[1] = 0.;
+    plane.u[2] = -TMath::Sin(a);
+    plane.n[0] = TMath::Sin(a);
+    plane.n[1] = 0.;
+    plane.n[2] = TMath::Cos(a);
+}
+
+// ---- Equation of motion: d(x,t)/ds = (t, k t x B) with s in mm --------------
+void R3BSofGladLookupBuilder::Derivative(const Double_t* state, Double_t k, Double_t* derivative) const
+{
+    Double_t point[3] = { 0.1 * state[0], 0.1 * state[1], 0.1 * state[2] }; // cm
+    Double_t b[3] = { 0., 0., 0. };                                            // kG
+    fField->Field(point, b);
+    for (Int_t i = 0; i < 3; i++)
+        b[i] *= 0.1; // T
+    const Double_t* t = state + 3;
+    derivative[0] = t[0];
+    derivative[1] = t[1];
+    derivative[2] = t[2];
+    derivative[3] = k * (t[1] * b[2] - t[2] * b[1]);
+    derivative[4] = k * (t[2] * b[0] - t[0] * b[2]);
+    derivative[5] = k * (t[0] * b[1] - t[1] * b[0]);
+}
+
+// ---- Track ------------------------------------------------------------------
+Bool_t R3BSofGladLookupBuilder::Track(Double_t x2,
+                                     Double_t dx12,
+                                     Double_t brho,
+                                     Double_t& x3,
+                                     Double_t& length) const
+{
+    if (!fField || brho <= 0.)
+        return kFALSE;
+
+    Double_t dz = fMwpc2Z - fMwpc1Z;
+    Double_t norm = TMath::Sqrt(dx12 * dx12 + dz * dz);
+    Double_t state[6] = { x2, 0., fMwpc2Z, dx12 / norm, 0., dz / norm };
+    const Double_t k = 1. / (brho * 1000.); // [1/(T mm)]
+
+    Bool_t found3 = kFALSE;
+    Double_t d3 = 0., dW = 0.;
+    for (Int_t i = 0; i < 3; i++)
+    {
+        d3 += (state[i] - fMwpc3.c[i]) * fMwpc3.n[i];
+        dW += (state[i] - fTofW.c[i]) * fTofW.n[i];
+    }
+
+    Double_t k1[6], k2[6], k3[6], k4[6], tmp[6], next[6];
+    Double_t h = fStep;
+    for (Double_t s = 0.; s < fMaxLength; s += h)
+    {
+        // Runge-Kutta 4
+        Derivative(state, k, k1);
+        for (Int_t i = 0; i < 6; i++)
+            tmp[i] = state[i] + 0.5 * h * k1[i];
+        Derivative(tmp, k, k2);
+        for (Int_t i = 0; i < 6; i++)
+            tmp[i] = state[i] + 0.5 * h * k2[i];
+        Derivative(tmp, k, k3);
+        for (Int_t i = 0; i < 6; i++)
+            tmp[i] = state[i] + h * k3[i];
+        Derivative(tmp, k, k4);
+        for (Int_t i = 0; i < 6; i++)
+            next[i] = state[i] + h / 6. * (k1[i] + 2. * k2[i] + 2. * k3[i] + k4[i]);
+        Double_t tnorm = TMath::Sqrt(next[3] * next[3] + next[4] * next[4] + next[5] * next[5]);
+        for (Int_t i = 3; i < 6; i++)
+            next[i] /= tnorm;
+
+        Double_t nd3 = 0., ndW = 0.;
+        for (Int_t i = 0; i < 3; i++)
+        {
+            nd3 += (next[i] - fMwpc3.c[i]) * fMwpc3.n[i];
+            ndW += (next[i] - fTofW.c[i]) * fTofW.n[i];
+        }
+
+        // Crossings, linear between the two points of the step
+        if (!found3 && d3 < 0. && nd3 >= 0.)
+        {
+            Double_t f = d3 / (d3 - nd3);
+            x3 = 0.;
+            for (Int_t i = 0; i < 3; i++)
+                x3 += (state[i] + f * (next[i] - state[i]) - fMwpc3.c[i]) * fMwpc3.u[i];
+            found3 = kTRUE;
+        }
+        if (dW < 0. && ndW >= 0.)
+        {
+            length = s + h * dW / (dW - ndW);
+            return found3;
+        }
+
+        for (Int_t i = 0; i < 6; i++)
+            state[i] = next[i];
+        d3 = nd3;
+        dW = ndW;
+    }
+    return kFALSE;
+}
+
+// ---- Build ------------------------------------------------------------------
+Bool_t R3BSofGladLookupBuilder::Build(R3BSofGladLookupPar* par)
+{
+    if (!fField)
+    {
+        LOG(ERROR) << "R3BSofGladLookupBuilder::Build() no field";
+        return kFALSE;
+    }
+    if (!par || fNumBrho < 2)
+    {
+        LOG(ERROR) << "R3BSofGladLookupBuilder::Build() no table or less than 2 values of Brho";
+        return kFALSE;
+    }
+
+    for (Int_t a = 0; a < R3BSofGladLookupPar::kNumAxes; a++)
+        par->SetAxis(a, fGridN[a], fGridMin[a], fGridMax[a]);
+    par->SetFieldScale(fFieldScale);
+
+    std::vector<Double_t> brho(fNumBrho), x3(fNumBrho), length(fNumBrho);
+    std::vector<Bool_t> ok(fNumBrho);
+    for (Int_t j = 0; j < fNumBrho; j++)
+        brho[j] = fBrhoMin + j * (fBrhoMax - fBrhoMin) / (fNumBrho - 1);
+
+    Int_t filled = 0;
+    for (Int_t i0 = 0; i0 < fGridN[0]; i0++)
+    {
+        Double_t x2 = fGridN[0] > 1 ? fGridMin[0] + i0 * (fGridMax[0] - fGridMin[0]) / (fGridN[0] - 1) : fGridMin[0];
+        for (Int_t i1 = 0; i1 < fGridN[1]; i1++)
+        {
+            Double_t dx12 =
+                fGridN[1] > 1 ? fGridMin[1] + i1 * (fGridMax[1] - fGridMin[1]) / (fGridN[1] - 1) : fGridMin[1];
+
+            // Straight line from the start to MWPC2
+            Double_t dz = fMwpc2Z - fMwpc1Z;
+            Double_t straight = (fMwpc2Z - fStartZ) * TMath::Sqrt(dx12 * dx12 + dz * dz) / dz;
+
+            for (Int_t j = 0; j < fNumBrho; j++)
+                ok[j] = Track(x2, dx12, brho[j], x3[j], length[j]);
+
+            for (Int_t i2 = 0; i2 < fGridN[2]; i2++)
+            {
+                Double_t target =
+                    fGridN[2] > 1 ? fGridMin[2] + i2 * (fGridMax[2] - fGridMin[2]) / (fGridN[2] - 1) : fGridMin[2];
+                Int_t index = par->GetIndex(i0, i1, i2);
+                for (Int_t j = 0; j + 1 < fNumBrho; j++)
+                {
+                    if (!ok[j] || !ok[j + 1])
+                        continue;
+                    Double_t lo = TMath::Min(x3[j], x3[j + 1]);
+                    Double_t hi = TMath::Max(x3[j], x3[j + 1]);
+                    if (target < lo || target > hi || hi == lo)
+                        continue;
+                    Double_t f = (target - x3[j]) / (x3[j + 1] - x3[j]);
+                    par->SetValues(index,
+                                   brho[j] + f * (brho[j + 1] - brho[j]),
+                                   straight + length[j] + f * (length[j + 1] - length[j]));
+                    filled++;
+                    break;
+                }
+            }
+        }
+    }
+
+    LOG(INFO) << "R3BSofGladLookupBuilder::Build() " << filled << " of "
+              << fGridN[0] * fGridN[1] * fGridN[2] << " cells filled";
+    return kTRUE;
+}
+
+ClassImp(R3BSofGladLookupBuilder)
@@ -0,0 +1,108 @@
+// ------------------------------------------------------------------
+// -----         R3BSofGladLookupBuilder header file            -----
+// -----   Fills R3BSofGladLookupPar by tracking through GLAD   -----
+// ------------------------------------------------------------------
+
+#ifndef R3BSofGladLookupBuilder_H
+#define R3BSofGladLookupBuilder_H
+
+#include "TObject.h"
+
+class FairField;
+class R3BSofGladLookupPar;
+
+/**
+ * Builds the lookup table of Brho and flight path for a setting of GLAD:
+ *   R3BSofGladLookupBuilder builder(field); // e.g. R3BGladFieldMap, after its Init()
+ *   builder.SetMwpc3(-2430., 0., 6890., -29.);
+ *   builder.Build(par);
+ * (see macros/s467/calibration/glad_lookup.C).
+ *
+ * For each point of the grid in x at MWPC2 and x at MWPC2 - x at MWPC1, tracks
+ * of fNumBrho rigidities are integrated through the field (Runge-Kutta, step
+ * fStep) from MWPC2 to the planes of MWPC3 and of the ToF-Wall. x at MWPC3 is
+ * monotonous in Brho, so the Brho and the path length at the points of the
+ * grid in x at MWPC3 are interpolated between the two nearest tracks.
+ * Positions in mm in the frame of the cave, angles of the chambers behind
+ * GLAD in degrees around y. The tracks are in the horizontal plane (y = 0).
+ **/
+class R3BSofGladLookupBuilder : public TObject
+{
+  public:
+    /** Default constructor **/
+    R3BSofGladLookupBuilder();
+
+    /** Standard constructor **/
+    R3BSofGladLookupBuilder(FairField* field);
+
+    /** Destructor **/
+    virtual ~R3BSofGladLookupBuilder();
+
+    /** Geometry **/
+    void SetField(FairField* field) { fField = field; }
+    void SetFieldScale(Double_t scale) { fFieldScale = scale; } // stored with the table
+    void SetStartZ(Double_t z) { fStartZ = z; }
+    void SetMwpc1Z(Double_t z) { fMwpc1Z = z; }
+    void SetMwpc2Z(Double_t z) { fMwpc2Z = z; }
+    void SetMwpc3(Double_t x, Double_t y, Double_t z, Double_t angle) { SetPlane(fMwpc3, x, y, z, angle); }
+    void SetTofW(Double_t x, Double_t y, Double_t z, Double_t angle) { SetPlane(fTofW, x, y, z, angle); }
+
+    /** Grid of the table and of the tracks **/
+    void SetGridX2(Int_t n, Double_t min, Double_t max) { SetGrid(0, n, min, max); }
+    void SetGridDx12(Int_t n, Double_t min, Double_t max) { SetGrid(1, n, min, max); }
+    void SetGridX3(Int_t n, Double_t min, Double_t max) { SetGrid(2, n, min, max); }
+    void SetBrhoRange(Int_t n, Double_t min, Double_t max)
+    {
+        fNumBrho = n;
+        fBrhoMin = min;
+        fBrhoMax = max;
+    }
+    void SetStep(Double_t step) { fStep = step; }
+
+    /** Fills the table, kFALSE without field **/
+    Bool_t Build(R3BSofGladLookupPar* par);
+
+    /** Tracks a fragment from MWPC2, kFALSE if it misses MWPC3 or the ToF-Wall
+     *@param x3      x at MWPC3, frame of the chamber [mm]
+     *@param length  path from MWPC2 to the ToF-Wall [mm]
+     **/
+    Bool_t Track(Double_t x2, Double_t dx12, Double_t brho, Double_t& x3, Double_t& length) const;
+
+  private:
+    struct Plane
+    {
+        Double_t c[3]; // centre
+        Double_t u[3]; // local x axis
+        Double_t n[3]; // normal, downstream
+    };
+
+    FairField* fField;
+    Double_t fFieldScale;
+    Double_t fStartZ; // SofSci at Cave C, start of the time of flight
+    Double_t fMwpc1Z;
+    Double_t fMwpc2Z;
+    Plane fMwpc3;
+    Plane fTofW;
+    Int_t fGridN[3];
+    Double_t fGridMin[3];
+    Double_t fGridMax[3];
+    Int_t fNumBrho;
+    Double_t fBrhoMin;
+    Double_t fBrhoMax;
+    Double_t fStep;
+    Double_t fMaxLength; // of a track from MWPC2
+
+    void SetGrid(Int_t axis, Int_t n, Double_t min, Double_t max)
+    {
+        fGridN[axis] = n;
+        fGridMin[axis] = min;
+        fGridMax[axis] = max;
+    }
+    static void SetPlane(Plane& plane, Double_t x, Double_t y, Double_t z, Double_t angle);
+    void Derivative(const Double_t* state, Double_t k, Double_t* derivative) const;
+
+  public:
+    ClassDef(R3BSofGladLookupBuilder, 0)
+};
+
+#endif
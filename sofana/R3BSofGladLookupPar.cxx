@@ -0,0 +1,188 @@
+// ------------------------------------------------------------------
+// -----         R3BSofGladLookupPar source file                -----
+// -----     Magnetic rigidity and path length through GLAD     -----
+// ------------------------------------------------------------------
+
+#include "R3BSofGladLookupPar.h"
+
+// ---- Standard Constructor ---------------------------------------------------
+R3BSofGladLookupPar::R3BSofGladLookupPar(const TString& name, const TString& title, const TString& context)
+    : FairParGenericSet(name, title, context)
+    , fFieldScale(1.)
+    , fBrho(new TArrayF())
+    , fLength(new TArrayF())
+{
+    for (Int_t a = 0; a < kNumAxes; a++)
+    {
+        fNumPoints[a] = 0;
+        fMin[a] = 0.;
+        fMax[a] = 0.;
+        fInvStep[a] = 0.;
+    }
+}
+
+// ----  Destructor ------------------------------------------------------------
+R3BSofGladLookupPar::~R3BSofGladLookupPar()
+{
+    clear();
+    if (fBrho)
+        delete fBrho;
+    if (fLength)
+        delete fLength;
+}
+
+// ----  Method clear ----------------------------------------------------------
+void R3BSofGladLookupPar::clear()
+{
+    status = kFALSE;
+    resetInputVersions();
+}
+
+// ----  Method SetAxis --------------------------------------------------------
+void R3BSofGladLookupPar::SetAxis(Int_t axis, Int_t numPoints, Double_t min, Double_t max)
+{
+    fNumPoints[axis] = numPoints;
+    fMin[axis] = min;
+    fMax[axis] = max;
+    UpdateSteps();
+    Int_t size = fNumPoints[0] * fNumPoints[1] * fNumPoints[2];
+    fBrho->Set(size);
+    fBrho->Reset();
+    fLength->Set(size);
+    fLength->Reset();
+}
+
+void R3BSofGladLookupPar::UpdateSteps()
+{
+    for (Int_t a = 0; a < kNumAxes; a++)
+        fInvStep[a] = (fNumPoints[a] > 1 && fMax[a] > fMin[a]) ? (fNumPoints[a] - 1) / (fMax[a] - fMin[a]) : 0.;
+}
+
+// ----  Method putParams ------------------------------------------------------
+void R3BSofGladLookupPar::putParams(FairParamList* list)
+{
+    LOG(INFO) << "R3BSofGladLookupPar::putParams() called";
+    if (!list)
+    {
+        return;
+    }
+
+    TArrayI numPoints(kNumAxes, fNumPoints);
+    TArrayD min(kNumAxes, fMin);
+    TArrayD max(kNumAxes, fMax);
+    list->add("gladLookupNumPoints", numPoints);
+    list->add("gladLookupMin", min);
+    list->add("gladLookupMax", max);
+    list->add("gladLookupFieldScale", fFieldScale);
+    list->add("gladLookupBrho", *fBrho);
+    list->add("gladLookupLength", *fLength);
+}
+
+// ----  Method getParams ------------------------------------------------------
+Bool_t R3BSofGladLookupPar::getParams(FairParamList* list)
+{
+    LOG(INFO) << "R3BSofGladLookupPar::getParams() called";
+    if (!list)
+    {
+        return kFALSE;
+    }
+
+    TArrayI numPoints(kNumAxes);
+    TArrayD min(kNumAxes);
+    TArrayD max(kNumAxes);
+    if (!list->fill("gladLookupNumPoints", &numPoints) || !list->fill("gladLookupMin", &min) ||
+        !list->fill("gladLookupMax", &max))
+    {
+        LOG(INFO) << "---Could not initialize the axes of the GLAD lookup table";
+        return kFALSE;
+    }
+    for (Int_t a = 0; a < kNumAxes; a++)
+    {
+        fNumPoints[a] = numPoints[a];
+        fMin[a] = min[a];
+        fMax[a] = max[a];
+    }
+    UpdateSteps();
+
+    if (!list->fill("gladLookupFieldScale", &fFieldScale))
+    {
+        LOG(INFO) << "---Could not initialize gladLookupFieldScale";
+        return kFALSE;
+    }
+
+    Int_t size = fNumPoints[0] * fNumPoints[1] * fNumPoints[2];
+    fBrho->Set(size);
+    if (!(list->fill("gladLookupBrho", fBrho)))
+    {
+        LOG(INFO) << "---Could not initialize gladLookupBrho";
+        return kFALSE;
+    }
+
+    fLength->Set(size);
+    if (!(list->fill("gladLookupLength", fLength)))
+    {
+        LOG(INFO) << "---Could not initialize gladLookupLength";
+        return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+// ----  Method printParams ----------------------------------------------------
+void R3BSofGladLookupPar::printParams()
+{
+    LOG(INFO) << "R3BSofGladLookupPar: table of Brho and path length, field scale " << fFieldScale;
+    const char* names[kNumAxes] = { "x MWPC2", "x MWPC2 - x MWPC1", "x MWPC3" };
+    for (Int_t a = 0; a < kNumAxes; a++)
+        LOG(INFO) << "Axis " << a << " (" << names[a] << "): " << fNumPoints[a] << " points from " << fMin[a]
+                  << " to " << fMax[a] << " mm";
+
+    Int_t filled = 0;
+    for (Int_t i = 0; i < fBrho->GetSize(); i++)
+        if (fBrho->GetAt(i) > 0.)
+            filled++;
+    LOG(INFO) << "R3BSofGladLookupPar: " << filled << " of " << fBrho->GetSize() << " cells reached by tracks";
+}
+
+// ----  Method Interpolate ----------------------------------------------------
+Bool_t R3BSofGladLookupPar::Interpolate(Double_t x2,
+                                        Double_t dx12,
+                                        Double_t x3,
+                                        Double_t& brho,
+                                        Double_t& length) const
+{
+    const Double_t x[kNumAxes] = { x2, dx12, x3 };
+    Int_t i[kNumAxes];
+    Double_t f[kNumAxes];
+    for (Int_t a = 0; a < kNumAxes; a++)
+    {
+        Double_t u = (x[a] - fMin[a]) * fInvStep[a];
+        if (fInvStep[a] == 0. || !(u >= 0.) || u > fNumPoints[a] - 1)
+            return kFALSE;
+        i[a] = (Int_t)u;
+        if (i[a] == fNumPoints[a] - 1)
+            i[a]--;
+        f[a] = u - i[a];
+    }
+
+    const Float_t* b = fBrho->GetArray();
+    const Float_t* l = fLength->GetArray();
+    const Int_t s1 = fNumPoints[2];
+    const Int_t s0 = fNumPoints[1] * s1;
+    const Int_t base = GetIndex(i[0], i[1], i[2]);
+    brho = 0.;
+    length = 0.;
+    for (Int_t c = 0; c < 8; c++)
+    {
+        const Int_t d0 = (c >> 2) & 1, d1 = (c >> 1) & 1, d2 = c & 1;
+        const Int_t k = base + d0 * s0 + d1 * s1 + d2;
+        if (b[k] <= 0.)
+            return kFALSE;
+        const Double_t w = (d0 ? f[0] : 1. - f[0]) * (d1 ? f[1] : 1. - f[1]) * (d2 ? f[2] : 1. - f[2]);
+        brho += w * b[k];
+        length += w * l[k];
+    }
+    return kTRUE;
+}
+
+ClassImp(R3BSofGladLookupPar)
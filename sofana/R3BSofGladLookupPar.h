@@ -0,0 +1,99 @@
+// ------------------------------------------------------------------
+// -----         R3BSofGladLookupPar header file                -----
+// -----     Magnetic rigidity and path length through GLAD     -----
+// ------------------------------------------------------------------
+
+#ifndef R3BSofGladLookupPar_H
+#define R3BSofGladLookupPar_H
+
+#include "TArrayD.h"
+#include "TArrayF.h"
+#include "TArrayI.h"
+#include "TObject.h"
+#include "TString.h"
+
+#include "FairLogger.h"
+#include "FairParGenericSet.h"
+#include "FairParamList.h"
+
+class FairParamList;
+
+/**
+ * Table of the magnetic rigidity Brho [Tm] and of the flight path [mm] from
+ * the start (SofSci at Cave C) to the ToF-Wall, over a regular grid of
+ *   axis 0: x at MWPC2 [mm],
+ *   axis 1: x at MWPC2 - x at MWPC1 [mm] (angle before GLAD),
+ *   axis 2: x at MWPC3 [mm] (local frame of the chamber).
+ * It is filled once per setting of GLAD by R3BSofGladLookupBuilder, from the
+ * field map and the geometry, and read by R3BSofFragmentAnalysis. Cells which
+ * no track reaches have Brho = 0.
+ **/
+class R3BSofGladLookupPar : public FairParGenericSet
+{
+  public:
+    static const Int_t kNumAxes = 3;
+
+    /** Standard constructor **/
+    R3BSofGladLookupPar(const TString& name = "sofGladLookupPar",
+                        const TString& title = "GLAD Brho Lookup Table",
+                        const TString& context = "SofGladLookupParContext");
+
+    /** Destructor **/
+    virtual ~R3BSofGladLookupPar();
+
+    /** Method to reset all parameters **/
+    virtual void clear();
+
+    /** Method to store all parameters using FairRuntimeDB **/
+    virtual void putParams(FairParamList* list);
+
+    /** Method to retrieve all parameters using FairRuntimeDB**/
+    Bool_t getParams(FairParamList* list);
+
+    /** Method to print values of parameters to the standard output **/
+    void printParams();
+
+    /** Sets the grid and clears the table **/
+    void SetAxis(Int_t axis, Int_t numPoints, Double_t min, Double_t max);
+
+    /** Accessor functions **/
+    Int_t GetNumPoints(Int_t axis) const { return fNumPoints[axis]; }
+    Double_t GetMin(Int_t axis) const { return fMin[axis]; }
+    Double_t GetMax(Int_t axis) const { return fMax[axis]; }
+    Double_t GetFieldScale() const { return fFieldScale; }
+    Int_t GetIndex(Int_t i0, Int_t i1, Int_t i2) const { return (i0 * fNumPoints[1] + i1) * fNumPoints[2] + i2; }
+    Float_t GetBrho(Int_t index) const { return fBrho->GetAt(index); }
+    Float_t GetLength(Int_t index) const { return fLength->GetAt(index); }
+
+    void SetFieldScale(Double_t scale) { fFieldScale = scale; }
+    void SetValues(Int_t index, Float_t brho, Float_t length)
+    {
+        fBrho->AddAt(brho, index);
+        fLength->AddAt(length, index);
+    }
+
+    /** Trilinear interpolation of the table, kFALSE outside of the grid or
+     *  next to a cell without track **/
+    Bool_t Interpolate(Double_t x2, Double_t dx12, Double_t x3, Double_t& brho, Double_t& length) const;
+
+  private:
+    Int_t fNumPoints[kNumAxes];
+    Double_t fMin[kNumAxes];
+    Double_t fMax[kNumAxes];
+    Double_t fFieldScale; // scale of the field map used for the table
+    TArrayF* fBrho;       // [Tm]
+    TArrayF* fLength;     // [mm]
+
+    // Inverse of the steps of the grid, set with the axes
+    Double_t fInvStep[kNumAxes]; //!
+
+    void UpdateSteps();
+
+    const R3BSofGladLookupPar& operator=(const R3BSofGladLookupPar&); /*< an assignment operator>*/
+
+    R3BSofGladLookupPar(const R3BSofGladLookupPar&); /*< a copy constructor >*/
+
+    ClassDef(R3BSofGladLookupPar, 1);
+};
+
+#endif
@@ -0,0 +1,261 @@
+// -----------------------------------------------------------------
+// -----                                                       -----
+// -----                R3BSofParallelRun                      -----
+// -----     Event-parallel reprocessing of a root input file  -----
+// -----------------------------------------------------------------
+
+#include "R3BSofParallelRun.h"
+
+// ROOT headers
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TList.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+// Fair headers
+#include "FairFileSource.h"
+#include "FairLogger.h"
+#include "FairRootFileSink.h"
+#include "FairRun.h"
+#include "FairRunAna.h"
+#include "FairTask.h"
+
+#include <exception>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// R3BSofParallelRun: Default Constructor --------------------------
+R3BSofParallelRun::R3BSofParallelRun()
+    : TObject()
+    , fInputFile("")
+    , fOutputFile("")
+    , fTreeName("evt")
+    , fNumWorkers(0)
+    , fNumEvents(-1)
+    , fKeepPartialFiles(kFALSE)
+    , fSetup(NULL)
+{
+}
+
+// R3BSofParallelRun: Standard Constructor --------------------------
+R3BSofParallelRun::R3BSofParallelRun(const TString& inputFile, const TString& outputFile, Int_t numWorkers)
+    : TObject()
+    , fInputFile(inputFile)
+    , fOutputFile(outputFile)
+    , fTreeName("evt")
+    , fNumWorkers(numWorkers)
+    , fNumEvents(-1)
+    , fKeepPartialFiles(kFALSE)
+    , fSetup(NULL)
+{
+}
+
+// Virtual R3BSofParallelRun: Destructor
+R3BSofParallelRun::~R3BSofParallelRun() {}
+
+TString R3BSofParallelRun::GetPartialFile(Int_t worker) const
+{
+    TString name = fOutputFile;
+    name.ReplaceAll(".root", "");
+    return TString::Format("%s_part%03d.root", name.Data(), worker);
+}
+
+// -----   Public method Run   --------------------------------------------
+Long64_t R3BSofParallelRun::Run()
+{
+    if (!fSetup)
+    {
+        LOG(ERROR) << "R3BSofParallelRun::Run() : no setup function";
+        return -1;
+    }
+
+    // The workers are forked: they must not inherit a run, open files or threads
+    if (FairRun::Instance())
+    {
+        LOG(ERROR) << "R3BSofParallelRun::Run() : a FairRun exists in this process, the workers create their own";
+        return -1;
+    }
+    if (gROOT->GetListOfFiles()->GetEntries() > 0)
+    {
+        LOG(ERROR) << "R3BSofParallelRun::Run() : " << gROOT->GetListOfFiles()->GetEntries()
+                   << " root files are open in this process, they would be shared by the workers";
+        return -1;
+    }
+
+    // The input is closed before the fork
+    Long64_t nentries = CountEntries();
+    if (fNumEvents >= 0 && fNumEvents < nentries)
+        nentries = fNumEvents;
+    if (nentries <= 0)
+    {
+        LOG(ERROR) << "R3BSofParallelRun::Run() : no entries in tree " << fTreeName << " of " << fInputFile;
+        return -1;
+    }
+    // FairRunAna::Run() takes the entries as Int_t
+    if (nentries > kMaxInt)
+    {
+        LOG(ERROR) << "R3BSofParallelRun::Run() : " << nentries << " entries, FairRunAna::Run() only reaches the entry "
+                   << kMaxInt << ", use SetNumEvents() or split the input file";
+        return -1;
+    }
+
+    Int_t nworkers = fNumWorkers > 0 ? fNumWorkers : (Int_t)std::thread::hardware_concurrency();
+    nworkers = (Int_t)TMath::Max(1LL, TMath::Min((Long64_t)nworkers, nentries));
+    LOG(INFO) << "R3BSofParallelRun: " << nentries << " events over " << nworkers << " workers";
+
+    // Consecutive ranges of entries, one per worker
+    std::vector<pid_t> pids(nworkers, -1);
+    for (Int_t w = 0; w < nworkers; w++)
+    {
+        Long64_t first = nentries * w / nworkers;
+        Long64_t last = nentries * (w + 1) / nworkers;
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            Int_t status = RunWorker(w, first, last);
+            _exit(status);
+        }
+        else if (pid < 0)
+        {
+            LOG(ERROR) << "R3BSofParallelRun::Run() : fork of the worker " << w << " failed";
+            break;
+        }
+        pids[w] = pid;
+    }
+
+    Bool_t ok = kTRUE;
+    for (Int_t w = 0; w < nworkers; w++)
+    {
+        if (pids[w] < 0)
+        {
+            ok = kFALSE;
+            continue;
+        }
+        int status = 0;
+        waitpid(pids[w], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            LOG(ERROR) << "R3BSofParallelRun::Run() : worker " << w << " failed, "
+                       << (WIFEXITED(status) ? "exit code " : "signal ")
+                       << (WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status));
+            ok = kFALSE;
+        }
+        else if (!CheckOutput(GetPartialFile(w), nentries * (w + 1) / nworkers - nentries * w / nworkers, kFALSE))
+            ok = kFALSE;
+    }
+    if (!ok)
+        return -1;
+
+    // Merge in the order of the ranges
+    TFileMerger merger(kFALSE, kFALSE);
+    merger.SetFastMethod(kTRUE);
+    merger.OutputFile(fOutputFile, "RECREATE");
+    for (Int_t w = 0; w < nworkers; w++)
+        merger.AddFile(GetPartialFile(w), kFALSE);
+    if (!merger.Merge() || !CheckOutput(fOutputFile, nentries, kTRUE))
+    {
+        LOG(ERROR) << "R3BSofParallelRun::Run() : merge into " << fOutputFile << " failed";
+        return -1;
+    }
+    if (!fKeepPartialFiles)
+        for (Int_t w = 0; w < nworkers; w++)
+            gSystem->Unlink(GetPartialFile(w));
+
+    LOG(INFO) << "R3BSofParallelRun: " << nentries << " events written to " << fOutputFile;
+    return nentries;
+}
+
+// -----   Private method CountEntries   -----------------------------------
+Long64_t R3BSofParallelRun::CountEntries() const
+{
+    TFile* f = TFile::Open(fInputFile, "READ");
+    if (!f || f->IsZombie())
+    {
+        LOG(ERROR) << "R3BSofParallelRun: cannot open " << fInputFile;
+        delete f;
+        return -1;
+    }
+    TTree* tree = (TTree*)f->Get(fTreeName);
+    Long64_t nentries = tree ? tree->GetEntries() : 0;
+    f->Close();
+    delete f;
+    return nentries;
+}
+
+// -----   Private method RunWorker   --------------------------------------
+Int_t R3BSofParallelRun::RunWorker(Int_t worker, Long64_t first, Long64_t last)
+{
+    try
+    {
+        FairRunAna* run = new FairRunAna();
+        run->SetSource(new FairFileSource(fInputFile));
+        run->SetSink(new FairRootFileSink(GetPartialFile(worker)));
+        fSetup(run);
+        run->Init();
+        if (!AreTasksActive(run->GetMainTask()))
+        {
+            LOG(ERROR) << "R3BSofParallelRun: worker " << worker << ", a task failed its Init";
+            return 2;
+        }
+        run->Run((Int_t)first, (Int_t)last);
+    }
+    catch (std::exception& e)
+    {
+        LOG(ERROR) << "R3BSofParallelRun: worker " << worker << " failed: " << e.what();
+        return 3;
+    }
+    LOG(INFO) << "R3BSofParallelRun: worker " << worker << " processed the entries " << first << " to " << last - 1;
+    return 0;
+}
+
+// -----   Private method AreTasksActive   ---------------------------------
+Bool_t R3BSofParallelRun::AreTasksActive(FairTask* task)
+{
+    if (!task)
+        return kTRUE;
+    if (!task->IsActive())
+    {
+        LOG(ERROR) << "R3BSofParallelRun: task " << task->GetName() << " is not active";
+        return kFALSE;
+    }
+    TIter next(task->GetListOfTasks());
+    while (FairTask* sub = (FairTask*)next())
+        if (!AreTasksActive(sub))
+            return kFALSE;
+    return kTRUE;
+}
+
+// -----   Private method CheckOutput   ------------------------------------
+Bool_t R3BSofParallelRun::CheckOutput(const TString& file, Long64_t nentries, Bool_t metadata) const
+{
+    TFile* f = TFile::Open(file, "READ");
+    if (!f || f->IsZombie())
+    {
+        LOG(ERROR) << "R3BSofParallelRun: cannot open " << file;
+        delete f;
+        return kFALSE;
+    }
+    Bool_t ok = kTRUE;
+    TTree* tree = (TTree*)f->Get(fTreeName);
+    if (!tree || tree->GetEntries() != nentries)
+    {
+        LOG(ERROR) << "R3BSofParallelRun: " << file << " holds " << (tree ? tree->GetEntries() : 0)
+                   << " entries of the tree " << fTreeName << " instead of " << nentries;
+        ok = kFALSE;
+    }
+    if (metadata && (!f->Get("FileHeader") || !f->Get("BranchList")))
+    {
+        LOG(ERROR) << "R3BSofParallelRun: " << file << " has no FileHeader or BranchList";
+        ok = kFALSE;
+    }
+    f->Close();
+    delete f;
+    return ok;
+}
+
+ClassImp(R3BSofParallelRun)
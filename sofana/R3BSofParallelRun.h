@@ -0,0 +1,99 @@
+// -----------------------------------------------------------------
+// -----                                                       -----
+// -----                R3BSofParallelRun                      -----
+// -----     Event-parallel reprocessing of a root input file  -----
+// -----------------------------------------------------------------
+
+#ifndef R3BSofParallelRun_H
+#define R3BSofParallelRun_H
+
+#include "TObject.h"
+#include "TString.h"
+
+class FairRunAna;
+class FairTask;
+
+/**
+ * Runs the sofia reconstruction chain over one root input file with several
+ * workers. The entries of the input tree are split into fNumWorkers
+ * consecutive ranges, each one processed by a forked process which owns its
+ * FairRunAna, its tasks, their state and output arrays, and writes its own
+ * output file. The parameters are read by every worker from the same
+ * files, which are only read. The output files are then merged in the order
+ * of the ranges, so the output tree keeps the order of the input.
+ *
+ * The tasks and parameter inputs are added by a setup function called in
+ * each worker, e.g. from a macro:
+ *   void Setup(FairRunAna* run) { run->AddTask(new R3BSofTofWTcal2SingleTcal()); ... }
+ *   R3BSofParallelRun* prun = new R3BSofParallelRun("mapped.root", "hit.root", 16);
+ *   prun->SetSetup(&Setup);
+ *   prun->Run();
+ * The FairRoot managers being singletons, the workers are processes and not
+ * threads. They are forked from the calling process, which must not hold a
+ * FairRun (it is only created in the workers), open root files or running
+ * threads; Run() fails when a FairRun exists or files are open. The input
+ * must be a root file (e.g. the mapped data written by the unpacking), an lmd
+ * stream can not be split, of at most 2^31-1 entries (FairRunAna::Run() takes
+ * Int_t entries).
+ *
+ * A worker fails when a task fails its Init (kERROR deactivates the task,
+ * kFATAL aborts), when the run throws, or when its output does not hold
+ * all the entries of its range; nothing is merged then. TFileMerger
+ * concatenates the trees; the FairRoot metadata (FileHeader, BranchList),
+ * identical in all the parts, are not mergeable and are copied once per part
+ * as cycles of the same key, the last one being read. The merged output is
+ * checked for the number of entries and for these objects.
+ **/
+class R3BSofParallelRun : public TObject
+{
+  public:
+    /** Function adding the tasks and the parameter inputs to the run of a worker **/
+    typedef void (*Setup)(FairRunAna* run);
+
+    /** Default constructor **/
+    R3BSofParallelRun();
+
+    /** Standard constructor **/
+    R3BSofParallelRun(const TString& inputFile, const TString& outputFile, Int_t numWorkers);
+
+    /** Destructor **/
+    virtual ~R3BSofParallelRun();
+
+    /** Method to process the events, returns the number of events processed, -1 on failure **/
+    Long64_t Run();
+
+    void SetSetup(Setup setup) { fSetup = setup; }
+    void SetNumWorkers(Int_t n) { fNumWorkers = n; }
+    void SetNumEvents(Long64_t n) { fNumEvents = n; }
+    void SetTreeName(const TString& name) { fTreeName = name; }
+    void SetKeepPartialFiles(Bool_t keep) { fKeepPartialFiles = keep; }
+
+  private:
+    TString fInputFile;
+    TString fOutputFile;
+    TString fTreeName;        // Tree of the input file
+    Int_t fNumWorkers;        // 0 for the number of cores
+    Long64_t fNumEvents;      // -1 for all the entries
+    Bool_t fKeepPartialFiles; // Output of each worker
+    Setup fSetup;             //!
+
+    /** Processing of the entries [first, last) in a worker, returns 0 on success **/
+    Int_t RunWorker(Int_t worker, Long64_t first, Long64_t last);
+
+    /** Number of entries of the input tree, the file being closed again **/
+    Long64_t CountEntries() const;
+
+    /** Name of the output file of a worker **/
+    TString GetPartialFile(Int_t worker) const;
+
+    /** Checks that the output file holds the tree with nentries entries **/
+    Bool_t CheckOutput(const TString& file, Long64_t nentries, Bool_t metadata) const;
+
+    /** False if a task of the list was deactivated, i.e. failed its Init **/
+    static Bool_t AreTasksActive(FairTask* task);
+
+  public:
+    ClassDef(R3BSofParallelRun, 1)
+};
+
+#endif
@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofPidAnalysis                      -----
+// -----       Isotope id from PID gates on FRS and fragments       -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofPidAnalysis.h"
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+
+#include "R3BSofFrsData.h"
+#include "R3BSofPidData.h"
+#include "R3BSofTrackingData.h"
+
+#include "TClonesArray.h"
+
+R3BSofPidAnalysis::R3BSofPidAnalysis()
+    : FairTask("R3BSof PID Analysis", 1)
+    , fOnline(kFALSE)
+    , fStaId(2)
+    , fStoId(4)
+    , fFrsDataCA(NULL)
+    , fTrackingDataCA(NULL)
+    , fPidDataCA(NULL)
+    , fNumEvents(0)
+    , fNumSelected(0)
+{
+}
+
+R3BSofPidAnalysis::R3BSofPidAnalysis(const TString& name, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+    , fOnline(kFALSE)
+    , fStaId(2)
+    , fStoId(4)
+    , fFrsDataCA(NULL)
+    , fTrackingDataCA(NULL)
+    , fPidDataCA(NULL)
+    , fNumEvents(0)
+    , fNumSelected(0)
+{
+}
+
+R3BSofPidAnalysis::~R3BSofPidAnalysis()
+{
+    LOG(INFO) << "R3BSofPidAnalysis: Delete instance";
+    if (fPidDataCA)
+        delete fPidDataCA;
+}
+
+// -----   Public method Init   --------------------------------------------
+InitStatus R3BSofPidAnalysis::Init()
+{
+    LOG(INFO) << "R3BSofPidAnalysis: Init";
+
+    FairRootManager* rootManager = FairRootManager::Instance();
+    if (!rootManager)
+    {
+        return kFATAL;
+    }
+
+    // INPUT DATA, only for the gates in use
+    if (fFrsGates.GetNumGates() > 0)
+    {
+        fFrsDataCA = (TClonesArray*)rootManager->GetObject("SofFrsData");
+        if (!fFrsDataCA)
+        {
+            LOG(ERROR) << "R3BSofPidAnalysis::Init() SofFrsData not found";
+            return kFATAL;
+        }
+        fFrsGates.Build();
+    }
+    if (fFragmentGates.GetNumGates() > 0)
+    {
+        fTrackingDataCA = (TClonesArray*)rootManager->GetObject("SofTrackingData");
+        if (!fTrackingDataCA)
+        {
+            LOG(ERROR) << "R3BSofPidAnalysis::Init() SofTrackingData not found";
+            return kFATAL;
+        }
+        fFragmentGates.Build();
+    }
+    if (!fFrsDataCA && !fTrackingDataCA)
+        LOG(WARNING) << "R3BSofPidAnalysis::Init() no gates, SofPidData will be empty";
+    fFrsCounts.assign(fFrsGates.GetNumGates(), 0);
+    fFragmentCounts.assign(fFragmentGates.GetNumGates(), 0);
+
+    // OUTPUT DATA
+    fPidDataCA = new TClonesArray("R3BSofPidData", 2);
+    if (!fOnline)
+    {
+        rootManager->Register("SofPidData", "PID gates", fPidDataCA, kTRUE);
+    }
+    else
+    {
+        rootManager->Register("SofPidData", "PID gates", fPidDataCA, kFALSE);
+    }
+    return kSUCCESS;
+}
+
+// -----   Public method Execution   --------------------------------------------
+void R3BSofPidAnalysis::Exec(Option_t* option)
+{
+    fNumEvents++;
+    if (fFrsDataCA)
+    {
+        Int_t nHits = fFrsDataCA->GetEntries();
+        for (Int_t i = 0; i < nHits; i++)
+        {
+            R3BSofFrsData* hit = (R3BSofFrsData*)fFrsDataCA->At(i);
+            if (hit->GetStaId() != fStaId || hit->GetStoId() != fStoId)
+                continue;
+            Int_t gate = fFrsGates.FindGate(hit->GetAq(), hit->GetZ());
+            if (gate < 0)
+                continue;
+            fFrsCounts[gate]++;
+            AddData(fFrsGates.GetIsotope(gate), 0, i, hit->GetZ(), hit->GetAq());
+        }
+    }
+    if (fTrackingDataCA)
+    {
+        Int_t nHits = fTrackingDataCA->GetEntries();
+        for (Int_t i = 0; i < nHits; i++)
+        {
+            R3BSofTrackingData* hit = (R3BSofTrackingData*)fTrackingDataCA->At(i);
+            Int_t gate = fFragmentGates.FindGate(hit->GetAq(), hit->GetZ());
+            if (gate < 0)
+                continue;
+            fFragmentCounts[gate]++;
+            AddData(fFragmentGates.GetIsotope(gate), 1, i, hit->GetZ(), hit->GetAq());
+        }
+    }
+    if (fPidDataCA->GetEntriesFast() > 0)
+        fNumSelected++;
+}
+
+// -----   Public method Reset   ------------------------------------------------
+void R3BSofPidAnalysis::Reset()
+{
+    LOG(DEBUG) << "Clearing SofPidData Structure";
+    if (fPidDataCA)
+        fPidDataCA->Clear();
+}
+
+// -----   Public method Finish   -----------------------------------------------
+void R3BSofPidAnalysis::Finish()
+{
+    LOG(INFO) << "R3BSofPidAnalysis: " << fNumSelected << " of " << fNumEvents << " events in the gates";
+    for (Int_t g = 0; g < (Int_t)fFrsCounts.size(); g++)
+        LOG(INFO) << "R3BSofPidAnalysis: FRS isotope " << fFrsGates.GetIsotope(g) << ": " << fFrsCounts[g];
+    for (Int_t g = 0; g < (Int_t)fFragmentCounts.size(); g++)
+        LOG(INFO) << "R3BSofPidAnalysis: fragment " << fFragmentGates.GetIsotope(g) << ": " << fFragmentCounts[g];
+}
+
+// -----   Private method AddData  --------------------------------------------
+R3BSofPidData* R3BSofPidAnalysis::AddData(Int_t isotope, Int_t source, Int_t index, Double_t z, Double_t aq)
+{
+    TClonesArray& clref = *fPidDataCA;
+    Int_t size = clref.GetEntriesFast();
+    return new (clref[size]) R3BSofPidData(isotope, source, index, z, aq);
+}
+
+ClassImp(R3BSofPidAnalysis)
@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofPidAnalysis                      -----
+// -----       Isotope id from PID gates on FRS and fragments       -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofPidAnalysis_H
+#define R3BSofPidAnalysis_H
+
+#include "FairTask.h"
+
+#include "R3BSofPidGates.h"
+
+#include <vector>
+
+class TClonesArray;
+class R3BSofPidData;
+
+/**
+ * Applies the gates on Z vs A/q to SofFrsData (one ToF path) and
+ * SofTrackingData, and writes one R3BSofPidData per entry inside a gate
+ * into SofPidData. An empty SofPidData means that no isotope of interest
+ * is in the event, so later tasks can skip it. For example:
+ *   R3BSofPidAnalysis* pid = new R3BSofPidAnalysis();
+ *   pid->GetFrsGates().AddGate(cut50Ca, 20050); // TCutG, x: A/q, y: Z
+ *   pid->SetFrsPath(2, 4);                       // S2 to Cave C
+ *   run->AddTask(pid);
+ * The gates are compiled in Init.
+ **/
+class R3BSofPidAnalysis : public FairTask
+{
+  public:
+    /** Default constructor **/
+    R3BSofPidAnalysis();
+
+    /** Standard constructor **/
+    R3BSofPidAnalysis(const TString& name, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofPidAnalysis();
+
+    /** Virtual method Exec **/
+    virtual void Exec(Option_t* option);
+
+    /** Virtual method Reset **/
+    virtual void Reset();
+
+    virtual void FinishEvent() { Reset(); }
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Virtual method Finish **/
+    virtual void Finish();
+
+    /** Accessor to select online mode **/
+    void SetOnline(Bool_t option) { fOnline = option; }
+
+    /** Gates on the incoming isotopes (SofFrsData) and on the fragments (SofTrackingData) **/
+    R3BSofPidGates& GetFrsGates() { return fFrsGates; }
+    R3BSofPidGates& GetFragmentGates() { return fFragmentGates; }
+
+    /** ToF path of SofFrsData, start and stop SofSci **/
+    void SetFrsPath(Int_t staId, Int_t stoId)
+    {
+        fStaId = staId;
+        fStoId = stoId;
+    }
+
+  private:
+    Bool_t fOnline;
+    Int_t fStaId, fStoId;
+    R3BSofPidGates fFrsGates;
+    R3BSofPidGates fFragmentGates;
+
+    TClonesArray* fFrsDataCA;      /**< Array with FRS-input data. >*/
+    TClonesArray* fTrackingDataCA; /**< Array with Tracking-input data. >*/
+    TClonesArray* fPidDataCA;      /**< Array with PID-output data. >*/
+
+    // Entries per gate, for the summary in Finish
+    std::vector<ULong64_t> fFrsCounts, fFragmentCounts;
+    ULong64_t fNumEvents, fNumSelected;
+
+    /** Private method AddData **/
+    R3BSofPidData* AddData(Int_t isotope, Int_t source, Int_t index, Double_t z, Double_t aq);
+
+  public:
+    ClassDef(R3BSofPidAnalysis, 1)
+};
+
+#endif
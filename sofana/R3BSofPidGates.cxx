@@ -0,0 +1,237 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                      R3BSofPidGates                        -----
+// -----         Polygon gates on Z vs A/q precompiled in a grid    -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofPidGates.h"
+
+#include "FairLogger.h"
+
+#include "TCutG.h"
+#include "TMath.h"
+
+R3BSofPidGates::R3BSofPidGates()
+    : TObject()
+    , fNbinsAq(256)
+    , fNbinsZ(256)
+    , fAqMin(0.)
+    , fZMin(0.)
+    , fInvStepAq(0.)
+    , fInvStepZ(0.)
+    , fNumEdgeCells(0)
+{
+    fFirst.push_back(0);
+}
+
+R3BSofPidGates::~R3BSofPidGates() {}
+
+void R3BSofPidGates::AddGate(const TCutG* cut, Int_t isotope)
+{
+    if (!cut)
+        return;
+    AddGate(cut->GetN(), cut->GetX(), cut->GetY(), isotope);
+}
+
+void R3BSofPidGates::AddGate(Int_t n, const Double_t* aq, const Double_t* z, Int_t isotope)
+{
+    if (n < 3)
+    {
+        LOG(WARNING) << "R3BSofPidGates::AddGate() gate of isotope " << isotope << " with less than 3 points ignored";
+        return;
+    }
+    fAq.insert(fAq.end(), aq, aq + n);
+    fZ.insert(fZ.end(), z, z + n);
+    fFirst.push_back(fAq.size());
+    fIsotope.push_back(isotope);
+}
+
+void R3BSofPidGates::Clear(Option_t*)
+{
+    fIsotope.clear();
+    fFirst.assign(1, 0);
+    fAq.clear();
+    fZ.clear();
+    fCell.clear();
+    fListStart.clear();
+    fList.clear();
+    fNumEdgeCells = 0;
+}
+
+// ---- Exact test, even-odd rule, same operations as TMath::IsInside -----------
+Bool_t R3BSofPidGates::IsInside(Int_t gate, Double_t aq, Double_t z) const
+{
+    Bool_t inside = kFALSE;
+    const Int_t first = fFirst[gate], last = fFirst[gate + 1];
+    for (Int_t i = first, j = last - 1; i < last; j = i++)
+    {
+        if ((fZ[i] < z && fZ[j] >= z) || (fZ[j] < z && fZ[i] >= z))
+            if (fAq[i] + (z - fZ[i]) / (fZ[j] - fZ[i]) * (fAq[j] - fAq[i]) < aq)
+                inside = !inside;
+    }
+    return inside;
+}
+
+Int_t R3BSofPidGates::FindGate(Double_t aq, Double_t z) const
+{
+    if (fCell.empty())
+        return -1;
+    Double_t u = (aq - fAqMin) * fInvStepAq;
+    Double_t v = (z - fZMin) * fInvStepZ;
+    if (!(u >= 0.) || !(v >= 0.) || u >= fNbinsAq || v >= fNbinsZ)
+        return -1;
+    Int_t cell = fCell[(Int_t)v * fNbinsAq + (Int_t)u];
+    if (cell > -2)
+        return cell;
+    Int_t k = -2 - cell;
+    for (Int_t l = fListStart[k]; l < fListStart[k + 1]; l++)
+        if (IsInside(fList[l], aq, z))
+            return fList[l];
+    return -1;
+}
+
+// ---- Segment crossing the cell [x0,x1]x[y0,y1], Liang-Barsky ----------------
+static Bool_t CrossesCell(Double_t ax,
+                          Double_t ay,
+                          Double_t bx,
+                          Double_t by,
+                          Double_t x0,
+                          Double_t x1,
+                          Double_t y0,
+                          Double_t y1)
+{
+    Double_t t0 = 0., t1 = 1.;
+    const Double_t dx = bx - ax, dy = by - ay;
+    const Double_t p[4] = { -dx, dx, -dy, dy };
+    const Double_t q[4] = { ax - x0, x1 - ax, ay - y0, y1 - ay };
+    for (Int_t i = 0; i < 4; i++)
+    {
+        if (p[i] == 0.)
+        {
+            if (q[i] < 0.)
+                return kFALSE;
+            continue;
+        }
+        Double_t t = q[i] / p[i];
+        if (p[i] < 0.)
+            t0 = TMath::Max(t0, t);
+        else
+            t1 = TMath::Min(t1, t);
+        if (t0 > t1)
+            return kFALSE;
+    }
+    return kTRUE;
+}
+
+void R3BSofPidGates::Build()
+{
+    fCell.clear();
+    fListStart.clear();
+    fList.clear();
+    fNumEdgeCells = 0;
+    if (fIsotope.empty() || fNbinsAq < 1 || fNbinsZ < 1)
+        return;
+
+    // Bounding box of all the gates
+    Double_t aqMin = fAq[0], aqMax = fAq[0], zMin = fZ[0], zMax = fZ[0];
+    for (size_t i = 1; i < fAq.size(); i++)
+    {
+        aqMin = TMath::Min(aqMin, fAq[i]);
+        aqMax = TMath::Max(aqMax, fAq[i]);
+        zMin = TMath::Min(zMin, fZ[i]);
+        zMax = TMath::Max(zMax, fZ[i]);
+    }
+    const Double_t stepAq = (aqMax - aqMin) / fNbinsAq * (1. + 1.e-9) + 1.e-12;
+    const Double_t stepZ = (zMax - zMin) / fNbinsZ * (1. + 1.e-9) + 1.e-12;
+    fAqMin = aqMin;
+    fZMin = zMin;
+    fInvStepAq = 1. / stepAq;
+    fInvStepZ = 1. / stepZ;
+
+    const Int_t nCells = fNbinsAq * fNbinsZ;
+    fCell.assign(nCells, -1);
+    std::vector<Bool_t> closed(nCells, kFALSE);
+    std::vector<Int_t> listOf(nCells, -1); // temporary list of each edge cell
+    std::vector<std::vector<Int_t> > lists;
+    std::vector<Bool_t> edge(nCells, kFALSE);
+
+    for (Int_t g = 0; g < (Int_t)fIsotope.size(); g++)
+    {
+        const Int_t first = fFirst[g], last = fFirst[g + 1];
+        Int_t iMin = fNbinsAq, iMax = -1, jMin = fNbinsZ, jMax = -1;
+        for (Int_t i = first; i < last; i++)
+        {
+            Int_t u = TMath::Min((Int_t)((fAq[i] - fAqMin) * fInvStepAq), fNbinsAq - 1);
+            Int_t v = TMath::Min((Int_t)((fZ[i] - fZMin) * fInvStepZ), fNbinsZ - 1);
+            iMin = TMath::Min(iMin, u);
+            iMax = TMath::Max(iMax, u);
+            jMin = TMath::Min(jMin, v);
+            jMax = TMath::Max(jMax, v);
+        }
+
+        // Cells crossed by the edges of the gate
+        for (Int_t i = first, j = last - 1; i < last; j = i++)
+        {
+            Int_t u0 = (Int_t)((TMath::Min(fAq[i], fAq[j]) - fAqMin) * fInvStepAq);
+            Int_t u1 = TMath::Min((Int_t)((TMath::Max(fAq[i], fAq[j]) - fAqMin) * fInvStepAq), fNbinsAq - 1);
+            Int_t v0 = (Int_t)((TMath::Min(fZ[i], fZ[j]) - fZMin) * fInvStepZ);
+            Int_t v1 = TMath::Min((Int_t)((TMath::Max(fZ[i], fZ[j]) - fZMin) * fInvStepZ), fNbinsZ - 1);
+            for (Int_t v = v0; v <= v1; v++)
+                for (Int_t u = u0; u <= u1; u++)
+                    if (CrossesCell(fAq[j],
+                                    fZ[j],
+                                    fAq[i],
+                                    fZ[i],
+                                    fAqMin + u * stepAq,
+                                    fAqMin + (u + 1) * stepAq,
+                                    fZMin + v * stepZ,
+                                    fZMin + (v + 1) * stepZ))
+                        edge[v * fNbinsAq + u] = kTRUE;
+        }
+
+        for (Int_t v = jMin; v <= jMax; v++)
+            for (Int_t u = iMin; u <= iMax; u++)
+            {
+                Int_t c = v * fNbinsAq + u;
+                Bool_t isEdge = edge[c];
+                edge[c] = kFALSE;
+                if (closed[c])
+                    continue;
+                if (!isEdge && !IsInside(g, fAqMin + (u + 0.5) * stepAq, fZMin + (v + 0.5) * stepZ))
+                    continue;
+                if (!isEdge && listOf[c] < 0)
+                {
+                    // Inside of the gate, no gate before to test
+                    fCell[c] = g;
+                    closed[c] = kTRUE;
+                    continue;
+                }
+                if (listOf[c] < 0)
+                {
+                    listOf[c] = lists.size();
+                    lists.push_back(std::vector<Int_t>());
+                }
+                lists[listOf[c]].push_back(g);
+                closed[c] = !isEdge;
+            }
+    }
+
+    // Lists of the edge cells
+    fListStart.push_back(0);
+    for (Int_t c = 0; c < nCells; c++)
+    {
+        if (listOf[c] < 0)
+            continue;
+        const std::vector<Int_t>& l = lists[listOf[c]];
+        fCell[c] = -2 - (Int_t)(fListStart.size() - 1);
+        fList.insert(fList.end(), l.begin(), l.end());
+        fListStart.push_back(fList.size());
+        fNumEdgeCells++;
+    }
+
+    LOG(INFO) << "R3BSofPidGates::Build() " << fIsotope.size() << " gates in " << fNbinsAq << " x " << fNbinsZ
+              << " cells, A/q from " << aqMin << " to " << aqMax << ", Z from " << zMin << " to " << zMax << ", "
+              << fNumEdgeCells << " cells with exact tests";
+}
+
+ClassImp(R3BSofPidGates)
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                      R3BSofPidGates                        -----
+// -----         Polygon gates on Z vs A/q precompiled in a grid    -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofPidGates_H
+#define R3BSofPidGates_H
+
+#include "TObject.h"
+
+#include <vector>
+
+class TCutG;
+
+/**
+ * Set of graphical cuts on Z (y) vs A/q (x), each giving an isotope id
+ * (e.g. 1000 * Z + A), compiled by Build() into a grid over the bounding box
+ * of the gates. A cell of the grid inside one gate and crossed by no edge
+ * gives the id directly; the cells crossed by edges keep the short list of
+ * gates to test exactly (even-odd rule, as TCutG::IsInside). When gates
+ * overlap, the first one added wins.
+ **/
+class R3BSofPidGates : public TObject
+{
+  public:
+    /** Default constructor **/
+    R3BSofPidGates();
+
+    /** Destructor **/
+    virtual ~R3BSofPidGates();
+
+    /** Gates, x: A/q and y: Z **/
+    void AddGate(const TCutG* cut, Int_t isotope);
+    void AddGate(Int_t n, const Double_t* aq, const Double_t* z, Int_t isotope);
+    void Clear(Option_t* option = "");
+
+    /** Grid, to be rebuilt after adding gates **/
+    void SetGrid(Int_t nAq, Int_t nZ)
+    {
+        fNbinsAq = nAq;
+        fNbinsZ = nZ;
+    }
+    void Build();
+
+    /** Id of the isotope, -1 outside of the gates **/
+    Int_t FindIsotope(Double_t aq, Double_t z) const
+    {
+        Int_t gate = FindGate(aq, z);
+        return gate < 0 ? -1 : fIsotope[gate];
+    }
+    /** Index of the gate, -1 outside of the gates **/
+    Int_t FindGate(Double_t aq, Double_t z) const;
+
+    /** Exact test of one gate **/
+    Bool_t IsInside(Int_t gate, Double_t aq, Double_t z) const;
+
+    Int_t GetNumGates() const { return fIsotope.size(); }
+    Int_t GetIsotope(Int_t gate) const { return fIsotope[gate]; }
+    Int_t GetNumEdgeCells() const { return fNumEdgeCells; }
+
+  private:
+    std::vector<Int_t> fIsotope;  // per gate
+    std::vector<Int_t> fFirst;    // first vertex of each gate, and end of the last
+    std::vector<Double_t> fAq;    // vertices
+    std::vector<Double_t> fZ;
+    Int_t fNbinsAq, fNbinsZ;
+
+    // Grid: cell >= 0 gate, -1 none, -2 - k gates fList[fListStart[k]..fListStart[k+1]] to test
+    Double_t fAqMin, fZMin, fInvStepAq, fInvStepZ; //!
+    std::vector<Int_t> fCell;                      //!
+    std::vector<Int_t> fListStart;                 //!
+    std::vector<Int_t> fList;                      //!
+    Int_t fNumEdgeCells;                           //!
+
+  public:
+    ClassDef(R3BSofPidGates, 1)
+};
+
+#endif
@@ -0,0 +1,494 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofPidSummary                       -----
+// -----        Mergeable integer maps for the run-wide PID         -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofPidSummary.h"
+
+#include "FairLogger.h"
+
+#include "TH2D.h"
+#include "TMath.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// --- Records of the file --- //
+
+static const char kMagic[8] = { 'S', 'O', 'F', 'P', 'I', 'D', 'S', '1' };
+static const UInt_t kVersion = 1;
+
+struct PidSummaryHeader
+{
+    char magic[8];
+    UInt_t version;
+    UInt_t numMaps;
+    ULong64_t numSources;
+    ULong64_t numEvents;
+    ULong64_t numBins;
+    ULong64_t countsOffset;
+};
+
+struct PidSummaryMap
+{
+    char name[32];
+    Int_t nx, ny;
+    Double_t xmin, xmax, ymin, ymax;
+};
+
+struct PidSummarySource
+{
+    char name[120];
+    ULong64_t events;
+};
+
+// Read-only mapping of a whole file
+struct PidSummaryFile
+{
+    const char* data;
+    size_t size;
+
+    PidSummaryFile()
+        : data(NULL)
+        , size(0)
+    {
+    }
+    ~PidSummaryFile() { Close(); }
+    Bool_t Open(const char* filename)
+    {
+        Int_t fd = open(filename, O_RDONLY);
+        if (fd < 0)
+            return kFALSE;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                data = (const char*)p;
+                size = st.st_size;
+                madvise(p, size, MADV_SEQUENTIAL);
+            }
+        }
+        close(fd);
+        return data != NULL;
+    }
+    void Close()
+    {
+        if (data)
+            munmap((void*)data, size);
+        data = NULL;
+        size = 0;
+    }
+    const PidSummaryHeader* Header() const { return (const PidSummaryHeader*)data; }
+    const PidSummaryMap* Maps() const { return (const PidSummaryMap*)(data + sizeof(PidSummaryHeader)); }
+    const PidSummarySource* Sources() const
+    {
+        return (const PidSummarySource*)(data + sizeof(PidSummaryHeader) + Header()->numMaps * sizeof(PidSummaryMap));
+    }
+    const ULong64_t* Counts() const { return (const ULong64_t*)(data + Header()->countsOffset); }
+
+    // Header and sizes consistent with the file
+    Bool_t IsValid() const
+    {
+        if (size < sizeof(PidSummaryHeader))
+            return kFALSE;
+        const PidSummaryHeader* h = Header();
+        if (memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion)
+            return kFALSE;
+        ULong64_t offset =
+            sizeof(PidSummaryHeader) + h->numMaps * sizeof(PidSummaryMap) + h->numSources * sizeof(PidSummarySource);
+        if (h->countsOffset != offset || offset + h->numBins * sizeof(ULong64_t) != size)
+            return kFALSE;
+        ULong64_t bins = 0;
+        for (UInt_t m = 0; m < h->numMaps; m++)
+            bins += (ULong64_t)(Maps()[m].nx + 2) * (Maps()[m].ny + 2);
+        return bins == h->numBins;
+    }
+};
+
+static void CopyName(char* dest, size_t size, const std::string& name)
+{
+    memset(dest, 0, size);
+    strncpy(dest, name.c_str(), size - 1);
+}
+
+// --- R3BSofPidSummary --- //
+
+R3BSofPidSummary::R3BSofPidSummary()
+    : TObject()
+    , fNumEvents(0)
+{
+}
+
+R3BSofPidSummary::~R3BSofPidSummary() {}
+
+Int_t R3BSofPidSummary::AddMap(const char* name,
+                               Int_t nx,
+                               Double_t xmin,
+                               Double_t xmax,
+                               Int_t ny,
+                               Double_t ymin,
+                               Double_t ymax)
+{
+    fName.push_back(std::string(name).substr(0, sizeof(PidSummaryMap::name) - 1));
+    fNx.push_back(0);
+    fNy.push_back(0);
+    fXmin.push_back(0.);
+    fXmax.push_back(0.);
+    fYmin.push_back(0.);
+    fYmax.push_back(0.);
+    fOffset.push_back(0);
+    Int_t m = fName.size() - 1;
+    SetMap(m, nx, xmin, xmax, ny, ymin, ymax);
+    return m;
+}
+
+void R3BSofPidSummary::SetMap(Int_t m,
+                              Int_t nx,
+                              Double_t xmin,
+                              Double_t xmax,
+                              Int_t ny,
+                              Double_t ymin,
+                              Double_t ymax)
+{
+    if (m < 0 || m >= GetNumMaps())
+    {
+        LOG(ERROR) << "R3BSofPidSummary::SetMap() no map " << m;
+        return;
+    }
+    if (nx < 1 || ny < 1 || !(xmax > xmin) || !(ymax > ymin))
+    {
+        LOG(ERROR) << "R3BSofPidSummary::SetMap() wrong binning of " << fName[m];
+        return;
+    }
+    // Counts of the other maps are kept
+    std::vector<ULong64_t> counts;
+    counts.swap(fCounts);
+    std::vector<ULong64_t> offset = fOffset;
+    std::vector<Int_t> oldNx = fNx, oldNy = fNy;
+
+    fNx[m] = nx;
+    fNy[m] = ny;
+    fXmin[m] = xmin;
+    fXmax[m] = xmax;
+    fYmin[m] = ymin;
+    fYmax[m] = ymax;
+    UpdateOffsets();
+    for (Int_t i = 0; i < GetNumMaps(); i++)
+    {
+        if (i == m || oldNx[i] == 0)
+            continue;
+        ULong64_t n = (ULong64_t)(oldNx[i] + 2) * (oldNy[i] + 2);
+        std::copy(counts.begin() + offset[i], counts.begin() + offset[i] + n, fCounts.begin() + fOffset[i]);
+    }
+}
+
+void R3BSofPidSummary::UpdateOffsets()
+{
+    ULong64_t bins = 0;
+    for (Int_t m = 0; m < GetNumMaps(); m++)
+    {
+        fOffset[m] = bins;
+        bins += (ULong64_t)(fNx[m] + 2) * (fNy[m] + 2);
+    }
+    fCounts.assign(bins, 0);
+}
+
+Int_t R3BSofPidSummary::FindMap(const char* name) const
+{
+    for (Int_t m = 0; m < GetNumMaps(); m++)
+        if (fName[m] == name)
+            return m;
+    return -1;
+}
+
+void R3BSofPidSummary::Reset()
+{
+    std::fill(fCounts.begin(), fCounts.end(), 0);
+    fSource.clear();
+    fSourceEvents.clear();
+    fNumEvents = 0;
+}
+
+void R3BSofPidSummary::AddSource(const char* name, ULong64_t events)
+{
+    fSource.push_back(std::string(name).substr(0, sizeof(PidSummarySource::name) - 1));
+    fSourceEvents.push_back(events);
+    fNumEvents += events;
+}
+
+Bool_t R3BSofPidSummary::IsCompatible(const R3BSofPidSummary& other) const
+{
+    if (other.GetNumMaps() != GetNumMaps())
+        return kFALSE;
+    for (Int_t m = 0; m < GetNumMaps(); m++)
+    {
+        if (other.fName[m] != fName[m] || other.fNx[m] != fNx[m] || other.fNy[m] != fNy[m] ||
+            other.fXmin[m] != fXmin[m] || other.fXmax[m] != fXmax[m] || other.fYmin[m] != fYmin[m] ||
+            other.fYmax[m] != fYmax[m])
+            return kFALSE;
+    }
+    return kTRUE;
+}
+
+Bool_t R3BSofPidSummary::Add(const R3BSofPidSummary& other)
+{
+    if (!IsCompatible(other))
+    {
+        LOG(ERROR) << "R3BSofPidSummary::Add() different maps";
+        return kFALSE;
+    }
+    for (size_t b = 0; b < fCounts.size(); b++)
+        fCounts[b] += other.fCounts[b];
+    Int_t nSources = other.GetNumSources(); // other may be this summary
+    for (Int_t s = 0; s < nSources; s++)
+    {
+        std::string name = other.fSource[s];
+        AddSource(name.c_str(), other.fSourceEvents[s]);
+    }
+    return kTRUE;
+}
+
+Bool_t R3BSofPidSummary::WriteFile(const char* filename) const
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        LOG(ERROR) << "R3BSofPidSummary::WriteFile() cannot open " << filename;
+        return kFALSE;
+    }
+    PidSummaryHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.numMaps = GetNumMaps();
+    header.numSources = GetNumSources();
+    header.numEvents = fNumEvents;
+    header.numBins = fCounts.size();
+    header.countsOffset = sizeof(PidSummaryHeader) + header.numMaps * sizeof(PidSummaryMap) +
+                          header.numSources * sizeof(PidSummarySource);
+    Bool_t ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (Int_t m = 0; ok && m < GetNumMaps(); m++)
+    {
+        PidSummaryMap map;
+        CopyName(map.name, sizeof(map.name), fName[m]);
+        map.nx = fNx[m];
+        map.ny = fNy[m];
+        map.xmin = fXmin[m];
+        map.xmax = fXmax[m];
+        map.ymin = fYmin[m];
+        map.ymax = fYmax[m];
+        ok = fwrite(&map, sizeof(map), 1, file) == 1;
+    }
+    for (Int_t s = 0; ok && s < GetNumSources(); s++)
+    {
+        PidSummarySource source;
+        CopyName(source.name, sizeof(source.name), fSource[s]);
+        source.events = fSourceEvents[s];
+        ok = fwrite(&source, sizeof(source), 1, file) == 1;
+    }
+    if (ok && !fCounts.empty())
+        ok = fwrite(fCounts.data(), sizeof(ULong64_t), fCounts.size(), file) == fCounts.size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok)
+        LOG(ERROR) << "R3BSofPidSummary::WriteFile() error writing " << filename;
+    return ok;
+}
+
+Bool_t R3BSofPidSummary::ReadFile(const char* filename)
+{
+    PidSummaryFile file;
+    if (!file.Open(filename) || !file.IsValid())
+    {
+        LOG(ERROR) << "R3BSofPidSummary::ReadFile() " << filename << " is not a PID summary";
+        return kFALSE;
+    }
+    const PidSummaryHeader* header = file.Header();
+    fName.clear();
+    fNx.clear();
+    fNy.clear();
+    fXmin.clear();
+    fXmax.clear();
+    fYmin.clear();
+    fYmax.clear();
+    fOffset.clear();
+    for (UInt_t m = 0; m < header->numMaps; m++)
+    {
+        const PidSummaryMap& map = file.Maps()[m];
+        fName.push_back(std::string(map.name, strnlen(map.name, sizeof(map.name))));
+        fNx.push_back(map.nx);
+        fNy.push_back(map.ny);
+        fXmin.push_back(map.xmin);
+        fXmax.push_back(map.xmax);
+        fYmin.push_back(map.ymin);
+        fYmax.push_back(map.ymax);
+        fOffset.push_back(0);
+    }
+    UpdateOffsets();
+    memcpy(fCounts.data(), file.Counts(), fCounts.size() * sizeof(ULong64_t));
+
+    fSource.clear();
+    fSourceEvents.clear();
+    fNumEvents = 0;
+    for (ULong64_t s = 0; s < header->numSources; s++)
+    {
+        const PidSummarySource& source = file.Sources()[s];
+        AddSource(std::string(source.name, strnlen(source.name, sizeof(source.name))).c_str(), source.events);
+    }
+    return kTRUE;
+}
+
+// Bins [b0, b1) of the output from all the inputs
+static void MergeSlice(const std::vector<PidSummaryFile*>* inputs, ULong64_t* out, ULong64_t b0, ULong64_t b1)
+{
+    std::fill(out + b0, out + b1, 0);
+    for (size_t i = 0; i < inputs->size(); i++)
+    {
+        const ULong64_t* in = (*inputs)[i]->Counts();
+        for (ULong64_t b = b0; b < b1; b++)
+            out[b] += in[b];
+    }
+}
+
+Bool_t R3BSofPidSummary::Merge(const std::vector<std::string>& inputs, const char* output, Int_t nThreads)
+{
+    if (inputs.empty())
+    {
+        LOG(ERROR) << "R3BSofPidSummary::Merge() no input";
+        return kFALSE;
+    }
+
+    // --- Inputs, all with the maps of the first one --- //
+    std::vector<PidSummaryFile*> files;
+    Bool_t ok = kTRUE;
+    ULong64_t numSources = 0, numEvents = 0;
+    for (size_t i = 0; i < inputs.size() && ok; i++)
+    {
+        PidSummaryFile* file = new PidSummaryFile();
+        files.push_back(file);
+        if (!file->Open(inputs[i].c_str()) || !file->IsValid())
+        {
+            LOG(ERROR) << "R3BSofPidSummary::Merge() " << inputs[i] << " is not a PID summary";
+            ok = kFALSE;
+        }
+        else if (file->Header()->numMaps != files[0]->Header()->numMaps ||
+                 memcmp(file->Maps(), files[0]->Maps(), file->Header()->numMaps * sizeof(PidSummaryMap)) != 0)
+        {
+            LOG(ERROR) << "R3BSofPidSummary::Merge() maps of " << inputs[i] << " differ from " << inputs[0];
+            ok = kFALSE;
+        }
+        else
+        {
+            numSources += file->Header()->numSources;
+            numEvents += file->Header()->numEvents;
+        }
+    }
+
+    // --- Output mapped in memory, the threads add slices of the bins --- //
+    // Written to a temporary file renamed at the end: the output may be one of the inputs, still mapped
+    std::string temp = std::string(output) + ".XXXXXX";
+    Int_t fd = -1;
+    char* data = NULL;
+    size_t size = 0;
+    if (ok)
+    {
+        const PidSummaryHeader* first = files[0]->Header();
+        ULong64_t countsOffset = sizeof(PidSummaryHeader) + first->numMaps * sizeof(PidSummaryMap) +
+                                 numSources * sizeof(PidSummarySource);
+        size = countsOffset + first->numBins * sizeof(ULong64_t);
+        fd = mkstemp(&temp[0]);
+        if (fd < 0 || fchmod(fd, 0644) != 0 || ftruncate(fd, size) != 0)
+            ok = kFALSE;
+        else
+        {
+            void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ok = p != MAP_FAILED;
+            data = ok ? (char*)p : NULL;
+        }
+        if (!ok)
+            LOG(ERROR) << "R3BSofPidSummary::Merge() cannot write " << output;
+    }
+    if (ok)
+    {
+        const PidSummaryHeader* first = files[0]->Header();
+        PidSummaryHeader* header = (PidSummaryHeader*)data;
+        *header = *first;
+        header->numSources = numSources;
+        header->numEvents = numEvents;
+        header->countsOffset = sizeof(PidSummaryHeader) + first->numMaps * sizeof(PidSummaryMap) +
+                               numSources * sizeof(PidSummarySource);
+        memcpy(data + sizeof(PidSummaryHeader), files[0]->Maps(), first->numMaps * sizeof(PidSummaryMap));
+        PidSummarySource* sources = (PidSummarySource*)(data + sizeof(PidSummaryHeader) +
+                                                        first->numMaps * sizeof(PidSummaryMap));
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            memcpy(sources, files[i]->Sources(), files[i]->Header()->numSources * sizeof(PidSummarySource));
+            sources += files[i]->Header()->numSources;
+        }
+
+        ULong64_t numBins = first->numBins;
+        ULong64_t* out = (ULong64_t*)(data + header->countsOffset);
+        if (nThreads <= 0)
+            nThreads = (Int_t)std::thread::hardware_concurrency();
+        // At least 64k bins per thread
+        nThreads = (Int_t)TMath::Max(1ULL, TMath::Min((ULong64_t)nThreads, numBins >> 16));
+        if (nThreads == 1)
+            MergeSlice(&files, out, 0, numBins);
+        else
+        {
+            std::vector<std::thread> workers;
+            for (Int_t t = 0; t < nThreads; t++)
+                workers.push_back(
+                    std::thread(MergeSlice, &files, out, numBins * t / nThreads, numBins * (t + 1) / nThreads));
+            for (Int_t t = 0; t < nThreads; t++)
+                workers[t].join();
+        }
+        ok = msync(data, size, MS_SYNC) == 0;
+        LOG(INFO) << "R3BSofPidSummary::Merge() " << inputs.size() << " files, " << numSources << " sources, "
+                  << numEvents << " events into " << output;
+    }
+
+    if (data)
+        munmap(data, size);
+    if (fd >= 0)
+    {
+        ok = (close(fd) == 0) && ok;
+        if (ok && rename(temp.c_str(), output) != 0)
+        {
+            LOG(ERROR) << "R3BSofPidSummary::Merge() cannot write " << output;
+            ok = kFALSE;
+        }
+        if (!ok)
+            unlink(temp.c_str());
+    }
+    for (size_t i = 0; i < files.size(); i++)
+        delete files[i];
+    return ok;
+}
+
+TH2D* R3BSofPidSummary::GetHistogram(Int_t m) const
+{
+    if (m < 0 || m >= GetNumMaps())
+        return NULL;
+    TH2D* h = new TH2D(fName[m].c_str(), fName[m].c_str(), fNx[m], fXmin[m], fXmax[m], fNy[m], fYmin[m], fYmax[m]);
+    Double_t entries = 0.;
+    for (Int_t iy = 0; iy <= fNy[m] + 1; iy++)
+        for (Int_t ix = 0; ix <= fNx[m] + 1; ix++)
+        {
+            ULong64_t counts = GetBinContent(m, ix, iy);
+            if (counts == 0)
+                continue;
+            h->SetBinContent(ix, iy, counts);
+            entries += counts;
+        }
+    h->SetEntries(entries);
+    return h;
+}
+
+ClassImp(R3BSofPidSummary)
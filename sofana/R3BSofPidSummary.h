@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                     R3BSofPidSummary                       -----
+// -----        Mergeable integer maps for the run-wide PID         -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofPidSummary_H
+#define R3BSofPidSummary_H
+
+#include "TObject.h"
+
+#include <string>
+#include <vector>
+
+class TH2D;
+
+/**
+ * Fixed-binning 2D maps of 64-bit counts (Z vs A/q, beta, Brho, positions)
+ * with the list of the files they come from. Summaries with the same maps
+ * are added bin by bin (Add), which is associative, so the summaries of the
+ * jobs of a campaign can be merged in any grouping and order. The maps have
+ * the under- and overflow bins of ROOT, bin (ix, iy) with ix in [0, nx + 1].
+ *
+ * File (".sofpid", native byte order), all records 8-byte aligned so that
+ * the counts can be used in place from a memory-mapped file:
+ *   header   magic "SOFPIDS1", version, maps, sources, events, bins, offset of the counts
+ *   maps     name[32], nx, ny, xmin, xmax, ymin, ymax
+ *   sources  name[120], events
+ *   counts   ULong64_t, map after map, (nx + 2) * (ny + 2) each, x first
+ * Merge(inputs, output) adds files with several threads over slices of the
+ * bins, reading the inputs and writing the output through mmap. The output
+ * is written to a temporary file next to it, renamed when complete: it can
+ * be one of the inputs, and a failed merge leaves it untouched.
+ **/
+class R3BSofPidSummary : public TObject
+{
+  public:
+    /** Default constructor **/
+    R3BSofPidSummary();
+
+    /** Destructor **/
+    virtual ~R3BSofPidSummary();
+
+    /** Maps, SetMap changes the binning and clears the counts of map m **/
+    Int_t AddMap(const char* name, Int_t nx, Double_t xmin, Double_t xmax, Int_t ny, Double_t ymin, Double_t ymax);
+    void SetMap(Int_t m, Int_t nx, Double_t xmin, Double_t xmax, Int_t ny, Double_t ymin, Double_t ymax);
+    Int_t FindMap(const char* name) const;
+
+    Int_t GetNumMaps() const { return fName.size(); }
+    const char* GetMapName(Int_t m) const { return fName[m].c_str(); }
+    ULong64_t GetNumBins() const { return fCounts.size(); }
+
+    /** Counts **/
+    inline void Fill(Int_t m, Double_t x, Double_t y)
+    {
+        fCounts[fOffset[m] + Bin(x, fNx[m], fXmin[m], fXmax[m]) + (fNx[m] + 2) * Bin(y, fNy[m], fYmin[m], fYmax[m])]++;
+    }
+    ULong64_t GetBinContent(Int_t m, Int_t ix, Int_t iy) const { return fCounts[fOffset[m] + ix + (fNx[m] + 2) * iy]; }
+    void Reset();
+
+    /** Provenance: name of an input (LMD or ROOT file) and its number of events **/
+    void AddSource(const char* name, ULong64_t events);
+    Int_t GetNumSources() const { return fSource.size(); }
+    const char* GetSourceName(Int_t s) const { return fSource[s].c_str(); }
+    ULong64_t GetSourceEvents(Int_t s) const { return fSourceEvents[s]; }
+    ULong64_t GetNumEvents() const { return fNumEvents; }
+
+    /** Same maps with the same binning **/
+    Bool_t IsCompatible(const R3BSofPidSummary& other) const;
+
+    /** Adds the counts and the sources of other **/
+    Bool_t Add(const R3BSofPidSummary& other);
+
+    /** Files **/
+    Bool_t WriteFile(const char* filename) const;
+    Bool_t ReadFile(const char* filename);
+
+    /** Adds the input files into output, nThreads = 0 for the number of cores **/
+    static Bool_t Merge(const std::vector<std::string>& inputs, const char* output, Int_t nThreads = 0);
+
+    /** New histogram of map m, owned by the caller **/
+    TH2D* GetHistogram(Int_t m) const;
+
+  private:
+    std::vector<std::string> fName;
+    std::vector<Int_t> fNx, fNy;
+    std::vector<Double_t> fXmin, fXmax, fYmin, fYmax;
+    std::vector<ULong64_t> fOffset; // first bin of each map in fCounts
+    std::vector<ULong64_t> fCounts;
+
+    std::vector<std::string> fSource;
+    std::vector<ULong64_t> fSourceEvents;
+    ULong64_t fNumEvents;
+
+    static inline Int_t Bin(Double_t v, Int_t n, Double_t min, Double_t max)
+    {
+        if (!(v >= min)) // NaN in the underflow
+            return 0;
+        if (v >= max)
+            return n + 1;
+        return 1 + (Int_t)(n * (v - min) / (max - min));
+    }
+    void UpdateOffsets();
+
+  public:
+    ClassDef(R3BSofPidSummary, 1)
+};
+
+#endif
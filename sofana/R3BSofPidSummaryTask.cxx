@@ -0,0 +1,124 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                   R3BSofPidSummaryTask                     -----
+// -----      PID summary of a job, merged over the whole campaign  -----
+// ----------------------------------------------------------------------
+
+#include "R3BSofPidSummaryTask.h"
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+
+#include "R3BSofFrsData.h"
+#include "R3BSofTrackingData.h"
+
+#include "TClonesArray.h"
+
+R3BSofPidSummaryTask::R3BSofPidSummaryTask()
+    : FairTask("R3BSof PID Summary", 1)
+    , fOutputFile("pid_summary.sofpid")
+    , fSourceName("")
+    , fStaId(2)
+    , fStoId(4)
+    , fFrsDataCA(NULL)
+    , fTrackingDataCA(NULL)
+    , fNumEvents(0)
+{
+    AddMaps();
+}
+
+R3BSofPidSummaryTask::R3BSofPidSummaryTask(const TString& name, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+    , fOutputFile("pid_summary.sofpid")
+    , fSourceName("")
+    , fStaId(2)
+    , fStoId(4)
+    , fFrsDataCA(NULL)
+    , fTrackingDataCA(NULL)
+    , fNumEvents(0)
+{
+    AddMaps();
+}
+
+R3BSofPidSummaryTask::~R3BSofPidSummaryTask() { LOG(INFO) << "R3BSofPidSummaryTask: Delete instance"; }
+
+// Default binning, in the order of EMap
+void R3BSofPidSummaryTask::AddMaps()
+{
+    fSummary.AddMap("FrsZvsAq", 600, 1.8, 3.0, 500, 0., 100.);
+    fSummary.AddMap("FrsBetavsZ", 500, 0., 100., 400, 0.6, 0.9);
+    fSummary.AddMap("FrsBrhovsAq", 600, 1.8, 3.0, 500, 5., 15.);
+    fSummary.AddMap("FrsXCavevsXS2", 200, -100., 100., 200, -100., 100.);
+    fSummary.AddMap("FragZvsAq", 600, 1.8, 3.0, 500, 0., 100.);
+    fSummary.AddMap("FragBetavsZ", 500, 0., 100., 400, 0.6, 0.9);
+    fSummary.AddMap("FragBrhovsAq", 600, 1.8, 3.0, 500, 5., 15.);
+}
+
+// -----   Public method Init   --------------------------------------------
+InitStatus R3BSofPidSummaryTask::Init()
+{
+    LOG(INFO) << "R3BSofPidSummaryTask: Init";
+
+    FairRootManager* rootManager = FairRootManager::Instance();
+    if (!rootManager)
+    {
+        return kFATAL;
+    }
+
+    // INPUT DATA, each one is optional
+    fFrsDataCA = (TClonesArray*)rootManager->GetObject("SofFrsData");
+    if (!fFrsDataCA)
+        LOG(WARNING) << "R3BSofPidSummaryTask::Init() SofFrsData not found, no FRS maps";
+    fTrackingDataCA = (TClonesArray*)rootManager->GetObject("SofTrackingData");
+    if (!fTrackingDataCA)
+        LOG(WARNING) << "R3BSofPidSummaryTask::Init() SofTrackingData not found, no fragment maps";
+    if (!fFrsDataCA && !fTrackingDataCA)
+    {
+        LOG(ERROR) << "R3BSofPidSummaryTask::Init() no input data";
+        return kFATAL;
+    }
+    if (fSourceName == "")
+        fSourceName = fOutputFile;
+    return kSUCCESS;
+}
+
+// -----   Public method Execution   --------------------------------------------
+void R3BSofPidSummaryTask::Exec(Option_t* option)
+{
+    fNumEvents++;
+    if (fFrsDataCA)
+    {
+        Int_t nHits = fFrsDataCA->GetEntriesFast();
+        for (Int_t i = 0; i < nHits; i++)
+        {
+            R3BSofFrsData* hit = (R3BSofFrsData*)fFrsDataCA->UncheckedAt(i);
+            if (hit->GetStaId() != fStaId || hit->GetStoId() != fStoId)
+                continue;
+            fSummary.Fill(kFrsZAq, hit->GetAq(), hit->GetZ());
+            fSummary.Fill(kFrsBetaZ, hit->GetZ(), hit->GetBeta());
+            fSummary.Fill(kFrsBrhoAq, hit->GetAq(), hit->GetBrho());
+            fSummary.Fill(kFrsXs2XC, hit->GetXS2(), hit->GetXCave());
+        }
+    }
+    if (fTrackingDataCA)
+    {
+        Int_t nHits = fTrackingDataCA->GetEntriesFast();
+        for (Int_t i = 0; i < nHits; i++)
+        {
+            R3BSofTrackingData* hit = (R3BSofTrackingData*)fTrackingDataCA->UncheckedAt(i);
+            fSummary.Fill(kFragZAq, hit->GetAq(), hit->GetZ());
+            fSummary.Fill(kFragBetaZ, hit->GetZ(), hit->GetBeta());
+            fSummary.Fill(kFragBrhoAq, hit->GetAq(), hit->GetBrho());
+        }
+    }
+}
+
+// -----   Public method Finish   -----------------------------------------------
+void R3BSofPidSummaryTask::Finish()
+{
+    fSummary.AddSource(fSourceName, fNumEvents);
+    if (fSummary.WriteFile(fOutputFile))
+        LOG(INFO) << "R3BSofPidSummaryTask: " << fNumEvents << " events of " << fSourceName << " in " << fOutputFile;
+}
+
+ClassImp(R3BSofPidSummaryTask)
@@ -0,0 +1,97 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                   R3BSofPidSummaryTask                     -----
+// -----      PID summary of a job, merged over the whole campaign  -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofPidSummaryTask_H
+#define R3BSofPidSummaryTask_H
+
+#include "FairTask.h"
+
+#include "R3BSofPidSummary.h"
+
+class TClonesArray;
+
+/**
+ * Fills a R3BSofPidSummary from SofFrsData (one ToF path) and
+ * SofTrackingData and writes it at the end of the job, in place of the
+ * histograms of R3BSofFrsFillTree/R3BSofFrsFragmentTree when only the PID
+ * of the whole campaign is needed:
+ *   R3BSofPidSummaryTask* summary = new R3BSofPidSummaryTask();
+ *   summary->SetOutputFile("run0273.sofpid");
+ *   summary->SetSourceName("run0273_0001.lmd");
+ *   summary->GetSummary().SetMap(R3BSofPidSummaryTask::kFrsZAq, 600, 2.3, 2.7, 400, 70., 95.);
+ *   run->AddTask(summary);
+ * and after the jobs:
+ *   sofia_pidmerge -o s467.sofpid -r s467_pid.root run*.sofpid
+ * The binning can be changed before Init, the files of a campaign must have
+ * the same one to be merged.
+ **/
+class R3BSofPidSummaryTask : public FairTask
+{
+  public:
+    /** Maps of the summary **/
+    enum EMap
+    {
+        kFrsZAq,     // Z vs A/q of the incoming isotope
+        kFrsBetaZ,   // beta vs Z
+        kFrsBrhoAq,  // Brho vs A/q
+        kFrsXs2XC,   // x at Cave C vs x at S2 [mm]
+        kFragZAq,    // Z vs A/q of the fragments
+        kFragBetaZ,  // beta vs Z
+        kFragBrhoAq, // Brho vs A/q
+        kNumMaps
+    };
+
+    /** Default constructor **/
+    R3BSofPidSummaryTask();
+
+    /** Standard constructor **/
+    R3BSofPidSummaryTask(const TString& name, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofPidSummaryTask();
+
+    /** Virtual method Exec **/
+    virtual void Exec(Option_t* option);
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Virtual method Finish **/
+    virtual void Finish();
+
+    /** Summary, to change the binning before Init **/
+    R3BSofPidSummary& GetSummary() { return fSummary; }
+
+    void SetOutputFile(const TString& filename) { fOutputFile = filename; }
+
+    /** Provenance of the job, by default the output file **/
+    void SetSourceName(const TString& name) { fSourceName = name; }
+
+    /** ToF path of SofFrsData, start and stop SofSci **/
+    void SetFrsPath(Int_t staId, Int_t stoId)
+    {
+        fStaId = staId;
+        fStoId = stoId;
+    }
+
+  private:
+    R3BSofPidSummary fSummary;
+    TString fOutputFile;
+    TString fSourceName;
+    Int_t fStaId, fStoId;
+
+    TClonesArray* fFrsDataCA;      /**< Array with FRS-input data. >*/
+    TClonesArray* fTrackingDataCA; /**< Array with Tracking-input data. >*/
+
+    ULong64_t fNumEvents;
+
+    void AddMaps();
+
+  public:
+    ClassDef(R3BSofPidSummaryTask, 1)
+};
+
+#endif
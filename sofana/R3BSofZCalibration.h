@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------
+// -----                                                            -----
+// -----                    R3BSofZCalibration                      -----
+// -----        Charge Z from the energy loss and the velocity      -----
+// ----------------------------------------------------------------------
+
+#ifndef R3BSofZCalibration_H
+#define R3BSofZCalibration_H
+
+#include "TArrayF.h"
+
+#include <cmath>
+#include <vector>
+
+/**
+ * Z as a polynomial of u = sqrt(E) * beta, the form of the hit parameters
+ * of R3B-Music and TWIM: Z = p0 + p1 * sqrt(E) * beta + p2 * E * beta^2 + ...
+ * Any order, the number of parameters of the containers. The coefficients
+ * are kept from the highest order for the Horner scheme.
+ * Header only, it is used by sofana and by the online spectra of sofonline,
+ * which is built first.
+ **/
+class R3BSofZCalibration
+{
+  public:
+    R3BSofZCalibration()
+        : fOrder(0)
+        , fCoefs(1, 0.)
+    {
+    }
+
+    /** Polynomial of n coefficients, coefs[k] of u^k **/
+    void SetPolynomial(Int_t n, const Double_t* coefs)
+    {
+        fOrder = n > 0 ? n - 1 : 0;
+        fCoefs.assign(fOrder + 1, 0.);
+        for (Int_t k = 0; coefs && k < n; k++)
+            fCoefs[fOrder - k] = coefs[k];
+    }
+
+    /** Polynomial from hit parameters (e.g. GetZHitPar(), GetNumParZFit()) **/
+    void SetPolynomial(const TArrayF* par, Int_t n, Int_t offset = 0)
+    {
+        std::vector<Double_t> coefs(n > 0 ? n : 1, 0.);
+        for (Int_t k = 0; par && k < n && offset + k < par->GetSize(); k++)
+            coefs[k] = par->GetAt(offset + k);
+        SetPolynomial(coefs.size(), coefs.data());
+    }
+
+    Int_t GetOrder() const { return fOrder; }
+
+    /** Z for u = sqrt(E) * beta **/
+    Double_t EvalU(Double_t u) const { return Horner(&fCoefs[0], u); }
+
+    /** Z for the energy loss E and the velocity beta **/
+    Double_t Eval(Double_t e, Double_t beta) const { return EvalU(std::sqrt(e) * beta); }
+
+    /** Z of n entries, z may be one of the inputs **/
+    void Eval(Int_t n, const Double_t* e, const Double_t* beta, Double_t* z) const
+    {
+        const Double_t* c = &fCoefs[0];
+        for (Int_t i = 0; i < n; i++)
+            z[i] = Horner(c, std::sqrt(e[i]) * beta[i]);
+    }
+
+  private:
+    Int_t fOrder;
+    std::vector<Double_t> fCoefs; // fOrder + 1, highest order first
+
+    Double_t Horner(const Double_t* c, Double_t u) const
+    {
+        Double_t z = c[0];
+        for (Int_t k = 1; k <= fOrder; k++)
+            z = std::fma(z, u, c[k]);
+        return z;
+    }
+};
+
+#endif
@@ -8,8 +8,17 @@
 
 #pragma link C++ class R3BSofFragmentAnalysis + ;
 #pragma link C++ class R3BSofFrsAnalysis + ;
+#pragma link C++ class R3BSofFrsIdKernel + ;
+#pragma link C++ class R3BSofPidGates + ;
+#pragma link C++ class R3BSofPidAnalysis + ;
+#pragma link C++ class R3BSofPidSummary + ;
+#pragma link C++ class R3BSofPidSummaryTask + ;
+#pragma link C++ class R3BSofEventFilter + ;
 #pragma link C++ class R3BSofFrsAnaPar + ;
 #pragma link C++ class R3BSofFragmentAnaPar + ;
+#pragma link C++ class R3BSofGladLookupPar + ;
+#pragma link C++ class R3BSofGladLookupBuilder + ;
 #pragma link C++ class R3BSofAnaContFact + ;
+#pragma link C++ class R3BSofParallelRun + ;
 
 #endif
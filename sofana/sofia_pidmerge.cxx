@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------
+// sofia_pidmerge: adds the PID summaries of the jobs of a campaign
+//
+// The inputs are the files written by R3BSofPidSummaryTask (or former
+// outputs of sofia_pidmerge, the merge is associative), all with the same
+// maps. They are read through mmap and added by several threads, each one
+// over a slice of the bins. The list of the sources with their number of
+// events is kept in the output.
+//
+// Usage:
+//   sofia_pidmerge [options] -o output.sofpid input.sofpid ...
+//   -o, --output FILE    merged summary (required)
+//   -j, --threads N      number of threads (number of cores)
+//   -r, --root FILE      also writes the maps as TH2D and the sources into a ROOT file
+//   -l, --list           prints the sources of the merged summary
+// ----------------------------------------------------------------------
+
+#include "R3BSofPidSummary.h"
+
+#include "TFile.h"
+#include "TH2D.h"
+#include "TList.h"
+#include "TObjString.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+
+static void Usage()
+{
+    fprintf(stderr,
+            "Usage: sofia_pidmerge [-j threads] [-r plots.root] [-l] -o output.sofpid input.sofpid ...\n");
+}
+
+// Maps as histograms and sources as strings "name events"
+static Bool_t WriteRoot(const R3BSofPidSummary& summary, const char* filename)
+{
+    TFile* file = TFile::Open(filename, "RECREATE");
+    if (!file || file->IsZombie())
+    {
+        fprintf(stderr, "sofia_pidmerge: cannot open %s\n", filename);
+        return kFALSE;
+    }
+    for (Int_t m = 0; m < summary.GetNumMaps(); m++)
+    {
+        TH2D* h = summary.GetHistogram(m);
+        h->SetDirectory(file);
+        h->Write();
+    }
+    TList sources;
+    sources.SetOwner(kTRUE);
+    for (Int_t s = 0; s < summary.GetNumSources(); s++)
+        sources.Add(new TObjString(Form("%s %llu", summary.GetSourceName(s), summary.GetSourceEvents(s))));
+    sources.Write("Sources", TObject::kSingleKey);
+    file->Close();
+    delete file;
+    return kTRUE;
+}
+
+int main(int argc, char** argv)
+{
+    TString output, rootFile;
+    Int_t nThreads = 0;
+    Bool_t list = kFALSE;
+
+    static const struct option longOptions[] = { { "output", required_argument, 0, 'o' },
+                                                 { "threads", required_argument, 0, 'j' },
+                                                 { "root", required_argument, 0, 'r' },
+                                                 { "list", no_argument, 0, 'l' },
+                                                 { "help", no_argument, 0, 'h' },
+                                                 { 0, 0, 0, 0 } };
+    Int_t c;
+    while ((c = getopt_long(argc, argv, "o:j:r:lh", longOptions, NULL)) != -1)
+    {
+        switch (c)
+        {
+            case 'o':
+                output = optarg;
+                break;
+            case 'j':
+                nThreads = atoi(optarg);
+                break;
+            case 'r':
+                rootFile = optarg;
+                break;
+            case 'l':
+                list = kTRUE;
+                break;
+            default:
+                Usage();
+                return c == 'h' ? 0 : 1;
+        }
+    }
+    std::vector<std::string> inputs;
+    for (Int_t i = optind; i < argc; i++)
+        inputs.push_back(argv[i]);
+    if (output == "" || inputs.empty())
+    {
+        Usage();
+        return 1;
+    }
+
+    TStopwatch timer;
+    timer.Start();
+    if (!R3BSofPidSummary::Merge(inputs, output, nThreads))
+        return 1;
+    timer.Stop();
+    printf("sofia_pidmerge: %zu files merged into %s in %.2f s\n", inputs.size(), output.Data(), timer.RealTime());
+
+    if (rootFile == "" && !list)
+        return 0;
+    R3BSofPidSummary summary;
+    if (!summary.ReadFile(output))
+        return 1;
+    if (list)
+    {
+        for (Int_t s = 0; s < summary.GetNumSources(); s++)
+            printf("%s %llu\n", summary.GetSourceName(s), summary.GetSourceEvents(s));
+        printf("total: %d sources, %llu events\n", summary.GetNumSources(), summary.GetNumEvents());
+    }
+    if (rootFile != "" && !WriteRoot(summary, rootFile))
+        return 1;
+    return 0;
+}
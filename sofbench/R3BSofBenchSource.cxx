@@ -0,0 +1,311 @@
+// ------------------------------------------------------------
+// -----                R3BSofBenchSource                 -----
+// -----   Synthetic mapped data of the SOFIA detectors   -----
+// ------------------------------------------------------------
+
+#include "R3BSofBenchSource.h"
+#include "R3BSofMwpcMappedData.h"
+#include "R3BSofSciMappedData.h"
+#include "R3BSofTofWFiredPaddles.h"
+#include "R3BSofTofWMappedData.h"
+#include "R3BSofTrimMappedData.h"
+#include "R3BSofTwimMappedData.h"
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+
+#include "TClonesArray.h"
+#include "TMath.h"
+#include "TString.h"
+
+// Pads of the planes 1 (X down), 2 (X up) and 3 (Y) of the MWPCs, as in the s467 parameters
+static const Int_t kMwpcPads[4][3] = { { 64, 0, 64 }, { 64, 64, 40 }, { 64, 64, 40 }, { 288, 0, 120 } };
+
+// Anodes of the MUSICs
+static const Int_t kTwimNumAnodes = 16;
+static const Int_t kTrimNumAnodes = 6;
+
+R3BSofBenchSource::R3BSofBenchSource()
+    : FairSource()
+    , fRandom(1)
+    , fSciNumDets(0)
+    , fSciNumTcalPars(1000)
+    , fTwimNumSections(0)
+    , fTrimNumSections(0)
+    , fMwpcNoise(0.)
+    , fTofWNumPaddles(0)
+    , fTofWMult(1.)
+    , fTofWNumTcalPars(1000)
+    , fNumEvents(0)
+    , fNumHits(0)
+    , fSciMappedData(new TClonesArray("R3BSofSciMappedData"))
+    , fTwimMappedData(new TClonesArray("R3BSofTwimMappedData"))
+    , fTrimMappedData(new TClonesArray("R3BSofTrimMappedData"))
+    , fTofWMappedData(new TClonesArray("R3BSofTofWMappedData"))
+    , fTofWFired(new R3BSofTofWFiredPaddles("SofTofWFiredPaddles"))
+{
+    for (Int_t s = 0; s < kNumStations; s++)
+    {
+        fSciId[s] = 0;
+        fSciMult[s] = 1.;
+    }
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+    {
+        fMwpcOn[m] = kFALSE;
+        fMwpcMappedData[m] = new TClonesArray("R3BSofMwpcMappedData");
+    }
+}
+
+R3BSofBenchSource::R3BSofBenchSource(UInt_t seed)
+    : FairSource()
+    , fRandom(seed)
+    , fSciNumDets(0)
+    , fSciNumTcalPars(1000)
+    , fTwimNumSections(0)
+    , fTrimNumSections(0)
+    , fMwpcNoise(0.)
+    , fTofWNumPaddles(0)
+    , fTofWMult(1.)
+    , fTofWNumTcalPars(1000)
+    , fNumEvents(0)
+    , fNumHits(0)
+    , fSciMappedData(new TClonesArray("R3BSofSciMappedData"))
+    , fTwimMappedData(new TClonesArray("R3BSofTwimMappedData"))
+    , fTrimMappedData(new TClonesArray("R3BSofTrimMappedData"))
+    , fTofWMappedData(new TClonesArray("R3BSofTofWMappedData"))
+    , fTofWFired(new R3BSofTofWFiredPaddles("SofTofWFiredPaddles"))
+{
+    for (Int_t s = 0; s < kNumStations; s++)
+    {
+        fSciId[s] = 0;
+        fSciMult[s] = 1.;
+    }
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+    {
+        fMwpcOn[m] = kFALSE;
+        fMwpcMappedData[m] = new TClonesArray("R3BSofMwpcMappedData");
+    }
+}
+
+R3BSofBenchSource::~R3BSofBenchSource()
+{
+    delete fSciMappedData;
+    delete fTwimMappedData;
+    delete fTrimMappedData;
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+        delete fMwpcMappedData[m];
+    delete fTofWMappedData;
+    delete fTofWFired;
+}
+
+void R3BSofBenchSource::EnableSci(Int_t numDets, Int_t idS2, Int_t idS8, Int_t idCaveC)
+{
+    fSciNumDets = numDets;
+    fSciId[kS2] = idS2;
+    fSciId[kS8] = idS8;
+    fSciId[kCaveC] = idCaveC;
+}
+
+void R3BSofBenchSource::EnableMwpc(Int_t mwpc)
+{
+    if (mwpc < 0 || mwpc >= kNumMwpcs)
+    {
+        LOG(ERROR) << "R3BSofBenchSource::EnableMwpc() there is no MWPC" << mwpc;
+        return;
+    }
+    fMwpcOn[mwpc] = kTRUE;
+}
+
+Bool_t R3BSofBenchSource::Init()
+{
+    FairRootManager* mgr = FairRootManager::Instance();
+    if (fSciNumDets > 0)
+        mgr->Register("SofSciMappedData", "SofSci", fSciMappedData, kFALSE);
+    if (fTwimNumSections > 0)
+        mgr->Register("TwimMappedData", "SofTwim", fTwimMappedData, kFALSE);
+    if (fTrimNumSections > 0)
+        mgr->Register("TrimMappedData", "SofTrim", fTrimMappedData, kFALSE);
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+        if (fMwpcOn[m])
+            mgr->Register(Form("Mwpc%dMappedData", m), Form("MWPC%d", m), fMwpcMappedData[m], kFALSE);
+    if (fTofWNumPaddles > 64)
+    {
+        LOG(ERROR) << "R3BSofBenchSource::Init() " << fTofWNumPaddles << " paddles in the TofW, at most 64";
+        return kFALSE;
+    }
+    if (fTofWNumPaddles > 0)
+    {
+        mgr->Register("SofTofWMappedData", "SofTofW", fTofWMappedData, kFALSE);
+        mgr->Register("SofTofWFiredPaddles", "SofTofW", fTofWFired, kFALSE);
+    }
+
+    LOG(INFO) << "R3BSofBenchSource::Init() " << fSciNumDets << " SofSci, " << fTwimNumSections
+              << " TWIM sections, " << fTrimNumSections << " Triple-MUSIC sections, MWPCs " << fMwpcOn[0]
+              << fMwpcOn[1] << fMwpcOn[2] << fMwpcOn[3] << ", " << fTofWNumPaddles << " TofW paddles";
+    return kTRUE;
+}
+
+Int_t R3BSofBenchSource::ReadEvent(UInt_t)
+{
+    Reset();
+    if (fSciNumDets > 0)
+        GenerateSci();
+    if (fTwimNumSections > 0)
+        GenerateTwim();
+    if (fTrimNumSections > 0)
+        GenerateTrim();
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+        if (fMwpcOn[m])
+            GenerateMwpc(m);
+    if (fTofWNumPaddles > 0)
+        GenerateTofW();
+
+    fNumEvents++;
+    fNumHits += fSciMappedData->GetEntriesFast() + fTwimMappedData->GetEntriesFast() +
+                fTrimMappedData->GetEntriesFast() + fTofWMappedData->GetEntriesFast();
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+        fNumHits += fMwpcMappedData[m]->GetEntriesFast();
+    return 0;
+}
+
+void R3BSofBenchSource::Close()
+{
+    LOG(INFO) << "R3BSofBenchSource: " << fNumEvents << " events, " << GetMeanHits() << " mapped hits per event";
+}
+
+void R3BSofBenchSource::Reset()
+{
+    fSciMappedData->Clear();
+    fTwimMappedData->Clear();
+    fTrimMappedData->Clear();
+    for (Int_t m = 0; m < kNumMwpcs; m++)
+        fMwpcMappedData[m]->Clear();
+    fTofWMappedData->Clear();
+    fTofWFired->Clear();
+}
+
+void R3BSofBenchSource::GenerateSci()
+{
+    // Coarse times in clock cycles of 5 ns, the pmts fire some cycles after the reference (pmt 3)
+    const UInt_t base = 1000 + fRandom.Integer(4000);
+    for (Int_t d = 1; d <= fSciNumDets; d++)
+    {
+        Int_t station = kS2;
+        if (d == fSciId[kCaveC])
+            station = kCaveC;
+        else if (d == fSciId[kS8])
+            station = kS8;
+        const UInt_t tc = base + 20 * d;
+
+        for (Int_t pmt = 1; pmt <= 2; pmt++)
+        {
+            const Int_t mult = (Int_t)fRandom.Poisson(fSciMult[station]);
+            for (Int_t h = 0; h < mult; h++)
+                new ((*fSciMappedData)[fSciMappedData->GetEntriesFast()])
+                    R3BSofSciMappedData(d, pmt, tc + fRandom.Integer(4), fRandom.Integer(fSciNumTcalPars));
+        }
+        new ((*fSciMappedData)[fSciMappedData->GetEntriesFast()])
+            R3BSofSciMappedData(d, 3, base, fRandom.Integer(fSciNumTcalPars));
+    }
+}
+
+void R3BSofBenchSource::GenerateTwim()
+{
+    // Drift times growing along the anodes, reference time on the anode after the last one
+    for (Int_t s = 0; s < fTwimNumSections; s++)
+    {
+        const Double_t t0 = fRandom.Gaus(2000., 200.);
+        for (Int_t a = 0; a < kTwimNumAnodes; a++)
+            new ((*fTwimMappedData)[fTwimMappedData->GetEntriesFast()])
+                R3BSofTwimMappedData(s,
+                                     a,
+                                     TMath::Nint(t0 + 300. * a + fRandom.Gaus(0., 20.)),
+                                     TMath::Nint(fRandom.Gaus(10000., 400.)),
+                                     kFALSE,
+                                     kFALSE);
+        new ((*fTwimMappedData)[fTwimMappedData->GetEntriesFast()])
+            R3BSofTwimMappedData(s, kTwimNumAnodes, 1000, 0, kFALSE, kFALSE);
+    }
+}
+
+void R3BSofBenchSource::GenerateTrim()
+{
+    // Anodes 1 to 6, then the reference time (7) and the trigger time (8)
+    for (Int_t s = 1; s <= fTrimNumSections; s++)
+    {
+        const Double_t t0 = fRandom.Gaus(2000., 200.);
+        for (Int_t a = 1; a <= kTrimNumAnodes; a++)
+            new ((*fTrimMappedData)[fTrimMappedData->GetEntriesFast()])
+                R3BSofTrimMappedData(s,
+                                     a,
+                                     TMath::Nint(t0 + 300. * a + fRandom.Gaus(0., 20.)),
+                                     TMath::Nint(fRandom.Gaus(8000., 300.)),
+                                     kFALSE,
+                                     kFALSE);
+        new ((*fTrimMappedData)[fTrimMappedData->GetEntriesFast()])
+            R3BSofTrimMappedData(s, kTrimNumAnodes + 1, 1000, 0, kFALSE, kFALSE);
+        new ((*fTrimMappedData)[fTrimMappedData->GetEntriesFast()])
+            R3BSofTrimMappedData(s, kTrimNumAnodes + 2, 900, 0, kFALSE, kFALSE);
+    }
+}
+
+void R3BSofBenchSource::GenerateMwpc(Int_t mwpc)
+{
+    // One track: the same position in both X planes, pads of 5 mm in X and Y
+    const Double_t x = fRandom.Uniform(3., kMwpcPads[mwpc][0] - 3.);
+    const Double_t y = fRandom.Uniform(3., kMwpcPads[mwpc][2] - 3.);
+    for (Int_t plane = 1; plane <= 3; plane++)
+    {
+        const Int_t numPads = kMwpcPads[mwpc][plane - 1];
+        if (numPads == 0)
+            continue;
+        const Double_t pos = plane == 3 ? y : x;
+        AddCluster(fMwpcMappedData[mwpc], plane, numPads, pos);
+        // pads around the pedestal, outside of the 5 pads of the cluster
+        const Int_t first = (Int_t)pos - 2;
+        const Int_t noise = (Int_t)fRandom.Poisson(fMwpcNoise);
+        for (Int_t n = 0; n < noise; n++)
+        {
+            Int_t pad = fRandom.Integer(numPads - 5);
+            if (pad >= first)
+                pad += 5;
+            new ((*fMwpcMappedData[mwpc])[fMwpcMappedData[mwpc]->GetEntriesFast()])
+                R3BSofMwpcMappedData(plane, pad, TMath::Nint(fRandom.Gaus(200., 10.)));
+        }
+    }
+}
+
+void R3BSofBenchSource::AddCluster(TClonesArray* array, Int_t plane, Int_t numPads, Double_t x)
+{
+    const Int_t center = (Int_t)x;
+    const Double_t amplitude = fRandom.Gaus(3000., 300.);
+    for (Int_t pad = TMath::Max(0, center - 2); pad <= TMath::Min(numPads - 1, center + 2); pad++)
+    {
+        const Double_t d = pad + 0.5 - x;
+        new ((*array)[array->GetEntriesFast()])
+            R3BSofMwpcMappedData(plane, pad, TMath::Nint(200. + amplitude * TMath::Exp(-0.5 * d * d)));
+    }
+}
+
+void R3BSofBenchSource::GenerateTofW()
+{
+    const Int_t mult = TMath::Min((Int_t)fRandom.Poisson(fTofWMult), fTofWNumPaddles);
+    const UInt_t base = 1000 + fRandom.Integer(4000);
+    for (Int_t h = 0; h < mult; h++)
+    {
+        Int_t paddle = fRandom.Integer(fTofWNumPaddles);
+        while (fTofWFired->IsFired(paddle))
+            paddle = (paddle + 1) % fTofWNumPaddles;
+        fTofWFired->SetFired(paddle);
+        for (Int_t pm = 1; pm <= 2; pm++)
+            new ((*fTofWMappedData)[fTofWMappedData->GetEntriesFast()])
+                R3BSofTofWMappedData(paddle + 1,
+                                     pm,
+                                     base + fRandom.Integer(4),
+                                     fRandom.Integer(fTofWNumTcalPars),
+                                     TMath::Nint(fRandom.Gaus(1000., 100.)),
+                                     kTRUE);
+    }
+}
+
+ClassImp(R3BSofBenchSource)
@@ -0,0 +1,120 @@
+// ------------------------------------------------------------
+// -----                R3BSofBenchSource                 -----
+// -----   Synthetic mapped data of the SOFIA detectors   -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofBenchSource_H
+#define R3BSofBenchSource_H
+
+#include "FairSource.h"
+#include "TRandom3.h"
+
+class TClonesArray;
+class R3BSofTofWFiredPaddles;
+
+/**
+ * Source of synthetic events for the benchmarks of the calibration tasks,
+ * used instead of the ucesb source. The mapped data branches of the enabled
+ * detectors are registered with the names of the sofsource readers:
+ *   SofSciMappedData, TwimMappedData, TrimMappedData, Mwpc0MappedData to
+ *   Mwpc3MappedData, SofTofWMappedData and SofTofWFiredPaddles.
+ *
+ * The data are random but shaped like the real ones (one track per event,
+ * all the anodes of the MUSICs, a cluster of pads per plane of the MWPCs,
+ * both pmts of the fired paddles of the TofW), so that every task down to
+ * the hit level finds something to do. The multiplicity of the SofSci is set
+ * per station, for the studies of the pile-up at S2 at high beam rates.
+ * The sequence of events only depends on the seed.
+ **/
+class R3BSofBenchSource : public FairSource
+{
+
+  public:
+    enum EStation
+    {
+        kS2 = 0,
+        kS8,
+        kCaveC,
+        kNumStations
+    };
+
+    /** Default constructor **/
+    R3BSofBenchSource();
+
+    /** Standard constructor **/
+    R3BSofBenchSource(UInt_t seed);
+
+    /** Destructor **/
+    virtual ~R3BSofBenchSource();
+
+    /** Detectors to generate, nothing by default **/
+    void EnableSci(Int_t numDets, Int_t idS2, Int_t idS8, Int_t idCaveC);
+    void EnableTwim(Int_t numSections = 1) { fTwimNumSections = numSections; }
+    void EnableTrim(Int_t numSections = 3) { fTrimNumSections = numSections; }
+    void EnableMwpc(Int_t mwpc); // 0 to 3
+    void EnableTofW(Int_t numPaddles = 28) { fTofWNumPaddles = numPaddles; }
+
+    /** Modifiers **/
+    void SetSciMultiplicity(EStation station, Double_t mean) { fSciMult[station] = mean; }
+    void SetSciNumTcalPars(Int_t n) { fSciNumTcalPars = n; }
+    void SetTofWMultiplicity(Double_t mean) { fTofWMult = mean; }
+    void SetTofWNumTcalPars(Int_t n) { fTofWNumTcalPars = n; }
+    void SetMwpcNoise(Double_t mean) { fMwpcNoise = mean; }
+
+    /** Hits generated per event, mean over the events read **/
+    Double_t GetMeanHits() const { return fNumEvents > 0 ? (Double_t)fNumHits / fNumEvents : 0.; }
+
+    /** Methods of FairSource **/
+    virtual Bool_t Init();
+    virtual Int_t ReadEvent(UInt_t = 0);
+    virtual void Close();
+    virtual void Reset();
+    virtual Source_Type GetSourceType() { return kONLINE; }
+    virtual void SetParUnpackers() {}
+    virtual Bool_t InitUnpackers() { return kTRUE; }
+    virtual Bool_t ReInitUnpackers() { return kTRUE; }
+
+  private:
+    static const Int_t kNumMwpcs = 4;
+
+    TRandom3 fRandom;
+
+    // SofSci, detectors 1-based, 0 when absent
+    Int_t fSciNumDets;
+    Int_t fSciId[kNumStations];
+    Double_t fSciMult[kNumStations]; // mean number of hits per pmt
+    Int_t fSciNumTcalPars;
+
+    Int_t fTwimNumSections;
+    Int_t fTrimNumSections;
+    Bool_t fMwpcOn[kNumMwpcs];
+    Double_t fMwpcNoise; // mean number of noisy pads per plane
+    Int_t fTofWNumPaddles;
+    Double_t fTofWMult; // mean number of fired paddles
+    Int_t fTofWNumTcalPars;
+
+    ULong64_t fNumEvents;
+    ULong64_t fNumHits;
+
+    TClonesArray* fSciMappedData;
+    TClonesArray* fTwimMappedData;
+    TClonesArray* fTrimMappedData;
+    TClonesArray* fMwpcMappedData[kNumMwpcs];
+    TClonesArray* fTofWMappedData;
+    R3BSofTofWFiredPaddles* fTofWFired;
+
+    void GenerateSci();
+    void GenerateTwim();
+    void GenerateTrim();
+    void GenerateMwpc(Int_t mwpc);
+    void GenerateTofW();
+    void AddCluster(TClonesArray* array, Int_t plane, Int_t numPads, Double_t x);
+
+    R3BSofBenchSource(const R3BSofBenchSource&);
+    R3BSofBenchSource& operator=(const R3BSofBenchSource&);
+
+  public:
+    ClassDef(R3BSofBenchSource, 0)
+};
+
+#endif
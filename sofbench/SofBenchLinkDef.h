@@ -0,0 +1,11 @@
+// clang-format off
+
+#ifdef __CINT__
+
+#pragma link off all globals;
+#pragma link off all classes;
+#pragma link off all functions;
+
+#pragma link C++ class R3BSofBenchSource + ;
+
+#endif
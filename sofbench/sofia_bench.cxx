@@ -0,0 +1,457 @@
+// ----------------------------------------------------------------------
+// sofia_bench: throughput of the SOFIA calibration tasks on synthetic data
+//
+// Every stage (one detector with its Mapped2Tcal/Mapped2Cal, Tcal2SingleTcal
+// and Cal2Hit tasks, or the whole chain of main_online.C) is run in a process
+// of its own on events of R3BSofBenchSource. The tasks are measured by
+// R3BSofTaskMonitor and the results are appended to the output file as JSON,
+// one line per task and one line per stage (task "all"), e.g.
+//   {"label":"v1.2","host":"lxg1234","stage":"sci","task":"R3BSofSciMapped2Tcal",
+//    "events":100000,"mean_ns":812.4,"median_ns":790.1,"p99_ns":1650.2,
+//    "hits_in":9.01,"hits_out":9.01,"ns_per_hit":90.2,"allocs":0.00}
+// Hits and allocations (calls of operator new) are per event. The times are
+// those of the tasks, events_per_s is the rate of the whole event loop, the
+// generation of the events included.
+//
+// Usage:
+//   sofia_bench [options] [stage ...]
+//   stages: sci twim trim mwpc0 mwpc1 mwpc2 mwpc3 tofw chain (default: all)
+//   -n, --events N       events per stage (100000)
+//   -p, --par FILE       parameter file ($VMCWORKDIR/sofia/macros/s467/parameters/CalibParam.par)
+//   -o, --output FILE    JSON lines, appended (sofia_bench.jsonl)
+//   -l, --label TEXT     label of the results, e.g. the release (none)
+//   -s, --seed N         seed of the generator (1)
+//       --sci N,S2,S8,C  number of SofSci and ids at S2, S8 and Cave C (4,2,3,4)
+//       --sci-mult S2,S8,C  mean hits per pmt of the SofSci at S2, S8 and Cave C (1,1,1)
+//       --tofw-mult M    mean fired paddles of the TofW (1)
+//       --mwpc-noise M   mean noisy pads per plane of the MWPCs (0)
+// The parameter file must have the containers of the stages which are run,
+// the Triple-MUSIC ones are not in the s467 file.
+// ----------------------------------------------------------------------
+
+#include "R3BSofBenchSource.h"
+#include "R3BSofTaskMonitor.h"
+
+#include "R3BSofMwpc0Cal2Hit.h"
+#include "R3BSofMwpc0Mapped2Cal.h"
+#include "R3BSofMwpc1Cal2Hit.h"
+#include "R3BSofMwpc1Mapped2Cal.h"
+#include "R3BSofMwpc2Cal2Hit.h"
+#include "R3BSofMwpc2Mapped2Cal.h"
+#include "R3BSofMwpc3Cal2Hit.h"
+#include "R3BSofMwpc3Mapped2Cal.h"
+#include "R3BSofSciMapped2Tcal.h"
+#include "R3BSofSciSingleTcal2Hit.h"
+#include "R3BSofSciTcal2SingleTcal.h"
+#include "R3BSofTofWMapped2Tcal.h"
+#include "R3BSofTofWSingleTCal2Hit.h"
+#include "R3BSofTofWTcal2SingleTcal.h"
+#include "R3BSofTrimCal2Hit.h"
+#include "R3BSofTrimMapped2Cal.h"
+#include "R3BSofTwimCal2Hit.h"
+#include "R3BSofTwimMapped2Cal.h"
+
+#include "FairLogger.h"
+#include "FairParAsciiFileIo.h"
+#include "FairRootFileSink.h"
+#include "FairRunOnline.h"
+#include "FairRuntimeDb.h"
+
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <new>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// --- Allocations of the process: replacement of the global operator new --- //
+
+static std::atomic<ULong64_t> gNumAllocations(0);
+
+void* operator new(size_t size)
+{
+    gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+static ULong64_t NumAllocations() { return gNumAllocations.load(std::memory_order_relaxed); }
+
+// --- Options --- //
+
+struct BenchOptions
+{
+    Long64_t events = 100000;
+    TString parFile;
+    TString output = "sofia_bench.jsonl";
+    TString label;
+    UInt_t seed = 1;
+    Int_t sci[4] = { 4, 2, 3, 4 }; // number of SofSci, ids at S2, S8 and Cave C
+    Double_t sciMult[3] = { 1., 1., 1. };
+    Double_t tofwMult = 1.;
+    Double_t mwpcNoise = 0.;
+};
+
+static const char* kStages[] = { "sci", "twim", "trim", "mwpc0", "mwpc1", "mwpc2", "mwpc3", "tofw", "chain" };
+static const Int_t kNumStages = sizeof(kStages) / sizeof(kStages[0]);
+
+static void Usage()
+{
+    fprintf(stderr,
+            "Usage: sofia_bench [-n events] [-p parfile] [-o output.jsonl] [-l label] [-s seed]\n"
+            "                   [--sci N,S2,S8,CaveC] [--sci-mult S2,S8,CaveC] [--tofw-mult M] [--mwpc-noise M]\n"
+            "                   [stage ...]\n"
+            "Stages: sci twim trim mwpc0 mwpc1 mwpc2 mwpc3 tofw chain (default: all)\n");
+}
+
+// --- Tasks of the stages --- //
+
+static Bool_t Has(const TString& stage, const char* detector) { return stage == "chain" || stage == detector; }
+
+static void AddSciTasks(FairRunOnline* run, Bool_t toHit)
+{
+    R3BSofSciMapped2Tcal* map2Tcal = new R3BSofSciMapped2Tcal();
+    map2Tcal->SetOnline(kTRUE);
+    run->AddTask(map2Tcal);
+
+    R3BSofSciTcal2SingleTcal* tcal2STcal = new R3BSofSciTcal2SingleTcal();
+    tcal2STcal->SetOnline(kTRUE);
+    run->AddTask(tcal2STcal);
+
+    if (!toHit)
+        return;
+    R3BSofSciSingleTcal2Hit* sTcal2Hit = new R3BSofSciSingleTcal2Hit();
+    sTcal2Hit->SetOnline(kTRUE);
+    sTcal2Hit->SetCalParams(675., -1922.); // ToF calibration at Cave C, as in main_online.C
+    run->AddTask(sTcal2Hit);
+}
+
+static void AddTasks(FairRunOnline* run, R3BSofBenchSource* source, const TString& stage, const BenchOptions& opt)
+{
+    // the ToF-Wall needs the SingleTcal data of the SofSci
+    if (Has(stage, "sci") || Has(stage, "tofw"))
+    {
+        source->EnableSci(opt.sci[0], opt.sci[1], opt.sci[2], opt.sci[3]);
+        AddSciTasks(run, Has(stage, "sci"));
+    }
+
+    if (Has(stage, "mwpc0"))
+    {
+        source->EnableMwpc(0);
+        R3BSofMwpc0Mapped2Cal* map2Cal = new R3BSofMwpc0Mapped2Cal();
+        map2Cal->SetOnline(kTRUE);
+        run->AddTask(map2Cal);
+        R3BSofMwpc0Cal2Hit* cal2Hit = new R3BSofMwpc0Cal2Hit();
+        cal2Hit->SetOnline(kTRUE);
+        run->AddTask(cal2Hit);
+    }
+
+    if (Has(stage, "mwpc1"))
+    {
+        source->EnableMwpc(1);
+        R3BSofMwpc1Mapped2Cal* map2Cal = new R3BSofMwpc1Mapped2Cal();
+        map2Cal->SetOnline(kTRUE);
+        run->AddTask(map2Cal);
+        R3BSofMwpc1Cal2Hit* cal2Hit = new R3BSofMwpc1Cal2Hit();
+        cal2Hit->SetOnline(kTRUE);
+        run->AddTask(cal2Hit);
+    }
+
+    if (Has(stage, "twim"))
+    {
+        source->EnableTwim();
+        R3BSofTwimMapped2Cal* map2Cal = new R3BSofTwimMapped2Cal();
+        map2Cal->SetOnline(kTRUE);
+        run->AddTask(map2Cal);
+        R3BSofTwimCal2Hit* cal2Hit = new R3BSofTwimCal2Hit();
+        cal2Hit->SetOnline(kTRUE);
+        run->AddTask(cal2Hit);
+    }
+
+    if (Has(stage, "trim"))
+    {
+        source->EnableTrim();
+        R3BSofTrimMapped2Cal* map2Cal = new R3BSofTrimMapped2Cal();
+        map2Cal->SetOnline(kTRUE);
+        run->AddTask(map2Cal);
+        R3BSofTrimCal2Hit* cal2Hit = new R3BSofTrimCal2Hit();
+        cal2Hit->SetOnline(kTRUE);
+        run->AddTask(cal2Hit);
+    }
+
+    if (Has(stage, "mwpc2"))
+    {
+        source->EnableMwpc(2);
+        R3BSofMwpc2Mapped2Cal* map2Cal = new R3BSofMwpc2Mapped2Cal();
+        map2Cal->SetOnline(kTRUE);
+        run->AddTask(map2Cal);
+        R3BSofMwpc2Cal2Hit* cal2Hit = new R3BSofMwpc2Cal2Hit();
+        cal2Hit->SetOnline(kTRUE);
+        run->AddTask(cal2Hit);
+    }
+
+    if (Has(stage, "mwpc3"))
+    {
+        source->EnableMwpc(3);
+        R3BSofMwpc3Mapped2Cal* map2Cal = new R3BSofMwpc3Mapped2Cal();
+        map2Cal->SetOnline(kTRUE);
+        run->AddTask(map2Cal);
+        R3BSofMwpc3Cal2Hit* cal2Hit = new R3BSofMwpc3Cal2Hit();
+        cal2Hit->SetOnline(kTRUE);
+        run->AddTask(cal2Hit);
+    }
+
+    if (Has(stage, "tofw"))
+    {
+        source->EnableTofW();
+        R3BSofTofWMapped2Tcal* map2Tcal = new R3BSofTofWMapped2Tcal();
+        map2Tcal->SetOnline(kTRUE);
+        run->AddTask(map2Tcal);
+        R3BSofTofWTcal2SingleTcal* tcal2STcal = new R3BSofTofWTcal2SingleTcal();
+        tcal2STcal->SetOnline(kTRUE);
+        run->AddTask(tcal2STcal);
+        R3BSofTofWSingleTCal2Hit* sTcal2Hit = new R3BSofTofWSingleTCal2Hit();
+        sTcal2Hit->SetOnline(kTRUE);
+        sTcal2Hit->SetExpId(467);
+        run->AddTask(sTcal2Hit);
+    }
+}
+
+// --- One stage, run in a child process --- //
+
+static Int_t RunStage(const TString& stage, const BenchOptions& opt)
+{
+    R3BSofBenchSource* source = new R3BSofBenchSource(opt.seed);
+    source->SetSciMultiplicity(R3BSofBenchSource::kS2, opt.sciMult[0]);
+    source->SetSciMultiplicity(R3BSofBenchSource::kS8, opt.sciMult[1]);
+    source->SetSciMultiplicity(R3BSofBenchSource::kCaveC, opt.sciMult[2]);
+    source->SetTofWMultiplicity(opt.tofwMult);
+    source->SetMwpcNoise(opt.mwpcNoise);
+
+    FairRunOnline* run = new FairRunOnline(source);
+    run->SetRunId(1);
+    run->SetSink(new FairRootFileSink("/dev/null"));
+
+    FairRuntimeDb* rtdb = run->GetRuntimeDb();
+    FairParAsciiFileIo* parIo = new FairParAsciiFileIo();
+    parIo->open(opt.parFile, "in");
+    rtdb->setFirstInput(parIo);
+
+    AddTasks(run, source, stage, opt);
+    R3BSofTaskMonitor* monitor = new R3BSofTaskMonitor("SofBenchMonitor", 0);
+    monitor->SetUpdateInterval(0);
+    monitor->Instrument(run);
+    R3BSofTaskMonitor::SetAllocationCounter(&NumAllocations);
+
+    run->Init();
+    FairLogger::GetLogger()->SetLogScreenLevel("WARNING");
+
+    TStopwatch timer;
+    timer.Start();
+    run->Run(0, opt.events);
+    timer.Stop();
+
+    // --- Results --- //
+    const TString head = Form("{\"label\":\"%s\",\"host\":\"%s\",\"stage\":\"%s\"",
+                              opt.label.Data(),
+                              gSystem->HostName(),
+                              stage.Data());
+    TString lines;
+    Double_t totalNs = 0.;
+    ULong64_t totalAllocations = 0;
+    for (Int_t t = 0; t < monitor->GetNumTasks(); t++)
+    {
+        const Double_t n = monitor->GetNumExecs(t);
+        if (n == 0)
+            continue;
+        const Double_t hitsIn = monitor->GetHitsIn(t) / n;
+        totalNs += monitor->GetTotalTime(t);
+        totalAllocations += monitor->GetAllocations(t);
+        lines += head;
+        lines += Form(",\"task\":\"%s\",\"events\":%.0f,\"mean_ns\":%.1f,\"median_ns\":%.1f,\"p99_ns\":%.1f,"
+                      "\"hits_in\":%.2f,\"hits_out\":%.2f,\"ns_per_hit\":%.1f,\"allocs\":%.2f}\n",
+                      monitor->GetTask(t)->GetName(),
+                      n,
+                      monitor->GetTotalTime(t) / n,
+                      monitor->Quantile(t, 0.5) * 1000.,
+                      monitor->Quantile(t, 0.99) * 1000.,
+                      hitsIn,
+                      monitor->GetHitsOut(t) / n,
+                      hitsIn > 0. ? monitor->GetTotalTime(t) / n / hitsIn : 0.,
+                      monitor->GetAllocations(t) / n);
+    }
+    const Double_t hits = source->GetMeanHits();
+    lines += head;
+    lines += Form(",\"task\":\"all\",\"events\":%lld,\"events_per_s\":%.0f,\"mean_ns\":%.1f,"
+                  "\"hits_in\":%.2f,\"ns_per_hit\":%.1f,\"allocs\":%.2f}\n",
+                  opt.events,
+                  opt.events / timer.RealTime(),
+                  totalNs / opt.events,
+                  hits,
+                  hits > 0. ? totalNs / opt.events / hits : 0.,
+                  (Double_t)totalAllocations / opt.events);
+
+    FILE* out = fopen(opt.output, "a");
+    if (!out)
+    {
+        LOG(ERROR) << "sofia_bench: cannot open " << opt.output;
+        return 1;
+    }
+    fputs(lines.Data(), out);
+    fclose(out);
+    printf("%s", lines.Data());
+    return 0;
+}
+
+// --- Main --- //
+
+static Bool_t ParseList(const char* arg, Double_t* values, Int_t n)
+{
+    std::string s(arg);
+    size_t pos = 0;
+    for (Int_t i = 0; i < n; i++)
+    {
+        size_t end = s.find(',', pos);
+        if ((end == std::string::npos) != (i == n - 1))
+            return kFALSE;
+        values[i] = atof(s.substr(pos, end - pos).c_str());
+        pos = end + 1;
+    }
+    return kTRUE;
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions opt;
+    opt.parFile = TString(gSystem->Getenv("VMCWORKDIR")) + "/sofia/macros/s467/parameters/CalibParam.par";
+
+    enum
+    {
+        kOptSci = 256,
+        kOptSciMult,
+        kOptTofWMult,
+        kOptMwpcNoise
+    };
+    static const struct option longOptions[] = { { "events", required_argument, 0, 'n' },
+                                                 { "par", required_argument, 0, 'p' },
+                                                 { "output", required_argument, 0, 'o' },
+                                                 { "label", required_argument, 0, 'l' },
+                                                 { "seed", required_argument, 0, 's' },
+                                                 { "sci", required_argument, 0, kOptSci },
+                                                 { "sci-mult", required_argument, 0, kOptSciMult },
+                                                 { "tofw-mult", required_argument, 0, kOptTofWMult },
+                                                 { "mwpc-noise", required_argument, 0, kOptMwpcNoise },
+                                                 { "help", no_argument, 0, 'h' },
+                                                 { 0, 0, 0, 0 } };
+    Int_t c;
+    Double_t sci[4];
+    while ((c = getopt_long(argc, argv, "n:p:o:l:s:h", longOptions, NULL)) != -1)
+    {
+        switch (c)
+        {
+            case 'n':
+                opt.events = atoll(optarg);
+                break;
+            case 'p':
+                opt.parFile = optarg;
+                break;
+            case 'o':
+                opt.output = optarg;
+                break;
+            case 'l':
+                opt.label = optarg;
+                break;
+            case 's':
+                opt.seed = strtoul(optarg, NULL, 0);
+                break;
+            case kOptSci:
+                if (!ParseList(optarg, sci, 4))
+                {
+                    Usage();
+                    return 1;
+                }
+                for (Int_t i = 0; i < 4; i++)
+                    opt.sci[i] = (Int_t)sci[i];
+                break;
+            case kOptSciMult:
+                if (!ParseList(optarg, opt.sciMult, 3))
+                {
+                    Usage();
+                    return 1;
+                }
+                break;
+            case kOptTofWMult:
+                opt.tofwMult = atof(optarg);
+                break;
+            case kOptMwpcNoise:
+                opt.mwpcNoise = atof(optarg);
+                break;
+            default:
+                Usage();
+                return c == 'h' ? 0 : 1;
+        }
+    }
+    if (opt.events < 1)
+    {
+        Usage();
+        return 1;
+    }
+
+    std::vector<TString> stages;
+    for (Int_t i = optind; i < argc; i++)
+    {
+        Bool_t known = kFALSE;
+        for (Int_t s = 0; s < kNumStages; s++)
+            known |= (strcmp(argv[i], kStages[s]) == 0);
+        if (!known)
+        {
+            fprintf(stderr, "sofia_bench: unknown stage %s\n", argv[i]);
+            Usage();
+            return 1;
+        }
+        stages.push_back(argv[i]);
+    }
+    if (stages.empty())
+        for (Int_t s = 0; s < kNumStages; s++)
+            stages.push_back(kStages[s]);
+
+    // One process per stage: FairRun and FairRootManager are singletons
+    Int_t failed = 0;
+    for (size_t s = 0; s < stages.size(); s++)
+    {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            perror("sofia_bench: fork");
+            return 1;
+        }
+        if (pid == 0)
+            _exit(RunStage(stages[s], opt));
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            fprintf(stderr, "sofia_bench: stage %s failed\n", stages[s].Data());
+            failed++;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
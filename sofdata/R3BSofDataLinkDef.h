@@ -24,10 +24,12 @@
 #pragma link C++ class R3BSofMwpcMappedData + ;
 #pragma link C++ class R3BSofMwpcCalData + ;
 #pragma link C++ class R3BSofMwpcHitData + ;
+#pragma link C++ class R3BSofMwpcPadImage + ;
 
 #pragma link C++ class R3BSofTofWMappedData + ;
 #pragma link C++ class R3BSofTofWTcalData + ;
 #pragma link C++ class R3BSofTofWSingleTcalData + ;
+#pragma link C++ class R3BSofTofWFiredPaddles + ;
 #pragma link C++ class R3BSofTofWCalData + ;
 #pragma link C++ class R3BSofTofWHitData + ;
 
@@ -40,6 +42,7 @@
 #pragma link C++ class R3BSofTwimHitData + ;
 #pragma link C++ class R3BSofFrsData + ;
 #pragma link C++ class R3BSofTrackingData + ;
+#pragma link C++ class R3BSofPidData + ;
 
 #pragma link C++ class R3BSofScalersMappedData + ;
 
@@ -0,0 +1,96 @@
+// -------------------------------------------------------------------------
+// -----                     R3BSofMwpcPadImage source file            -----
+// -------------------------------------------------------------------------
+
+#include "R3BSofMwpcPadImage.h"
+
+// -----   Default constructor   -------------------------------------------
+R3BSofMwpcPadImage::R3BSofMwpcPadImage()
+    : TNamed()
+    , fNumPads(0)
+    , fSize(0)
+    , fNumWords(0)
+    , fNumFired(0)
+    , fQ(NULL)
+    , fFired(NULL)
+{
+    for (Int_t p = 0; p < kNumPlanes; p++)
+    {
+        fNumPadsPlane[p] = 0;
+        fOffset[p] = 0;
+    }
+}
+// -------------------------------------------------------------------------
+
+// -----   Standard constructor   ------------------------------------------
+R3BSofMwpcPadImage::R3BSofMwpcPadImage(const char* name, Int_t pads1, Int_t pads2, Int_t pads3)
+    : TNamed(name, name)
+    , fNumPads(0)
+    , fSize(0)
+    , fNumWords(0)
+    , fNumFired(0)
+    , fQ(NULL)
+    , fFired(NULL)
+{
+    SetPlanes(pads1, pads2, pads3);
+}
+// -------------------------------------------------------------------------
+
+// -----   Destructor   ----------------------------------------------------
+R3BSofMwpcPadImage::~R3BSofMwpcPadImage()
+{
+    if (fQ)
+        delete[] fQ;
+    if (fFired)
+        delete[] fFired;
+}
+// -------------------------------------------------------------------------
+
+// -----   Public method SetPlanes   ---------------------------------------
+void R3BSofMwpcPadImage::SetPlanes(Int_t pads1, Int_t pads2, Int_t pads3)
+{
+    fNumPadsPlane[0] = pads1;
+    fNumPadsPlane[1] = pads2;
+    fNumPadsPlane[2] = pads3;
+    fOffset[0] = 0;
+    fOffset[1] = pads1;
+    fOffset[2] = pads1 + pads2;
+    fNumPads = pads1 + pads2 + pads3;
+    fSize = (fNumPads + 7) & ~7;
+    fNumWords = (fSize + 63) >> 6;
+
+    if (fQ)
+        delete[] fQ;
+    if (fFired)
+        delete[] fFired;
+    fQ = new Int_t[fSize];
+    fFired = new ULong64_t[fNumWords];
+
+    for (Int_t i = 0; i < fSize; i++)
+        fQ[i] = kEmpty;
+    for (Int_t w = 0; w < fNumWords; w++)
+        fFired[w] = 0;
+    fNumFired = 0;
+}
+// -------------------------------------------------------------------------
+
+// -----   Public method Clear   -------------------------------------------
+void R3BSofMwpcPadImage::Clear(Option_t*)
+{
+    // Only the fired pads are reset
+    for (Int_t w = 0; w < fNumWords && fNumFired > 0; w++)
+    {
+        ULong64_t bits = fFired[w];
+        while (bits)
+        {
+            fQ[(w << 6) + __builtin_ctzll(bits)] = kEmpty;
+            bits &= bits - 1;
+            fNumFired--;
+        }
+        fFired[w] = 0;
+    }
+    fNumFired = 0;
+}
+// -------------------------------------------------------------------------
+
+ClassImp(R3BSofMwpcPadImage)
@@ -0,0 +1,92 @@
+#ifndef R3BSofMwpcPadImage_H
+#define R3BSofMwpcPadImage_H
+#include "TNamed.h"
+
+/**
+ * Dense image of the pad charges of one MWPC.
+ * The planes are stored one after the other (plane 1, plane 2, plane 3), so
+ * that the index of a pad matches the index of its calibration parameters.
+ * Pads without signal hold kEmpty, a large negative value which never passes
+ * the zero suppression. The fired pads are tracked in a bitmap to reset the
+ * image at the end of each event.
+ **/
+class R3BSofMwpcPadImage : public TNamed
+{
+
+  public:
+    enum
+    {
+        kNumPlanes = 3,
+        kEmpty = -0x40000000
+    };
+
+    /** Default constructor **/
+    R3BSofMwpcPadImage();
+
+    /** Constructor with arguments
+     *@param name    Name of the image, e.g. Mwpc0PadImage
+     *@param pads1   Number of pads in plane 1
+     *@param pads2   Number of pads in plane 2
+     *@param pads3   Number of pads in plane 3
+     **/
+    R3BSofMwpcPadImage(const char* name, Int_t pads1, Int_t pads2, Int_t pads3);
+
+    /** Destructor **/
+    virtual ~R3BSofMwpcPadImage();
+
+    /** Method to set up the planes, clears the image **/
+    void SetPlanes(Int_t pads1, Int_t pads2, Int_t pads3);
+
+    /** Reset of the fired pads **/
+    virtual void Clear(Option_t* option = "");
+
+    /** Accessors **/
+    inline Int_t GetNumPads() const { return fNumPads; }
+    inline Int_t GetNumPads(Int_t plane) const { return fNumPadsPlane[plane - 1]; }
+    inline Int_t GetNumFired() const { return fNumFired; }
+    inline Int_t GetIndex(Int_t plane, Int_t pad) const { return fOffset[plane - 1] + pad; }
+    inline Int_t GetPlane(Int_t index) const
+    {
+        return index < fOffset[1] ? 1 : (index < fOffset[2] ? 2 : 3);
+    }
+    inline Int_t GetPad(Int_t index) const { return index - fOffset[GetPlane(index) - 1]; }
+    inline Bool_t IsValid(Int_t plane, Int_t pad) const
+    {
+        return plane > 0 && plane <= kNumPlanes && pad >= 0 && pad < fNumPadsPlane[plane - 1];
+    }
+    inline Bool_t IsFired(Int_t index) const { return (fFired[index >> 6] >> (index & 63)) & 1; }
+    inline Int_t GetQ(Int_t index) const { return fQ[index]; }
+    /** Charges of all pads, padded with kEmpty up to a multiple of 8 **/
+    inline const Int_t* GetQArray() const { return fQ; }
+    inline const ULong64_t* GetFiredBitmap() const { return fFired; }
+    inline Int_t GetNumWords() const { return fNumWords; }
+
+    /** Modifiers **/
+    inline void SetQ(Int_t plane, Int_t pad, Int_t charge) { SetQ(GetIndex(plane, pad), charge); }
+    inline void SetQ(Int_t index, Int_t charge)
+    {
+        ULong64_t bit = 1ULL << (index & 63);
+        fNumFired += !(fFired[index >> 6] & bit);
+        fFired[index >> 6] |= bit;
+        fQ[index] = charge;
+    }
+
+  protected:
+    Int_t fNumPadsPlane[kNumPlanes];
+    Int_t fOffset[kNumPlanes];
+    Int_t fNumPads;
+    Int_t fSize;     // Allocated size, multiple of 8
+    Int_t fNumWords; // Words of the fired-pad bitmap
+    Int_t fNumFired;
+    Int_t* fQ;          //[fSize]
+    ULong64_t* fFired;  //[fNumWords]
+
+  private:
+    R3BSofMwpcPadImage(const R3BSofMwpcPadImage&);
+    R3BSofMwpcPadImage& operator=(const R3BSofMwpcPadImage&);
+
+  public:
+    ClassDef(R3BSofMwpcPadImage, 1)
+};
+
+#endif
@@ -0,0 +1,30 @@
+// ---------------------------------------------------------------------------
+// -----                                                                 -----
+// -----                      R3BSofPidData                              -----
+// -----           Isotope selected by the PID gates of sofana           -----
+// -----                                                                 -----
+// ---------------------------------------------------------------------------
+
+#include "R3BSofPidData.h"
+
+R3BSofPidData::R3BSofPidData()
+    : fIsotope(-1)
+    , fSource(0)
+    , fIndex(0)
+    , fZ(0.)
+    , fAq(0.)
+{
+}
+
+//------------------------------
+
+R3BSofPidData::R3BSofPidData(Int_t isotope, Int_t source, Int_t index, Double_t z, Double_t aq)
+    : fIsotope(isotope)
+    , fSource(source)
+    , fIndex(index)
+    , fZ(z)
+    , fAq(aq)
+{
+}
+
+ClassImp(R3BSofPidData)
@@ -0,0 +1,46 @@
+// ---------------------------------------------------------------------------
+// -----                                                                 -----
+// -----                      R3BSofPidData                              -----
+// -----           Isotope selected by the PID gates of sofana           -----
+// -----                                                                 -----
+// ---------------------------------------------------------------------------
+
+#ifndef R3BSofPidData_H
+#define R3BSofPidData_H
+#include "TObject.h"
+
+class R3BSofPidData : public TObject
+{
+
+  public:
+    // Default Constructor
+    R3BSofPidData();
+
+    /** Standard Constructor
+     *@param isotope  Id of the isotope given with the gate
+     *@param source   0: SofFrsData, 1: SofTrackingData
+     *@param index    Index of the entry in the source array
+     *@param z        Z of the entry
+     *@param aq       A/q of the entry
+     **/
+    R3BSofPidData(Int_t isotope, Int_t source, Int_t index, Double_t z, Double_t aq);
+
+    // Destructor
+    virtual ~R3BSofPidData() {}
+
+    // Getters
+    inline const Int_t GetIsotope() const { return fIsotope; }
+    inline const Int_t GetSource() const { return fSource; }
+    inline const Int_t GetIndex() const { return fIndex; }
+    inline const Double_t GetZ() const { return fZ; }
+    inline const Double_t GetAq() const { return fAq; }
+
+  protected:
+    Int_t fIsotope, fSource, fIndex;
+    Double_t fZ, fAq;
+
+  public:
+    ClassDef(R3BSofPidData, 1)
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "R3BSofTofWFiredPaddles.h"
+
+R3BSofTofWFiredPaddles::R3BSofTofWFiredPaddles()
+    : TNamed()
+    , fMask(0)
+{
+}
+
+R3BSofTofWFiredPaddles::R3BSofTofWFiredPaddles(const char* name)
+    : TNamed(name, name)
+    , fMask(0)
+{
+}
+ClassImp(R3BSofTofWFiredPaddles)
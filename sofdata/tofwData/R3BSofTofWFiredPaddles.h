@@ -0,0 +1,42 @@
+#ifndef R3BSOFTOFWFIREDPADDLES_H
+#define R3BSOFTOFWFIREDPADDLES_H
+
+#include "TNamed.h"
+
+/**
+ * Bitmask of the paddles of the ToF wall with at least one hit in the event,
+ * bit d for the paddle d+1. It is filled by the reader and registered as
+ * SofTofWFiredPaddles, so that the next stages only loop over the fired
+ * paddles:
+ *   for (ULong64_t m = fired->GetMask(); m; m &= m - 1)
+ *       Int_t d = __builtin_ctzll(m); // 0-based
+ **/
+class R3BSofTofWFiredPaddles : public TNamed
+{
+  public:
+    // Default Constructor
+    R3BSofTofWFiredPaddles();
+
+    // Standard Constructor
+    R3BSofTofWFiredPaddles(const char* name);
+
+    // Destructor
+    virtual ~R3BSofTofWFiredPaddles() {}
+
+    // Getters
+    inline ULong64_t GetMask() const { return fMask; }
+    inline Bool_t IsFired(Int_t paddle) const { return (fMask >> paddle) & 1; }
+    inline Int_t GetNumFired() const { return __builtin_popcountll(fMask); }
+
+    // Modifiers, paddle is 0-based (at most 64 paddles)
+    inline void SetFired(Int_t paddle) { fMask |= 1ULL << paddle; }
+    virtual void Clear(Option_t* option = "") { fMask = 0; }
+
+  private:
+    ULong64_t fMask;
+
+  public:
+    ClassDef(R3BSofTofWFiredPaddles, 1)
+};
+
+#endif
@@ -5,14 +5,26 @@ R3BSofTofWSingleTcalData::R3BSofTofWSingleTcalData()
     , fRawTimeNs(0.)
     , fRawTofNs(0.)
     , fRawPosNs(0.)
+    , fRank(0)
+    , fEnergyUp(0)
+    , fEnergyDown(0)
 {
 }
 
-R3BSofTofWSingleTcalData::R3BSofTofWSingleTcalData(Int_t detector, Double_t time, Double_t tof, Double_t pos)
+R3BSofTofWSingleTcalData::R3BSofTofWSingleTcalData(Int_t detector,
+                                                   Double_t time,
+                                                   Double_t tof,
+                                                   Double_t pos,
+                                                   Int_t rank,
+                                                   UInt_t eUp,
+                                                   UInt_t eDown)
     : fDetector(detector)
     , fRawTimeNs(time)
     , fRawTofNs(tof)
     , fRawPosNs(pos)
+    , fRank(rank)
+    , fEnergyUp(eUp)
+    , fEnergyDown(eDown)
 {
 }
 ClassImp(R3BSofTofWSingleTcalData)
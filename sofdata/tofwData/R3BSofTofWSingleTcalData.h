@@ -10,7 +10,13 @@ class R3BSofTofWSingleTcalData : public TObject
     R3BSofTofWSingleTcalData();
 
     // Standard Constructor
-    R3BSofTofWSingleTcalData(Int_t plastic, Double_t time, Double_t tof, Double_t pos);
+    R3BSofTofWSingleTcalData(Int_t plastic,
+                             Double_t time,
+                             Double_t tof,
+                             Double_t pos,
+                             Int_t rank = 0,
+                             UInt_t eUp = 0,
+                             UInt_t eDown = 0);
 
     // Destructor
     virtual ~R3BSofTofWSingleTcalData() {}
@@ -20,21 +26,33 @@ class R3BSofTofWSingleTcalData : public TObject
     inline const Double_t& GetRawTofNs() const { return fRawTofNs; }
     inline const Double_t& GetRawTimeNs() const { return fRawTimeNs; }
     inline const Double_t& GetRawPosNs() const { return fRawPosNs; }
+    inline const Int_t& GetRank() const { return fRank; }
+    inline const UInt_t& GetEnergyUp() const { return fEnergyUp; }
+    inline const UInt_t& GetEnergyDown() const { return fEnergyDown; }
 
     // Modifiers
     void SetDetector(Int_t det) { fDetector = det; }
     void SetRawTimeNs(Double_t time) { fRawTimeNs = time; }
     void SetRawPosNs(Double_t pos) { fRawPosNs = pos; }
     void SetRawTofNs(Double_t tof) { fRawTofNs = tof; }
+    void SetRank(Int_t rank) { fRank = rank; }
+    void SetEnergies(UInt_t eUp, UInt_t eDown)
+    {
+        fEnergyUp = eUp;
+        fEnergyDown = eDown;
+    }
 
   private:
     Int_t fDetector; // 1..28
     Double_t fRawTofNs;
     Double_t fRawPosNs; // RawTimeDOWN - RawTimeUP
     Double_t fRawTimeNs;
+    Int_t fRank; // 0 for the best candidate of the paddle
+    UInt_t fEnergyUp;
+    UInt_t fEnergyDown;
 
   public:
-    ClassDef(R3BSofTofWSingleTcalData, 2)
+    ClassDef(R3BSofTofWSingleTcalData, 4)
 };
 
 #endif
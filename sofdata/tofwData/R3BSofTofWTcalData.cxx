@@ -4,13 +4,15 @@ R3BSofTofWTcalData::R3BSofTofWTcalData()
     : fDetector(0)
     , fPmt(0)
     , fRawTimeNs(0)
+    , fEnergy(0)
 {
 }
 
-R3BSofTofWTcalData::R3BSofTofWTcalData(UShort_t detector, UShort_t pmt, Double_t tns)
+R3BSofTofWTcalData::R3BSofTofWTcalData(UShort_t detector, UShort_t pmt, Double_t tns, UInt_t energy)
     : fDetector(detector)
     , fPmt(pmt)
     , fRawTimeNs(tns)
+    , fEnergy(energy)
 {
 }
 ClassImp(R3BSofTofWTcalData)
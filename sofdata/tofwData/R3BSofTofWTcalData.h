@@ -10,7 +10,7 @@ class R3BSofTofWTcalData : public TObject
     R3BSofTofWTcalData();
 
     // Standard Constructor
-    R3BSofTofWTcalData(UShort_t detector, UShort_t pmt, Double_t t);
+    R3BSofTofWTcalData(UShort_t detector, UShort_t pmt, Double_t t, UInt_t energy = 0);
 
     // Destructor
     virtual ~R3BSofTofWTcalData() {}
@@ -19,14 +19,16 @@ class R3BSofTofWTcalData : public TObject
     inline const UShort_t& GetDetector() const { return fDetector; }
     inline const UShort_t& GetPmt() const { return fPmt; }
     inline const Double_t& GetRawTimeNs() const { return fRawTimeNs; }
+    inline const UInt_t& GetEnergy() const { return fEnergy; }
 
   private:
     UShort_t fDetector; // 1..28
     UShort_t fPmt;      // 1..3
     Double_t fRawTimeNs;
+    UInt_t fEnergy; // from the mapped data, for the walk correction
 
   public:
-    ClassDef(R3BSofTofWTcalData, 2)
+    ClassDef(R3BSofTofWTcalData, 3)
 };
 
 #endif
@@ -9,6 +9,9 @@
  */
 
 #include "R3BAmsCorrelationOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BAmsHitData.h"
 #include "R3BCalifaHitData.h"
 #include "R3BEventHeader.h"
@@ -53,6 +56,22 @@ R3BAmsCorrelationOnlineSpectra::R3BAmsCorrelationOnlineSpectra()
     , fMinProtonE(50000.)
     , fHitCalifaHist_bins(500)
     , fHitCalifaHist_max(4000)
+    , fs_Ams_hit_Pos()
+    , fs_Ams_hit_E()
+    , fs_Ams_hit_E_theta()
+    , fs_Ams_hit_Mul()
+    , fs2_ams_theta_phi()
+    , fs2_ams_e1_e2()
+    , fs2_ams_theta1_theta2()
+    , fs2_ams_phi1_phi2()
+    , fs1_Califa_MultHit(NULL)
+    , fs2_Califa_coinE(NULL)
+    , fs2_Califa_coinTheta(NULL)
+    , fs2_Califa_coinPhi(NULL)
+    , fs2_Califa_theta_phi(NULL)
+    , fs2_Califa_theta_energy(NULL)
+    , fs1_Califa_total_energy(NULL)
+    , fs1_openangle(NULL)
 {
 }
 
@@ -69,6 +88,22 @@ R3BAmsCorrelationOnlineSpectra::R3BAmsCorrelationOnlineSpectra(const TString& na
     , fMinProtonE(50000.)
     , fHitCalifaHist_bins(500)
     , fHitCalifaHist_max(4000)
+    , fs_Ams_hit_Pos()
+    , fs_Ams_hit_E()
+    , fs_Ams_hit_E_theta()
+    , fs_Ams_hit_Mul()
+    , fs2_ams_theta_phi()
+    , fs2_ams_e1_e2()
+    , fs2_ams_theta1_theta2()
+    , fs2_ams_phi1_phi2()
+    , fs1_Califa_MultHit(NULL)
+    , fs2_Califa_coinE(NULL)
+    , fs2_Califa_coinTheta(NULL)
+    , fs2_Califa_coinPhi(NULL)
+    , fs2_Califa_theta_phi(NULL)
+    , fs2_Califa_theta_energy(NULL)
+    , fs1_Califa_total_energy(NULL)
+    , fs1_openangle(NULL)
 {
 }
 
@@ -83,6 +118,28 @@ R3BAmsCorrelationOnlineSpectra::~R3BAmsCorrelationOnlineSpectra()
         delete fHitItemsTwim;
     if (fHitItemsCalifa)
         delete fHitItemsCalifa;
+    for (Int_t i = 0; i < 6; i++)
+    {
+        delete fs_Ams_hit_Pos[i];
+        delete fs_Ams_hit_E[i];
+        delete fs_Ams_hit_E_theta[i];
+        delete fs_Ams_hit_Mul[i];
+    }
+    for (Int_t i = 0; i < 2; i++)
+    {
+        delete fs2_ams_theta_phi[i];
+        delete fs2_ams_e1_e2[i];
+        delete fs2_ams_theta1_theta2[i];
+        delete fs2_ams_phi1_phi2[i];
+    }
+    delete fs1_Califa_MultHit;
+    delete fs2_Califa_coinE;
+    delete fs2_Califa_coinTheta;
+    delete fs2_Califa_coinPhi;
+    delete fs2_Califa_theta_phi;
+    delete fs2_Califa_theta_energy;
+    delete fs1_Califa_total_energy;
+    delete fs1_openangle;
 }
 
 InitStatus R3BAmsCorrelationOnlineSpectra::Init()
@@ -97,7 +154,7 @@ InitStatus R3BAmsCorrelationOnlineSpectra::Init()
     run->GetHttpServer()->Register("", this);
 
     // get access to Hit data
-    fHitItemsAms = (TClonesArray*)mgr->GetObject("AmsHitData");
+    fHitItemsAms = (TClonesArray*)R3BSofOnlinePipeline::GetObject("AmsHitData");
     if (!fHitItemsAms)
     {
         LOG(WARNING) << "R3BAmsCorrelationOnlineSpectra: AmsHitData not found";
@@ -105,17 +162,17 @@ InitStatus R3BAmsCorrelationOnlineSpectra::Init()
     }
 
     // get access to hit data of the TWIM
-    fHitItemsTwim = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fHitItemsTwim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fHitItemsTwim)
         LOG(ERROR) << "R3BAmsCorrelationOnlineSpectra: TwimHitData not found";
 
     // get access to hit data of the MUSIC
-    fHitItemsMus = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fHitItemsMus = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fHitItemsMus)
         LOG(ERROR) << "R3BAmsCorrelationOnlineSpectra: MusicHitData not found";
 
     // get access to Hit data
-    fHitItemsCalifa = (TClonesArray*)mgr->GetObject("CalifaHitData");
+    fHitItemsCalifa = (TClonesArray*)R3BSofOnlinePipeline::GetObject("CalifaHitData");
     if (!fHitItemsCalifa)
         LOG(ERROR) << "R3BAmsCorrelationOnlineSpectra::CalifaHitData not found";
 
@@ -407,6 +464,29 @@ InitStatus R3BAmsCorrelationOnlineSpectra::Init()
     fh1_openangle->SetLineWidth(2);
     fh1_openangle->Draw("");
 
+    for (Int_t i = 0; i < 6; i++)
+    {
+        fs_Ams_hit_Pos[i] = R3BSofHistBackend::Book(fh_Ams_hit_Pos[i]);
+        fs_Ams_hit_E[i] = R3BSofHistBackend::Book(fh_Ams_hit_E[i]);
+        fs_Ams_hit_E_theta[i] = R3BSofHistBackend::Book(fh_Ams_hit_E_theta[i]);
+        fs_Ams_hit_Mul[i] = R3BSofHistBackend::Book(fh_Ams_hit_Mul[i]);
+    }
+    for (Int_t i = 0; i < 2; i++)
+    {
+        fs2_ams_theta_phi[i] = R3BSofHistBackend::Book(fh2_ams_theta_phi[i]);
+        fs2_ams_e1_e2[i] = R3BSofHistBackend::Book(fh2_ams_e1_e2[i]);
+        fs2_ams_theta1_theta2[i] = R3BSofHistBackend::Book(fh2_ams_theta1_theta2[i]);
+        fs2_ams_phi1_phi2[i] = R3BSofHistBackend::Book(fh2_ams_phi1_phi2[i]);
+    }
+    fs1_Califa_MultHit = R3BSofHistBackend::Book(fh1_Califa_MultHit);
+    fs2_Califa_coinE = R3BSofHistBackend::Book(fh2_Califa_coinE);
+    fs2_Califa_coinTheta = R3BSofHistBackend::Book(fh2_Califa_coinTheta);
+    fs2_Califa_coinPhi = R3BSofHistBackend::Book(fh2_Califa_coinPhi);
+    fs2_Califa_theta_phi = R3BSofHistBackend::Book(fh2_Califa_theta_phi);
+    fs2_Califa_theta_energy = R3BSofHistBackend::Book(fh2_Califa_theta_energy);
+    fs1_Califa_total_energy = R3BSofHistBackend::Book(fh1_Califa_total_energy);
+    fs1_openangle = R3BSofHistBackend::Book(fh1_openangle);
+
     // MAIN FOLDER-AMS-CALIFA-MUSICs
     TFolder* mainfol = new TFolder("CALIFA-MUSICs", "AMS-CALIFA-MUSICs correlation info");
 
@@ -459,31 +539,31 @@ void R3BAmsCorrelationOnlineSpectra::Reset_Histo()
     {
         for (Int_t i = 0; i < fNbDet; i++)
         {
-            fh_Ams_hit_Mul[i]->Reset();
-            fh_Ams_hit_Pos[i]->Reset();
-            fh_Ams_hit_E[i]->Reset();
-            fh_Ams_hit_E_theta[i]->Reset();
+            fs_Ams_hit_Mul[i]->Reset();
+            fs_Ams_hit_Pos[i]->Reset();
+            fs_Ams_hit_E[i]->Reset();
+            fs_Ams_hit_E_theta[i]->Reset();
         }
 
         for (Int_t i = 0; i < 2; i++)
         {
-            fh2_ams_theta_phi[i]->Reset();
-            fh2_ams_theta1_theta2[i]->Reset();
-            fh2_ams_phi1_phi2[i]->Reset();
-            fh2_ams_e1_e2[i]->Reset();
+            fs2_ams_theta_phi[i]->Reset();
+            fs2_ams_theta1_theta2[i]->Reset();
+            fs2_ams_phi1_phi2[i]->Reset();
+            fs2_ams_e1_e2[i]->Reset();
         }
     }
     // Hit CALIFA data
     if (fHitItemsCalifa)
     {
-        fh1_Califa_MultHit->Reset();
-        fh2_Califa_coinE->Reset();
-        fh2_Califa_coinTheta->Reset();
-        fh2_Califa_coinPhi->Reset();
-        fh2_Califa_theta_phi->Reset();
-        fh2_Califa_theta_energy->Reset();
-        fh1_Califa_total_energy->Reset();
-        fh1_openangle->Reset();
+        fs1_Califa_MultHit->Reset();
+        fs2_Califa_coinE->Reset();
+        fs2_Califa_coinTheta->Reset();
+        fs2_Califa_coinPhi->Reset();
+        fs2_Califa_theta_phi->Reset();
+        fs2_Califa_theta_energy->Reset();
+        fs1_Califa_total_energy->Reset();
+        fs1_openangle->Reset();
     }
 }
 
@@ -546,7 +626,7 @@ void R3BAmsCorrelationOnlineSpectra::Exec(Option_t* option)
         if (fHitItemsCalifa && fHitItemsCalifa->GetEntriesFast() > 0)
         {
             Int_t nHits = fHitItemsCalifa->GetEntriesFast();
-            fh1_Califa_MultHit->Fill(nHits);
+            fs1_Califa_MultHit->Fill(nHits);
 
             Double_t theta = 0., phi = 0.;
             Double_t califa_theta[nHits];
@@ -562,9 +642,9 @@ void R3BAmsCorrelationOnlineSpectra::Exec(Option_t* option)
                 califa_theta[ihit] = theta;
                 califa_phi[ihit] = phi;
                 califa_e[ihit] = hit->GetEnergy();
-                fh2_Califa_theta_phi->Fill(theta, phi);
-                fh2_Califa_theta_energy->Fill(theta + gRandom->Uniform(-1.5, 1.5), hit->GetEnergy());
-                fh1_Califa_total_energy->Fill(hit->GetEnergy());
+                fs2_Califa_theta_phi->Fill(theta, phi);
+                fs2_Califa_theta_energy->Fill(theta + gRandom->Uniform(-1.5, 1.5), hit->GetEnergy());
+                fs1_Califa_total_energy->Fill(hit->GetEnergy());
             }
 
             TVector3 master[2];
@@ -587,7 +667,7 @@ void R3BAmsCorrelationOnlineSpectra::Exec(Option_t* option)
             }
             if (maxEL > fMinProtonE && maxER > fMinProtonE)
             {
-                fh1_openangle->Fill(master[0].Angle(master[1]) * TMath::RadToDeg());
+                fs1_openangle->Fill(master[0].Angle(master[1]) * TMath::RadToDeg());
             }
 
             // Comparison of hits to get energy, theta and phi correlations between them
@@ -595,15 +675,15 @@ void R3BAmsCorrelationOnlineSpectra::Exec(Option_t* option)
                 for (Int_t i2 = i1 + 1; i2 < nHits; i2++)
                     if (gRandom->Uniform(0., 1.) < 0.5)
                     {
-                        fh2_Califa_coinE->Fill(califa_e[i1], califa_e[i2]);
-                        fh2_Califa_coinTheta->Fill(califa_theta[i1], califa_theta[i2]);
-                        fh2_Califa_coinPhi->Fill(califa_phi[i1], califa_phi[i2]);
+                        fs2_Califa_coinE->Fill(califa_e[i1], califa_e[i2]);
+                        fs2_Califa_coinTheta->Fill(califa_theta[i1], califa_theta[i2]);
+                        fs2_Califa_coinPhi->Fill(califa_phi[i1], califa_phi[i2]);
                     }
                     else
                     {
-                        fh2_Califa_coinE->Fill(califa_e[i2], califa_e[i1]);
-                        fh2_Califa_coinTheta->Fill(califa_theta[i2], califa_theta[i1]);
-                        fh2_Califa_coinPhi->Fill(califa_phi[i2], califa_phi[i1]);
+                        fs2_Califa_coinE->Fill(califa_e[i2], califa_e[i1]);
+                        fs2_Califa_coinTheta->Fill(califa_theta[i2], califa_theta[i1]);
+                        fs2_Califa_coinPhi->Fill(califa_phi[i2], califa_phi[i1]);
                     }
         }
 
@@ -633,14 +713,14 @@ void R3BAmsCorrelationOnlineSpectra::Exec(Option_t* option)
                 if (!hit)
                     continue;
                 DetId = hit->GetDetId();
-                fh_Ams_hit_Pos[DetId]->Fill(hit->GetPos_S(), hit->GetPos_K());
-                fh_Ams_hit_E[DetId]->Fill(hit->GetEnergyS(), hit->GetEnergyK());
-                fh_Ams_hit_E_theta[DetId]->Fill(hit->GetTheta() * TMath::RadToDeg(), hit->GetEnergyS());
+                fs_Ams_hit_Pos[DetId]->Fill(hit->GetPos_S(), hit->GetPos_K());
+                fs_Ams_hit_E[DetId]->Fill(hit->GetEnergyS(), hit->GetEnergyK());
+                fs_Ams_hit_E_theta[DetId]->Fill(hit->GetTheta() * TMath::RadToDeg(), hit->GetEnergyS());
                 mulhit[DetId]++;
                 if (DetId == 0 || DetId == 3) // inner detectors, layer 1
-                    fh2_ams_theta_phi[0]->Fill(hit->GetTheta() * TMath::RadToDeg(), hit->GetPhi() * TMath::RadToDeg());
+                    fs2_ams_theta_phi[0]->Fill(hit->GetTheta() * TMath::RadToDeg(), hit->GetPhi() * TMath::RadToDeg());
                 else // outer detectors, layer 2
-                    fh2_ams_theta_phi[1]->Fill(hit->GetTheta() * TMath::RadToDeg(), hit->GetPhi() * TMath::RadToDeg());
+                    fs2_ams_theta_phi[1]->Fill(hit->GetTheta() * TMath::RadToDeg(), hit->GetPhi() * TMath::RadToDeg());
                 // look for the max. energy per AMS detector
                 if (Emaxhit[DetId] < hit->GetEnergyS())
                 {
@@ -658,33 +738,33 @@ void R3BAmsCorrelationOnlineSpectra::Exec(Option_t* option)
                 }
             }
             for (Int_t i = 0; i < fNbDet; i++)
-                fh_Ams_hit_Mul[i]->Fill(mulhit[i]);
+                fs_Ams_hit_Mul[i]->Fill(mulhit[i]);
             if (Emaxhit[0] > 0. && (Emaxhit[1] > 0. || Emaxhit[2] > 0.))
             {
-                fh2_ams_e1_e2[0]->Fill(Emaxhit[0], TMath::Max(Emaxhit[1], Emaxhit[2]));
+                fs2_ams_e1_e2[0]->Fill(Emaxhit[0], TMath::Max(Emaxhit[1], Emaxhit[2]));
                 if (Emaxhit[1] > Emaxhit[2])
                 {
-                    fh2_ams_theta1_theta2[0]->Fill(Thetamaxhit[0], Thetamaxhit[1]);
-                    fh2_ams_phi1_phi2[0]->Fill(Phimaxhit[0], Phimaxhit[1]);
+                    fs2_ams_theta1_theta2[0]->Fill(Thetamaxhit[0], Thetamaxhit[1]);
+                    fs2_ams_phi1_phi2[0]->Fill(Phimaxhit[0], Phimaxhit[1]);
                 }
                 else if (Emaxhit[2] > Emaxhit[1])
                 {
-                    fh2_ams_theta1_theta2[0]->Fill(Thetamaxhit[0], Thetamaxhit[2]);
-                    fh2_ams_phi1_phi2[0]->Fill(Phimaxhit[0], Phimaxhit[2]);
+                    fs2_ams_theta1_theta2[0]->Fill(Thetamaxhit[0], Thetamaxhit[2]);
+                    fs2_ams_phi1_phi2[0]->Fill(Phimaxhit[0], Phimaxhit[2]);
                 }
             }
             if (Emaxhit[3] > 0. && (Emaxhit[4] > 0. || Emaxhit[5] > 0.))
             {
-                fh2_ams_e1_e2[1]->Fill(Emaxhit[3], TMath::Max(Emaxhit[4], Emaxhit[5]));
+                fs2_ams_e1_e2[1]->Fill(Emaxhit[3], TMath::Max(Emaxhit[4], Emaxhit[5]));
                 if (Emaxhit[4] > Emaxhit[5])
                 {
-                    fh2_ams_theta1_theta2[1]->Fill(Thetamaxhit[3], Thetamaxhit[4]);
-                    fh2_ams_phi1_phi2[1]->Fill(Phimaxhit[3], Phimaxhit[4]);
+                    fs2_ams_theta1_theta2[1]->Fill(Thetamaxhit[3], Thetamaxhit[4]);
+                    fs2_ams_phi1_phi2[1]->Fill(Phimaxhit[3], Phimaxhit[4]);
                 }
                 else if (Emaxhit[5] > Emaxhit[4])
                 {
-                    fh2_ams_theta1_theta2[1]->Fill(Thetamaxhit[3], Thetamaxhit[5]);
-                    fh2_ams_phi1_phi2[1]->Fill(Phimaxhit[3], Phimaxhit[5]);
+                    fs2_ams_theta1_theta2[1]->Fill(Thetamaxhit[3], Thetamaxhit[5]);
+                    fs2_ams_phi1_phi2[1]->Fill(Phimaxhit[3], Phimaxhit[5]);
                 }
             }
         }
@@ -715,6 +795,7 @@ void R3BAmsCorrelationOnlineSpectra::FinishEvent()
 
 void R3BAmsCorrelationOnlineSpectra::FinishTask()
 {
+    R3BSofHistBackend::Flush();
     if (fHitItemsAms)
     {
         for (Int_t i = 0; i < fNbDet; i++)
@@ -19,6 +19,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads AMS-CALIFA-MUSICs data and plots correlated online histograms
@@ -143,6 +144,24 @@ class R3BAmsCorrelationOnlineSpectra : public FairTask
     TH1F* fh1_Califa_total_energy;
     TH1F* fh1_openangle;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs_Ams_hit_Pos[6];        //!
+    R3BSofShardedHist* fs_Ams_hit_E[6];          //!
+    R3BSofShardedHist* fs_Ams_hit_E_theta[6];    //!
+    R3BSofShardedHist* fs_Ams_hit_Mul[6];        //!
+    R3BSofShardedHist* fs2_ams_theta_phi[2];     //!
+    R3BSofShardedHist* fs2_ams_e1_e2[2];         //!
+    R3BSofShardedHist* fs2_ams_theta1_theta2[2]; //!
+    R3BSofShardedHist* fs2_ams_phi1_phi2[2];     //!
+    R3BSofShardedHist* fs1_Califa_MultHit;       //!
+    R3BSofShardedHist* fs2_Califa_coinE;         //!
+    R3BSofShardedHist* fs2_Califa_coinTheta;     //!
+    R3BSofShardedHist* fs2_Califa_coinPhi;       //!
+    R3BSofShardedHist* fs2_Califa_theta_phi;     //!
+    R3BSofShardedHist* fs2_Califa_theta_energy;  //!
+    R3BSofShardedHist* fs1_Califa_total_energy;  //!
+    R3BSofShardedHist* fs1_openangle;            //!
+
     // TString fAmsFile;        	      /**< Config file name. */
     Int_t fNbDet; /**< Number of AMS detectors. */
 
@@ -9,6 +9,7 @@
  */
 
 #include "R3BSofAtOnlineSpectra.h"
+#include "R3BSofOnlinePipeline.h"
 #include "R3BEventHeader.h"
 #include "R3BSofAtMappedData.h"
 #include "THttpServer.h"
@@ -72,13 +73,13 @@ InitStatus R3BSofAtOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofAtOnlineSpectra::Init FairRootManager not found";
-    header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
     // === get access to mapped data of the active target === //
-    fMappedItemsAt = (TClonesArray*)mgr->GetObject("AtMappedData");
+    fMappedItemsAt = (TClonesArray*)R3BSofOnlinePipeline::GetObject("AtMappedData");
     if (!fMappedItemsAt)
     {
         return kFATAL;
@@ -9,6 +9,7 @@
  */
 
 #include "R3BSofFrsFillTree.h"
+#include "R3BSofOnlinePipeline.h"
 
 R3BSofFrsFillTree::R3BSofFrsFillTree()
     : FairTask("SofFrsFillTree", 1)
@@ -72,7 +73,7 @@ InitStatus R3BSofFrsFillTree::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofFrsFillTree::Init FairRootManager not found";
-    header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     // Reading MusicCalPar from FairRuntimeDb
     FairRuntimeDb* rtdb = FairRuntimeDb::instance();
@@ -84,7 +85,7 @@ InitStatus R3BSofFrsFillTree::Init()
     // --- ------------------------------------ --- //
     // --- get access to mapped data of the SCI --- //
     // --- ------------------------------------ --- //
-    fFrsData = (TClonesArray*)mgr->GetObject("SofFrsData");
+    fFrsData = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofFrsData");
     if (!fFrsData)
     {
         return kFATAL;
@@ -93,7 +94,7 @@ InitStatus R3BSofFrsFillTree::Init()
     // --- ------------------------------------ --- //
     // --- get access to mapped data of the SCI --- //
     // --- ------------------------------------ --- //
-    fMappedItemsSci = (TClonesArray*)mgr->GetObject("SofSciMappedData");
+    fMappedItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciMappedData");
     if (!fMappedItemsSci)
     {
         return kFATAL;
@@ -102,7 +103,7 @@ InitStatus R3BSofFrsFillTree::Init()
     // --- ---------------------------------- --- //
     // --- get access to tcal data of the SCI --- //
     // --- ---------------------------------- --- //
-    fTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciTcalData");
+    fTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciTcalData");
     if (!fTcalItemsSci)
     {
         return kFATAL;
@@ -111,25 +112,25 @@ InitStatus R3BSofFrsFillTree::Init()
     // --- ----------------------------------------- --- //
     // --- get access to single tcal data of the SCI --- //
     // --- ----------------------------------------- --- //
-    fSingleTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciSingleTcalData");
+    fSingleTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciSingleTcalData");
     if (!fSingleTcalItemsSci)
     {
         return kFATAL;
     }
     /*
     // get access to hit data of the MUSIC
-    fMusHitItems = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fMusHitItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fMusHitItems)
         LOG(WARNING) << "R3BSofFrsFillTree: MusicHitData not found";
 
     // get access to cal data of the MUSIC
-    fMusCalItems = (TClonesArray*)mgr->GetObject("MusicCalData");
+    fMusCalItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicCalData");
     if (!fMusCalItems)
         LOG(WARNING) << "R3BSofFrsFillTree: MusicCalData not found";
     */
 
     // Twim
-    fTwimHitItems = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fTwimHitItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fTwimHitItems)
         LOG(WARNING) << "R3BSofFrsFillTree: TwimHitData not found";
 
@@ -143,33 +144,12 @@ InitStatus R3BSofFrsFillTree::Init()
     fNumAnodes = fCal_TwimPar->GetNumAnodes();  // Number of anodes
     fNumParams = fCal_TwimPar->GetNumParZFit(); // Number of TwimParameters
 
-    // Anodes that don't work set to zero
-    TwimCalZParams = new TArrayF();
-    Int_t array_size = fNumSec * fNumParams;
-    TwimCalZParams->Set(array_size);
-    TwimCalZParams = fCal_TwimPar->GetZHitPar(); // Array with the Cal parameters
-
-    // Parameters detector
-    for (Int_t s = 0; s < fNumSec; s++)
-        // Parameters detector
-        if (fNumParams == 2)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-        }
-        else if (fNumParams == 3)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-            fTwimZ2 = TwimCalZParams->GetAt(2);
-        }
-        else
-            LOG(INFO) << "R3BSofTwimCal2Hit parameters for charge-Z cannot be used here, number of parameters: "
-                      << fNumParams;
+    // Z polynomial of any order in sqrt(E) * beta, parameters of the first section
+    fTwimZCal.SetPolynomial(fCal_TwimPar->GetZHitPar(), fNumParams);
     // Twim end
 
     // get access to cal data of the MWPC0
-    fCalItemsMwpc0 = (TClonesArray*)mgr->GetObject("Mwpc0CalData");
+    fCalItemsMwpc0 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc0CalData");
     if (!fCalItemsMwpc0)
         LOG(WARNING) << "R3BSofFrsFillTree: Mwpc0CalData not found";
 
@@ -396,7 +376,7 @@ void R3BSofFrsFillTree::Exec(Option_t* option)
 
     if (TheBeta > 0. && TwimE > 0.)
     {
-        TwimZ = fTwimZ0 + fTwimZ1 * TMath::Sqrt(TwimE) * TheBeta + fTwimZ2 * TwimE * TheBeta * TheBeta;
+        TwimZ = fTwimZCal.Eval(TwimE, TheBeta);
     }
 
     // --- -------------- --- //
@@ -8,6 +8,7 @@
 #define R3BSofFrsFillTree_H
 
 #include "FairTask.h"
+#include "R3BSofZCalibration.h"
 #include "TMath.h"
 #include "TClonesArray.h"
 
@@ -129,10 +130,7 @@ class R3BSofFrsFillTree : public FairTask
     UChar_t fNumSec;
     UChar_t fNumAnodes;
     UChar_t fNumParams;
-    Float_t fZ0 = 0., fZ1 = 0. , fZ2 = 0.; // CalibPar for R3BMUSIC
-    TArrayF* CalZParams;
-    Float_t fTwimZ0 = 0., fTwimZ1 = 0., fTwimZ2 = 0.; // CalibPar for Twim
-    TArrayF* TwimCalZParams;
+    R3BSofZCalibration fTwimZCal; //! CalibPar for Twim
 
     // check for trigger should be done globablly (somewhere else)
     R3BEventHeader* header; /**< Event header.      */
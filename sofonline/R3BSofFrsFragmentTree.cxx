@@ -9,6 +9,7 @@
  */
 
 #include "R3BSofFrsFragmentTree.h"
+#include "R3BSofOnlinePipeline.h"
 
 R3BSofFrsFragmentTree::R3BSofFrsFragmentTree()
     : FairTask("SofFrsFragmentTree", 1)
@@ -96,9 +97,9 @@ InitStatus R3BSofFrsFragmentTree::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofFrsFragmentTree::Init FairRootManager not found";
-    header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
     if (!header)
-      header = (R3BEventHeader*)mgr->GetObject("EventHeader.");
+      header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("EventHeader.");
 
     // Reading MusicCalPar from FairRuntimeDb
     FairRuntimeDb* rtdb = FairRuntimeDb::instance();
@@ -110,12 +111,12 @@ InitStatus R3BSofFrsFragmentTree::Init()
     // --- ------------------------------------ --- //
     // --- get access to Ana data --- //
     // --- ------------------------------------ --- //
-    fFrsData = (TClonesArray*)mgr->GetObject("SofFrsData");
+    fFrsData = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofFrsData");
     if (!fFrsData)
     {
         return kFATAL;
     }
-    fFragData = (TClonesArray*)mgr->GetObject("SofTrackingData");
+    fFragData = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofTrackingData");
     if (!fFragData)
     {
         return kFATAL;
@@ -125,7 +126,7 @@ InitStatus R3BSofFrsFragmentTree::Init()
     // --- ------------------------------------ --- //
     // --- get access to mapped data of the SCI --- //
     // --- ------------------------------------ --- //
-    fMappedItemsSci = (TClonesArray*)mgr->GetObject("SofSciMappedData");
+    fMappedItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciMappedData");
     if (!fMappedItemsSci)
     {
         return kFATAL;
@@ -134,7 +135,7 @@ InitStatus R3BSofFrsFragmentTree::Init()
     // --- ---------------------------------- --- //
     // --- get access to tcal data of the SCI --- //
     // --- ---------------------------------- --- //
-    fTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciTcalData");
+    fTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciTcalData");
     if (!fTcalItemsSci)
     {
         return kFATAL;
@@ -143,7 +144,7 @@ InitStatus R3BSofFrsFragmentTree::Init()
     // --- ----------------------------------------- --- //
     // --- get access to single tcal data of the SCI --- //
     // --- ----------------------------------------- --- //
-    fSingleTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciSingleTcalData");
+    fSingleTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciSingleTcalData");
     if (!fSingleTcalItemsSci)
     {
         return kFATAL;
@@ -151,18 +152,18 @@ InitStatus R3BSofFrsFragmentTree::Init()
     */
     
     // get access to hit data of the MUSIC
-    fMusHitItems = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fMusHitItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fMusHitItems)
         LOG(WARNING) << "R3BSofFrsFragmentTree: MusicHitData not found";
     /*
     // get access to cal data of the MUSIC
-    fMusCalItems = (TClonesArray*)mgr->GetObject("MusicCalData");
+    fMusCalItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicCalData");
     if (!fMusCalItems)
         LOG(WARNING) << "R3BSofFrsFragmentTree: MusicCalData not found";
     */
 
     // Twim
-    fTwimHitItems = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fTwimHitItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fTwimHitItems)
         LOG(WARNING) << "R3BSofFrsFragmentTree: TwimHitData not found";
 
@@ -176,53 +177,32 @@ InitStatus R3BSofFrsFragmentTree::Init()
     fNumAnodes = fCal_TwimPar->GetNumAnodes();  // Number of anodes
     fNumParams = fCal_TwimPar->GetNumParZFit(); // Number of TwimParameters
 
-    // Anodes that don't work set to zero
-    TwimCalZParams = new TArrayF();
-    Int_t array_size = fNumSec * fNumParams;
-    TwimCalZParams->Set(array_size);
-    TwimCalZParams = fCal_TwimPar->GetZHitPar(); // Array with the Cal parameters
-
-    // Parameters detector
-    for (Int_t s = 0; s < fNumSec; s++)
-        // Parameters detector
-        if (fNumParams == 2)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-        }
-        else if (fNumParams == 3)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-            fTwimZ2 = TwimCalZParams->GetAt(2);
-        }
-        else
-            LOG(INFO) << "R3BSofTwimCal2Hit parameters for charge-Z cannot be used here, number of parameters: "
-                      << fNumParams;
+    // Z polynomial of any order in sqrt(E) * beta, parameters of the first section
+    fTwimZCal.SetPolynomial(fCal_TwimPar->GetZHitPar(), fNumParams);
     // Twim end
     // get access to cal data of the MWPC0
     /*
-    fCalItemsMwpc0 = (TClonesArray*)mgr->GetObject("Mwpc0CalData");
+    fCalItemsMwpc0 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc0CalData");
     if (!fCalItemsMwpc0)
         LOG(WARNING) << "R3BSofFrsFragmentTree: Mwpc0CalData not found";
     */
-    fHitItemsMwpc0 = (TClonesArray*)mgr->GetObject("Mwpc0HitData");
+    fHitItemsMwpc0 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc0HitData");
     if (!fHitItemsMwpc0)
         LOG(WARNING) << "R3BSofFrsFragmentTree: Mwpc0HitData not found";
 
-    fHitItemsMwpc1 = (TClonesArray*)mgr->GetObject("Mwpc1HitData");
+    fHitItemsMwpc1 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc1HitData");
     if (!fHitItemsMwpc1)
         LOG(WARNING) << "R3BSofFrsFragmentTree: Mwpc1HitData not found";
 
-    fHitItemsMwpc2 = (TClonesArray*)mgr->GetObject("Mwpc2HitData");
+    fHitItemsMwpc2 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc2HitData");
     if (!fHitItemsMwpc2)
         LOG(WARNING) << "R3BSofFrsFragmentTree: Mwpc2HitData not found";
 
-    fHitItemsMwpc3 = (TClonesArray*)mgr->GetObject("Mwpc3HitData");
+    fHitItemsMwpc3 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc3HitData");
     if (!fHitItemsMwpc3)
         LOG(WARNING) << "R3BSofFrsFragmentTree: Mwpc3HitData not found";
 
-    fTofWHitDataCA = (TClonesArray*)mgr->GetObject("TofWHitData");
+    fTofWHitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TofWHitData");
     if (!fTofWHitDataCA)
         LOG(WARNING) << "R3BSofFrsFragmentTree: TofWHitData not found";
 
@@ -434,7 +414,7 @@ void R3BSofFrsFragmentTree::Exec(Option_t* option)
 
     if (TheBeta > 0. && TwimE > 0.)
     {
-        TwimZ = fTwimZ0 + fTwimZ1 * TMath::Sqrt(TwimE) * TheBeta + fTwimZ2 * TwimE * TheBeta * TheBeta;
+        TwimZ = fTwimZCal.Eval(TwimE, TheBeta);
     }
 
     // --- -------------- --- //
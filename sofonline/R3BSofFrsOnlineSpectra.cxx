@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofFrsOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BSofFrsData.h"
 #include "THttpServer.h"
@@ -43,6 +46,10 @@ R3BSofFrsOnlineSpectra::R3BSofFrsOnlineSpectra()
     : FairTask("SofFrsOnlineSpectra", 1)
     , fHitItemsFrs(NULL)
     , fNEvents(0)
+    , fs1_beta(NULL)
+    , fs1_brho(NULL)
+    , fs2_Aqvsq(NULL)
+    , fs2_Xs2vsbeta(NULL)
 {
 }
 
@@ -50,6 +57,10 @@ R3BSofFrsOnlineSpectra::R3BSofFrsOnlineSpectra(const TString& name, Int_t iVerbo
     : FairTask(name, iVerbose)
     , fHitItemsFrs(NULL)
     , fNEvents(0)
+    , fs1_beta(NULL)
+    , fs1_brho(NULL)
+    , fs2_Aqvsq(NULL)
+    , fs2_Xs2vsbeta(NULL)
 {
 }
 
@@ -58,6 +69,10 @@ R3BSofFrsOnlineSpectra::~R3BSofFrsOnlineSpectra()
     LOG(INFO) << "R3BSofFrsOnlineSpectra::Delete instance";
     if (fHitItemsFrs)
         delete fHitItemsFrs;
+    delete fs1_beta;
+    delete fs1_brho;
+    delete fs2_Aqvsq;
+    delete fs2_Xs2vsbeta;
 }
 
 InitStatus R3BSofFrsOnlineSpectra::Init()
@@ -71,13 +86,13 @@ InitStatus R3BSofFrsOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofFrsOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
     // get access to mapped data of FRS
-    fHitItemsFrs = (TClonesArray*)mgr->GetObject("SofFrsData");
+    fHitItemsFrs = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofFrsData");
     if (!fHitItemsFrs)
     {
         return kFATAL;
@@ -159,6 +174,11 @@ InitStatus R3BSofFrsOnlineSpectra::Init()
     fh2_Aqvsq->GetYaxis()->SetTitleSize(0.045);
     fh2_Aqvsq->Draw("colz");
 
+    fs1_beta = R3BSofHistBackend::Book(fh1_beta);
+    fs1_brho = R3BSofHistBackend::Book(fh1_brho);
+    fs2_Aqvsq = R3BSofHistBackend::Book(fh2_Aqvsq);
+    fs2_Xs2vsbeta = R3BSofHistBackend::Book(fh2_Xs2vsbeta);
+
     // MAIN FOLDER-FRS
     TFolder* mainfol = new TFolder("FRS-IncomingID", "FRS incomingID info");
     mainfol->Add(cBeta);
@@ -177,10 +197,10 @@ void R3BSofFrsOnlineSpectra::Reset_Histo()
 {
     LOG(INFO) << "R3BSofFrsOnlineSpectra::Reset_Histo";
 
-    fh1_beta->Reset();
-    fh1_brho->Reset();
-    fh2_Aqvsq->Reset();
-    fh2_Xs2vsbeta->Reset();
+    fs1_beta->Reset();
+    fs1_brho->Reset();
+    fs2_Aqvsq->Reset();
+    fs2_Xs2vsbeta->Reset();
 }
 
 void R3BSofFrsOnlineSpectra::Exec(Option_t* option)
@@ -198,10 +218,10 @@ void R3BSofFrsOnlineSpectra::Exec(Option_t* option)
             R3BSofFrsData* hit = (R3BSofFrsData*)fHitItemsFrs->At(ihit);
             if (!hit)
                 continue;
-            fh1_beta->Fill(hit->GetBeta());
-            fh1_brho->Fill(hit->GetBrho());
-            fh2_Aqvsq->Fill(hit->GetAq(), hit->GetZ());
-            fh2_Xs2vsbeta->Fill(hit->GetXS2(), hit->GetBeta());
+            fs1_beta->Fill(hit->GetBeta());
+            fs1_brho->Fill(hit->GetBrho());
+            fs2_Aqvsq->Fill(hit->GetAq(), hit->GetZ());
+            fs2_Xs2vsbeta->Fill(hit->GetXS2(), hit->GetBeta());
         }
     }
 
@@ -220,6 +240,7 @@ void R3BSofFrsOnlineSpectra::FinishTask()
 {
     if (fHitItemsFrs)
     {
+        R3BSofHistBackend::Flush();
         cBeta->Write();
         cBrho->Write();
         cXs2vsBeta->Write();
@@ -20,6 +20,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads FRS data and plots online histograms
@@ -100,6 +101,12 @@ class R3BSofFrsOnlineSpectra : public FairTask
     TH2F* fh2_Aqvsq;
     TH2F* fh2_Xs2vsbeta;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs1_beta;      //!
+    R3BSofShardedHist* fs1_brho;      //!
+    R3BSofShardedHist* fs2_Aqvsq;     //!
+    R3BSofShardedHist* fs2_Xs2vsbeta; //!
+
   public:
     ClassDef(R3BSofFrsOnlineSpectra, 1)
 };
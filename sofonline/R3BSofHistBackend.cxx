@@ -0,0 +1,167 @@
+// ------------------------------------------------------------
+// -----                R3BSofHistBackend                 -----
+// -----   Snapshots of the sharded online histograms     -----
+// ------------------------------------------------------------
+
+#include "R3BSofHistBackend.h"
+#include "R3BSofShardedHist.h"
+#include "R3BSofSparseHist.h"
+
+#include "FairLogger.h"
+
+#include "TMath.h"
+
+#include <algorithm>
+#include <chrono>
+
+R3BSofHistBackend* R3BSofHistBackend::fgInstance = NULL;
+
+R3BSofHistBackend::R3BSofHistBackend()
+    : FairTask("R3BSofHistBackend", 1)
+    , fNumShards(4)
+    , fPeriod(500)
+    , fStop(kFALSE)
+    , fNumSnapshots(0)
+{
+    fgInstance = this;
+}
+
+R3BSofHistBackend::R3BSofHistBackend(Int_t nShards, Int_t period, Int_t iVerbose)
+    : FairTask("R3BSofHistBackend", iVerbose)
+    , fNumShards(nShards)
+    , fPeriod(period)
+    , fStop(kFALSE)
+    , fNumSnapshots(0)
+{
+    fgInstance = this;
+}
+
+R3BSofHistBackend::~R3BSofHistBackend()
+{
+    Stop();
+    if (fgInstance == this)
+        fgInstance = NULL;
+}
+
+R3BSofShardedHist* R3BSofHistBackend::Book(TH1* h)
+{
+    if (!h)
+        return NULL;
+    if (!fgInstance)
+        return new R3BSofShardedHist(h, 0);
+    R3BSofShardedHist* sharded = new R3BSofShardedHist(h, TMath::Max(1, fgInstance->fNumShards));
+    std::lock_guard<std::mutex> lock(fgInstance->fMutex);
+    fgInstance->fHists.push_back(sharded);
+    return sharded;
+}
+
+Bool_t R3BSofHistBackend::Book(R3BSofSparseHist* h)
+{
+    if (!h || !fgInstance)
+        return kFALSE;
+    std::lock_guard<std::mutex> lock(fgInstance->fMutex);
+    h->fPublished = kTRUE;
+    fgInstance->fSparse.push_back(h);
+    return kTRUE;
+}
+
+void R3BSofHistBackend::Unregister(R3BSofShardedHist* h)
+{
+    if (!fgInstance)
+        return;
+    std::lock_guard<std::mutex> lock(fgInstance->fMutex);
+    std::vector<R3BSofShardedHist*>& hists = fgInstance->fHists;
+    hists.erase(std::remove(hists.begin(), hists.end(), h), hists.end());
+}
+
+void R3BSofHistBackend::Unregister(R3BSofSparseHist* h)
+{
+    if (!fgInstance)
+        return;
+    std::lock_guard<std::mutex> lock(fgInstance->fMutex);
+    std::vector<R3BSofSparseHist*>& sparse = fgInstance->fSparse;
+    sparse.erase(std::remove(sparse.begin(), sparse.end(), h), sparse.end());
+}
+
+void R3BSofHistBackend::Flush()
+{
+    if (!fgInstance)
+        return;
+    std::lock_guard<std::mutex> lock(fgInstance->fMutex);
+    fgInstance->Snapshot(kTRUE);
+    fgInstance->Publish();
+}
+
+InitStatus R3BSofHistBackend::Init()
+{
+    LOG(INFO) << "R3BSofHistBackend::Init() " << fNumShards << " shards, snapshot every " << fPeriod << " ms";
+    Start();
+    return kSUCCESS;
+}
+
+void R3BSofHistBackend::Exec(Option_t* option)
+{
+    // The event loop does not wait for a snapshot in progress
+    std::unique_lock<std::mutex> lock(fMutex, std::try_to_lock);
+    if (lock.owns_lock())
+        Publish();
+}
+
+void R3BSofHistBackend::FinishTask()
+{
+    Stop();
+    LOG(INFO) << "R3BSofHistBackend: " << fHists.size() << " histograms, " << fSparse.size() << " sparse, "
+              << fNumSnapshots << " snapshots";
+}
+
+void R3BSofHistBackend::Start()
+{
+    if (fThread.joinable())
+        return;
+    fStop.store(kFALSE);
+    fThread = std::thread(&R3BSofHistBackend::Run, this);
+}
+
+void R3BSofHistBackend::Stop()
+{
+    if (!fThread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fStop.store(kTRUE);
+    }
+    fWakeUp.notify_all();
+    fThread.join();
+}
+
+void R3BSofHistBackend::Run()
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    while (!fStop.load())
+    {
+        fWakeUp.wait_for(lock, std::chrono::milliseconds(fPeriod), [this] { return fStop.load(); });
+        if (fStop.load())
+            break;
+        Snapshot(kFALSE);
+    }
+}
+
+void R3BSofHistBackend::Snapshot(Bool_t force)
+{
+    for (size_t i = 0; i < fHists.size(); i++)
+        fHists[i]->Snapshot(force);
+    // the pages are copied by the filling thread
+    for (size_t i = 0; i < fSparse.size(); i++)
+        fSparse[i]->fSnapshotRequested.store(kTRUE, std::memory_order_relaxed);
+    fNumSnapshots++;
+}
+
+void R3BSofHistBackend::Publish()
+{
+    for (size_t i = 0; i < fHists.size(); i++)
+        fHists[i]->Publish();
+    for (size_t i = 0; i < fSparse.size(); i++)
+        fSparse[i]->Publish();
+}
+
+ClassImp(R3BSofHistBackend)
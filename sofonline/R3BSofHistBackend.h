@@ -0,0 +1,111 @@
+// ------------------------------------------------------------
+// -----                R3BSofHistBackend                 -----
+// -----   Snapshots of the sharded online histograms     -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofHistBackend_H
+#define R3BSofHistBackend_H
+
+#include "FairTask.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TH1;
+class R3BSofShardedHist;
+class R3BSofSparseHist;
+
+/**
+ * Backend of the online histograms filled by several threads, e.g. the
+ * online spectra running on R3BSofOnlinePipeline stages:
+ *   R3BSofHistBackend* backend = new R3BSofHistBackend(4, 500); // 4 shards, 500 ms
+ *   run->AddTask(backend); // to the run, not to a pipeline
+ * The spectra book their histograms in Init,
+ *   fh1_beta = new TH1F(...);
+ *   fs_beta = R3BSofHistBackend::Book(fh1_beta);
+ * and fill fs_beta instead of fh1_beta. A thread of the backend sums the
+ * shards of every histogram each period, and Exec, on the thread of the
+ * event loop which also serves THttpServer, publishes the sums into the
+ * histograms. Flush() publishes everything at once, e.g. before writing the
+ * histograms in FinishTask. Without a backend, Book returns objects filling
+ * the histograms directly.
+ *
+ * The displays of R3BSofSparseHist are booked too: each period the backend
+ * requests a copy of the pages, made by the filling thread in
+ * R3BSofSparseHist::Update(), and Exec rebuilds the display from it.
+ **/
+class R3BSofHistBackend : public FairTask
+{
+  public:
+    /** Default constructor **/
+    R3BSofHistBackend();
+
+    /** Standard constructor
+     *@param nShards  Bin arrays per histogram, threads beyond share them
+     *@param period   Time between two snapshots [ms]
+     **/
+    R3BSofHistBackend(Int_t nShards, Int_t period = 500, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofHistBackend();
+
+    /** Sharded filling of h, owned by the caller, NULL for a histogram not booked **/
+    static R3BSofShardedHist* Book(TH1* h);
+
+    /** Display of h published by the backend, kFALSE without a backend (display filled by Fill) **/
+    static Bool_t Book(R3BSofSparseHist* h);
+
+    /** Snapshot and publication of all the histograms, no filling meanwhile. The pages of the
+     *  R3BSofSparseHist are the last ones copied, R3BSofSparseHist::Snapshot() before for the last counts **/
+    static void Flush();
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Virtual method Exec, publishes the snapshots **/
+    virtual void Exec(Option_t* option);
+
+    /** Virtual method FinishTask **/
+    virtual void FinishTask();
+
+    /** Modifiers, before Init **/
+    void SetNumShards(Int_t n) { fNumShards = n; }
+    void SetPeriod(Int_t ms) { fPeriod = ms; }
+
+  private:
+    friend class R3BSofShardedHist;
+    friend class R3BSofSparseHist;
+
+    Int_t fNumShards;
+    Int_t fPeriod;
+
+    std::vector<R3BSofShardedHist*> fHists; //!
+    std::vector<R3BSofSparseHist*> fSparse; //!
+    std::mutex fMutex;                      //! fHists, fSparse and the snapshots
+    std::condition_variable fWakeUp;        //!
+    std::atomic<Bool_t> fStop;              //!
+    std::thread fThread;                    //!
+
+    ULong64_t fNumSnapshots;
+
+    static R3BSofHistBackend* fgInstance;
+
+    static void Unregister(R3BSofShardedHist* h);
+    static void Unregister(R3BSofSparseHist* h);
+    void Start();
+    void Stop();
+    void Run();
+    void Snapshot(Bool_t force);
+    void Publish();
+
+    R3BSofHistBackend(const R3BSofHistBackend&);
+    R3BSofHistBackend& operator=(const R3BSofHistBackend&);
+
+  public:
+    ClassDef(R3BSofHistBackend, 1)
+};
+
+#endif
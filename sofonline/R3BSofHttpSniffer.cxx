@@ -0,0 +1,220 @@
+// ------------------------------------------------------------
+// -----                R3BSofHttpSniffer                 -----
+// -----   Cached rendering of the online canvases        -----
+// ------------------------------------------------------------
+
+#include "R3BSofHttpSniffer.h"
+
+#include "FairLogger.h"
+
+#include "TAxis.h"
+#include "TGraph.h"
+#include "TH1.h"
+#include "THttpServer.h"
+#include "TList.h"
+#include "TPad.h"
+#include "TRegexp.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    // Few entries per object and per client options, all dropped beyond
+    const size_t kMaxEntries = 4096;
+
+    inline void Mix(ULong64_t& sig, ULong64_t v) { sig = (sig ^ v) * 1099511628211ULL; }
+
+    inline void Mix(ULong64_t& sig, Double_t v)
+    {
+        ULong64_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        Mix(sig, bits);
+    }
+
+    void MixAxis(ULong64_t& sig, const TAxis* axis)
+    {
+        Mix(sig, (ULong64_t)axis->GetNbins());
+        Mix(sig, axis->GetXmin());
+        Mix(sig, axis->GetXmax());
+    }
+
+    // Changes of the drawn data, false if nothing can be tracked
+    Bool_t AddSignature(TObject* obj, ULong64_t& sig)
+    {
+        if (!obj)
+            return kFALSE;
+        if (obj->InheritsFrom(TPad::Class()))
+        {
+            Bool_t tracked = kFALSE;
+            TIter next(((TPad*)obj)->GetListOfPrimitives());
+            while (TObject* prim = next())
+                tracked |= AddSignature(prim, sig);
+            return tracked;
+        }
+        if (obj->InheritsFrom(TH1::Class()))
+        {
+            TH1* h = (TH1*)obj;
+            Mix(sig, h->GetEntries());
+            Mix(sig, h->GetMaximumStored());
+            Mix(sig, h->GetMinimumStored());
+            MixAxis(sig, h->GetXaxis());
+            if (h->GetDimension() > 1)
+                MixAxis(sig, h->GetYaxis());
+            return kTRUE;
+        }
+        if (obj->InheritsFrom(TGraph::Class()))
+        {
+            Mix(sig, (ULong64_t)((TGraph*)obj)->GetN());
+            return kTRUE;
+        }
+        return kFALSE;
+    }
+} // namespace
+
+R3BSofHttpSniffer::R3BSofHttpSniffer()
+    : TRootSnifferFull("sofsniff")
+    , fPeriod(1000)
+    , fMaxAge(60000)
+    , fNumRendered(0)
+    , fNumCached(0)
+{
+}
+
+R3BSofHttpSniffer::R3BSofHttpSniffer(const char* name, Int_t period)
+    : TRootSnifferFull(name)
+    , fPeriod(period)
+    , fMaxAge(60000)
+    , fNumRendered(0)
+    , fNumCached(0)
+{
+}
+
+R3BSofHttpSniffer::~R3BSofHttpSniffer() {}
+
+R3BSofHttpSniffer* R3BSofHttpSniffer::Install(THttpServer* server, Int_t period)
+{
+    if (!server)
+    {
+        LOG(ERROR) << "R3BSofHttpSniffer::Install() no http server, the canvases are not cached";
+        return NULL;
+    }
+    R3BSofHttpSniffer* sniffer = new R3BSofHttpSniffer("sofsniff", period);
+    // The registered objects are kept in the folders of gROOT, only the settings move
+    TRootSniffer* previous = server->GetSniffer();
+    if (previous)
+    {
+        sniffer->SetReadOnly(previous->IsReadOnly());
+        sniffer->SetScanGlobalDir(previous->IsScanGlobalDir());
+    }
+    server->SetSniffer(sniffer);
+    LOG(INFO) << "R3BSofHttpSniffer::Install() objects rendered at most every " << period << " ms";
+    return sniffer;
+}
+
+void R3BSofHttpSniffer::SetRefresh(const char* pattern, Int_t ms)
+{
+    fRefresh.push_back(std::make_pair(TString(pattern), ms));
+}
+
+Bool_t R3BSofHttpSniffer::ProduceJson(const std::string& path, const std::string& options, std::string& res)
+{
+    std::string key = "json:" + path + "?" + options;
+    TObject* obj = FindTObjectInHierarchy(path.c_str());
+    ULong64_t signature = 0;
+    if (FindCached(key, obj, res, signature))
+        return kTRUE;
+    if (!TRootSnifferFull::ProduceJson(path, options, res))
+        return kFALSE;
+    if (obj)
+        Store(key, signature, res);
+    return kTRUE;
+}
+
+Bool_t R3BSofHttpSniffer::ProduceImage(Int_t kind,
+                                       const std::string& path,
+                                       const std::string& options,
+                                       std::string& res)
+{
+    std::string key = Form("image%d:", kind) + path + "?" + options;
+    TObject* obj = FindTObjectInHierarchy(path.c_str());
+    ULong64_t signature = 0;
+    if (FindCached(key, obj, res, signature))
+        return kTRUE;
+    if (!TRootSnifferFull::ProduceImage(kind, path, options, res))
+        return kFALSE;
+    if (obj)
+        Store(key, signature, res);
+    return kTRUE;
+}
+
+Bool_t R3BSofHttpSniffer::FindCached(const std::string& key, TObject* obj, std::string& res, ULong64_t& signature)
+{
+    if (!obj)
+        return kFALSE;
+    std::map<std::string, Entry>::iterator it = fCache.find(key);
+    if (it == fCache.end())
+    {
+        // Signature taken before the rendering, a fill in between renders again next time
+        signature = Signature(obj);
+        return kFALSE;
+    }
+    Entry& entry = it->second;
+    Long64_t age = Now() - entry.fTime;
+    if (age < GetPeriod(obj))
+    {
+        res = entry.fResult;
+        fNumCached++;
+        return kTRUE;
+    }
+    signature = Signature(obj);
+    if (signature != 0 && signature == entry.fSignature && age < fMaxAge)
+    {
+        res = entry.fResult;
+        fNumCached++;
+        return kTRUE;
+    }
+    return kFALSE;
+}
+
+void R3BSofHttpSniffer::Store(const std::string& key, ULong64_t signature, const std::string& res)
+{
+    if (fCache.size() >= kMaxEntries && fCache.find(key) == fCache.end())
+        fCache.clear();
+    Entry& entry = fCache[key];
+    entry.fResult = res;
+    entry.fSignature = signature;
+    entry.fTime = Now();
+    fNumRendered++;
+}
+
+Int_t R3BSofHttpSniffer::GetPeriod(TObject* obj) const
+{
+    TString name = obj->GetName();
+    // The last matching pattern wins
+    for (size_t i = fRefresh.size(); i-- > 0;)
+    {
+        Ssiz_t len = 0;
+        if (name.Index(TRegexp(fRefresh[i].first, kTRUE), &len) == 0 && len == name.Length())
+            return fRefresh[i].second;
+    }
+    return fPeriod;
+}
+
+// 0 for objects whose changes cannot be tracked, e.g. text
+ULong64_t R3BSofHttpSniffer::Signature(TObject* obj)
+{
+    ULong64_t sig = 14695981039346656037ULL;
+    if (!AddSignature(obj, sig))
+        return 0;
+    return sig == 0 ? 1 : sig;
+}
+
+Long64_t R3BSofHttpSniffer::Now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+ClassImp(R3BSofHttpSniffer)
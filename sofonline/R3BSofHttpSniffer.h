@@ -0,0 +1,93 @@
+// ------------------------------------------------------------
+// -----                R3BSofHttpSniffer                 -----
+// -----   Cached rendering of the online canvases        -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofHttpSniffer_H
+#define R3BSofHttpSniffer_H
+
+#include "TRootSnifferFull.h"
+#include "TString.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class THttpServer;
+
+/**
+ * Sniffer of the online THttpServer keeping the last JSON and image
+ * renderings of every object requested by the browsers. An object is
+ * rendered again only when its histograms changed (entries, binning or
+ * range, through all the pads of a canvas) and its refresh period elapsed;
+ * in between, all the browser clients are served the cached rendering.
+ * Objects of which no change can be tracked, e.g. text, are rendered again
+ * every period, the others at the latest after SetMaxAge. Installed right
+ * after the server is activated:
+ *   run->ActivateHttpServer(refresh, port);
+ *   R3BSofHttpSniffer* sniffer = R3BSofHttpSniffer::Install(run->GetHttpServer(), 1000);
+ *   sniffer->SetRefresh("RawTof_*", 5000); // canvases by name, wildcards allowed
+ **/
+class R3BSofHttpSniffer : public TRootSnifferFull
+{
+  public:
+    /** Default constructor **/
+    R3BSofHttpSniffer();
+
+    /** Standard constructor
+     *@param period  Minimum time between two renderings of an object [ms]
+     **/
+    R3BSofHttpSniffer(const char* name, Int_t period = 1000);
+
+    /** Destructor **/
+    virtual ~R3BSofHttpSniffer();
+
+    /** Replaces the sniffer of the server, with its settings **/
+    static R3BSofHttpSniffer* Install(THttpServer* server, Int_t period = 1000);
+
+    /** Modifiers **/
+    void SetPeriod(Int_t ms) { fPeriod = ms; }
+    void SetMaxAge(Int_t ms) { fMaxAge = ms; }
+    void SetRefresh(const char* pattern, Int_t ms);
+    void ClearCache() { fCache.clear(); }
+
+    /** Accessors **/
+    ULong64_t GetNumRendered() const { return fNumRendered; }
+    ULong64_t GetNumCached() const { return fNumCached; }
+
+  protected:
+    virtual Bool_t ProduceJson(const std::string& path, const std::string& options, std::string& res);
+    virtual Bool_t ProduceImage(Int_t kind, const std::string& path, const std::string& options, std::string& res);
+
+  private:
+    struct Entry
+    {
+        std::string fResult;
+        ULong64_t fSignature;
+        Long64_t fTime; // of the rendering [ms]
+    };
+
+    Int_t fPeriod;
+    Int_t fMaxAge;
+    std::vector<std::pair<TString, Int_t>> fRefresh; //! periods by name pattern
+    std::map<std::string, Entry> fCache;              //! by kind, path and options
+
+    ULong64_t fNumRendered;
+    ULong64_t fNumCached;
+
+    /** Cached rendering if still valid, else key and signature of the new one **/
+    Bool_t FindCached(const std::string& key, TObject* obj, std::string& res, ULong64_t& signature);
+    void Store(const std::string& key, ULong64_t signature, const std::string& res);
+    Int_t GetPeriod(TObject* obj) const;
+
+    static ULong64_t Signature(TObject* obj);
+    static Long64_t Now();
+
+    R3BSofHttpSniffer(const R3BSofHttpSniffer&);
+    R3BSofHttpSniffer& operator=(const R3BSofHttpSniffer&);
+
+  public:
+    ClassDef(R3BSofHttpSniffer, 1)
+};
+
+#endif
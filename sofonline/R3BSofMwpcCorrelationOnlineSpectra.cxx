@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofMwpcCorrelationOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BSofMwpcCalData.h"
 #include "R3BSofMwpcHitData.h"
@@ -46,6 +49,10 @@ R3BSofMwpcCorrelationOnlineSpectra::R3BSofMwpcCorrelationOnlineSpectra()
     , fNameDet1("Mwpc1")
     , fNameDet2("Mwpc2")
     , fNEvents(0)
+    , fs2_mwpc_calx(NULL)
+    , fs2_mwpc_caly(NULL)
+    , fs2_mwpc_hitx(NULL)
+    , fs2_mwpc_hity(NULL)
 {
 }
 
@@ -61,6 +68,10 @@ R3BSofMwpcCorrelationOnlineSpectra::R3BSofMwpcCorrelationOnlineSpectra(const TSt
     , fNameDet1(namedet1)
     , fNameDet2(namedet2)
     , fNEvents(0)
+    , fs2_mwpc_calx(NULL)
+    , fs2_mwpc_caly(NULL)
+    , fs2_mwpc_hitx(NULL)
+    , fs2_mwpc_hity(NULL)
 {
 }
 
@@ -75,6 +86,10 @@ R3BSofMwpcCorrelationOnlineSpectra::~R3BSofMwpcCorrelationOnlineSpectra()
         delete fCalItemsMwpc2;
     if (fHitItemsMwpc2)
         delete fHitItemsMwpc2;
+    delete fs2_mwpc_calx;
+    delete fs2_mwpc_caly;
+    delete fs2_mwpc_hitx;
+    delete fs2_mwpc_hity;
 }
 
 InitStatus R3BSofMwpcCorrelationOnlineSpectra::Init()
@@ -94,24 +109,24 @@ InitStatus R3BSofMwpcCorrelationOnlineSpectra::Init()
     run->GetHttpServer()->Register("", this);
 
     // get access to mapped data of the mwpc detectors
-    fCalItemsMwpc1 = (TClonesArray*)mgr->GetObject(fNameDet1 + "CalData");
+    fCalItemsMwpc1 = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet1 + "CalData");
     if (!fCalItemsMwpc1)
     {
         return kFATAL;
     }
-    fCalItemsMwpc2 = (TClonesArray*)mgr->GetObject(fNameDet2 + "CalData");
+    fCalItemsMwpc2 = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet2 + "CalData");
     if (!fCalItemsMwpc2)
     {
         return kFATAL;
     }
 
     // get access to hit data of mwpcs
-    fHitItemsMwpc1 = (TClonesArray*)mgr->GetObject(fNameDet1 + "HitData");
+    fHitItemsMwpc1 = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet1 + "HitData");
     if (!fHitItemsMwpc1)
         LOG(WARNING) << "R3BSof" + fNameDet1 + "vs" + fNameDet2 + "CorrelationOnlineSpectra: " + fNameDet1 +
                             "HitData not found";
 
-    fHitItemsMwpc2 = (TClonesArray*)mgr->GetObject(fNameDet2 + "HitData");
+    fHitItemsMwpc2 = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet2 + "HitData");
     if (!fHitItemsMwpc2)
         LOG(WARNING) << "R3BSof" + fNameDet1 + "vs" + fNameDet2 + "CorrelationOnlineSpectra: " + fNameDet1 +
                             "HitData not found";
@@ -202,6 +217,11 @@ InitStatus R3BSofMwpcCorrelationOnlineSpectra::Init()
     cMWPCHit2D->cd(2);
     fh2_mwpc_hity->Draw("col");
 
+    fs2_mwpc_calx = R3BSofHistBackend::Book(fh2_mwpc_calx);
+    fs2_mwpc_caly = R3BSofHistBackend::Book(fh2_mwpc_caly);
+    fs2_mwpc_hitx = R3BSofHistBackend::Book(fh2_mwpc_hitx);
+    fs2_mwpc_hity = R3BSofHistBackend::Book(fh2_mwpc_hity);
+
     // MAIN FOLDER
     TFolder* mainfolMW = new TFolder(fNameDet1 + "-" + fNameDet2, fNameDet1 + "-" + fNameDet2 + " info");
     mainfolMW->Add(cMWPCCal2D);
@@ -220,14 +240,14 @@ void R3BSofMwpcCorrelationOnlineSpectra::Reset_Histo()
 {
     LOG(INFO) << "R3BSof" + fNameDet1 + "vs" + fNameDet2 + "CorrelationOnlineSpectra::Reset_Histo";
     // Cal data
-    fh2_mwpc_calx->Reset();
-    fh2_mwpc_caly->Reset();
+    fs2_mwpc_calx->Reset();
+    fs2_mwpc_caly->Reset();
 
     // Hit data
     if (fHitItemsMwpc1 && fHitItemsMwpc2)
     {
-        fh2_mwpc_hitx->Reset();
-        fh2_mwpc_hity->Reset();
+        fs2_mwpc_hitx->Reset();
+        fs2_mwpc_hity->Reset();
     }
 }
 
@@ -293,9 +313,9 @@ void R3BSofMwpcCorrelationOnlineSpectra::Exec(Option_t* option)
             }
         }
         if (maxpadx1 > -1 && maxpadx2 > -1)
-            fh2_mwpc_calx->Fill(maxpadx1 + gRandom->Uniform(-0.5, 0.5), maxpadx2 + gRandom->Uniform(-0.5, 0.5));
+            fs2_mwpc_calx->Fill(maxpadx1 + gRandom->Uniform(-0.5, 0.5), maxpadx2 + gRandom->Uniform(-0.5, 0.5));
         if (maxpady1 > -1 && maxpady2 > -1)
-            fh2_mwpc_caly->Fill(maxpady1 + gRandom->Uniform(-0.5, 0.5), maxpady2 + gRandom->Uniform(-0.5, 0.5));
+            fs2_mwpc_caly->Fill(maxpady1 + gRandom->Uniform(-0.5, 0.5), maxpady2 + gRandom->Uniform(-0.5, 0.5));
     }
 
     // Fill Hit data
@@ -324,8 +344,8 @@ void R3BSofMwpcCorrelationOnlineSpectra::Exec(Option_t* option)
         }
         if (mw1x > -500. && mw1y > -500. && mw2x > -500. && mw2y > -500.)
         {
-            fh2_mwpc_hitx->Fill(mw1x, mw2x);
-            fh2_mwpc_hity->Fill(mw1y, mw2y);
+            fs2_mwpc_hitx->Fill(mw1x, mw2x);
+            fs2_mwpc_hity->Fill(mw1y, mw2y);
         }
     }
 
@@ -354,7 +374,7 @@ void R3BSofMwpcCorrelationOnlineSpectra::FinishEvent()
 
 void R3BSofMwpcCorrelationOnlineSpectra::FinishTask()
 {
-
+    R3BSofHistBackend::Flush();
     if (fCalItemsMwpc1 && fCalItemsMwpc2)
     {
         cMWPCCal2D->Write();
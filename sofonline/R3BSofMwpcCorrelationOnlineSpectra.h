@@ -20,6 +20,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads MWPC data and plots online histograms
@@ -106,6 +107,12 @@ class R3BSofMwpcCorrelationOnlineSpectra : public FairTask
     TH2F* fh2_mwpc_hitx;
     TH2F* fh2_mwpc_hity;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs2_mwpc_calx; //!
+    R3BSofShardedHist* fs2_mwpc_caly; //!
+    R3BSofShardedHist* fs2_mwpc_hitx; //!
+    R3BSofShardedHist* fs2_mwpc_hity; //!
+
   public:
     ClassDef(R3BSofMwpcCorrelationOnlineSpectra, 1)
 };
@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofMwpcOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BSofMwpcCalData.h"
 #include "R3BSofMwpcHitData.h"
@@ -46,6 +49,13 @@ R3BSofMwpcOnlineSpectra::R3BSofMwpcOnlineSpectra()
     , fHitItemsMwpc(NULL)
     , fNameDet("MWPC")
     , fNEvents(0)
+    , fs2_mwpc_cal(NULL)
+    , fs1_mwpc_cal()
+    , fs2_mwpc_xq(NULL)
+    , fs2_mwpc_yq(NULL)
+    , fs1_Xpos(NULL)
+    , fs1_Ypos(NULL)
+    , fs2_XYpos(NULL)
 {
 }
 
@@ -55,6 +65,13 @@ R3BSofMwpcOnlineSpectra::R3BSofMwpcOnlineSpectra(const TString& name, Int_t iVer
     , fHitItemsMwpc(NULL)
     , fNameDet(namedet)
     , fNEvents(0)
+    , fs2_mwpc_cal(NULL)
+    , fs1_mwpc_cal()
+    , fs2_mwpc_xq(NULL)
+    , fs2_mwpc_yq(NULL)
+    , fs1_Xpos(NULL)
+    , fs1_Ypos(NULL)
+    , fs2_XYpos(NULL)
 {
 }
 
@@ -65,6 +82,14 @@ R3BSofMwpcOnlineSpectra::~R3BSofMwpcOnlineSpectra()
         delete fCalItemsMwpc;
     if (fHitItemsMwpc)
         delete fHitItemsMwpc;
+    delete fs2_mwpc_cal;
+    for (Int_t i = 0; i < 2; i++)
+        delete fs1_mwpc_cal[i];
+    delete fs2_mwpc_xq;
+    delete fs2_mwpc_yq;
+    delete fs1_Xpos;
+    delete fs1_Ypos;
+    delete fs2_XYpos;
 }
 
 InitStatus R3BSofMwpcOnlineSpectra::Init()
@@ -78,20 +103,20 @@ InitStatus R3BSofMwpcOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSof" + fNameDet + "OnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
     // get access to mapped data of mwpcs
-    fCalItemsMwpc = (TClonesArray*)mgr->GetObject(fNameDet + "CalData");
+    fCalItemsMwpc = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet + "CalData");
     if (!fCalItemsMwpc)
     {
         return kFATAL;
     }
 
     // get access to hit data of mwpcs
-    fHitItemsMwpc = (TClonesArray*)mgr->GetObject(fNameDet + "HitData");
+    fHitItemsMwpc = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet + "HitData");
     if (!fHitItemsMwpc)
         LOG(WARNING) << "R3BSofMwpcOnlineSpectra: " + fNameDet + "HitData not found";
 
@@ -269,6 +294,15 @@ InitStatus R3BSofMwpcOnlineSpectra::Init()
     fh2_XYpos->GetYaxis()->SetTitleSize(0.045);
     fh2_XYpos->Draw("col");
 
+    fs2_mwpc_cal = R3BSofHistBackend::Book(fh2_mwpc_cal);
+    for (Int_t i = 0; i < 2; i++)
+        fs1_mwpc_cal[i] = R3BSofHistBackend::Book(fh1_mwpc_cal[i]);
+    fs2_mwpc_xq = R3BSofHistBackend::Book(fh2_mwpc_xq);
+    fs2_mwpc_yq = R3BSofHistBackend::Book(fh2_mwpc_yq);
+    fs1_Xpos = R3BSofHistBackend::Book(fh1_Xpos);
+    fs1_Ypos = R3BSofHistBackend::Book(fh1_Ypos);
+    fs2_XYpos = R3BSofHistBackend::Book(fh2_XYpos);
+
     // MAIN FOLDER-MWPC
     TFolder* mainfolMW = new TFolder(fNameDet, fNameDet + " info");
     mainfolMW->Add(cMWPCCal);
@@ -297,17 +331,17 @@ void R3BSofMwpcOnlineSpectra::Reset_Histo()
     if (fCalItemsMwpc)
     {
         for (Int_t i = 0; i < 2; i++)
-            fh1_mwpc_cal[i]->Reset();
-        fh2_mwpc_cal->Reset();
-        fh2_mwpc_xq->Reset();
-        fh2_mwpc_yq->Reset();
+            fs1_mwpc_cal[i]->Reset();
+        fs2_mwpc_cal->Reset();
+        fs2_mwpc_xq->Reset();
+        fs2_mwpc_yq->Reset();
     }
     // Hit data
     if (fHitItemsMwpc)
     {
-        fh1_Xpos->Reset();
-        fh1_Ypos->Reset();
-        fh2_XYpos->Reset();
+        fs1_Xpos->Reset();
+        fs1_Ypos->Reset();
+        fs2_XYpos->Reset();
     }
 }
 
@@ -329,8 +363,8 @@ void R3BSofMwpcOnlineSpectra::Exec(Option_t* option)
                 continue;
             if (hit->GetPlane() == 1 || hit->GetPlane() == 2)
             {
-                fh1_mwpc_cal[0]->Fill(hit->GetPad());
-                fh2_mwpc_xq->Fill(hit->GetPad() + gRandom->Uniform(-0.5, 0.5), hit->GetQ());
+                fs1_mwpc_cal[0]->Fill(hit->GetPad());
+                fs2_mwpc_xq->Fill(hit->GetPad() + gRandom->Uniform(-0.5, 0.5), hit->GetQ());
                 if (hit->GetQ() > maxqx)
                 {
                     maxpadx = hit->GetPad();
@@ -339,8 +373,8 @@ void R3BSofMwpcOnlineSpectra::Exec(Option_t* option)
             }
             if (hit->GetPlane() == 3)
             {
-                fh1_mwpc_cal[1]->Fill(hit->GetPad());
-                fh2_mwpc_yq->Fill(hit->GetPad() + gRandom->Uniform(-0.5, 0.5), hit->GetQ());
+                fs1_mwpc_cal[1]->Fill(hit->GetPad());
+                fs2_mwpc_yq->Fill(hit->GetPad() + gRandom->Uniform(-0.5, 0.5), hit->GetQ());
                 if (hit->GetQ() > maxqy)
                 {
                     maxpady = hit->GetPad();
@@ -349,7 +383,7 @@ void R3BSofMwpcOnlineSpectra::Exec(Option_t* option)
             }
         }
         if (maxpadx > -1 && maxpady > -1)
-            fh2_mwpc_cal->Fill(maxpadx, maxpady);
+            fs2_mwpc_cal->Fill(maxpadx, maxpady);
     }
 
     // Fill Hit data
@@ -361,9 +395,9 @@ void R3BSofMwpcOnlineSpectra::Exec(Option_t* option)
             R3BSofMwpcHitData* hit = (R3BSofMwpcHitData*)fHitItemsMwpc->At(ihit);
             if (!hit)
                 continue;
-            fh1_Xpos->Fill(hit->GetX());
-            fh1_Ypos->Fill(hit->GetY());
-            fh2_XYpos->Fill(hit->GetX(), hit->GetY());
+            fs1_Xpos->Fill(hit->GetX());
+            fs1_Ypos->Fill(hit->GetY());
+            fs2_XYpos->Fill(hit->GetX(), hit->GetY());
         }
     }
 
@@ -385,7 +419,7 @@ void R3BSofMwpcOnlineSpectra::FinishEvent()
 
 void R3BSofMwpcOnlineSpectra::FinishTask()
 {
-
+    R3BSofHistBackend::Flush();
     if (fCalItemsMwpc)
     {
         cMWPCCal->Write();
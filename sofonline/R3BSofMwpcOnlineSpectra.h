@@ -20,6 +20,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads MWPC data and plots online histograms
@@ -108,6 +109,15 @@ class R3BSofMwpcOnlineSpectra : public FairTask
     TH1F* fh1_Ypos;
     TH2F* fh2_XYpos;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs2_mwpc_cal;    //!
+    R3BSofShardedHist* fs1_mwpc_cal[2]; //!
+    R3BSofShardedHist* fs2_mwpc_xq;     //!
+    R3BSofShardedHist* fs2_mwpc_yq;     //!
+    R3BSofShardedHist* fs1_Xpos;        //!
+    R3BSofShardedHist* fs1_Ypos;        //!
+    R3BSofShardedHist* fs2_XYpos;       //!
+
   public:
     ClassDef(R3BSofMwpcOnlineSpectra, 1)
 };
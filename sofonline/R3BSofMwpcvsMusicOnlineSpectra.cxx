@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofMwpcvsMusicOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BMusicHitData.h"
 #include "R3BMusicMappedData.h"
@@ -47,6 +50,9 @@ R3BSofMwpcvsMusicOnlineSpectra::R3BSofMwpcvsMusicOnlineSpectra()
     , fHitItemsMus(NULL)
     , fNameDet1("Mwpc0")
     , fNEvents(0)
+    , fs2_MusCorMwpc0_EsumVsX0mm(NULL)
+    , fs2_MusCorMwpc0_EsumVsY0mm(NULL)
+    , fs2_MusCorMwpc0_DTvsX0()
 {
 }
 
@@ -60,6 +66,9 @@ R3BSofMwpcvsMusicOnlineSpectra::R3BSofMwpcvsMusicOnlineSpectra(const TString& na
     , fHitItemsMus(NULL)
     , fNameDet1(namedet1)
     , fNEvents(0)
+    , fs2_MusCorMwpc0_EsumVsX0mm(NULL)
+    , fs2_MusCorMwpc0_EsumVsY0mm(NULL)
+    , fs2_MusCorMwpc0_DTvsX0()
 {
 }
 
@@ -74,6 +83,10 @@ R3BSofMwpcvsMusicOnlineSpectra::~R3BSofMwpcvsMusicOnlineSpectra()
         delete fMappedItemsMus;
     if (fHitItemsMus)
         delete fHitItemsMus;
+    delete fs2_MusCorMwpc0_EsumVsX0mm;
+    delete fs2_MusCorMwpc0_EsumVsY0mm;
+    for (Int_t i = 0; i < NbAnodesMus; i++)
+        delete fs2_MusCorMwpc0_DTvsX0[i];
 }
 
 InitStatus R3BSofMwpcvsMusicOnlineSpectra::Init()
@@ -92,24 +105,24 @@ InitStatus R3BSofMwpcvsMusicOnlineSpectra::Init()
     run->GetHttpServer()->Register("", this);
 
     // get access to mapped data of the mwpc detector
-    fCalItemsMwpc = (TClonesArray*)mgr->GetObject(fNameDet1 + "CalData");
+    fCalItemsMwpc = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet1 + "CalData");
     if (!fCalItemsMwpc)
     {
         return kFATAL;
     }
 
     // get access to hit data of mwpcs
-    fHitItemsMwpc = (TClonesArray*)mgr->GetObject(fNameDet1 + "HitData");
+    fHitItemsMwpc = (TClonesArray*)R3BSofOnlinePipeline::GetObject(fNameDet1 + "HitData");
     if (!fHitItemsMwpc)
         LOG(WARNING) << "R3BSof" + fNameDet1 + "vsMusicOnlineSpectra: " + fNameDet1 + "HitData not found";
 
     // get access to map data of the MUSIC
-    fMappedItemsMus = (TClonesArray*)mgr->GetObject("MusicMappedData");
+    fMappedItemsMus = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicMappedData");
     if (!fMappedItemsMus)
         LOG(WARNING) << "R3BSof" + fNameDet1 + "vsMusicOnlineSpectra: MusicMappedData not found";
 
     // get access to hit data of the MUSIC
-    fHitItemsMus = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fHitItemsMus = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fHitItemsMus)
         LOG(WARNING) << "R3BSof" + fNameDet1 + "vsMusicOnlineSpectra: MusicHitData not found";
 
@@ -166,6 +179,11 @@ InitStatus R3BSofMwpcvsMusicOnlineSpectra::Init()
     cMusECorMwpc0->cd(2);
     fh2_MusCorMwpc0_EsumVsY0mm->Draw("col");
 
+    fs2_MusCorMwpc0_EsumVsX0mm = R3BSofHistBackend::Book(fh2_MusCorMwpc0_EsumVsX0mm);
+    fs2_MusCorMwpc0_EsumVsY0mm = R3BSofHistBackend::Book(fh2_MusCorMwpc0_EsumVsY0mm);
+    for (Int_t i = 0; i < NbAnodesMus; i++)
+        fs2_MusCorMwpc0_DTvsX0[i] = R3BSofHistBackend::Book(fh2_MusCorMwpc0_DTvsX0[i]);
+
     // MAIN FOLDER
     TFolder* mainfol = new TFolder(fNameDet1 + "-Music", fNameDet1 + "-Music info");
     mainfol->Add(cMusECorMwpc0);
@@ -185,10 +203,10 @@ void R3BSofMwpcvsMusicOnlineSpectra::Reset_Histo()
     // Cal data
     for (Int_t j = 0; j < NbAnodesMus; j++)
     {
-        fh2_MusCorMwpc0_DTvsX0[j]->Reset();
+        fs2_MusCorMwpc0_DTvsX0[j]->Reset();
     }
-    fh2_MusCorMwpc0_EsumVsX0mm->Reset();
-    fh2_MusCorMwpc0_EsumVsY0mm->Reset();
+    fs2_MusCorMwpc0_EsumVsX0mm->Reset();
+    fs2_MusCorMwpc0_EsumVsY0mm->Reset();
     // Hit data
 }
 
@@ -243,13 +261,13 @@ void R3BSofMwpcvsMusicOnlineSpectra::Exec(Option_t* option)
                     R3BSofMwpcHitData* hit = (R3BSofMwpcHitData*)fHitItemsMwpc->At(ihit);
                     if (!hit)
                         continue;
-                    fh2_MusCorMwpc0_EsumVsX0mm->Fill(hit->GetX(), (e1 + e2) / (n1 + n2));
-                    fh2_MusCorMwpc0_EsumVsY0mm->Fill(hit->GetY(), (e1 + e2) / (n1 + n2));
+                    fs2_MusCorMwpc0_EsumVsX0mm->Fill(hit->GetX(), (e1 + e2) / (n1 + n2));
+                    fs2_MusCorMwpc0_EsumVsY0mm->Fill(hit->GetY(), (e1 + e2) / (n1 + n2));
                     for (Int_t i = 0; i < NbAnodesMus; i++)
                     {
                         if (multhit[NbAnodesMus] == 1 && multhit[i] == 1)
                         {
-                            fh2_MusCorMwpc0_DTvsX0[i]->Fill(hit->GetX(), fT[i] - fT[NbAnodesMus]);
+                            fs2_MusCorMwpc0_DTvsX0[i]->Fill(hit->GetX(), fT[i] - fT[NbAnodesMus]);
                         }
                     }
                 }
@@ -282,7 +300,7 @@ void R3BSofMwpcvsMusicOnlineSpectra::FinishEvent()
 
 void R3BSofMwpcvsMusicOnlineSpectra::FinishTask()
 {
-
+    R3BSofHistBackend::Flush();
     if (fCalItemsMwpc && fMappedItemsMus)
     {
     }
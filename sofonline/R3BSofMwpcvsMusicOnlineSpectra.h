@@ -22,6 +22,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads MWPC data and plots online histograms
@@ -106,6 +107,11 @@ class R3BSofMwpcvsMusicOnlineSpectra : public FairTask
     TH2F* fh2_MusCorMwpc0_EsumVsY0mm;
     TH2F* fh2_MusCorMwpc0_DTvsX0[NbAnodesMus];
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs2_MusCorMwpc0_EsumVsX0mm;          //!
+    R3BSofShardedHist* fs2_MusCorMwpc0_EsumVsY0mm;          //!
+    R3BSofShardedHist* fs2_MusCorMwpc0_DTvsX0[NbAnodesMus]; //!
+
   public:
     ClassDef(R3BSofMwpcvsMusicOnlineSpectra, 1)
 };
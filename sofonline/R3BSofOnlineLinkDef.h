@@ -22,5 +22,9 @@
 #pragma link C++ class R3BAmsCorrelationOnlineSpectra + ;
 #pragma link C++ class R3BSofTrackingOnlineSpectra + ;
 #pragma link C++ class R3BSofScalersOnlineSpectra + ;
+#pragma link C++ class R3BSofOnlinePipeline + ;
+#pragma link C++ class R3BSofTaskMonitor + ;
+#pragma link C++ class R3BSofHistBackend + ;
+#pragma link C++ class R3BSofHttpSniffer + ;
 
 #endif
@@ -0,0 +1,367 @@
+// ------------------------------------------------------------
+// -----              R3BSofOnlinePipeline                -----
+// -----     Online tasks run on a thread of their own    -----
+// ------------------------------------------------------------
+
+#include "R3BSofOnlinePipeline.h"
+#include "R3BEventHeader.h"
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include "FairRun.h"
+
+#include "TClass.h"
+#include "TClonesArray.h"
+#include "TDataMember.h"
+#include "TList.h"
+#include "TNamed.h"
+#include "TRealData.h"
+
+#include <chrono>
+#include <cstring>
+
+R3BSofOnlinePipeline* R3BSofOnlinePipeline::fgInit = NULL;
+
+R3BSofOnlinePipeline::R3BSofOnlinePipeline()
+    : FairTask("R3BSofOnlinePipeline", 1)
+    , fDepth(256)
+    , fPolicy(kDrop)
+    , fConnectFailed(kFALSE)
+    , fHeaderIn(NULL)
+    , fHeaderOut(NULL)
+    , fHead(0)
+    , fTail(0)
+    , fDone(0)
+    , fStop(kFALSE)
+    , fNumEvents(0)
+    , fNumDropped(0)
+    , fNumBlocked(0)
+    , fMaxOccupancy(0)
+{
+}
+
+R3BSofOnlinePipeline::R3BSofOnlinePipeline(const char* name, Int_t depth, EPolicy policy, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+    , fDepth(depth)
+    , fPolicy(policy)
+    , fConnectFailed(kFALSE)
+    , fHeaderIn(NULL)
+    , fHeaderOut(NULL)
+    , fHead(0)
+    , fTail(0)
+    , fDone(0)
+    , fStop(kFALSE)
+    , fNumEvents(0)
+    , fNumDropped(0)
+    , fNumBlocked(0)
+    , fMaxOccupancy(0)
+{
+}
+
+R3BSofOnlinePipeline::~R3BSofOnlinePipeline()
+{
+    Stop();
+    // the output arrays belong to the tasks of the stage from Init on
+    for (size_t i = 0; i < fSlots.size(); i++)
+        delete fSlots[i];
+    for (size_t i = 0; i < fSlotHeaders.size(); i++)
+        delete fSlotHeaders[i];
+    for (size_t i = 0; i < fObjSlots.size(); i++)
+        delete fObjSlots[i];
+}
+
+void R3BSofOnlinePipeline::Add(TTask* task)
+{
+    FairTask* ftask = dynamic_cast<FairTask*>(task);
+    if (!ftask)
+    {
+        LOG(ERROR) << "R3BSofOnlinePipeline::Add() " << task->GetName() << " is not a FairTask";
+        return;
+    }
+    fStageTasks.push_back(ftask);
+}
+
+TObject* R3BSofOnlinePipeline::GetObject(const TString& name)
+{
+    TObject* obj = FairRootManager::Instance()->GetObject(name);
+    if (!fgInit || !obj)
+        return obj;
+    return fgInit->Connect(name, obj);
+}
+
+FairTask* R3BSofOnlinePipeline::GetTask(const TString& name)
+{
+    FairRun* run = FairRun::Instance();
+    if (!run)
+        return NULL;
+    FairTask* task = run->GetTask(name);
+    if (task || !run->GetMainTask())
+        return task;
+    TIter next(run->GetMainTask()->GetListOfTasks());
+    while (TObject* obj = next())
+    {
+        R3BSofOnlinePipeline* pipeline = dynamic_cast<R3BSofOnlinePipeline*>(obj);
+        if (pipeline && (task = pipeline->FindStageTask(name)))
+            return task;
+    }
+    return NULL;
+}
+
+FairTask* R3BSofOnlinePipeline::FindStageTask(const TString& name) const
+{
+    for (size_t t = 0; t < fStageTasks.size(); t++)
+        if (name == fStageTasks[t]->GetName())
+            return fStageTasks[t];
+    return NULL;
+}
+
+TObject* R3BSofOnlinePipeline::Connect(const TString& name, TObject* obj)
+{
+    // branch already passed to the stage
+    for (size_t b = 0; b < fNames.size(); b++)
+        if (fNames[b] == name)
+            return fOutput[b];
+    if (obj == fHeaderIn)
+        return fHeaderOut;
+    for (size_t o = 0; o < fObjIn.size(); o++)
+        if (fObjIn[o] == obj)
+            return fObjOut[o];
+
+    if (obj->InheritsFrom(R3BEventHeader::Class()))
+    {
+        fHeaderIn = (R3BEventHeader*)obj;
+        fHeaderOut = new R3BEventHeader();
+        for (Int_t k = 0; k < fDepth; k++)
+            fSlotHeaders.push_back(new R3BEventHeader());
+        return fHeaderOut;
+    }
+
+    TClonesArray* input = dynamic_cast<TClonesArray*>(obj);
+    if (!input)
+    {
+        // single object (e.g. a bitmask of the event): the members of the
+        // class past its TNamed or TObject base are copied
+        TClass* cl = obj->IsA();
+        TClass* base = obj->InheritsFrom(TNamed::Class()) ? TNamed::Class() : TObject::Class();
+        if (!IsFlat(cl, base))
+        {
+            // the stage would read the object while the event loop writes it
+            LOG(ERROR) << "R3BSofOnlinePipeline::Connect() " << name << " is neither a TClonesArray nor a flat "
+                       << base->GetName() << ", its tasks must run in the event loop";
+            fConnectFailed = kTRUE;
+            return obj;
+        }
+        fObjIn.push_back(obj);
+        fObjOut.push_back((TObject*)cl->New());
+        fObjOffset.push_back(base->Size());
+        fObjPayload.push_back(cl->Size() - base->Size());
+        for (Int_t k = 0; k < fDepth; k++)
+            fObjSlots.push_back((TObject*)cl->New());
+        return fObjOut.back();
+    }
+
+    // the objects are copied member by member, only for flat classes
+    TClass* cl = input->GetClass();
+    if (!IsFlat(cl, TObject::Class()))
+    {
+        LOG(ERROR) << "R3BSofOnlinePipeline::Connect() " << cl->GetName() << " of " << name
+                   << " is not a flat class, its tasks must run in the event loop";
+        fConnectFailed = kTRUE;
+        return obj;
+    }
+
+    fNames.push_back(name);
+    fInput.push_back(input);
+    fOutput.push_back(new TClonesArray(cl->GetName()));
+    fPayload.push_back(cl->Size() - sizeof(TObject));
+    for (Int_t k = 0; k < fDepth; k++)
+        fSlots.push_back(new TClonesArray(cl->GetName()));
+    return fOutput.back();
+}
+
+void R3BSofOnlinePipeline::SetParContainers()
+{
+    for (size_t t = 0; t < fStageTasks.size(); t++)
+        fStageTasks[t]->SetParTask();
+}
+
+InitStatus R3BSofOnlinePipeline::Init()
+{
+    LOG(INFO) << "R3BSofOnlinePipeline::Init() " << GetName() << ": " << fStageTasks.size() << " tasks, depth "
+              << fDepth << ", " << (fPolicy == kBlock ? "blocking" : "dropping") << " when full";
+    if (fDepth < 1)
+    {
+        LOG(ERROR) << "R3BSofOnlinePipeline::Init() depth " << fDepth << " of " << GetName();
+        return kFATAL;
+    }
+
+    fgInit = this;
+    for (size_t t = 0; t < fStageTasks.size(); t++)
+        fStageTasks[t]->InitTask();
+    fgInit = NULL;
+    if (fConnectFailed)
+    {
+        LOG(ERROR) << "R3BSofOnlinePipeline::Init() inputs of " << GetName() << " cannot be passed to the stage";
+        return kFATAL;
+    }
+
+    LOG(INFO) << "R3BSofOnlinePipeline::Init() " << fNames.size() << " branches, " << fObjIn.size() << " objects"
+              << (fHeaderIn ? " and the event header" : "") << " passed to " << GetName();
+    Start();
+    return kSUCCESS;
+}
+
+InitStatus R3BSofOnlinePipeline::ReInit()
+{
+    Drain();
+    for (size_t t = 0; t < fStageTasks.size(); t++)
+        fStageTasks[t]->ReInitTask();
+    return kSUCCESS;
+}
+
+void R3BSofOnlinePipeline::Exec(Option_t* option)
+{
+    fNumEvents++;
+    const ULong64_t tail = fTail.load(std::memory_order_relaxed);
+    ULong64_t occupancy = tail - fHead.load(std::memory_order_acquire);
+    if (occupancy >= (ULong64_t)fDepth)
+    {
+        if (fPolicy == kDrop)
+        {
+            fNumDropped++;
+            return;
+        }
+        fNumBlocked++;
+        while (tail - fHead.load(std::memory_order_acquire) >= (ULong64_t)fDepth)
+            std::this_thread::yield();
+    }
+    if (occupancy >= fMaxOccupancy)
+        fMaxOccupancy = occupancy + 1;
+
+    const Int_t k = tail % fDepth;
+    for (size_t b = 0; b < fInput.size(); b++)
+        CopyArray(fInput[b], fSlots[b * fDepth + k], fPayload[b]);
+    if (fHeaderIn)
+        CopyHeader(fHeaderIn, fSlotHeaders[k]);
+    for (size_t o = 0; o < fObjIn.size(); o++)
+        CopyObject(fObjIn[o], fObjSlots[o * fDepth + k], fObjOffset[o], fObjPayload[o]);
+    fTail.store(tail + 1, std::memory_order_release);
+}
+
+void R3BSofOnlinePipeline::FinishTask()
+{
+    Stop();
+    LOG(INFO) << "R3BSofOnlinePipeline " << GetName() << ": " << fNumEvents - fNumDropped << " of " << fNumEvents
+              << " events passed, " << fNumDropped << " dropped, " << fNumBlocked
+              << " waits for a free slot, maximum occupancy " << fMaxOccupancy << "/" << fDepth;
+    for (size_t t = 0; t < fStageTasks.size(); t++)
+        fStageTasks[t]->FinishTask();
+}
+
+void R3BSofOnlinePipeline::Start()
+{
+    if (fThread.joinable())
+        return;
+    fStop.store(kFALSE);
+    fThread = std::thread(&R3BSofOnlinePipeline::Run, this);
+}
+
+void R3BSofOnlinePipeline::Stop()
+{
+    if (!fThread.joinable())
+        return;
+    fStop.store(kTRUE, std::memory_order_release);
+    fThread.join();
+}
+
+void R3BSofOnlinePipeline::Drain()
+{
+    while (fThread.joinable() && fDone.load(std::memory_order_acquire) != fTail.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+}
+
+void R3BSofOnlinePipeline::Run()
+{
+    ULong64_t head = fHead.load(std::memory_order_relaxed);
+    while (kTRUE)
+    {
+        if (head == fTail.load(std::memory_order_acquire))
+        {
+            // the queue is emptied before stopping
+            if (fStop.load(std::memory_order_acquire))
+            {
+                if (head == fTail.load(std::memory_order_acquire))
+                    break;
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        const Int_t k = head % fDepth;
+        for (size_t b = 0; b < fOutput.size(); b++)
+            CopyArray(fSlots[b * fDepth + k], fOutput[b], fPayload[b]);
+        if (fHeaderOut)
+            CopyHeader(fSlotHeaders[k], fHeaderOut);
+        for (size_t o = 0; o < fObjOut.size(); o++)
+            CopyObject(fObjSlots[o * fDepth + k], fObjOut[o], fObjOffset[o], fObjPayload[o]);
+        // the slot is free again
+        fHead.store(++head, std::memory_order_release);
+
+        for (size_t t = 0; t < fStageTasks.size(); t++)
+        {
+            if (!fStageTasks[t]->IsActive())
+                continue;
+            fStageTasks[t]->Exec("");
+            fStageTasks[t]->FinishEvent();
+        }
+        fDone.store(head, std::memory_order_release);
+    }
+}
+
+Bool_t R3BSofOnlinePipeline::IsFlat(TClass* cl, TClass* base)
+{
+    // basic members only, apart from those of the base placed first
+    if (cl->GetBaseClassOffset(base) != 0)
+        return kFALSE;
+    cl->BuildRealData();
+    TIter next(cl->GetListOfRealData());
+    while (TRealData* rd = (TRealData*)next())
+    {
+        TDataMember* dm = rd->GetDataMember();
+        if (dm && base->InheritsFrom(dm->GetClass()))
+            continue;
+        if (!dm || dm->IsaPointer() || !(dm->IsBasic() || dm->IsEnum()))
+            return kFALSE;
+    }
+    return kTRUE;
+}
+
+void R3BSofOnlinePipeline::CopyArray(TClonesArray* from, TClonesArray* to, Int_t payload)
+{
+    // the objects of the destination are constructed once and then reused
+    to->Clear();
+    const Int_t n = from->GetEntriesFast();
+    for (Int_t i = 0; i < n; i++)
+    {
+        const char* src = (const char*)from->UncheckedAt(i);
+        char* dst = (char*)to->ConstructedAt(i);
+        memcpy(dst + sizeof(TObject), src + sizeof(TObject), payload);
+    }
+}
+
+void R3BSofOnlinePipeline::CopyHeader(R3BEventHeader* from, R3BEventHeader* to)
+{
+    to->SetEventno(from->GetEventno());
+    to->SetTrigger(from->GetTrigger());
+    to->SetTimeStamp(from->GetTimeStamp());
+    to->SetTpat(from->GetTpat());
+    to->SetTStart(from->GetTStart());
+}
+
+void R3BSofOnlinePipeline::CopyObject(TObject* from, TObject* to, Int_t offset, Int_t payload)
+{
+    memcpy((char*)to + offset, (const char*)from + offset, payload);
+}
+
+ClassImp(R3BSofOnlinePipeline)
@@ -0,0 +1,159 @@
+// ------------------------------------------------------------
+// -----              R3BSofOnlinePipeline                -----
+// -----     Online tasks run on a thread of their own    -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofOnlinePipeline_H
+#define R3BSofOnlinePipeline_H
+
+#include "FairTask.h"
+#include "TString.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TClass;
+class TClonesArray;
+class R3BEventHeader;
+
+/**
+ * Stage of the online analysis running its tasks (typically the online
+ * spectra) on a thread of its own, so that the event loop (unpacking and
+ * calibration) does not wait for the filling of the histograms.
+ *
+ * The tasks are added to the pipeline instead of the run:
+ *   R3BSofOnlinePipeline* spectra = new R3BSofOnlinePipeline("Spectra", 256, R3BSofOnlinePipeline::kDrop);
+ *   spectra->Add(tofwOnline);
+ *   run->AddTask(spectra); // after the calibration tasks
+ *
+ * The data are passed through a bounded lock-free queue (one producer, one
+ * consumer) of depth events. When the queue is full, the event is either not
+ * passed to the stage (kDrop, the spectra sample the data at full trigger rate)
+ * or the event loop waits for a free slot (kBlock, back-pressure, no event lost).
+ * Several pipelines can be used, each with its own thread, depth and policy.
+ *
+ * The tasks of the stage get their inputs with R3BSofOnlinePipeline::GetObject()
+ * instead of FairRootManager::GetObject(), which returns the copy of the branch
+ * owned by the stage. Only the TClonesArray of flat data classes (basic members
+ * only), single objects of flat classes deriving from TObject or TNamed (e.g.
+ * SofTofWFiredPaddles) and R3BEventHeader can be copied, Init fails for any
+ * other input. The
+ * tasks of the stage are found with R3BSofOnlinePipeline::GetTask(), the
+ * tasks of the run being searched first.
+ *
+ * THttpServer reads the histograms and runs the commands on the thread of the
+ * event loop: the tasks of a stage must fill their histograms through
+ * R3BSofHistBackend, which publishes them on that thread.
+ **/
+class R3BSofOnlinePipeline : public FairTask
+{
+
+  public:
+    enum EPolicy
+    {
+        kBlock = 0, // Event loop waits for a free slot
+        kDrop       // Event not passed to the stage
+    };
+
+    /** Default constructor **/
+    R3BSofOnlinePipeline();
+
+    /** Standard constructor
+     *@param depth   Number of events in the queue
+     *@param policy  Behaviour when the queue is full
+     **/
+    R3BSofOnlinePipeline(const char* name, Int_t depth = 256, EPolicy policy = kDrop, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofOnlinePipeline();
+
+    /** Adds a task to the stage, it is run on the thread of the stage **/
+    virtual void Add(TTask* task);
+
+    /** Replacement of FairRootManager::GetObject() for the tasks of a stage **/
+    static TObject* GetObject(const TString& name);
+
+    /** Replacement of FairRun::GetTask(), also searches the tasks of the pipelines of the run **/
+    static FairTask* GetTask(const TString& name);
+
+    /** Task of the stage, NULL if none of this name **/
+    FairTask* FindStageTask(const TString& name) const;
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Virtual method ReInit **/
+    virtual InitStatus ReInit();
+
+    /** Virtual method Exec, passes the event to the stage **/
+    virtual void Exec(Option_t* option);
+
+    /** The tasks of the stage are not executed by the event loop **/
+    virtual void ExecuteTasks(Option_t* option) {}
+
+    /** Virtual method FinishTask **/
+    virtual void FinishTask();
+
+    /** Modifiers **/
+    void SetDepth(Int_t depth) { fDepth = depth; }
+    void SetPolicy(EPolicy policy) { fPolicy = policy; }
+
+  protected:
+    /** Virtual method SetParContainers **/
+    virtual void SetParContainers();
+
+  private:
+    Int_t fDepth;
+    EPolicy fPolicy;
+    std::vector<FairTask*> fStageTasks; //!
+    Bool_t fConnectFailed;              //! an input cannot be copied to the stage
+
+    // Branches passed to the stage: event loop, slots of the queue and stage
+    std::vector<TString> fNames;               //!
+    std::vector<TClonesArray*> fInput;         //!
+    std::vector<TClonesArray*> fSlots;         //! [branch * fDepth + slot]
+    std::vector<TClonesArray*> fOutput;        //!
+    std::vector<Int_t> fPayload;               //! bytes copied per object
+    R3BEventHeader* fHeaderIn;                 //!
+    R3BEventHeader* fHeaderOut;                //!
+    std::vector<R3BEventHeader*> fSlotHeaders; //!
+    std::vector<TObject*> fObjIn;              //! single objects
+    std::vector<TObject*> fObjSlots;           //! [object * fDepth + slot]
+    std::vector<TObject*> fObjOut;             //!
+    std::vector<Int_t> fObjOffset;             //! first byte copied, size of the base
+    std::vector<Int_t> fObjPayload;            //!
+
+    // Queue: events fHead to fTail - 1 wait for the stage
+    std::atomic<ULong64_t> fHead; //!
+    std::atomic<ULong64_t> fTail; //!
+    std::atomic<ULong64_t> fDone; //! events executed by the stage
+    std::atomic<Bool_t> fStop;    //!
+    std::thread fThread;          //!
+
+    // Statistics
+    ULong64_t fNumEvents;
+    ULong64_t fNumDropped;
+    ULong64_t fNumBlocked;
+    ULong64_t fMaxOccupancy;
+
+    static R3BSofOnlinePipeline* fgInit; // pipeline whose tasks are initialised
+
+    TObject* Connect(const TString& name, TObject* obj);
+    void Start();
+    void Stop();
+    void Drain();
+    void Run();
+    static Bool_t IsFlat(TClass* cl, TClass* base);
+    static void CopyArray(TClonesArray* from, TClonesArray* to, Int_t payload);
+    static void CopyHeader(R3BEventHeader* from, R3BEventHeader* to);
+    static void CopyObject(TObject* from, TObject* to, Int_t offset, Int_t payload);
+
+    R3BSofOnlinePipeline(const R3BSofOnlinePipeline&);
+    R3BSofOnlinePipeline& operator=(const R3BSofOnlinePipeline&);
+
+  public:
+    ClassDef(R3BSofOnlinePipeline, 1)
+};
+
+#endif
@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BAmsOnlineSpectra.h"
 #include "R3BCalifaOnlineSpectra.h"
 #include "R3BEventHeader.h"
@@ -83,6 +86,9 @@ R3BSofOnlineSpectra::R3BSofOnlineSpectra()
     , fWRItemsS2(NULL)
     , fWRItemsS8(NULL)
     , fNEvents(0)
+    , fs1_trigger(NULL)
+    , fs1_wr(NULL)
+    , fs1_wrs()
 {
 }
 
@@ -115,6 +121,9 @@ R3BSofOnlineSpectra::R3BSofOnlineSpectra(const TString& name, Int_t iVerbose)
     , fWRItemsS2(NULL)
     , fWRItemsS8(NULL)
     , fNEvents(0)
+    , fs1_trigger(NULL)
+    , fs1_wr(NULL)
+    , fs1_wrs()
 {
 }
 
@@ -134,6 +143,10 @@ R3BSofOnlineSpectra::~R3BSofOnlineSpectra()
         delete fWRItemsS2;
     if (fWRItemsS8)
         delete fWRItemsS8;
+    delete fs1_trigger;
+    delete fs1_wr;
+    for (Int_t i = 0; i < 5; i++)
+        delete fs1_wrs[i];
 }
 
 InitStatus R3BSofOnlineSpectra::Init()
@@ -147,7 +160,7 @@ InitStatus R3BSofOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofOnlineSpectra::Init FairRootManager not found";
-    fEventHeader = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    fEventHeader = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     if (NULL == run)
@@ -155,142 +168,142 @@ InitStatus R3BSofOnlineSpectra::Init()
     run->GetHttpServer()->Register("", this);
 
     // get access to WR-Master data
-    fWRItemsMaster = (TClonesArray*)mgr->GetObject("WRMasterData");
+    fWRItemsMaster = (TClonesArray*)R3BSofOnlinePipeline::GetObject("WRMasterData");
     if (!fWRItemsMaster)
     {
         LOG(WARNING) << "R3BSofOnlineSpectra::WRMasterData not found";
     }
 
     // get access to WR-Sofia data
-    fWRItemsSofia = (TClonesArray*)mgr->GetObject("SofWRData");
+    fWRItemsSofia = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofWRData");
     if (!fWRItemsSofia)
     {
         LOG(WARNING) << "R3BSofOnlineSpectra::SofWRData not found";
     }
 
     // get access to WR-Califa data
-    fWRItemsCalifa = (TClonesArray*)mgr->GetObject("WRCalifaData");
+    fWRItemsCalifa = (TClonesArray*)R3BSofOnlinePipeline::GetObject("WRCalifaData");
     if (!fWRItemsCalifa)
     {
         LOG(WARNING) << "R3BSofOnlineSpectra::WRCalifaData not found";
     }
 
     // get access to WR-Neuland data
-    fWRItemsNeuland = (TClonesArray*)mgr->GetObject("WRNeulandData");
+    fWRItemsNeuland = (TClonesArray*)R3BSofOnlinePipeline::GetObject("WRNeulandData");
     if (!fWRItemsNeuland)
     {
         LOG(WARNING) << "R3BSofOnlineSpectra::WRNeulandData not found";
     }
 
     // get access to WR-S2 data
-    fWRItemsS2 = (TClonesArray*)mgr->GetObject("WRS2Data");
+    fWRItemsS2 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("WRS2Data");
     if (!fWRItemsS2)
     {
         LOG(WARNING) << "R3BSofOnlineSpectra::WRS2Data not found";
     }
 
     // get access to WR-S8 data
-    fWRItemsS8 = (TClonesArray*)mgr->GetObject("WRS8Data");
+    fWRItemsS8 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("WRS8Data");
     if (!fWRItemsS8)
     {
         LOG(WARNING) << "R3BSofOnlineSpectra::WRS8Data not found";
     }
 
     // Looking for AT online
-    fAtOnline = (R3BSofAtOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofAtOnlineSpectra");
+    fAtOnline = (R3BSofAtOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofAtOnlineSpectra");
     if (!fAtOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofAtOnlineSpectra not found";
 
     // Looking for Mwpc0 online
-    fMwpc0Online = (R3BSofMwpcOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc0OnlineSpectra");
+    fMwpc0Online = (R3BSofMwpcOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc0OnlineSpectra");
     if (!fMwpc0Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc0OnlineSpectra not found";
 
     // Looking for Mwpc0_1 online
     fMwpc01Online =
-        (R3BSofMwpcCorrelationOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc0_1CorrelationOnlineSpectra");
+        (R3BSofMwpcCorrelationOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc0_1CorrelationOnlineSpectra");
     if (!fMwpc01Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc0_1CorrelationOnlineSpectra not found";
 
     // Looking for Mwpc0_2 online
     fMwpc02Online =
-        (R3BSofMwpcCorrelationOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc0_2CorrelationOnlineSpectra");
+        (R3BSofMwpcCorrelationOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc0_2CorrelationOnlineSpectra");
     if (!fMwpc02Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc0_2CorrelationOnlineSpectra not found";
 
     // Looking for Mwpc1_2 online
     fMwpc12Online =
-        (R3BSofMwpcCorrelationOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc1_2CorrelationOnlineSpectra");
+        (R3BSofMwpcCorrelationOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc1_2CorrelationOnlineSpectra");
     if (!fMwpc12Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc1_2CorrelationOnlineSpectra not found";
 
     // Looking for Mwpc2_3 online
     fMwpc23Online =
-        (R3BSofMwpcCorrelationOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc2_3CorrelationOnlineSpectra");
+        (R3BSofMwpcCorrelationOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc2_3CorrelationOnlineSpectra");
     if (!fMwpc23Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc0_1CorrelationOnlineSpectra not found";
 
-    fFrsOnline = (R3BSofFrsOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofFrsOnlineSpectra");
+    fFrsOnline = (R3BSofFrsOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofFrsOnlineSpectra");
     if (!fFrsOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofFrsOnlineSpectra not found";
 
     // Looking for Mwpc1 online
-    fMwpc1Online = (R3BSofMwpcOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc1OnlineSpectra");
+    fMwpc1Online = (R3BSofMwpcOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc1OnlineSpectra");
     if (!fMwpc1Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc1OnlineSpectra not found";
 
     // Looking for Mwpc2 online
-    fMwpc2Online = (R3BSofMwpcOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc2OnlineSpectra");
+    fMwpc2Online = (R3BSofMwpcOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc2OnlineSpectra");
     if (!fMwpc2Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc2OnlineSpectra not found";
 
     // Looking for Mwpc3 online
-    fMwpc3Online = (R3BSofMwpcOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofMwpc3OnlineSpectra");
+    fMwpc3Online = (R3BSofMwpcOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofMwpc3OnlineSpectra");
     if (!fMwpc3Online)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofMwpc3OnlineSpectra not found";
 
     // Looking for Trim online
-    fTrimOnline = (R3BSofTrimOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofTrimOnlineSpectra");
+    fTrimOnline = (R3BSofTrimOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofTrimOnlineSpectra");
     if (!fTrimOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofTrimOnlineSpectra not found";
 
     // Looking for Twim online
-    fTwimOnline = (R3BSofTwimOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofTwimOnlineSpectra");
+    fTwimOnline = (R3BSofTwimOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofTwimOnlineSpectra");
     if (!fTwimOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofTwimOnlineSpectra not found";
 
     // Looking for Sci online
-    fSciOnline = (R3BSofSciOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofSciOnlineSpectra");
+    fSciOnline = (R3BSofSciOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofSciOnlineSpectra");
     if (!fSciOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofSciOnlineSpectra not found";
 
     // Looking for TofW online
-    fTofWOnline = (R3BSofTofWOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofTofWOnlineSpectra");
+    fTofWOnline = (R3BSofTofWOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofTofWOnlineSpectra");
     if (!fTofWOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofTofWOnlineSpectra not found";
 
     // Looking for Scalers online
-    fScalersOnline = (R3BSofScalersOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofScalersOnlineSpectra");
+    fScalersOnline = (R3BSofScalersOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofScalersOnlineSpectra");
     if (!fScalersOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofScalersOnlineSpectra not found";
 
     // Looking for Music online
-    fMusicOnline = (R3BMusicOnlineSpectra*)FairRunOnline::Instance()->GetTask("R3BMusicOnlineSpectra");
+    fMusicOnline = (R3BMusicOnlineSpectra*)R3BSofOnlinePipeline::GetTask("R3BMusicOnlineSpectra");
     if (!fMusicOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::R3BMusicOnlineSpectra not found";
 
     // Looking for AMS online
-    fAmsOnline = (R3BAmsOnlineSpectra*)FairRunOnline::Instance()->GetTask("AmsOnlineSpectra");
+    fAmsOnline = (R3BAmsOnlineSpectra*)R3BSofOnlinePipeline::GetTask("AmsOnlineSpectra");
     if (!fAmsOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::AmsOnlineSpectra not found";
 
     // Looking for CALIFA online
-    fCalifaOnline = (R3BCalifaOnlineSpectra*)FairRunOnline::Instance()->GetTask("CALIFAOnlineSpectra");
+    fCalifaOnline = (R3BCalifaOnlineSpectra*)R3BSofOnlinePipeline::GetTask("CALIFAOnlineSpectra");
     if (!fCalifaOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::CALIFAOnlineSpectra not found";
 
     // Looking for Tracking online
-    fTrackOnline = (R3BSofTrackingOnlineSpectra*)FairRunOnline::Instance()->GetTask("SofTrackingOnlineSpectra");
+    fTrackOnline = (R3BSofTrackingOnlineSpectra*)R3BSofOnlinePipeline::GetTask("SofTrackingOnlineSpectra");
     if (!fTrackOnline)
         LOG(WARNING) << "R3BSofOnlineSpectra::SofTrackingOnlineSpectra not found";
 
@@ -409,6 +422,14 @@ InitStatus R3BSofOnlineSpectra::Init()
     }
     leg->Draw();
 
+    fs1_trigger = R3BSofHistBackend::Book(fh1_trigger);
+    fs1_wr = R3BSofHistBackend::Book(fh1_wr);
+    for (Int_t i = 0; i < 5; i++)
+        fs1_wrs[i] = R3BSofHistBackend::Book(fh1_wrs[i]);
+    // the maximum of the display follows the WR of NeuLAND, on the thread of the web server
+    if (fs1_wrs[2] && !fs1_wrs[2]->IsDirect())
+        fs1_wrs[2]->SetMaximumOf(fh1_wrs[0], 5.);
+
     // MAIN FOLDER-SOFIA
     TFolder* mainfolsof = new TFolder("SOFIA", "SOFIA WhiteRabbit and trigger info");
     mainfolsof->Add(cTrigger);
@@ -427,19 +448,19 @@ InitStatus R3BSofOnlineSpectra::Init()
 void R3BSofOnlineSpectra::Reset_GENERAL_Histo()
 {
     LOG(INFO) << "R3BSofOnlineSpectra::Reset_General_Histo";
-    fh1_trigger->Reset();
+    fs1_trigger->Reset();
     if (fWRItemsMaster && fWRItemsSofia)
-        fh1_wr->Reset();
+        fs1_wr->Reset();
     if (fWRItemsCalifa && fWRItemsSofia)
     {
-        fh1_wrs[0]->Reset();
-        fh1_wrs[1]->Reset();
+        fs1_wrs[0]->Reset();
+        fs1_wrs[1]->Reset();
         if (fWRItemsNeuland)
-            fh1_wrs[2]->Reset();
+            fs1_wrs[2]->Reset();
         if (fWRItemsS2)
-            fh1_wrs[3]->Reset();
+            fs1_wrs[3]->Reset();
         if (fWRItemsS8)
-            fh1_wrs[4]->Reset();
+            fs1_wrs[4]->Reset();
     }
     // Reset AT histograms if they exist somewhere
     if (fAtOnline)
@@ -515,12 +536,12 @@ void R3BSofOnlineSpectra::Exec(Option_t* option)
         {
             tpatbin = (fEventHeader->GetTpat() & (1 << i));
             if (tpatbin != 0)
-                fh1_trigger->Fill(i + 1);
+                fs1_trigger->Fill(i + 1);
         }
     }
     else if (fEventHeader->GetTpat() == 0)
     {
-        fh1_trigger->Fill(0);
+        fs1_trigger->Fill(0);
     }
     else
     {
@@ -554,8 +575,8 @@ void R3BSofOnlineSpectra::Exec(Option_t* option)
                     continue;
                 wr[ihit] = hit->GetTimeStamp();
             }
-            fh1_wrs[0]->Fill(wrs - wr[0]); // messel
-            fh1_wrs[1]->Fill(wrs - wr[1]); // wixhausen
+            fs1_wrs[0]->Fill(wrs - wr[0]); // messel
+            fs1_wrs[1]->Fill(wrs - wr[1]); // wixhausen
         }
         // Neuland
         if (fWRItemsNeuland && fWRItemsNeuland->GetEntriesFast() > 0)
@@ -566,10 +587,12 @@ void R3BSofOnlineSpectra::Exec(Option_t* option)
                 R3BWRMasterData* hit = (R3BWRMasterData*)fWRItemsNeuland->At(ihit);
                 if (!hit)
                     continue;
-                fh1_wrs[2]->Fill(int64_t(wrs - hit->GetTimeStamp()));
+                fs1_wrs[2]->Fill(int64_t(wrs - hit->GetTimeStamp()));
             }
             // fh1_wrs[4]->GetMaximum();
-            fh1_wrs[0]->SetMaximum(5. * fh1_wrs[2]->GetBinContent(fh1_wrs[2]->GetMaximumBin()));
+            // with the backend, set when fh1_wrs[2] is published (Init)
+            if (fs1_wrs[2]->IsDirect())
+                fh1_wrs[0]->SetMaximum(5. * fh1_wrs[2]->GetBinContent(fh1_wrs[2]->GetMaximumBin()));
         }
         // S2
         if (fWRItemsS2 && fWRItemsS2->GetEntriesFast() > 0)
@@ -580,7 +603,7 @@ void R3BSofOnlineSpectra::Exec(Option_t* option)
                 R3BWRMasterData* hit = (R3BWRMasterData*)fWRItemsS2->At(ihit);
                 if (!hit)
                     continue;
-                fh1_wrs[3]->Fill(int64_t(wrs - hit->GetTimeStamp()));
+                fs1_wrs[3]->Fill(int64_t(wrs - hit->GetTimeStamp()));
             }
         }
         // S8
@@ -592,7 +615,7 @@ void R3BSofOnlineSpectra::Exec(Option_t* option)
                 R3BWRMasterData* hit = (R3BWRMasterData*)fWRItemsS8->At(ihit);
                 if (!hit)
                     continue;
-                fh1_wrs[4]->Fill(int64_t(wrs - hit->GetTimeStamp()));
+                fs1_wrs[4]->Fill(int64_t(wrs - hit->GetTimeStamp()));
             }
         }
         // Master
@@ -607,7 +630,7 @@ void R3BSofOnlineSpectra::Exec(Option_t* option)
                     continue;
                 wrm = hit->GetTimeStamp();
             }
-            fh1_wr->Fill(wrm - wrs);
+            fs1_wr->Fill(wrm - wrs);
         }
     }
     fNEvents += 1;
@@ -644,6 +667,7 @@ void R3BSofOnlineSpectra::FinishEvent()
 
 void R3BSofOnlineSpectra::FinishTask()
 {
+    R3BSofHistBackend::Flush();
     // Write trigger canvas in the root file
     cTrigger->Write();
     if (fWRItemsMaster && fWRItemsSofia)
@@ -34,6 +34,7 @@ class R3BAmsOnlineSpectra;
 class R3BCalifaOnlineSpectra;
 class R3BSofFrsOnlineSpectra;
 class R3BSofTrackingOnlineSpectra;
+class R3BSofShardedHist;
 
 /**
  * This taks reads General SOFIA data and plots online histograms
@@ -135,6 +136,11 @@ class R3BSofOnlineSpectra : public FairTask
     TH1F *fh1_trigger, *fh1_wr;
     TH1F* fh1_wrs[5];
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs1_trigger; //!
+    R3BSofShardedHist* fs1_wr;      //!
+    R3BSofShardedHist* fs1_wrs[5];  //!
+
   public:
     ClassDef(R3BSofOnlineSpectra, 0)
 };
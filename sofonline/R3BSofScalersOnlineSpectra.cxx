@@ -8,6 +8,9 @@
  */
 
 #include "R3BSofScalersOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BSofScalersMappedData.h"
 #include "THttpServer.h"
@@ -40,6 +43,7 @@ R3BSofScalersOnlineSpectra::R3BSofScalersOnlineSpectra()
     : FairTask("SofScalersOnlineSpectra", 1)
     , fMappedItemsScalers(NULL)
     , fNEvents(0)
+    , fs1_GeneralView()
 {
 }
 
@@ -47,6 +51,7 @@ R3BSofScalersOnlineSpectra::R3BSofScalersOnlineSpectra(const char* name, Int_t i
     : FairTask(name, iVerbose)
     , fMappedItemsScalers(NULL)
     , fNEvents(0)
+    , fs1_GeneralView()
 {
 }
 
@@ -55,6 +60,8 @@ R3BSofScalersOnlineSpectra::~R3BSofScalersOnlineSpectra()
     LOG(INFO) << "R3BSofScalersOnlineSpectra::Delete instance";
     if (fMappedItemsScalers)
         delete fMappedItemsScalers;
+    for (Int_t i = 0; i < NbScalers; i++)
+        delete fs1_GeneralView[i];
 }
 
 InitStatus R3BSofScalersOnlineSpectra::Init()
@@ -65,7 +72,7 @@ InitStatus R3BSofScalersOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofScalersOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
@@ -73,7 +80,7 @@ InitStatus R3BSofScalersOnlineSpectra::Init()
     // --- ---------------------------------------- --- //
     // --- get access to mapped data of the scalers --- //
     // --- ---------------------------------------- --- //
-    fMappedItemsScalers = (TClonesArray*)mgr->GetObject("SofScalersMappedData");
+    fMappedItemsScalers = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofScalersMappedData");
     if (!fMappedItemsScalers)
     {
         return kFATAL;
@@ -135,6 +142,9 @@ InitStatus R3BSofScalersOnlineSpectra::Init()
     fh1_GeneralView[1]->LabelsDeflate("X");
     fh1_GeneralView[1]->LabelsOption("v");
 
+    for (Int_t i = 0; i < NbScalers; i++)
+        fs1_GeneralView[i] = R3BSofHistBackend::Book(fh1_GeneralView[i]);
+
     // --- ------------------- --- //
     // --- MAIN FOLDER-Scalers --- //
     // --- ------------------- --- //
@@ -157,7 +167,7 @@ void R3BSofScalersOnlineSpectra::Reset_Histo()
     for (Int_t i = 0; i < NbScalers; i++)
     {
         // === accumulated statistics per channel === //
-        fh1_GeneralView[i]->Reset();
+        fs1_GeneralView[i]->Reset();
     }
 }
 
@@ -177,7 +187,7 @@ void R3BSofScalersOnlineSpectra::Exec(Option_t* option)
             R3BSofScalersMappedData* hitmapped = (R3BSofScalersMappedData*)fMappedItemsScalers->At(ihit);
             if (!hitmapped)
                 continue;
-            fh1_GeneralView[hitmapped->GetScaler() - 1]->Fill(hitmapped->GetChannel(), hitmapped->GetValue());
+            fs1_GeneralView[hitmapped->GetScaler() - 1]->Fill(hitmapped->GetChannel(), hitmapped->GetValue());
         }
     }
     fNEvents += 1;
@@ -193,6 +203,7 @@ void R3BSofScalersOnlineSpectra::FinishEvent()
 
 void R3BSofScalersOnlineSpectra::FinishTask()
 {
+    R3BSofHistBackend::Flush();
     if (fMappedItemsScalers)
     {
         for (UShort_t i = 0; i < NbScalers; i++)
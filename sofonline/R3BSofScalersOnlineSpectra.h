@@ -26,6 +26,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads SCI data and plots online histograms
@@ -100,6 +101,9 @@ class R3BSofScalersOnlineSpectra : public FairTask
     // Histograms for Mapped data : accumulate statistics per channel
     TH1I* fh1_GeneralView[NbScalers];
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs1_GeneralView[NbScalers]; //!
+
   public:
     ClassDef(R3BSofScalersOnlineSpectra, 1)
 };
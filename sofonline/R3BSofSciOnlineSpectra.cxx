@@ -8,6 +8,9 @@
  */
 
 #include "R3BSofSciOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BMusicCalData.h"
 #include "R3BMusicHitData.h"
@@ -17,6 +20,7 @@
 #include "R3BSofSciMappedData.h"
 #include "R3BSofSciSingleTcalData.h"
 #include "R3BSofSciTcalData.h"
+#include "R3BSofSparseHist.h"
 #include "R3BSofTwimCalData.h"
 #include "R3BSofTwimHitData.h"
 #include "R3BSofTwimHitPar.h"
@@ -59,6 +63,24 @@ R3BSofSciOnlineSpectra::R3BSofSciOnlineSpectra()
     , fNbChannels(3)
     , fIdS2(0)
     , fIdS8(0)
+    , fTofViewMin(0.)
+    , fTofViewMax(0.)
+    , fPosViewMin(0.)
+    , fPosViewMax(0.)
+    , fSparseResetRequested(kFALSE)
+    , fh1_RawPos_AtTcalMult1(NULL)
+    , fs1_finetime(NULL)
+    , fs2_mult(NULL)
+    , fs2_MusZvsRawPos(NULL)
+    , fs2_MusZvsRawTof_FromS2(NULL)
+    , fs2_MusZvsRawTof_FromS8(NULL)
+    , fs2_Beta_Correlation()
+    , fs2_MusDTvsRawPos(NULL)
+    , fs2_TwimvsMusicZ_betacorrected(NULL)
+    , fs2_MusEvsBeta(NULL)
+    , fs2_Aqvsx2(NULL)
+    , fs2_Aqvsq(NULL)
+    , fs2_Mwpc0vsRawPos(NULL)
 {
 }
 
@@ -77,6 +99,24 @@ R3BSofSciOnlineSpectra::R3BSofSciOnlineSpectra(const char* name, Int_t iVerbose)
     , fIdS2(0)
     , fIdS8(0)
     , fBrho0(7.1175) // For 40Ca setting in s467
+    , fTofViewMin(0.)
+    , fTofViewMax(0.)
+    , fPosViewMin(0.)
+    , fPosViewMax(0.)
+    , fSparseResetRequested(kFALSE)
+    , fh1_RawPos_AtTcalMult1(NULL)
+    , fs1_finetime(NULL)
+    , fs2_mult(NULL)
+    , fs2_MusZvsRawPos(NULL)
+    , fs2_MusZvsRawTof_FromS2(NULL)
+    , fs2_MusZvsRawTof_FromS8(NULL)
+    , fs2_Beta_Correlation()
+    , fs2_MusDTvsRawPos(NULL)
+    , fs2_TwimvsMusicZ_betacorrected(NULL)
+    , fs2_MusEvsBeta(NULL)
+    , fs2_Aqvsx2(NULL)
+    , fs2_Aqvsq(NULL)
+    , fs2_Mwpc0vsRawPos(NULL)
 {
 }
 
@@ -99,6 +139,29 @@ R3BSofSciOnlineSpectra::~R3BSofSciOnlineSpectra()
         delete fCalItemsMwpc0;
     if (fTofwHitData)
         delete fTofwHitData;
+    if (fs1_finetime)
+    {
+        for (Int_t i = 0; i < fNbDetectors * fNbChannels; i++)
+            delete fs1_finetime[i];
+        delete[] fs1_finetime;
+    }
+    R3BSofShardedHist** perDet[] = { fs2_mult, fs2_MusZvsRawPos, fs2_MusZvsRawTof_FromS2, fs2_MusZvsRawTof_FromS8 };
+    for (auto fs : perDet)
+    {
+        if (!fs)
+            continue;
+        for (Int_t i = 0; i < fNbDetectors; i++)
+            delete fs[i];
+        delete[] fs;
+    }
+    for (Int_t i = 0; i < 3; i++)
+        delete fs2_Beta_Correlation[i];
+    delete fs2_MusDTvsRawPos;
+    delete fs2_TwimvsMusicZ_betacorrected;
+    delete fs2_MusEvsBeta;
+    delete fs2_Aqvsx2;
+    delete fs2_Aqvsq;
+    delete fs2_Mwpc0vsRawPos;
 }
 
 InitStatus R3BSofSciOnlineSpectra::Init()
@@ -112,7 +175,7 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofSciOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
@@ -120,7 +183,7 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     // --- ------------------------------------ --- //
     // --- get access to mapped data of the SCI --- //
     // --- ------------------------------------ --- //
-    fMappedItemsSci = (TClonesArray*)mgr->GetObject("SofSciMappedData");
+    fMappedItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciMappedData");
     if (!fMappedItemsSci)
     {
         return kFATAL;
@@ -129,7 +192,7 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     // --- ---------------------------------- --- //
     // --- get access to tcal data of the SCI --- //
     // --- ---------------------------------- --- //
-    fTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciTcalData");
+    fTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciTcalData");
     if (!fTcalItemsSci)
     {
         return kFATAL;
@@ -138,19 +201,19 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     // --- ----------------------------------------- --- //
     // --- get access to single tcal data of the SCI --- //
     // --- ----------------------------------------- --- //
-    fSingleTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciSingleTcalData");
+    fSingleTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciSingleTcalData");
     if (!fSingleTcalItemsSci)
     {
         return kFATAL;
     }
 
     // get access to hit data of the MUSIC
-    fMusHitItems = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fMusHitItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fMusHitItems)
         LOG(WARNING) << "R3BSofSciOnlineSpectra: MusicHitData not found";
 
     // get access to cal data of the MUSIC
-    fMusCalItems = (TClonesArray*)mgr->GetObject("MusicCalData");
+    fMusCalItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicCalData");
     if (!fMusCalItems)
         LOG(WARNING) << "R3BSofSciOnlineSpectra: MusicCalData not found";
 
@@ -175,29 +238,12 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     fNumAnodes = fCal_Par->GetNumAnodes();  // Number of anodes
     fNumParams = fCal_Par->GetNumParZFit(); // Number of Parameters
     LOG(INFO) << "R3BMusicCal2Hit: Nb parameters for charge-Z: " << fNumParams;
-    CalZParams = new TArrayF();
-    CalZParams->Set(fNumParams);
-    CalZParams = fCal_Par->GetZHitPar(); // Array with the Cal parameters
-
-    // Parameters detector
-    if (fNumParams == 2)
-    {
-        fZ0 = CalZParams->GetAt(0);
-        fZ1 = CalZParams->GetAt(1);
-    }
-    else if (fNumParams == 3)
-    {
-        fZ0 = CalZParams->GetAt(0);
-        fZ1 = CalZParams->GetAt(1);
-        fZ2 = CalZParams->GetAt(2);
-    }
-    else
-        LOG(INFO) << "R3BMusicCal2Hit parameters for charge-Z cannot be used here, number of parameters: "
-                  << fNumParams;
+    // Z polynomial of any order in sqrt(E) * beta, the array belongs to the container
+    fMusicZCal.SetPolynomial(fCal_Par->GetZHitPar(), fNumParams);
     // getting parameters for R3BMUSIC end
 
     // Twim
-    fTwimHitItems = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fTwimHitItems = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fTwimHitItems)
         LOG(WARNING) << "R3BSofSciOnlineSpectra: TwimHitData not found";
 
@@ -211,33 +257,12 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     fNumAnodes = fCal_TwimPar->GetNumAnodes();  // Number of anodes
     fNumParams = fCal_TwimPar->GetNumParZFit(); // Number of TwimParameters
 
-    // Anodes that don't work set to zero
-    TwimCalZParams = new TArrayF();
-    Int_t array_size = fNumSec * fNumParams;
-    TwimCalZParams->Set(array_size);
-    TwimCalZParams = fCal_TwimPar->GetZHitPar(); // Array with the Cal parameters
-
-    // Parameters detector
-    for (Int_t s = 0; s < fNumSec; s++)
-        // Parameters detector
-        if (fNumParams == 2)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-        }
-        else if (fNumParams == 3)
-        {
-            fTwimZ0 = TwimCalZParams->GetAt(0);
-            fTwimZ1 = TwimCalZParams->GetAt(1);
-            fTwimZ2 = TwimCalZParams->GetAt(2);
-        }
-        else
-            LOG(INFO) << "R3BSofTwimCal2Hit parameters for charge-Z cannot be used here, number of parameters: "
-                      << fNumParams;
+    // Parameters of the first section
+    fTwimZCal.SetPolynomial(fCal_TwimPar->GetZHitPar(), fNumParams);
     // Twim end
 
     // get access to cal data of the MWPC0
-    fCalItemsMwpc0 = (TClonesArray*)mgr->GetObject("Mwpc0CalData");
+    fCalItemsMwpc0 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc0CalData");
     if (!fCalItemsMwpc0)
         LOG(WARNING) << "R3BSofSciOnlineSpectra: Mwpc0CalData not found";
 
@@ -251,8 +276,8 @@ InitStatus R3BSofSciOnlineSpectra::Init()
     fh1_finetime = new TH1I*[fNbDetectors * fNbChannels];
     fh2_mult = new TH2I*[fNbDetectors];
     cSciRawPos = new TCanvas*[fNbDetectors];
-    fh1_RawPos_AtTcalMult1 = new TH1F*[fNbDetectors];
-    fh1_RawPos_AtSingleTcal = new TH1F*[fNbDetectors];
+    fh1_RawPos_AtTcalMult1 = new R3BSofSparseHist*[fNbDetectors];
+    fh1_RawPos_AtSingleTcal = new R3BSofSparseHist*[fNbDetectors];
     cMusicZvsRawPos = new TCanvas*[fNbDetectors];
     fh2_MusZvsRawPos = new TH2F*[fNbDetectors];
     for (Int_t i = 0; i < fNbDetectors; i++)
@@ -280,33 +305,33 @@ InitStatus R3BSofSciOnlineSpectra::Init()
         cSciRawPos[i] = new TCanvas(Name1, Name1, 10, 10, 500, 500);
         cSciRawPos[i]->Divide(1, 2);
         sprintf(Name1, "SofSci%i_RawPosAtTcal_Mult1", i + 1);
-        fh1_RawPos_AtTcalMult1[i] = new TH1F(Name1, Name1, 20000, -10, 10);
-        fh1_RawPos_AtTcalMult1[i]->GetXaxis()->SetTitle(
+        fh1_RawPos_AtTcalMult1[i] = new R3BSofSparseHist(Name1, Name1, 20000, -10, 10);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetXaxis()->SetTitle(
             "(RIGHT,Wix. side) -->  raw position [ns, 1ps/bin] --> (LEFT,Mes. side) -->");
-        fh1_RawPos_AtTcalMult1[i]->GetYaxis()->SetTitle("Counts per bin");
-        fh1_RawPos_AtTcalMult1[i]->GetXaxis()->CenterTitle(true);
-        fh1_RawPos_AtTcalMult1[i]->GetYaxis()->CenterTitle(true);
-        fh1_RawPos_AtTcalMult1[i]->GetXaxis()->SetLabelSize(0.045);
-        fh1_RawPos_AtTcalMult1[i]->GetXaxis()->SetTitleSize(0.045);
-        fh1_RawPos_AtTcalMult1[i]->GetYaxis()->SetLabelSize(0.045);
-        fh1_RawPos_AtTcalMult1[i]->GetYaxis()->SetTitleSize(0.045);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetXaxis()->CenterTitle(true);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetYaxis()->CenterTitle(true);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetXaxis()->SetLabelSize(0.045);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetXaxis()->SetTitleSize(0.045);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetYaxis()->SetLabelSize(0.045);
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->GetYaxis()->SetTitleSize(0.045);
         cSciRawPos[i]->cd(1);
-        fh1_RawPos_AtTcalMult1[i]->Draw("");
+        fh1_RawPos_AtTcalMult1[i]->GetDisplay()->Draw("");
 
         // === RAW POSITION AT SINGLE TCAL LEVEL === //
         sprintf(Name1, "SofSci%i_RawPosAtSingleTcal", i + 1);
-        fh1_RawPos_AtSingleTcal[i] = new TH1F(Name1, Name1, 20000, -10, 10);
-        fh1_RawPos_AtSingleTcal[i]->GetXaxis()->SetTitle(
+        fh1_RawPos_AtSingleTcal[i] = new R3BSofSparseHist(Name1, Name1, 20000, -10, 10);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetXaxis()->SetTitle(
             "(RIGHT,Wix. side) -->  raw position [ns, 1ps/bin] --> (LEFT,Mes. side) -->");
-        fh1_RawPos_AtSingleTcal[i]->GetYaxis()->SetTitle("Counts per bin");
-        fh1_RawPos_AtSingleTcal[i]->GetXaxis()->CenterTitle(true);
-        fh1_RawPos_AtSingleTcal[i]->GetYaxis()->CenterTitle(true);
-        fh1_RawPos_AtSingleTcal[i]->GetXaxis()->SetLabelSize(0.045);
-        fh1_RawPos_AtSingleTcal[i]->GetXaxis()->SetTitleSize(0.045);
-        fh1_RawPos_AtSingleTcal[i]->GetYaxis()->SetLabelSize(0.045);
-        fh1_RawPos_AtSingleTcal[i]->GetYaxis()->SetTitleSize(0.045);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetXaxis()->CenterTitle(true);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetYaxis()->CenterTitle(true);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetXaxis()->SetLabelSize(0.045);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetXaxis()->SetTitleSize(0.045);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetYaxis()->SetLabelSize(0.045);
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->GetYaxis()->SetTitleSize(0.045);
         cSciRawPos[i]->cd(2);
-        fh1_RawPos_AtSingleTcal[i]->Draw("");
+        fh1_RawPos_AtSingleTcal[i]->GetDisplay()->Draw("");
 
         // === R3B MUSIC CHARGE VERSUS RAW POSITION === //
         sprintf(Name1, "MUSIC_Z_vs_RawPos_Sci%02d", i + 1);
@@ -360,15 +385,15 @@ InitStatus R3BSofSciOnlineSpectra::Init()
 
     // === RAW TOF FROM S2 AT TCAL AND SINGLE TCAL LEVELS === //
     cSciRawTof_FromS2 = new TCanvas*[fNbDetectors];
-    fh1_RawTof_FromS2_AtTcalMult1 = new TH1D*[fNbDetectors];
-    fh1_RawTof_FromS2_AtTcalMult1_wTref = new TH1D*[fNbDetectors];
-    fh1_RawTof_FromS2_AtSingleTcal_wTref = new TH1D*[fNbDetectors];
+    fh1_RawTof_FromS2_AtTcalMult1 = new R3BSofSparseHist*[fNbDetectors];
+    fh1_RawTof_FromS2_AtTcalMult1_wTref = new R3BSofSparseHist*[fNbDetectors];
+    fh1_RawTof_FromS2_AtSingleTcal_wTref = new R3BSofSparseHist*[fNbDetectors];
     cMusicZvsRawTof_FromS2 = new TCanvas*[fNbDetectors];
     fh2_MusZvsRawTof_FromS2 = new TH2F*[fNbDetectors];
     cSciRawTof_FromS8 = new TCanvas*[fNbDetectors];
-    fh1_RawTof_FromS8_AtTcalMult1 = new TH1D*[fNbDetectors];
-    fh1_RawTof_FromS8_AtTcalMult1_wTref = new TH1D*[fNbDetectors];
-    fh1_RawTof_FromS8_AtSingleTcal_wTref = new TH1D*[fNbDetectors];
+    fh1_RawTof_FromS8_AtTcalMult1 = new R3BSofSparseHist*[fNbDetectors];
+    fh1_RawTof_FromS8_AtTcalMult1_wTref = new R3BSofSparseHist*[fNbDetectors];
+    fh1_RawTof_FromS8_AtSingleTcal_wTref = new R3BSofSparseHist*[fNbDetectors];
     fh2_Beta_Correlation =
         new TH2F*[fNbDetectors * (fNbDetectors - 1) * (fNbDetectors * (fNbDetectors - 1) / 2 - 1) / 4];
     //
@@ -383,23 +408,23 @@ InitStatus R3BSofSciOnlineSpectra::Init()
             cSciRawTof_FromS2[dstop] = new TCanvas(Name1, Name2, 10, 10, 800, 800);
             cSciRawTof_FromS2[dstop]->Divide(1, 3);
             sprintf(Name1, "RawTofNs_m1_Sci%02d_to_Sci%02d", fIdS2, dstop + 1);
-            fh1_RawTof_FromS2_AtTcalMult1[dstop] = new TH1D(Name1, Name1, 100000, -50000, 50000);
-            fh1_RawTof_FromS2_AtTcalMult1[dstop]->GetXaxis()->SetTitle("Raw Tof [ns]");
-            fh1_RawTof_FromS2_AtTcalMult1[dstop]->GetYaxis()->SetTitle("Counts per bin");
+            fh1_RawTof_FromS2_AtTcalMult1[dstop] = new R3BSofSparseHist(Name1, Name1, 100000, -50000, 50000);
+            fh1_RawTof_FromS2_AtTcalMult1[dstop]->GetDisplay()->GetXaxis()->SetTitle("Raw Tof [ns]");
+            fh1_RawTof_FromS2_AtTcalMult1[dstop]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
             sprintf(Name1, "RawTofNs_m1_wTref_Sci%02d_to_Sci%02d", fIdS2, dstop + 1);
-            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop] = new TH1D(Name1, Name1, 400000, -2000, 2000);
-            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop]->GetXaxis()->SetTitle("Raw Tof [ns]");
-            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop]->GetYaxis()->SetTitle("Counts per bin");
+            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop] = new R3BSofSparseHist(Name1, Name1, 400000, -2000, 2000);
+            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop]->GetDisplay()->GetXaxis()->SetTitle("Raw Tof [ns]");
+            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
             sprintf(Name1, "RawTofNs_wTref_Sci%02d_to_Sci%02d", fIdS2, dstop + 1);
-            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop] = new TH1D(Name1, Name1, 400000, -2000, 2000);
-            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop]->GetXaxis()->SetTitle("Raw Tof [ns]");
-            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop]->GetYaxis()->SetTitle("Counts per bin");
+            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop] = new R3BSofSparseHist(Name1, Name1, 400000, -2000, 2000);
+            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop]->GetDisplay()->GetXaxis()->SetTitle("Raw Tof [ns]");
+            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
             cSciRawTof_FromS2[dstop]->cd(1);
-            fh1_RawTof_FromS2_AtTcalMult1[dstop]->Draw("");
+            fh1_RawTof_FromS2_AtTcalMult1[dstop]->GetDisplay()->Draw("");
             cSciRawTof_FromS2[dstop]->cd(2);
-            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop]->Draw("");
+            fh1_RawTof_FromS2_AtTcalMult1_wTref[dstop]->GetDisplay()->Draw("");
             cSciRawTof_FromS2[dstop]->cd(3);
-            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop]->Draw("");
+            fh1_RawTof_FromS2_AtSingleTcal_wTref[dstop]->GetDisplay()->Draw("");
         }
         if (fIdS8 > 0)
         {
@@ -408,23 +433,23 @@ InitStatus R3BSofSciOnlineSpectra::Init()
             cSciRawTof_FromS8[dstop] = new TCanvas(Name1, Name2, 10, 10, 800, 800);
             cSciRawTof_FromS8[dstop]->Divide(1, 3);
             sprintf(Name1, "RawTofNs_m1_Sci%02d_to_Sci%02d", fIdS8, dstop + 1);
-            fh1_RawTof_FromS8_AtTcalMult1[dstop] = new TH1D(Name1, Name1, 100000, -50000, 50000);
-            fh1_RawTof_FromS8_AtTcalMult1[dstop]->GetXaxis()->SetTitle("Raw Tof [ns]");
-            fh1_RawTof_FromS8_AtTcalMult1[dstop]->GetYaxis()->SetTitle("Counts per bin");
+            fh1_RawTof_FromS8_AtTcalMult1[dstop] = new R3BSofSparseHist(Name1, Name1, 100000, -50000, 50000);
+            fh1_RawTof_FromS8_AtTcalMult1[dstop]->GetDisplay()->GetXaxis()->SetTitle("Raw Tof [ns]");
+            fh1_RawTof_FromS8_AtTcalMult1[dstop]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
             sprintf(Name1, "RawTofNs_m1_wTref_Sci%02d_to_Sci%02d", fIdS8, dstop + 1);
-            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop] = new TH1D(Name1, Name1, 400000, -2000, 2000);
-            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop]->GetXaxis()->SetTitle("Raw Tof [ns]");
-            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop]->GetYaxis()->SetTitle("Counts per bin");
+            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop] = new R3BSofSparseHist(Name1, Name1, 400000, -2000, 2000);
+            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop]->GetDisplay()->GetXaxis()->SetTitle("Raw Tof [ns]");
+            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
             sprintf(Name1, "RawTofNs_wTref_Sci%02d_to_Sci%02d", fIdS8, dstop + 1);
-            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop] = new TH1D(Name1, Name1, 400000, -2000, 2000);
-            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop]->GetXaxis()->SetTitle("Raw Tof [ns]");
-            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop]->GetYaxis()->SetTitle("Counts per bin");
+            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop] = new R3BSofSparseHist(Name1, Name1, 400000, -2000, 2000);
+            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop]->GetDisplay()->GetXaxis()->SetTitle("Raw Tof [ns]");
+            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop]->GetDisplay()->GetYaxis()->SetTitle("Counts per bin");
             cSciRawTof_FromS8[dstop]->cd(1);
-            fh1_RawTof_FromS8_AtTcalMult1[dstop]->Draw("");
+            fh1_RawTof_FromS8_AtTcalMult1[dstop]->GetDisplay()->Draw("");
             cSciRawTof_FromS8[dstop]->cd(2);
-            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop]->Draw("");
+            fh1_RawTof_FromS8_AtTcalMult1_wTref[dstop]->GetDisplay()->Draw("");
             cSciRawTof_FromS8[dstop]->cd(3);
-            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop]->Draw("");
+            fh1_RawTof_FromS8_AtSingleTcal_wTref[dstop]->GetDisplay()->Draw("");
         }
 
         // === MUSIC HIT DATA VERSUS SCI-RAW TOF
@@ -561,6 +586,55 @@ InitStatus R3BSofSciOnlineSpectra::Init()
         fh2_Aqvsx2->Draw("colz");
     }
 
+    fs1_finetime = new R3BSofShardedHist*[fNbDetectors * fNbChannels]();
+    fs2_mult = new R3BSofShardedHist*[fNbDetectors]();
+    fs2_MusZvsRawPos = new R3BSofShardedHist*[fNbDetectors]();
+    fs2_MusZvsRawTof_FromS2 = new R3BSofShardedHist*[fNbDetectors]();
+    fs2_MusZvsRawTof_FromS8 = new R3BSofShardedHist*[fNbDetectors]();
+    for (Int_t i = 0; i < fNbDetectors; i++)
+    {
+        for (Int_t j = 0; j < fNbChannels; j++)
+            fs1_finetime[i * fNbChannels + j] = R3BSofHistBackend::Book(fh1_finetime[i * fNbChannels + j]);
+        fs2_mult[i] = R3BSofHistBackend::Book(fh2_mult[i]);
+        fs2_MusZvsRawPos[i] = R3BSofHistBackend::Book(fh2_MusZvsRawPos[i]);
+        if (fIdS2 > 0)
+            fs2_MusZvsRawTof_FromS2[i] = R3BSofHistBackend::Book(fh2_MusZvsRawTof_FromS2[i]);
+        if (fIdS8 > 0)
+            fs2_MusZvsRawTof_FromS8[i] = R3BSofHistBackend::Book(fh2_MusZvsRawTof_FromS8[i]);
+    }
+    for (Int_t i = 0; i < 3; i++)
+        fs2_Beta_Correlation[i] = R3BSofHistBackend::Book(fh2_Beta_Correlation[i]);
+    fs2_MusDTvsRawPos = R3BSofHistBackend::Book(fh2_MusDTvsRawPos);
+    fs2_TwimvsMusicZ_betacorrected = R3BSofHistBackend::Book(fh2_TwimvsMusicZ_betacorrected);
+    fs2_MusEvsBeta = R3BSofHistBackend::Book(fh2_MusEvsBeta);
+    if (fIdS2 > 0)
+    {
+        fs2_Aqvsx2 = R3BSofHistBackend::Book(fh2_Aqvsx2);
+        fs2_Aqvsq = R3BSofHistBackend::Book(fh2_Aqvsq);
+    }
+    fs2_Mwpc0vsRawPos = R3BSofHistBackend::Book(fh2_Mwpc0vsRawPos);
+
+    fSparseHists.clear();
+    for (Int_t i = 0; i < fNbDetectors; i++)
+    {
+        fSparseHists.push_back(fh1_RawPos_AtTcalMult1[i]);
+        fSparseHists.push_back(fh1_RawPos_AtSingleTcal[i]);
+        if (fIdS2 > 0)
+        {
+            fSparseHists.push_back(fh1_RawTof_FromS2_AtTcalMult1[i]);
+            fSparseHists.push_back(fh1_RawTof_FromS2_AtTcalMult1_wTref[i]);
+            fSparseHists.push_back(fh1_RawTof_FromS2_AtSingleTcal_wTref[i]);
+        }
+        if (fIdS8 > 0)
+        {
+            fSparseHists.push_back(fh1_RawTof_FromS8_AtTcalMult1[i]);
+            fSparseHists.push_back(fh1_RawTof_FromS8_AtTcalMult1_wTref[i]);
+            fSparseHists.push_back(fh1_RawTof_FromS8_AtSingleTcal_wTref[i]);
+        }
+    }
+    for (size_t k = 0; k < fSparseHists.size(); k++)
+        R3BSofHistBackend::Book(fSparseHists[k]);
+
     // --- --------------- --- //
     // --- MAIN FOLDER-Sci --- //
     // --- --------------- --- //
@@ -599,53 +673,97 @@ InitStatus R3BSofSciOnlineSpectra::Init()
 
     // Register command to reset histograms
     run->GetHttpServer()->RegisterCommand("Reset_SOFSCI_HIST", Form("/Objects/%s/->Reset_Histo()", GetName()));
+    // Register commands to zoom on the raw ToF and raw position, e.g. 600,620
+    run->GetHttpServer()->RegisterCommand("Zoom_SOFSCI_TOF",
+                                          Form("/Objects/%s/->SetTofView(%%arg1%%,%%arg2%%)", GetName()));
+    run->GetHttpServer()->RegisterCommand("Zoom_SOFSCI_POS",
+                                          Form("/Objects/%s/->SetPosView(%%arg1%%,%%arg2%%)", GetName()));
+    // Views set before Init
+    SetTofView(fTofViewMin, fTofViewMax);
+    SetPosView(fPosViewMin, fPosViewMax);
 
     return kSUCCESS;
 }
 
+void R3BSofSciOnlineSpectra::SetTofView(Double_t min, Double_t max)
+{
+    fTofViewMin = min;
+    fTofViewMax = max;
+    if (!fh1_RawPos_AtTcalMult1) // before Init
+        return;
+    for (Int_t i = 0; i < fNbDetectors; i++)
+    {
+        if (fIdS2 > 0)
+        {
+            fh1_RawTof_FromS2_AtTcalMult1[i]->SetView(min, max);
+            fh1_RawTof_FromS2_AtTcalMult1_wTref[i]->SetView(min, max);
+            fh1_RawTof_FromS2_AtSingleTcal_wTref[i]->SetView(min, max);
+        }
+        if (fIdS8 > 0)
+        {
+            fh1_RawTof_FromS8_AtTcalMult1[i]->SetView(min, max);
+            fh1_RawTof_FromS8_AtTcalMult1_wTref[i]->SetView(min, max);
+            fh1_RawTof_FromS8_AtSingleTcal_wTref[i]->SetView(min, max);
+        }
+    }
+}
+
+void R3BSofSciOnlineSpectra::SetPosView(Double_t min, Double_t max)
+{
+    fPosViewMin = min;
+    fPosViewMax = max;
+    if (!fh1_RawPos_AtTcalMult1) // before Init
+        return;
+    for (Int_t i = 0; i < fNbDetectors; i++)
+    {
+        fh1_RawPos_AtTcalMult1[i]->SetView(min, max);
+        fh1_RawPos_AtSingleTcal[i]->SetView(min, max);
+    }
+}
+
+// The sparse histograms free their pages: only on the filling thread
+void R3BSofSciOnlineSpectra::ApplyRequests()
+{
+    if (!fSparseResetRequested.exchange(kFALSE))
+        return;
+    for (size_t k = 0; k < fSparseHists.size(); k++)
+        fSparseHists[k]->Reset();
+}
+
 void R3BSofSciOnlineSpectra::Reset_Histo()
 {
     LOG(INFO) << "R3BSofSciOnlineSpectra::Reset_Histo";
+    // === RAW POSITION AND TIME-OF-FLIGHT, by Exec === //
+    fSparseResetRequested.store(kTRUE);
     for (Int_t i = 0; i < fNbDetectors; i++)
     {
         // === MULT AND FINE TIME === //
-        fh2_mult[i]->Reset();
+        fs2_mult[i]->Reset();
         for (Int_t j = 0; j < fNbChannels; j++)
         {
-            fh1_finetime[i * fNbChannels + j]->Reset();
+            fs1_finetime[i * fNbChannels + j]->Reset();
         }
-        // === RAW POSITION === //
-        fh1_RawPos_AtTcalMult1[i]->Reset();
-        fh1_RawPos_AtSingleTcal[i]->Reset();
         // === R3BMUSIC === //
-        fh2_MusZvsRawPos[i]->Reset();
+        fs2_MusZvsRawPos[i]->Reset();
 
         if (fIdS2 > 0)
         {
-            // === RAW TIME_OF_FLIGHT === //
-            fh1_RawTof_FromS2_AtTcalMult1[i]->Reset();
-            fh1_RawTof_FromS2_AtTcalMult1_wTref[i]->Reset();
-            fh1_RawTof_FromS2_AtSingleTcal_wTref[i]->Reset();
             // === R3BMUSIC === //
-            fh2_MusZvsRawTof_FromS2[i]->Reset();
-            fh2_MusEvsBeta->Reset();
-            fh2_TwimvsMusicZ_betacorrected->Reset();
-            fh2_Aqvsx2->Reset();
-            fh2_Aqvsq->Reset();
+            fs2_MusZvsRawTof_FromS2[i]->Reset();
+            fs2_MusEvsBeta->Reset();
+            fs2_TwimvsMusicZ_betacorrected->Reset();
+            fs2_Aqvsx2->Reset();
+            fs2_Aqvsq->Reset();
         }
         if (fIdS8 > 0)
         {
-            // === RAW TIME_OF_FLIGHT === //
-            fh1_RawTof_FromS8_AtTcalMult1[i]->Reset();
-            fh1_RawTof_FromS8_AtTcalMult1_wTref[i]->Reset();
-            fh1_RawTof_FromS8_AtSingleTcal_wTref[i]->Reset();
             // === R3BMUSIC === //
-            fh2_MusZvsRawTof_FromS8[i]->Reset();
+            fs2_MusZvsRawTof_FromS8[i]->Reset();
         }
     }
 
-    fh2_MusDTvsRawPos->Reset();
-    fh2_Mwpc0vsRawPos->Reset();
+    fs2_MusDTvsRawPos->Reset();
+    fs2_Mwpc0vsRawPos->Reset();
 }
 
 void R3BSofSciOnlineSpectra::Exec(Option_t* option)
@@ -654,6 +772,10 @@ void R3BSofSciOnlineSpectra::Exec(Option_t* option)
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofSciOnlineSpectra::Exec FairRootManager not found";
 
+    ApplyRequests();
+    for (size_t k = 0; k < fSparseHists.size(); k++)
+        fSparseHists[k]->Update();
+
     Int_t nHits;
     UShort_t iDet; // 0-bsed
     UShort_t iCh;  // 0-based
@@ -738,7 +860,7 @@ void R3BSofSciOnlineSpectra::Exec(Option_t* option)
             iDet = hitmapped->GetDetector() - 1;
             iCh = hitmapped->GetPmt() - 1;
             multMapSci[iDet * fNbChannels + iCh]++;
-            fh1_finetime[iDet * fNbChannels + iCh]->Fill(hitmapped->GetTimeFine());
+            fs1_finetime[iDet * fNbChannels + iCh]->Fill(hitmapped->GetTimeFine());
         }
 
         // --- ----------------------- --- //
@@ -790,15 +912,15 @@ void R3BSofSciOnlineSpectra::Exec(Option_t* option)
                 // if ((d == fNbDetectors-1) && (fIdS8>0)) toff = hitsingletcal->GetRawTofNs_FromS8(); //for S8
                 if (MusicZ > 0)
                 {
-                    fh2_MusZvsRawPos[d]->Fill(hitsingletcal->GetRawPosNs(), MusicZ);
+                    fs2_MusZvsRawPos[d]->Fill(hitsingletcal->GetRawPosNs(), MusicZ);
                     if (fIdS2 > 0)
-                        fh2_MusZvsRawTof_FromS2[d]->Fill(hitsingletcal->GetRawTofNs_FromS2(), MusicZ);
+                        fs2_MusZvsRawTof_FromS2[d]->Fill(hitsingletcal->GetRawTofNs_FromS2(), MusicZ);
                     if (fIdS8 > 0)
-                        fh2_MusZvsRawTof_FromS8[d]->Fill(hitsingletcal->GetRawTofNs_FromS8(), MusicZ);
+                        fs2_MusZvsRawTof_FromS8[d]->Fill(hitsingletcal->GetRawTofNs_FromS8(), MusicZ);
                 }
                 if (d == fNbDetectors - 1)
                 {
-                    fh2_MusDTvsRawPos->Fill(hitsingletcal->GetRawPosNs(), MusicDT); // at Cave C
+                    fs2_MusDTvsRawPos->Fill(hitsingletcal->GetRawPosNs(), MusicDT); // at Cave C
                 }
                 if (fIdS2 > 0 && fIdS8 > 0)
                 {
@@ -826,22 +948,20 @@ void R3BSofSciOnlineSpectra::Exec(Option_t* option)
                 Gamma_S8_Cave = 1. / (TMath::Sqrt(1. - (Beta_S8_Cave) * (Beta_S8_Cave)));
                 Brho_S8_Cave = fBrho0 * (1 + xs2 / 726.); //+mwpc0x/10./2000);
                 //
-                fh2_Beta_Correlation[0]->Fill(Beta_S2_Cave, Beta_S2_S8);
-                fh2_Beta_Correlation[1]->Fill(Beta_S2_S8, Beta_S8_Cave);
-                fh2_Beta_Correlation[2]->Fill(Beta_S8_Cave, Beta_S2_Cave);
+                fs2_Beta_Correlation[0]->Fill(Beta_S2_Cave, Beta_S2_S8);
+                fs2_Beta_Correlation[1]->Fill(Beta_S2_S8, Beta_S8_Cave);
+                fs2_Beta_Correlation[2]->Fill(Beta_S8_Cave, Beta_S2_Cave);
                 //
                 TheBeta = Beta_S2_S8;
                 TheGamma = Gamma_S2_S8;
                 TheBrho = Brho_S2_S8;
-                MusicZ_betacorr =
-                    fZ0 + fZ1 * TMath::Sqrt(MusicE) * TheBeta + fZ2 * MusicE * TheBeta * TheBeta; // mostly first order
-                TwimZ_betacorr = fTwimZ0 + fTwimZ1 * TMath::Sqrt(TwimE) * TheBeta +
-                                 fTwimZ2 * TwimE * TheBeta * TheBeta; // mostly first order
+                MusicZ_betacorr = fMusicZCal.Eval(MusicE, TheBeta); // mostly first order
+                TwimZ_betacorr = fTwimZCal.Eval(TwimE, TheBeta);
                 //
-                fh2_MusEvsBeta->Fill(TheBeta, TMath::Sqrt(MusicE) * TheBeta);
-                fh2_TwimvsMusicZ_betacorrected->Fill(MusicZ_betacorr, TwimZ_betacorr);
-                fh2_Aqvsq->Fill(TheBrho / (3.10716 * TheGamma * TheBeta), MusicZ_betacorr);
-                fh2_Aqvsx2->Fill(fBrho0 / (3.10716 * TheGamma * TheBeta), xs2);
+                fs2_MusEvsBeta->Fill(TheBeta, TMath::Sqrt(MusicE) * TheBeta);
+                fs2_TwimvsMusicZ_betacorrected->Fill(MusicZ_betacorr, TwimZ_betacorr);
+                fs2_Aqvsq->Fill(TheBrho / (3.10716 * TheGamma * TheBeta), MusicZ_betacorr);
+                fs2_Aqvsx2->Fill(fBrho0 / (3.10716 * TheGamma * TheBeta), xs2);
             }
         }
         // Get cal data MWPC0
@@ -871,7 +991,7 @@ void R3BSofSciOnlineSpectra::Exec(Option_t* option)
         {
             for (UShort_t j = 0; j < fNbChannels; j++)
             {
-                fh2_mult[i]->Fill(j + 1, multMapSci[i * fNbChannels + j]);
+                fs2_mult[i]->Fill(j + 1, multMapSci[i * fNbChannels + j]);
             }
             if ((multMapSci[i * fNbChannels] == 1) && (multMapSci[i * fNbChannels + 1] == 1))
             {
@@ -883,7 +1003,7 @@ void R3BSofSciOnlineSpectra::Exec(Option_t* option)
 
                 if (mwpc0padx > 0 && possci > -10. && possci < 10. && i == 3)
                 {
-                    fh2_Mwpc0vsRawPos->Fill(possci, mwpc0padx);
+                    fs2_Mwpc0vsRawPos->Fill(possci, mwpc0padx);
                 }
             }
         }
@@ -968,7 +1088,11 @@ void R3BSofSciOnlineSpectra::FinishEvent()
 
 void R3BSofSciOnlineSpectra::FinishTask()
 {
-
+    // No filling anymore: the last pages copied for the displays
+    ApplyRequests();
+    for (size_t k = 0; k < fSparseHists.size(); k++)
+        fSparseHists[k]->Snapshot();
+    R3BSofHistBackend::Flush();
     if (fMappedItemsSci)
     {
         for (UShort_t i = 0; i < fNbDetectors; i++)
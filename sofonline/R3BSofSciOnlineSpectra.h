@@ -7,19 +7,24 @@
 #define R3BSofSciOnlineSpectra_H
 
 #include "FairTask.h"
+#include "R3BSofZCalibration.h"
 #include "TCanvas.h"
 #include "TH1.h"
 #include "TH2D.h"
 #include "TH2F.h"
 #include "TMath.h"
 #include <array>
+#include <atomic>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
+class R3BSofSparseHist;
 
 /**
  * This taks reads SCI data and plots online histograms
@@ -95,6 +100,11 @@ class R3BSofSciOnlineSpectra : public FairTask
     Int_t GetIdS8() { return fIdS8; }
     Double_t GetBrho0() { return fBrho0; }
 
+    /** Views of the raw ToF and raw position histograms, also through THttpServer; min >= max for the full range.
+     *  On the thread of the event loop, which publishes their displays **/
+    void SetTofView(Double_t min, Double_t max);
+    void SetPosView(Double_t min, Double_t max);
+
   private:
     TClonesArray* fMappedItemsSci;     /**< Array with mapped items. */
     TClonesArray* fTcalItemsSci;       /**< Array with tcal items. */
@@ -110,14 +120,19 @@ class R3BSofSciOnlineSpectra : public FairTask
     Int_t fIdS2;
     Int_t fIdS8;
     Double_t fBrho0;  //Brho setting in FRS S2-S8
+    Double_t fTofViewMin, fTofViewMax;
+    Double_t fPosViewMin, fPosViewMax;
+
+    // Sparse histograms, their pages filled and reset by Exec, their displays published by R3BSofHistBackend
+    std::vector<R3BSofSparseHist*> fSparseHists; //!
+    std::atomic<Bool_t> fSparseResetRequested;   //! through THttpServer
+    void ApplyRequests();
 
     Int_t fNumSec;
     Int_t fNumAnodes;
     Int_t fNumParams;
-    Float_t fZ0 = 0., fZ1 = 0. , fZ2 = 0.; // CalibPar for R3BMUSIC
-    TArrayF* CalZParams;
-    Float_t fTwimZ0 = 0., fTwimZ1 = 0., fTwimZ2 = 0.; // CalibPar for Twim
-    TArrayF* TwimCalZParams;
+    R3BSofZCalibration fMusicZCal; //! CalibPar for R3BMUSIC
+    R3BSofZCalibration fTwimZCal;  //! CalibPar for Twim
 
     // check for trigger should be done globablly (somewhere else)
     R3BEventHeader* header; /**< Event header.      */
@@ -143,17 +158,17 @@ class R3BSofSciOnlineSpectra : public FairTask
     TH1I** fh1_finetime; // [fNbDetectors * NbChannels];
     TH2I** fh2_mult;     // [fNbDetectors];
 
-    // Histograms for PosRaw Data at Tcal and SingleTcal
-    TH1F** fh1_RawPos_AtTcalMult1;  // [fNbDetectors];
-    TH1F** fh1_RawPos_AtSingleTcal; // [fNbDetectors];
+    // Histograms for PosRaw Data at Tcal and SingleTcal, full resolution only where populated
+    R3BSofSparseHist** fh1_RawPos_AtTcalMult1;  //! [fNbDetectors];
+    R3BSofSparseHist** fh1_RawPos_AtSingleTcal; //! [fNbDetectors];
 
-    TH1D** fh1_RawTof_FromS2_AtTcalMult1;        // [fNbDetectors];
-    TH1D** fh1_RawTof_FromS2_AtTcalMult1_wTref;  // [fNbDetectors];
-    TH1D** fh1_RawTof_FromS2_AtSingleTcal_wTref; // [fNbDetectors];
+    R3BSofSparseHist** fh1_RawTof_FromS2_AtTcalMult1;        //! [fNbDetectors];
+    R3BSofSparseHist** fh1_RawTof_FromS2_AtTcalMult1_wTref;  //! [fNbDetectors];
+    R3BSofSparseHist** fh1_RawTof_FromS2_AtSingleTcal_wTref; //! [fNbDetectors];
 
-    TH1D** fh1_RawTof_FromS8_AtTcalMult1;        // [fNbDetectors];
-    TH1D** fh1_RawTof_FromS8_AtTcalMult1_wTref;  // [fNbDetectors];
-    TH1D** fh1_RawTof_FromS8_AtSingleTcal_wTref; // [fNbDetectors];
+    R3BSofSparseHist** fh1_RawTof_FromS8_AtTcalMult1;        //! [fNbDetectors];
+    R3BSofSparseHist** fh1_RawTof_FromS8_AtTcalMult1_wTref;  //! [fNbDetectors];
+    R3BSofSparseHist** fh1_RawTof_FromS8_AtSingleTcal_wTref; //! [fNbDetectors];
 
     TH2F** fh2_Beta_Correlation;
     
@@ -170,6 +185,20 @@ class R3BSofSciOnlineSpectra : public FairTask
     // Histogram for correlation with Mwpc0
     TH2F* fh2_Mwpc0vsRawPos;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist** fs1_finetime;                  //! [fNbDetectors * NbChannels];
+    R3BSofShardedHist** fs2_mult;                      //! [fNbDetectors];
+    R3BSofShardedHist** fs2_MusZvsRawPos;              //! [fNbDetectors];
+    R3BSofShardedHist** fs2_MusZvsRawTof_FromS2;       //! [fNbDetectors];
+    R3BSofShardedHist** fs2_MusZvsRawTof_FromS8;       //! [fNbDetectors];
+    R3BSofShardedHist* fs2_Beta_Correlation[3];        //!
+    R3BSofShardedHist* fs2_MusDTvsRawPos;              //!
+    R3BSofShardedHist* fs2_TwimvsMusicZ_betacorrected; //!
+    R3BSofShardedHist* fs2_MusEvsBeta;                 //!
+    R3BSofShardedHist* fs2_Aqvsx2;                     //!
+    R3BSofShardedHist* fs2_Aqvsq;                      //!
+    R3BSofShardedHist* fs2_Mwpc0vsRawPos;              //!
+
     // check how many raw pos found
 
   public:
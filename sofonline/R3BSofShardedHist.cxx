@@ -0,0 +1,131 @@
+// ------------------------------------------------------------
+// -----                R3BSofShardedHist                 -----
+// -----     Lock-free filling of a published histogram   -----
+// ------------------------------------------------------------
+
+#include "R3BSofShardedHist.h"
+#include "R3BSofHistBackend.h"
+
+#include "TArrayD.h"
+#include "TArrayF.h"
+
+R3BSofShardedHist::R3BSofShardedHist(TH1* h, Int_t nShards)
+    : fHist(h)
+    , fDirect(nShards < 1)
+    , fNumShards(nShards < 1 ? 1 : nShards)
+    , fNumCells(0)
+    , fNx(h->GetNbinsX())
+    , fNy(h->GetDimension() > 1 ? h->GetNbinsY() : 0)
+    , fXmin(h->GetXaxis()->GetXmin())
+    , fXmax(h->GetXaxis()->GetXmax())
+    , fXscale(fNx / (fXmax - fXmin))
+    , fYmin(h->GetYaxis()->GetXmin())
+    , fYmax(h->GetYaxis()->GetXmax())
+    , fYscale(fNy / (fYmax - fYmin))
+    , fXfix(!h->GetXaxis()->IsVariableBinSize())
+    , fYfix(!h->GetYaxis()->IsVariableBinSize())
+    , fXaxis(*h->GetXaxis())
+    , fYaxis(*h->GetYaxis())
+    , fCounts(NULL)
+    , fSnapshotEntries(0.)
+    , fReady(kFALSE)
+    , fResetRequested(kFALSE)
+    , fResetCount(0)
+    , fSnapshotResetCount(0)
+    , fMaximumOf(NULL)
+    , fMaximumFactor(1.)
+{
+    if (fDirect)
+        return;
+    fNumCells = (fNx + 2) * (fNy > 0 ? fNy + 2 : 1);
+    fCounts = new std::atomic<ULong64_t>[(size_t)fNumShards * fNumCells];
+    for (size_t i = 0; i < (size_t)fNumShards * fNumCells; i++)
+        fCounts[i].store(0, std::memory_order_relaxed);
+    fBaseline.assign(fNumCells, 0);
+    fSnapshot.assign(fNumCells, 0.);
+}
+
+R3BSofShardedHist::~R3BSofShardedHist()
+{
+    if (fDirect)
+        return;
+    R3BSofHistBackend::Unregister(this);
+    delete[] fCounts;
+}
+
+Int_t R3BSofShardedHist::ThreadShard()
+{
+    static std::atomic<Int_t> gNextShard(0);
+    static thread_local Int_t shard = gNextShard.fetch_add(1);
+    return shard;
+}
+
+void R3BSofShardedHist::Reset()
+{
+    fHist->Reset();
+    if (!fDirect)
+    {
+        // A snapshot taken before, even if ready, would bring back the counts
+        fResetCount.fetch_add(1, std::memory_order_acq_rel);
+        fResetRequested.store(kTRUE, std::memory_order_release);
+    }
+}
+
+void R3BSofShardedHist::Snapshot(Bool_t force)
+{
+    if (fDirect || (!force && fReady.load(std::memory_order_acquire)))
+        return;
+
+    // Count read first: a Reset from here on makes this snapshot stale, its baseline is applied next time
+    UInt_t resetCount = fResetCount.load(std::memory_order_acquire);
+    Bool_t reset = fResetRequested.exchange(kFALSE, std::memory_order_acq_rel);
+    Double_t entries = 0.;
+    for (Int_t cell = 0; cell < fNumCells; cell++)
+    {
+        ULong64_t sum = 0;
+        for (Int_t s = 0; s < fNumShards; s++)
+            sum += fCounts[(size_t)s * fNumCells + cell].load(std::memory_order_relaxed);
+        if (reset)
+            fBaseline[cell] = sum;
+        fSnapshot[cell] = sum - fBaseline[cell];
+        entries += fSnapshot[cell];
+    }
+    fSnapshotEntries = entries;
+    fSnapshotResetCount = resetCount;
+    fReady.store(kTRUE, std::memory_order_release);
+}
+
+void R3BSofShardedHist::Publish()
+{
+    if (fDirect || !fReady.load(std::memory_order_acquire))
+        return;
+    if (fSnapshotResetCount != fResetCount.load(std::memory_order_acquire))
+    {
+        fReady.store(kFALSE, std::memory_order_release); // taken before a Reset
+        return;
+    }
+
+    // Arrays of TH1F/TH2F and TH1D/TH2D written in place, the others bin by bin
+    TArrayF* arrayF = dynamic_cast<TArrayF*>(fHist);
+    TArrayD* arrayD = dynamic_cast<TArrayD*>(fHist);
+    if (arrayF && arrayF->GetSize() == fNumCells)
+    {
+        for (Int_t cell = 0; cell < fNumCells; cell++)
+            arrayF->fArray[cell] = fSnapshot[cell];
+    }
+    else if (arrayD && arrayD->GetSize() == fNumCells)
+    {
+        for (Int_t cell = 0; cell < fNumCells; cell++)
+            arrayD->fArray[cell] = fSnapshot[cell];
+    }
+    else
+    {
+        for (Int_t cell = 0; cell < fNumCells; cell++)
+            fHist->SetBinContent(cell, fSnapshot[cell]);
+    }
+    fHist->ResetStats();
+    fHist->SetEntries(fSnapshotEntries);
+    if (fMaximumOf)
+        fMaximumOf->SetMaximum(fMaximumFactor * fHist->GetBinContent(fHist->GetMaximumBin()));
+    fReady.store(kFALSE, std::memory_order_release);
+}
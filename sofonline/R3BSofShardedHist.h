@@ -0,0 +1,140 @@
+// ------------------------------------------------------------
+// -----                R3BSofShardedHist                 -----
+// -----     Lock-free filling of a published histogram   -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofShardedHist_H
+#define R3BSofShardedHist_H
+
+#include "TAxis.h"
+#include "TH1.h"
+#include "TH2.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+ * Counts of a TH1 or TH2 filled by any thread without lock: every thread
+ * adds to the bins of its shard with relaxed atomic increments. The
+ * snapshot thread of R3BSofHistBackend sums the shards into a buffer and the
+ * event loop copies it into the histogram, on the thread which serves
+ * THttpServer, so that the web display never reads a histogram being filled.
+ *
+ * Obtained with R3BSofHistBackend::Book(h) and owned by the caller. Without
+ * a backend in the run the object fills h directly, as before. Only
+ * integer weights, the statistics of the histogram are computed from the
+ * bins.
+ **/
+class R3BSofShardedHist
+{
+  public:
+    /** nShards = 0: direct filling of h **/
+    R3BSofShardedHist(TH1* h, Int_t nShards);
+
+    /** Destructor, removes the histogram from the backend **/
+    ~R3BSofShardedHist();
+
+    /** Filling, from any thread **/
+    inline void Fill(Double_t x)
+    {
+        if (fDirect)
+            fHist->Fill(x);
+        else
+            Add(XBin(x));
+    }
+    /** x and y of a TH2, x and weight (non-negative integer) of a TH1 as TH1::Fill **/
+    inline void Fill(Double_t x, Double_t y)
+    {
+        if (fDirect)
+            fHist->Fill(x, y);
+        else if (fNy == 0)
+            Add(XBin(x), (ULong64_t)y);
+        else
+            Add(XBin(x) + (fNx + 2) * YBin(y));
+    }
+    /** x, y and weight (non-negative integer) of a TH2 **/
+    inline void Fill(Double_t x, Double_t y, Double_t w)
+    {
+        if (fDirect)
+            static_cast<TH2*>(fHist)->Fill(x, y, w);
+        else
+            Add(XBin(x) + (fNx + 2) * YBin(y), (ULong64_t)w);
+    }
+
+    /** Clears the histogram, the shards are cleared at the next snapshot, earlier ones are never published **/
+    void Reset();
+
+    TH1* GetHist() const { return fHist; }
+    Bool_t IsDirect() const { return fDirect; }
+
+    /** Maximum of the display of h set to factor times the largest bin, at each Publish **/
+    void SetMaximumOf(TH1* h, Double_t factor)
+    {
+        fMaximumOf = h;
+        fMaximumFactor = factor;
+    }
+
+    /** Snapshot thread: sums the shards, unless the last snapshot is not published (force) **/
+    void Snapshot(Bool_t force);
+
+    /** Thread of the web server: copies the last snapshot into the histogram **/
+    void Publish();
+
+  private:
+    TH1* fHist;
+    Bool_t fDirect;
+    Int_t fNumShards;
+    Int_t fNumCells; // bins with under- and overflow, global numbering of ROOT
+
+    // Axes, fixed bins computed here and variable ones by a copy of the axis
+    Int_t fNx, fNy;
+    Double_t fXmin, fXmax, fXscale, fYmin, fYmax, fYscale;
+    Bool_t fXfix, fYfix;
+    TAxis fXaxis, fYaxis;
+
+    std::atomic<ULong64_t>* fCounts;      // [shard * fNumCells + cell]
+    std::vector<ULong64_t> fBaseline;     // sums at the last Reset, snapshot thread
+    std::vector<Double_t> fSnapshot;      // sums - fBaseline
+    Double_t fSnapshotEntries;            //
+    std::atomic<Bool_t> fReady;           // fSnapshot waits for Publish
+    std::atomic<Bool_t> fResetRequested;  //
+    std::atomic<UInt_t> fResetCount;      // Reset calls
+    UInt_t fSnapshotResetCount;           // fResetCount when fSnapshot was taken
+    TH1* fMaximumOf;                      // histogram whose maximum follows this one
+    Double_t fMaximumFactor;              //
+
+    static Int_t ThreadShard();
+
+    inline void Add(Int_t cell, ULong64_t n = 1)
+    {
+        fCounts[(ThreadShard() % fNumShards) * fNumCells + cell].fetch_add(n, std::memory_order_relaxed);
+    }
+    inline Int_t XBin(Double_t x) const
+    {
+        if (!fXfix)
+            return fXaxis.FindFixBin(x);
+        // NaN in the overflow, as TAxis::FindFixBin
+        if (x < fXmin)
+            return 0;
+        if (!(x < fXmax))
+            return fNx + 1;
+        Int_t bin = 1 + (Int_t)((x - fXmin) * fXscale);
+        return bin > fNx ? fNx : bin;
+    }
+    inline Int_t YBin(Double_t y) const
+    {
+        if (!fYfix)
+            return fYaxis.FindFixBin(y);
+        if (y < fYmin)
+            return 0;
+        if (!(y < fYmax))
+            return fNy + 1;
+        Int_t bin = 1 + (Int_t)((y - fYmin) * fYscale);
+        return bin > fNy ? fNy : bin;
+    }
+
+    R3BSofShardedHist(const R3BSofShardedHist&);
+    R3BSofShardedHist& operator=(const R3BSofShardedHist&);
+};
+
+#endif
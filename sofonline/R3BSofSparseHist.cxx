@@ -0,0 +1,235 @@
+// ------------------------------------------------------------
+// -----                 R3BSofSparseHist                 -----
+// -----   Fine 1D histogram stored by populated pages    -----
+// ------------------------------------------------------------
+
+#include "R3BSofSparseHist.h"
+#include "R3BSofHistBackend.h"
+
+#include "TMath.h"
+
+#include <cstring>
+
+R3BSofSparseHist::R3BSofSparseHist(const char* name,
+                                   const char* title,
+                                   Int_t nbins,
+                                   Double_t xmin,
+                                   Double_t xmax,
+                                   Int_t nDisplay)
+    : fName(name)
+    , fTitle(title)
+    , fNbins(nbins)
+    , fXmin(xmin)
+    , fXmax(xmax)
+    , fScale(nbins / (xmax - xmin))
+    , fNumDisplay(TMath::Max(1, nDisplay))
+    , fViewFirst(0)
+    , fViewLast(nbins)
+    , fGroup(1)
+    , fPages((nbins + kPageSize - 1) >> kPageBits, (UInt_t*)NULL)
+    , fNumPages(0)
+    , fUnderflow(0)
+    , fOverflow(0)
+    , fDisplay(NULL)
+    , fPublished(kFALSE)
+    , fSnapshotRequested(kFALSE)
+    , fSnapshotReady(kFALSE)
+    , fSnapshotUnderflow(0)
+    , fSnapshotOverflow(0)
+{
+    fDisplay = new TH1D(name, title, TMath::Min(fNbins, fNumDisplay), xmin, xmax);
+    SetView(xmin, xmax);
+}
+
+R3BSofSparseHist::~R3BSofSparseHist()
+{
+    if (fPublished)
+        R3BSofHistBackend::Unregister(this);
+    for (size_t p = 0; p < fPages.size(); p++)
+        delete[] fPages[p];
+}
+
+UInt_t* R3BSofSparseHist::NewPage(Int_t p)
+{
+    fPages[p] = new UInt_t[kPageSize];
+    memset(fPages[p], 0, kPageSize * sizeof(UInt_t));
+    fNumPages++;
+    return fPages[p];
+}
+
+void R3BSofSparseHist::SetView(Double_t min, Double_t max)
+{
+    Int_t first = 0, last = fNbins;
+    if (min < max)
+    {
+        first = TMath::Max(0, (Int_t)TMath::Floor((min - fXmin) * fScale));
+        last = TMath::Min(fNbins, (Int_t)TMath::Ceil((max - fXmin) * fScale));
+        if (last <= first)
+        {
+            first = TMath::Min(first, fNbins - 1);
+            last = first + 1;
+        }
+    }
+    // Display bins of group fine bins, the view extended to a multiple of group, to the left at the end of
+    // the range; when it starts at the first fine bin, the last display bin only has the remaining fine bins
+    Int_t group = (last - first + fNumDisplay - 1) / fNumDisplay;
+    Int_t nDisplay = (last - first + group - 1) / group;
+    last = first + nDisplay * group;
+    if (last > fNbins)
+    {
+        first = TMath::Max(0, fNbins - nDisplay * group);
+        last = first + nDisplay * group;
+    }
+    std::unique_lock<std::mutex> lock(fMutex, std::defer_lock);
+    if (fPublished)
+        lock.lock();
+    fViewFirst = first;
+    fViewLast = TMath::Min(last, fNbins);
+    fGroup = group;
+    fDisplay->SetBins(nDisplay, fXmin + first / fScale, fXmin + last / fScale);
+    Rebuild();
+}
+
+// Display from the pages, or from their last copy with a backend, the fine bins out of the view in its
+// under- and overflow
+void R3BSofSparseHist::Rebuild()
+{
+    fDisplay->Reset();
+    Int_t nDisplay = fDisplay->GetNbinsX();
+    Double_t under, over, entries;
+    if (fPublished)
+    {
+        under = fSnapshotUnderflow;
+        over = fSnapshotOverflow;
+        entries = under + over;
+        for (size_t k = 0; k < fSnapshotPages.size(); k++)
+            AddPage(fSnapshotPages[k], &fSnapshotCounts[k * kPageSize], under, over, entries);
+    }
+    else
+    {
+        under = fUnderflow;
+        over = fOverflow;
+        entries = under + over;
+        for (size_t p = 0; p < fPages.size(); p++)
+            if (fPages[p])
+                AddPage(p, fPages[p], under, over, entries);
+    }
+    fDisplay->SetBinContent(0, under);
+    fDisplay->SetBinContent(nDisplay + 1, over);
+    fDisplay->ResetStats();
+    fDisplay->SetEntries(entries);
+}
+
+void R3BSofSparseHist::AddPage(Int_t p, const UInt_t* page, Double_t& under, Double_t& over, Double_t& entries)
+{
+    Int_t first = p << kPageBits;
+    Int_t n = TMath::Min((Int_t)kPageSize, fNbins - first);
+    for (Int_t i = 0; i < n; i++)
+    {
+        if (page[i] == 0)
+            continue;
+        Int_t bin = first + i;
+        entries += page[i];
+        if (bin < fViewFirst)
+            under += page[i];
+        else if (bin >= fViewLast)
+            over += page[i];
+        else
+            fDisplay->AddBinContent(1 + (bin - fViewFirst) / fGroup, page[i]);
+    }
+}
+
+void R3BSofSparseHist::Snapshot()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fSnapshotRequested.store(kFALSE, std::memory_order_relaxed);
+    fSnapshotPages.clear();
+    fSnapshotCounts.clear();
+    for (size_t p = 0; p < fPages.size(); p++)
+    {
+        if (!fPages[p])
+            continue;
+        fSnapshotPages.push_back(p);
+        fSnapshotCounts.insert(fSnapshotCounts.end(), fPages[p], fPages[p] + kPageSize);
+    }
+    fSnapshotUnderflow = fUnderflow;
+    fSnapshotOverflow = fOverflow;
+    fSnapshotReady = kTRUE;
+}
+
+void R3BSofSparseHist::Publish()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fSnapshotReady)
+        return;
+    Rebuild();
+    fSnapshotReady = kFALSE;
+}
+
+void R3BSofSparseHist::Reset()
+{
+    for (size_t p = 0; p < fPages.size(); p++)
+    {
+        delete[] fPages[p];
+        fPages[p] = NULL;
+    }
+    fNumPages = 0;
+    fUnderflow = 0;
+    fOverflow = 0;
+    if (fPublished)
+        Snapshot(); // empty, the display is cleared at the next Publish
+    else
+        fDisplay->Reset();
+}
+
+Double_t R3BSofSparseHist::GetBinContent(Int_t bin) const
+{
+    if (bin <= 0)
+        return fUnderflow;
+    if (bin > fNbins)
+        return fOverflow;
+    const UInt_t* page = fPages[(bin - 1) >> kPageBits];
+    return page ? page[(bin - 1) & kPageMask] : 0.;
+}
+
+ULong64_t R3BSofSparseHist::GetMemory() const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    return (ULong64_t)fNumPages * kPageSize * sizeof(UInt_t) + fPages.size() * sizeof(UInt_t*) +
+           fSnapshotCounts.capacity() * sizeof(UInt_t) + (fDisplay->GetNbinsX() + 2) * sizeof(Double_t);
+}
+
+Int_t R3BSofSparseHist::Write() const
+{
+    // Not in the current directory, where the display has the same name
+    Bool_t addDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+    TH1D* full = new TH1D(fName, fTitle, fNbins, fXmin, fXmax);
+    TH1::AddDirectory(addDirectory);
+    full->GetXaxis()->SetTitle(fDisplay->GetXaxis()->GetTitle());
+    full->GetYaxis()->SetTitle(fDisplay->GetYaxis()->GetTitle());
+
+    Double_t entries = fUnderflow + fOverflow;
+    for (size_t p = 0; p < fPages.size(); p++)
+    {
+        const UInt_t* page = fPages[p];
+        if (!page)
+            continue;
+        Int_t first = p << kPageBits;
+        Int_t n = TMath::Min((Int_t)kPageSize, fNbins - first);
+        for (Int_t i = 0; i < n; i++)
+        {
+            if (page[i] == 0)
+                continue;
+            full->SetBinContent(1 + first + i, page[i]);
+            entries += page[i];
+        }
+    }
+    full->SetBinContent(0, fUnderflow);
+    full->SetBinContent(fNbins + 1, fOverflow);
+    full->ResetStats();
+    full->SetEntries(entries);
+    Int_t nbytes = full->Write();
+    delete full;
+    return nbytes;
+}
@@ -0,0 +1,145 @@
+// ------------------------------------------------------------
+// -----                 R3BSofSparseHist                 -----
+// -----   Fine 1D histogram stored by populated pages    -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofSparseHist_H
+#define R3BSofSparseHist_H
+
+#include "TH1D.h"
+#include "TString.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * 1D histogram with a very fine binning (e.g. raw ToF, 400000 bins) of
+ * which only a few regions are populated. The counts are kept at full
+ * resolution in pages of 1024 bins allocated at the first count, and a
+ * display histogram of at most nDisplay bins is registered to THttpServer
+ * and drawn in the canvases. The display shows the view set by SetView,
+ * with bins of full resolution as soon as the view is narrow enough:
+ *   fh1_tof = new R3BSofSparseHist("RawTof", "Raw ToF", 400000, -2000, 2000);
+ *   fh1_tof->GetDisplay()->Draw();
+ *   fh1_tof->Fill(tof);
+ *   fh1_tof->SetView(600., 620.); // 2000 bins of 0.01 ns
+ * Write() writes the histogram at full resolution. Fill and Reset are
+ * called from the thread filling the histogram, SetView from the thread of
+ * the web server (the event loop).
+ *
+ * With R3BSofHistBackend (R3BSofHistBackend::Book(sparse), the filling
+ * thread being e.g. a R3BSofOnlinePipeline stage) the display is not filled:
+ * the filling thread copies the populated pages at each Update() following
+ * a request of the backend, and the event loop rebuilds the display from the
+ * last copy in Publish() and SetView(). Without a backend, Fill also fills
+ * the display, everything being on the event loop.
+ **/
+class R3BSofSparseHist
+{
+  public:
+    /** Fine binning, at most nDisplay bins in the display **/
+    R3BSofSparseHist(const char* name,
+                     const char* title,
+                     Int_t nbins,
+                     Double_t xmin,
+                     Double_t xmax,
+                     Int_t nDisplay = 2000);
+
+    /** Destructor **/
+    ~R3BSofSparseHist();
+
+    inline void Fill(Double_t x)
+    {
+        if (!fPublished)
+            fDisplay->Fill(x);
+        if (!(x >= fXmin))
+        {
+            fUnderflow++;
+            return;
+        }
+        if (x >= fXmax)
+        {
+            fOverflow++;
+            return;
+        }
+        Int_t bin = (Int_t)((x - fXmin) * fScale);
+        if (bin >= fNbins)
+            bin = fNbins - 1;
+        UInt_t* page = fPages[bin >> kPageBits];
+        if (!page)
+            page = NewPage(bin >> kPageBits);
+        page[bin & kPageMask]++;
+    }
+
+    /** Histogram of the view, registered and drawn **/
+    TH1D* GetDisplay() const { return fDisplay; }
+
+    /** View in [min, max], aligned on the fine bins; min >= max for the full range **/
+    void SetView(Double_t min, Double_t max);
+
+    void Reset();
+
+    /** Filling thread: copies the pages if the backend requested it **/
+    inline void Update()
+    {
+        if (fSnapshotRequested.load(std::memory_order_relaxed))
+            Snapshot();
+    }
+    /** Filling thread: copies the pages for the next Publish **/
+    void Snapshot();
+    /** Thread of the web server: display of the last copy **/
+    void Publish();
+
+    /** Fine bins, 0 underflow and nbins + 1 overflow **/
+    Int_t GetNbins() const { return fNbins; }
+    Double_t GetBinContent(Int_t bin) const;
+
+    /** Memory of the counts and of the display [bytes] **/
+    ULong64_t GetMemory() const;
+
+    /** Writes the histogram at full resolution **/
+    Int_t Write() const;
+
+  private:
+    friend class R3BSofHistBackend;
+
+    enum
+    {
+        kPageBits = 10,
+        kPageSize = 1 << kPageBits,
+        kPageMask = kPageSize - 1
+    };
+
+    TString fName;
+    TString fTitle;
+    Int_t fNbins;
+    Double_t fXmin, fXmax, fScale; // fScale: fine bins per unit
+    Int_t fNumDisplay;
+    Int_t fViewFirst, fViewLast; // fine bins of the view [first, last), 0-based
+    Int_t fGroup;                // fine bins per display bin
+
+    std::vector<UInt_t*> fPages; // NULL until the first count
+    Int_t fNumPages;             // allocated
+    ULong64_t fUnderflow, fOverflow;
+
+    TH1D* fDisplay;
+
+    // Copy of the pages for the display, with a backend
+    Bool_t fPublished;                      // booked by R3BSofHistBackend
+    mutable std::mutex fMutex;              // the copy and the display
+    std::atomic<Bool_t> fSnapshotRequested; // by the backend
+    Bool_t fSnapshotReady;                  // not yet published
+    std::vector<Int_t> fSnapshotPages;      // populated pages
+    std::vector<UInt_t> fSnapshotCounts;    // [page of fSnapshotPages * kPageSize + i]
+    ULong64_t fSnapshotUnderflow, fSnapshotOverflow;
+
+    UInt_t* NewPage(Int_t p);
+    void Rebuild();
+    void AddPage(Int_t p, const UInt_t* page, Double_t& under, Double_t& over, Double_t& entries);
+
+    R3BSofSparseHist(const R3BSofSparseHist&);
+    R3BSofSparseHist& operator=(const R3BSofSparseHist&);
+};
+
+#endif
@@ -0,0 +1,405 @@
+// ------------------------------------------------------------
+// -----                R3BSofTaskMonitor                 -----
+// -----     CPU time and data flow of the FairTasks      -----
+// ------------------------------------------------------------
+
+#include "R3BSofTaskMonitor.h"
+
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include "FairRun.h"
+#include "FairRunOnline.h"
+
+#include "TClass.h"
+#include "TClonesArray.h"
+#include "TDataMember.h"
+#include "TH1F.h"
+#include "THttpServer.h"
+#include "TList.h"
+#include "TObjString.h"
+#include "TRealData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Histogrammed buckets of the Exec time: from 32 to 2^37 ticks
+static const Int_t kFirstBucket = 16;
+static const Int_t kLastBucket = 144;
+
+// Time stamp counter of the cpu, nanoseconds of the steady clock elsewhere
+static inline ULong64_t Ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+ULong64_t (*R3BSofTaskMonitor::fgAllocationCounter)() = NULL;
+
+// Inserted before a monitored task in the list of the run
+class R3BSofTaskMonitor::Probe : public FairTask
+{
+  public:
+    Probe(R3BSofTaskMonitor* monitor, Int_t task)
+        : FairTask(Form("%s_Probe%d", monitor->GetName(), task), 0)
+        , fMonitor(monitor)
+        , fTask(task)
+    {
+    }
+
+    virtual InitStatus Init()
+    {
+        fMonitor->MarkInit(fTask);
+        return kSUCCESS;
+    }
+
+    virtual void Exec(Option_t* option) { fMonitor->Mark(fTask); }
+
+  private:
+    R3BSofTaskMonitor* fMonitor;
+    Int_t fTask;
+};
+
+R3BSofTaskMonitor::R3BSofTaskMonitor()
+    : FairTask("R3BSofTaskMonitor", 1)
+    , fUpdateInterval(1000)
+    , fHeapSampling(0)
+    , fTicksPerNs(1.)
+    , fNumEvents(0)
+    , fRunning(kFALSE)
+    , fHeapSample(kFALSE)
+    , fStart(0)
+    , fAllocStart(0)
+    , fHeapStart(0)
+    , fNumBranches(0)
+    , fh1_meanTime(NULL)
+    , fh1_hitsIn(NULL)
+    , fh1_hitsOut(NULL)
+    , fh1_heap(NULL)
+{
+}
+
+R3BSofTaskMonitor::R3BSofTaskMonitor(const char* name, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+    , fUpdateInterval(1000)
+    , fHeapSampling(0)
+    , fTicksPerNs(1.)
+    , fNumEvents(0)
+    , fRunning(kFALSE)
+    , fHeapSample(kFALSE)
+    , fStart(0)
+    , fAllocStart(0)
+    , fHeapStart(0)
+    , fNumBranches(0)
+    , fh1_meanTime(NULL)
+    , fh1_hitsIn(NULL)
+    , fh1_hitsOut(NULL)
+    , fh1_heap(NULL)
+{
+}
+
+R3BSofTaskMonitor::~R3BSofTaskMonitor() {}
+
+void R3BSofTaskMonitor::Instrument(FairRun* run)
+{
+    FairTask* main = run->GetMainTask();
+    TList* list = main->GetListOfTasks();
+    // the tasks keep their place and their owner, the probes go in between
+    TObjLink* link = list->FirstLink();
+    while (link)
+    {
+        FairTask* task = dynamic_cast<FairTask*>(link->GetObject());
+        if (!task)
+        {
+            LOG(ERROR) << "R3BSofTaskMonitor::Instrument() " << link->GetObject()->GetName()
+                       << " is not a FairTask, not monitored";
+            link = link->Next();
+            continue;
+        }
+        list->AddBefore(link, new Probe(this, fMonitored.size()));
+        fMonitored.push_back(task);
+        link = link->Next();
+    }
+    main->Add(this);
+    LOG(INFO) << "R3BSofTaskMonitor::Instrument() " << fMonitored.size() << " tasks monitored";
+}
+
+InitStatus R3BSofTaskMonitor::Init()
+{
+    LOG(INFO) << "R3BSofTaskMonitor::Init()";
+
+    // --- Ticks of the time stamp counter per nanosecond --- //
+    std::chrono::steady_clock::time_point c0 = std::chrono::steady_clock::now();
+    ULong64_t t0 = Ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ULong64_t t1 = Ticks();
+    std::chrono::steady_clock::time_point c1 = std::chrono::steady_clock::now();
+    fTicksPerNs = (t1 - t0) / (Double_t)std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count();
+    LOG(INFO) << "R3BSofTaskMonitor::Init() " << fTicksPerNs << " ticks per ns";
+
+    // --- Outputs and inputs of the last task, the others are done by the probes --- //
+    const Int_t n = fMonitored.size();
+    MarkInit(n);
+
+    // --- Histograms --- //
+    Double_t edges[kLastBucket - kFirstBucket + 1];
+    for (Int_t b = kFirstBucket; b <= kLastBucket; b++)
+        edges[b - kFirstBucket] = BucketLow(b) / fTicksPerNs / 1000.;
+    fh1_time.assign(n, NULL);
+    for (Int_t t = 0; t < n; t++)
+    {
+        const char* name = fMonitored[t]->GetName();
+        fh1_time[t] = new TH1F(Form("fh1_ExecTime_%s", name),
+                               Form("Time of %s::Exec;time [#mus];events", fMonitored[t]->ClassName()),
+                               kLastBucket - kFirstBucket,
+                               edges);
+    }
+    fh1_meanTime = new TH1F("fh1_TaskMeanTime", "Mean time of Exec per event;;time [#mus]", n, 0, n);
+    fh1_hitsIn = new TH1F("fh1_TaskHitsIn", "Hits in per event;;hits", n, 0, n);
+    fh1_hitsOut = new TH1F("fh1_TaskHitsOut", "Hits out per event;;hits", n, 0, n);
+    fh1_heap = new TH1F("fh1_TaskHeap", "Heap growth during Exec per sampled event;;bytes", n, 0, n);
+    TH1F* summary[4] = { fh1_meanTime, fh1_hitsIn, fh1_hitsOut, fh1_heap };
+    for (Int_t h = 0; h < 4; h++)
+        for (Int_t t = 0; t < n; t++)
+            summary[h]->GetXaxis()->SetBinLabel(t + 1, fMonitored[t]->GetName());
+
+    FairRunOnline* run = FairRunOnline::Instance();
+    if (run && run->GetHttpServer())
+    {
+        for (Int_t h = 0; h < 4; h++)
+            run->GetHttpServer()->Register("/Tasks", summary[h]);
+        for (Int_t t = 0; t < n; t++)
+            run->GetHttpServer()->Register("/Tasks", fh1_time[t]);
+    }
+    return kSUCCESS;
+}
+
+void R3BSofTaskMonitor::MarkInit(Int_t t)
+{
+    FairRootManager* mgr = FairRootManager::Instance();
+    TList* branches = mgr->GetBranchNameList();
+    if (t == 0)
+    {
+        const Int_t n = fMonitored.size();
+        fIn.assign(n, std::vector<TClonesArray*>());
+        fOut.assign(n, std::vector<TClonesArray*>());
+        fTicks.assign(n, 0);
+        fHitsIn.assign(n, 0);
+        fHitsOut.assign(n, 0);
+        fHeap.assign(n, 0);
+        fNumHeapSamples.assign(n, 0);
+        fAllocations.assign(n, 0);
+        fBuckets.assign(n, std::vector<ULong64_t>(kNumBuckets, 0));
+        fNumBranches = branches->GetEntries();
+        return;
+    }
+
+    // outputs of the task t - 1: the branches registered in its Init
+    const Int_t p = t - 1;
+    FairTask* task = fMonitored[p];
+    for (Int_t b = fNumBranches; b < branches->GetEntries(); b++)
+    {
+        TClonesArray* array = dynamic_cast<TClonesArray*>(mgr->GetObject(((TObjString*)branches->At(b))->GetString()));
+        if (array)
+            fOut[p].push_back(array);
+    }
+    fNumBranches = branches->GetEntries();
+
+    // inputs: the other TClonesArray* members of the task
+    TClass* cl = task->IsA();
+    cl->BuildRealData(task);
+    TIter next(cl->GetListOfRealData());
+    while (TRealData* rd = (TRealData*)next())
+    {
+        TDataMember* dm = rd->GetDataMember();
+        if (!dm || !dm->IsaPointer() || dm->GetArrayDim() > 0 || strcmp(dm->GetTypeName(), "TClonesArray") != 0)
+            continue;
+        TClonesArray* array = *(TClonesArray**)((char*)task + rd->GetThisOffset());
+        if (array && std::find(fOut[p].begin(), fOut[p].end(), array) == fOut[p].end() &&
+            std::find(fIn[p].begin(), fIn[p].end(), array) == fIn[p].end())
+            fIn[p].push_back(array);
+    }
+    LOG(INFO) << "R3BSofTaskMonitor::Init() " << task->GetName() << ": " << fIn[p].size() << " arrays in, "
+              << fOut[p].size() << " out";
+}
+
+void R3BSofTaskMonitor::Exec(Option_t* option)
+{
+    Mark(fMonitored.size());
+    if (fUpdateInterval > 0 && fNumEvents % fUpdateInterval == 0)
+        UpdateHistos();
+}
+
+void R3BSofTaskMonitor::Mark(Int_t t)
+{
+    const ULong64_t end = Ticks();
+    if (t > 0 && fRunning)
+    {
+        // end of the task t - 1, the probe itself not included
+        const Int_t p = t - 1;
+        const ULong64_t ticks = end - fStart;
+        if (fgAllocationCounter)
+            fAllocations[p] += fgAllocationCounter() - fAllocStart;
+        if (fHeapSample)
+        {
+            fHeap[p] += HeapInUse() - fHeapStart;
+            fNumHeapSamples[p]++;
+        }
+        fTicks[p] += ticks;
+        fBuckets[p][Bucket(ticks)]++;
+        for (size_t i = 0; i < fIn[p].size(); i++)
+            fHitsIn[p] += fIn[p][i]->GetEntriesFast();
+        for (size_t i = 0; i < fOut[p].size(); i++)
+            fHitsOut[p] += fOut[p][i]->GetEntriesFast();
+    }
+    if (t == 0)
+    {
+        fNumEvents++;
+        fHeapSample = fHeapSampling > 0 && fNumEvents % fHeapSampling == 0;
+    }
+
+    // start of the task t, skipped by the event loop when not active
+    fRunning = t < (Int_t)fMonitored.size() && fMonitored[t]->IsActive();
+    if (!fRunning)
+        return;
+    fHeapStart = fHeapSample ? HeapInUse() : 0;
+    fAllocStart = fgAllocationCounter ? fgAllocationCounter() : 0;
+    fStart = Ticks();
+}
+
+void R3BSofTaskMonitor::FinishTask()
+{
+    UpdateHistos();
+
+    ULong64_t total = 0;
+    for (size_t t = 0; t < fMonitored.size(); t++)
+        total += fTicks[t];
+    LOG(INFO) << "R3BSofTaskMonitor: " << fNumEvents << " events, " << total / fTicksPerNs / 1.e9 << " s in the tasks";
+    LOG(INFO) << Form("%-36s %6s %10s %10s %10s %9s %9s %11s %9s",
+                      "task",
+                      "time",
+                      "mean[us]",
+                      "median[us]",
+                      "99%[us]",
+                      "hits in",
+                      "hits out",
+                      "heap[B]",
+                      "allocs");
+    for (size_t t = 0; t < fMonitored.size(); t++)
+    {
+        ULong64_t n = GetNumExecs(t);
+        if (n == 0)
+            continue;
+        LOG(INFO) << Form("%-36s %5.1f%% %10.3f %10.3f %10.3f %9.2f %9.2f %11.1f %9.2f",
+                          fMonitored[t]->GetName(),
+                          total > 0 ? 100. * fTicks[t] / total : 0.,
+                          fTicks[t] / fTicksPerNs / 1000. / n,
+                          Quantile(t, 0.5),
+                          Quantile(t, 0.99),
+                          (Double_t)fHitsIn[t] / n,
+                          (Double_t)fHitsOut[t] / n,
+                          fNumHeapSamples[t] > 0 ? (Double_t)fHeap[t] / fNumHeapSamples[t] : 0.,
+                          (Double_t)fAllocations[t] / n);
+    }
+
+    if (fNumEvents > 0)
+    {
+        fh1_meanTime->Write();
+        fh1_hitsIn->Write();
+        fh1_hitsOut->Write();
+        fh1_heap->Write();
+        for (size_t t = 0; t < fh1_time.size(); t++)
+            fh1_time[t]->Write();
+    }
+}
+
+void R3BSofTaskMonitor::UpdateHistos()
+{
+    for (size_t t = 0; t < fMonitored.size(); t++)
+    {
+        ULong64_t n = 0, under = 0, over = 0;
+        for (Int_t b = 0; b < kNumBuckets; b++)
+        {
+            n += fBuckets[t][b];
+            if (b < kFirstBucket)
+                under += fBuckets[t][b];
+            else if (b >= kLastBucket)
+                over += fBuckets[t][b];
+            else
+                fh1_time[t]->SetBinContent(b - kFirstBucket + 1, fBuckets[t][b]);
+        }
+        fh1_time[t]->SetBinContent(0, under);
+        fh1_time[t]->SetBinContent(kLastBucket - kFirstBucket + 1, over);
+        fh1_time[t]->SetEntries(n);
+        if (n == 0)
+            continue;
+        fh1_meanTime->SetBinContent(t + 1, fTicks[t] / fTicksPerNs / 1000. / n);
+        fh1_hitsIn->SetBinContent(t + 1, (Double_t)fHitsIn[t] / n);
+        fh1_hitsOut->SetBinContent(t + 1, (Double_t)fHitsOut[t] / n);
+        if (fNumHeapSamples[t] > 0)
+            fh1_heap->SetBinContent(t + 1, (Double_t)fHeap[t] / fNumHeapSamples[t]);
+    }
+}
+
+// 4 buckets per factor 2: 0, 1, 2, 3, then [4,5), [5,6), [6,7), [7,8), [8,10), ...
+Int_t R3BSofTaskMonitor::Bucket(ULong64_t ticks)
+{
+    if (ticks < 4)
+        return ticks;
+    Int_t msb = 63 - __builtin_clzll(ticks);
+    return 4 * (msb - 1) + ((ticks >> (msb - 2)) & 3);
+}
+
+ULong64_t R3BSofTaskMonitor::BucketLow(Int_t bucket)
+{
+    if (bucket < 4)
+        return bucket;
+    return (ULong64_t)(4 + bucket % 4) << (bucket / 4 - 1);
+}
+
+ULong64_t R3BSofTaskMonitor::GetNumExecs(Int_t task) const
+{
+    ULong64_t n = 0;
+    for (Int_t b = 0; b < kNumBuckets; b++)
+        n += fBuckets[task][b];
+    return n;
+}
+
+Double_t R3BSofTaskMonitor::Quantile(Int_t task, Double_t q) const
+{
+    ULong64_t n = GetNumExecs(task);
+    ULong64_t sum = 0;
+    for (Int_t b = 0; b < kNumBuckets - 1; b++)
+    {
+        sum += fBuckets[task][b];
+        if (sum >= q * n)
+            return 0.5 * (BucketLow(b) + BucketLow(b + 1)) / fTicksPerNs / 1000.;
+    }
+    return BucketLow(kNumBuckets - 1) / fTicksPerNs / 1000.;
+}
+
+Long64_t R3BSofTaskMonitor::HeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo mi = mallinfo();
+    return (Long64_t)(UInt_t)mi.uordblks + (UInt_t)mi.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+ClassImp(R3BSofTaskMonitor)
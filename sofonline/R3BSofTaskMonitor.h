@@ -0,0 +1,134 @@
+// ------------------------------------------------------------
+// -----                R3BSofTaskMonitor                 -----
+// -----     CPU time and data flow of the FairTasks      -----
+// ------------------------------------------------------------
+
+#ifndef R3BSofTaskMonitor_H
+#define R3BSofTaskMonitor_H
+
+#include "FairTask.h"
+
+#include <vector>
+
+class FairRun;
+class TClonesArray;
+class TH1F;
+
+/**
+ * Measures the tasks of a run, without changing them:
+ *   R3BSofTaskMonitor* monitor = new R3BSofTaskMonitor();
+ *   monitor->Instrument(run); // after the last AddTask, before Init
+ *
+ * The tasks stay in the list of the run, found by FairRun::GetTask and owned
+ * as before: a probe task is inserted before each of them and the monitor is
+ * appended, every probe marking the end of the previous task and the start of
+ * the next one. For each task it gives
+ *  - the time of Exec (and of its subtasks), read with the time stamp counter
+ *    of the cpu, as a histogram with 4 bins per factor 2,
+ *  - the hits in (entries of the TClonesArray* members of the task which
+ *    point to branches of other tasks) and out (entries of the branches
+ *    registered in its Init) per event,
+ *  - the growth of the heap during Exec, sampled every fHeapSampling events
+ *    (mallinfo of glibc, off by default since it costs a few microseconds),
+ *  - the number of allocations during Exec, if the program gives a counter
+ *    (see sofbench/sofia_bench.cxx).
+ * The histograms are published in the folder /Tasks of the THttpServer of an
+ * online run, updated every fUpdateInterval events, and written at the end
+ * together with a summary in the log.
+ **/
+class R3BSofTaskMonitor : public FairTask
+{
+
+  public:
+    /** Default constructor **/
+    R3BSofTaskMonitor();
+
+    /** Standard constructor **/
+    R3BSofTaskMonitor(const char* name, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofTaskMonitor();
+
+    /** Inserts the probes between the tasks of the run and appends the monitor **/
+    void Instrument(FairRun* run);
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Virtual method Exec, end of the last task **/
+    virtual void Exec(Option_t* option);
+
+    /** Virtual method FinishTask **/
+    virtual void FinishTask();
+
+    /** Modifiers **/
+    void SetUpdateInterval(Int_t n) { fUpdateInterval = n; }
+    void SetHeapSampling(Int_t n) { fHeapSampling = n; }
+
+    /** Counter of the allocations of the process (e.g. by a replacement of operator new),
+     *  read around each Exec when set **/
+    static void SetAllocationCounter(ULong64_t (*counter)()) { fgAllocationCounter = counter; }
+
+    /** Results per task, t in [0, GetNumTasks()) **/
+    Int_t GetNumTasks() const { return fMonitored.size(); }
+    FairTask* GetTask(Int_t t) const { return fMonitored[t]; }
+    ULong64_t GetNumExecs(Int_t t) const;
+    Double_t GetTotalTime(Int_t t) const { return fTicks[t] / fTicksPerNs; } // [ns]
+    Double_t Quantile(Int_t t, Double_t q) const;                            // [us]
+    ULong64_t GetHitsIn(Int_t t) const { return fHitsIn[t]; }
+    ULong64_t GetHitsOut(Int_t t) const { return fHitsOut[t]; }
+    ULong64_t GetAllocations(Int_t t) const { return fAllocations[t]; }
+
+  private:
+    class Probe;
+
+    static const Int_t kNumBuckets = 252; // up to 2^64 ticks
+
+    Int_t fUpdateInterval; // events between two updates of the histograms
+    Int_t fHeapSampling;   // events between two heap samples, 0 for none
+    Double_t fTicksPerNs;
+    ULong64_t fNumEvents;
+
+    // Task being executed, from its probe on
+    Bool_t fRunning;       //! the task is active
+    Bool_t fHeapSample;    //! heap sampled in this event
+    ULong64_t fStart;      //!
+    ULong64_t fAllocStart; //!
+    Long64_t fHeapStart;   //!
+    Int_t fNumBranches;    //! branches registered before the Init of the task
+
+    // Per task
+    std::vector<FairTask*> fMonitored;            //!
+    std::vector<std::vector<TClonesArray*>> fIn;  //!
+    std::vector<std::vector<TClonesArray*>> fOut; //!
+    std::vector<ULong64_t> fTicks;                //! total time
+    std::vector<ULong64_t> fHitsIn;               //!
+    std::vector<ULong64_t> fHitsOut;              //!
+    std::vector<Long64_t> fHeap;                  //! heap growth of the samples [bytes]
+    std::vector<ULong64_t> fNumHeapSamples;       //!
+    std::vector<ULong64_t> fAllocations;          //!
+    std::vector<std::vector<ULong64_t>> fBuckets; //! distribution of the Exec time
+    std::vector<TH1F*> fh1_time;                  //!
+
+    // Summary, one bin per task
+    TH1F* fh1_meanTime;
+    TH1F* fh1_hitsIn;
+    TH1F* fh1_hitsOut;
+    TH1F* fh1_heap;
+
+    static Int_t Bucket(ULong64_t ticks);
+    static ULong64_t BucketLow(Int_t bucket);
+    static ULong64_t (*fgAllocationCounter)();
+
+    static Long64_t HeapInUse();
+    void UpdateHistos();
+
+    /** Probe t: end of the task t - 1 and start of the task t, t = number of tasks for the monitor **/
+    void Mark(Int_t t);
+    void MarkInit(Int_t t);
+
+  public:
+    ClassDef(R3BSofTaskMonitor, 1)
+};
+
+#endif
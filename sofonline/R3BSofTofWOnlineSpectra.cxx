@@ -8,9 +8,13 @@
  */
 
 #include "R3BSofTofWOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BSofMwpcCalData.h"
 #include "R3BSofSciSingleTcalData.h"
+#include "R3BSofTofWFiredPaddles.h"
 #include "R3BSofTofWMappedData.h"
 #include "R3BSofTofWSingleTcalData.h"
 #include "R3BSofTofWTcalData.h"
@@ -52,6 +56,17 @@ R3BSofTofWOnlineSpectra::R3BSofTofWOnlineSpectra()
     , fTwimTofRangeMin(-87.)
     , fIdSofSciCaveC(1)
     , fNEvents(0)
+    , fFiredPaddles(NULL)
+    , fs1_finetime()
+    , fs1_EneRaw()
+    , fs2_mult()
+    , fs1_RawPos_AtTcalMult1()
+    , fs1_RawPos_AtSingleTcal()
+    , fs1_RawTof_AtTcalMult1()
+    , fs1_RawTof_AtSingleTcal()
+    , fs2_Twim_Tof()
+    , fs2_Mwpc3Y_PosTof()
+    , fs2_Mwpc3X_Tof(NULL)
 {
 }
 
@@ -67,6 +82,17 @@ R3BSofTofWOnlineSpectra::R3BSofTofWOnlineSpectra(const char* name, Int_t iVerbos
     , fTwimTofRangeMin(-87.)
     , fIdSofSciCaveC(1)
     , fNEvents(0)
+    , fFiredPaddles(NULL)
+    , fs1_finetime()
+    , fs1_EneRaw()
+    , fs2_mult()
+    , fs1_RawPos_AtTcalMult1()
+    , fs1_RawPos_AtSingleTcal()
+    , fs1_RawTof_AtTcalMult1()
+    , fs1_RawTof_AtSingleTcal()
+    , fs2_Twim_Tof()
+    , fs2_Mwpc3Y_PosTof()
+    , fs2_Mwpc3X_Tof(NULL)
 {
 }
 
@@ -85,6 +111,23 @@ R3BSofTofWOnlineSpectra::~R3BSofTofWOnlineSpectra()
         delete fHitItemsTwim;
     if (fCalItemsMwpc)
         delete fCalItemsMwpc;
+    for (Int_t i = 0; i < NbDets * NbChs; i++)
+    {
+        delete fs1_finetime[i];
+        delete fs1_EneRaw[i];
+    }
+    for (Int_t i = 0; i < NbChs; i++)
+        delete fs2_mult[i];
+    for (Int_t i = 0; i < NbDets; i++)
+    {
+        delete fs1_RawPos_AtTcalMult1[i];
+        delete fs1_RawPos_AtSingleTcal[i];
+        delete fs1_RawTof_AtTcalMult1[i];
+        delete fs1_RawTof_AtSingleTcal[i];
+        delete fs2_Twim_Tof[i];
+        delete fs2_Mwpc3Y_PosTof[i];
+    }
+    delete fs2_Mwpc3X_Tof;
 }
 
 InitStatus R3BSofTofWOnlineSpectra::Init()
@@ -98,7 +141,7 @@ InitStatus R3BSofTofWOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofTofWOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
@@ -106,16 +149,19 @@ InitStatus R3BSofTofWOnlineSpectra::Init()
     // --- ------------------------------------- --- //
     // --- get access to mapped data of the TofW --- //
     // --- ------------------------------------- --- //
-    fMappedItemsTofW = (TClonesArray*)mgr->GetObject("SofTofWMappedData");
+    fMappedItemsTofW = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofTofWMappedData");
     if (!fMappedItemsTofW)
     {
         return kFATAL;
     }
 
+    // paddles with mapped hits, from the reader, optional
+    fFiredPaddles = (R3BSofTofWFiredPaddles*)R3BSofOnlinePipeline::GetObject("SofTofWFiredPaddles");
+
     // --- ----------------------------------- --- //
     // --- get access to tcal data of the TofW --- //
     // --- ----------------------------------- --- //
-    fTcalItemsTofW = (TClonesArray*)mgr->GetObject("SofTofWTcalData");
+    fTcalItemsTofW = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofTofWTcalData");
     if (!fTcalItemsTofW)
     {
         return kFATAL;
@@ -124,7 +170,7 @@ InitStatus R3BSofTofWOnlineSpectra::Init()
     // --- ------------------------------------------ --- //
     // --- get access to single tcal data of the TofW --- //
     // --- ------------------------------------------ --- //
-    fSingleTcalItemsTofW = (TClonesArray*)mgr->GetObject("SofTofWSingleTcalData");
+    fSingleTcalItemsTofW = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofTofWSingleTcalData");
     if (!fSingleTcalItemsTofW)
     {
         return kFATAL;
@@ -133,19 +179,19 @@ InitStatus R3BSofTofWOnlineSpectra::Init()
     // --- ----------------------------------------- --- //
     // --- get access to single tcal data of the Sci --- //
     // --- ----------------------------------------- --- //
-    fSingleTcalItemsSci = (TClonesArray*)mgr->GetObject("SofSciSingleTcalData");
+    fSingleTcalItemsSci = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofSciSingleTcalData");
     if (!fSingleTcalItemsSci)
     {
         return kFATAL;
     }
 
     // get access to hit data of the TWIM
-    fHitItemsTwim = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fHitItemsTwim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fHitItemsTwim)
         LOG(WARNING) << "R3BSofTofWOnlineSpectra: TwimHitData not found";
 
     // get access to cal data of the MWPC3
-    fCalItemsMwpc = (TClonesArray*)mgr->GetObject("Mwpc3CalData");
+    fCalItemsMwpc = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc3CalData");
     if (!fCalItemsMwpc)
         LOG(WARNING) << "R3BSofTofWOnlineSpectra: Mwpc3CalData not found";
 
@@ -332,6 +378,24 @@ InitStatus R3BSofTofWOnlineSpectra::Init()
         fh2_Mwpc3Y_PosTof[i]->Draw("col");
     }
 
+    for (Int_t i = 0; i < NbDets * NbChs; i++)
+    {
+        fs1_finetime[i] = R3BSofHistBackend::Book(fh1_finetime[i]);
+        fs1_EneRaw[i] = R3BSofHistBackend::Book(fh1_EneRaw[i]);
+    }
+    for (Int_t i = 0; i < NbChs; i++)
+        fs2_mult[i] = R3BSofHistBackend::Book(fh2_mult[i]);
+    for (Int_t i = 0; i < NbDets; i++)
+    {
+        fs1_RawPos_AtTcalMult1[i] = R3BSofHistBackend::Book(fh1_RawPos_AtTcalMult1[i]);
+        fs1_RawPos_AtSingleTcal[i] = R3BSofHistBackend::Book(fh1_RawPos_AtSingleTcal[i]);
+        fs1_RawTof_AtTcalMult1[i] = R3BSofHistBackend::Book(fh1_RawTof_AtTcalMult1[i]);
+        fs1_RawTof_AtSingleTcal[i] = R3BSofHistBackend::Book(fh1_RawTof_AtSingleTcal[i]);
+        fs2_Twim_Tof[i] = R3BSofHistBackend::Book(fh2_Twim_Tof[i]);
+        fs2_Mwpc3Y_PosTof[i] = R3BSofHistBackend::Book(fh2_Mwpc3Y_PosTof[i]);
+    }
+    fs2_Mwpc3X_Tof = R3BSofHistBackend::Book(fh2_Mwpc3X_Tof);
+
     // --- --------------- --- //
     // --- MAIN FOLDER-TofW --- //
     // --- --------------- --- //
@@ -385,31 +449,31 @@ void R3BSofTofWOnlineSpectra::Reset_Histo()
     for (Int_t j = 0; j < NbChs; j++)
     {
         // === MULT === //
-        fh2_mult[j]->Reset();
+        fs2_mult[j]->Reset();
         for (Int_t i = 0; i < NbDets; i++)
         {
             // === FINE TIME === //
-            fh1_finetime[i * NbChs + j]->Reset();
-            fh1_EneRaw[i * NbChs + j]->Reset();
+            fs1_finetime[i * NbChs + j]->Reset();
+            fs1_EneRaw[i * NbChs + j]->Reset();
         }
     }
 
     for (Int_t i = 0; i < NbDets; i++)
     {
         // === RAW POSITION === //
-        fh1_RawPos_AtTcalMult1[i]->Reset();
-        fh1_RawPos_AtSingleTcal[i]->Reset();
+        fs1_RawPos_AtTcalMult1[i]->Reset();
+        fs1_RawPos_AtSingleTcal[i]->Reset();
         // === RAW TIME-OF-FLIGHT === //
-        fh1_RawTof_AtTcalMult1[i]->Reset();
-        fh1_RawTof_AtSingleTcal[i]->Reset();
+        fs1_RawTof_AtTcalMult1[i]->Reset();
+        fs1_RawTof_AtSingleTcal[i]->Reset();
     }
     for (UShort_t i = 0; i < NbDets; i++)
     {
-        fh2_Twim_Tof[i]->Reset();
-        fh2_Mwpc3Y_PosTof[i]->Reset();
+        fs2_Twim_Tof[i]->Reset();
+        fs2_Mwpc3Y_PosTof[i]->Reset();
     }
 
-    fh2_Mwpc3X_Tof->Reset();
+    fs2_Mwpc3X_Tof->Reset();
 }
 
 void R3BSofTofWOnlineSpectra::Exec(Option_t* option)
@@ -423,17 +487,8 @@ void R3BSofTofWOnlineSpectra::Exec(Option_t* option)
     UShort_t iCh;  // 0-based
     Double_t iRawTimeNs[NbDets * 2];
     UShort_t mult[NbDets * NbChs];
-
-    // --- -------------- --- //
-    // --- initialisation --- //
-    // --- -------------- --- //
-    for (UShort_t i = 0; i < NbDets; i++)
-    {
-        for (UShort_t j = 0; j < NbChs; j++)
-        {
-            mult[i * NbChs + j] = 0;
-        }
-    }
+    // Paddles with hits, only these entries of mult and iRawTimeNs are used
+    ULong64_t fired = 0;
 
     if (fSingleTcalItemsTofW && fSingleTcalItemsTofW->GetEntriesFast())
     {
@@ -444,14 +499,23 @@ void R3BSofTofWOnlineSpectra::Exec(Option_t* option)
         for (Int_t ihit = 0; ihit < nHits; ihit++)
         {
             R3BSofTofWSingleTcalData* hitST = (R3BSofTofWSingleTcalData*)fSingleTcalItemsTofW->At(ihit);
-            fh1_RawPos_AtSingleTcal[hitST->GetDetector() - 1]->Fill(hitST->GetRawPosNs());
-            fh1_RawTof_AtSingleTcal[hitST->GetDetector() - 1]->Fill(hitST->GetRawTofNs());
+            fs1_RawPos_AtSingleTcal[hitST->GetDetector() - 1]->Fill(hitST->GetRawPosNs());
+            fs1_RawTof_AtSingleTcal[hitST->GetDetector() - 1]->Fill(hitST->GetRawTofNs());
         } // end of loop over the singletcal data
     }
 
     if (fMappedItemsTofW && fMappedItemsTofW->GetEntriesFast() && fTcalItemsTofW && fTcalItemsTofW->GetEntriesFast())
     {
 
+        // the fired paddles are published by the reader, else found from the mapped data
+        if (fFiredPaddles)
+        {
+            fired = fFiredPaddles->GetMask();
+            for (ULong64_t m = fired; m; m &= m - 1)
+                for (UShort_t j = 0; j < NbChs; j++)
+                    mult[__builtin_ctzll(m) * NbChs + j] = 0;
+        }
+
         // --- --------------------- --- //
         // --- loop over mapped data --- //
         // --- --------------------- --- //
@@ -463,9 +527,15 @@ void R3BSofTofWOnlineSpectra::Exec(Option_t* option)
                 continue;
             iDet = hitmapped->GetDetector() - 1;
             iCh = hitmapped->GetPmt() - 1;
+            if (!((fired >> iDet) & 1))
+            {
+                fired |= 1ULL << iDet;
+                for (UShort_t j = 0; j < NbChs; j++)
+                    mult[iDet * NbChs + j] = 0;
+            }
             mult[iDet * NbChs + iCh]++;
-            fh1_finetime[iDet * NbChs + iCh]->Fill(hitmapped->GetTimeFine());
-            fh1_EneRaw[iDet * NbChs + iCh]->Fill(hitmapped->GetEnergy());
+            fs1_finetime[iDet * NbChs + iCh]->Fill(hitmapped->GetTimeFine());
+            fs1_EneRaw[iDet * NbChs + iCh]->Fill(hitmapped->GetEnergy());
         }
 
         // --- ------------------- --- //
@@ -544,32 +614,38 @@ void R3BSofTofWOnlineSpectra::Exec(Option_t* option)
         // --- ----------------------------------------- --- //
         Double_t tofw = 0.;
         Double_t tofpos = -1000;
-        for (UShort_t i = 0; i < NbDets; i++)
+        // the paddles without hits have multiplicity 0 for both PMTs, filled
+        // every event so that the published histograms are up to date
+        for (ULong64_t m = ~fired & ((1ULL << NbDets) - 1); m; m &= m - 1)
+            for (UShort_t j = 0; j < NbChs; j++)
+                fs2_mult[j]->Fill(__builtin_ctzll(m) + 1, 0);
+        for (ULong64_t m = fired; m; m &= m - 1)
         {
+            UShort_t i = __builtin_ctzll(m);
             for (UShort_t j = 0; j < NbChs; j++)
             {
-                fh2_mult[j]->Fill(i + 1, mult[i * NbChs + j]);
+                fs2_mult[j]->Fill(i + 1, mult[i * NbChs + j]);
             }
             if ((mult[i * NbChs] == 1) && (mult[i * NbChs + 1] == 1))
             {
                 // Y position is increasing from down to up: PosRaw = TrawDown - TrawUp
                 tofpos = (Double_t)(iRawTimeNs[i * NbChs + 1] - iRawTimeNs[i * NbChs]);
-                fh1_RawPos_AtTcalMult1[i]->Fill(tofpos);
+                fs1_RawPos_AtTcalMult1[i]->Fill(tofpos);
                 if (TrawStart != -1000000.)
                 {
                     tofw = (0.5 * (iRawTimeNs[i * 2 + 1] + iRawTimeNs[i * 2])) - TrawStart;
-                    fh1_RawTof_AtTcalMult1[i]->Fill(tofw);
+                    fs1_RawTof_AtTcalMult1[i]->Fill(tofw);
                     if (twimZ > 0)
                     {
-                        fh2_Twim_Tof[i]->Fill(tofw, twimZ);
+                        fs2_Twim_Tof[i]->Fill(tofw, twimZ);
                     }
                     if (mwpc3x > 0)
                     {
-                        fh2_Mwpc3X_Tof->Fill(i + gRandom->Uniform(-0.5, 0.5), mwpc3x + gRandom->Uniform(-0.5, 0.5));
+                        fs2_Mwpc3X_Tof->Fill(i + gRandom->Uniform(-0.5, 0.5), mwpc3x + gRandom->Uniform(-0.5, 0.5));
                     }
                     if (mwpc3y > 0)
                     {
-                        fh2_Mwpc3Y_PosTof[i]->Fill(tofpos, mwpc3y + gRandom->Uniform(-0.5, 0.5));
+                        fs2_Mwpc3Y_PosTof[i]->Fill(tofpos, mwpc3y + gRandom->Uniform(-0.5, 0.5));
                     }
                 }
             } // end of if mult=1 in the plastic
@@ -605,7 +681,7 @@ void R3BSofTofWOnlineSpectra::FinishEvent()
 
 void R3BSofTofWOnlineSpectra::FinishTask()
 {
-
+    R3BSofHistBackend::Flush();
     if (fMappedItemsTofW)
     {
         cTofWMult->Write();
@@ -23,6 +23,8 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofTofWFiredPaddles;
+class R3BSofShardedHist;
 
 /**
  * This taks reads SCI data and plots online histograms
@@ -106,6 +108,8 @@ class R3BSofTofWOnlineSpectra : public FairTask
     R3BEventHeader* header; /**< Event header.      */
     Int_t fNEvents;         /**< Event counter.     */
 
+    R3BSofTofWFiredPaddles* fFiredPaddles; // paddles with hits from the reader, optional
+
     // Canvas
     TCanvas* cTofWFineTime[NbChs];
     TCanvas* cTofWMult;
@@ -139,6 +143,18 @@ class R3BSofTofWOnlineSpectra : public FairTask
     TH2F* fh2_Mwpc3X_Tof;
     TH2F* fh2_Mwpc3Y_PosTof[NbDets];
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs1_finetime[NbDets * NbChs];    //!
+    R3BSofShardedHist* fs1_EneRaw[NbDets * NbChs];      //!
+    R3BSofShardedHist* fs2_mult[NbChs];                 //!
+    R3BSofShardedHist* fs1_RawPos_AtTcalMult1[NbDets];  //!
+    R3BSofShardedHist* fs1_RawPos_AtSingleTcal[NbDets]; //!
+    R3BSofShardedHist* fs1_RawTof_AtTcalMult1[NbDets];  //!
+    R3BSofShardedHist* fs1_RawTof_AtSingleTcal[NbDets]; //!
+    R3BSofShardedHist* fs2_Twim_Tof[NbDets];            //!
+    R3BSofShardedHist* fs2_Mwpc3Y_PosTof[NbDets];       //!
+    R3BSofShardedHist* fs2_Mwpc3X_Tof;                  //!
+
   public:
     ClassDef(R3BSofTofWOnlineSpectra, 1)
 };
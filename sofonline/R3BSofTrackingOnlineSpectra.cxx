@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofTrackingOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BMusicHitData.h"
 #include "R3BSofMwpcHitData.h"
@@ -59,6 +62,14 @@ R3BSofTrackingOnlineSpectra::R3BSofTrackingOnlineSpectra()
     , fWidthTarget(30.)
     , fZ_max(40.)
     , fZ_min(0.)
+    , fs1_beta(NULL)
+    , fs1_brho(NULL)
+    , fs2_Aqvsq(NULL)
+    , fs2_Mwpc3vsbeta(NULL)
+    , fs2_tracking_planeXZ(NULL)
+    , fs2_tracking_planeYZ(NULL)
+    , fs2_target_PosXY(NULL)
+    , fs2_ZvsBeta(NULL)
 {
 }
 
@@ -78,6 +89,14 @@ R3BSofTrackingOnlineSpectra::R3BSofTrackingOnlineSpectra(const TString& name, In
     , fWidthTarget(30.)
     , fZ_max(40.)
     , fZ_min(0.)
+    , fs1_beta(NULL)
+    , fs1_brho(NULL)
+    , fs2_Aqvsq(NULL)
+    , fs2_Mwpc3vsbeta(NULL)
+    , fs2_tracking_planeXZ(NULL)
+    , fs2_tracking_planeYZ(NULL)
+    , fs2_target_PosXY(NULL)
+    , fs2_ZvsBeta(NULL)
 {
 }
 
@@ -117,6 +136,14 @@ R3BSofTrackingOnlineSpectra::~R3BSofTrackingOnlineSpectra()
     {
         delete fTrackingDataCA;
     }
+    delete fs1_beta;
+    delete fs1_brho;
+    delete fs2_Aqvsq;
+    delete fs2_Mwpc3vsbeta;
+    delete fs2_tracking_planeXZ;
+    delete fs2_tracking_planeYZ;
+    delete fs2_target_PosXY;
+    delete fs2_ZvsBeta;
 }
 
 InitStatus R3BSofTrackingOnlineSpectra::Init()
@@ -134,48 +161,48 @@ InitStatus R3BSofTrackingOnlineSpectra::Init()
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
-    fMwpc0HitDataCA = (TClonesArray*)mgr->GetObject("Mwpc0HitData");
+    fMwpc0HitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc0HitData");
     if (!fMwpc0HitDataCA)
     {
         LOG(ERROR) << "R3BSofTrackingOnlineSpectra: Mwpc0HitData not found";
         return kFATAL;
     }
 
-    fMusicHitDataCA = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fMusicHitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fMusicHitDataCA)
     {
         LOG(ERROR) << "R3BSofTrackingOnlineSpectra: MusicHitData not found";
         return kFATAL;
     }
 
-    fMwpc1HitDataCA = (TClonesArray*)mgr->GetObject("Mwpc1HitData");
+    fMwpc1HitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc1HitData");
     if (!fMwpc1HitDataCA)
     {
         LOG(WARNING) << "R3BSofTrackingOnlineSpectra: Mwpc1HitData not found";
     }
 
-    fMwpc2HitDataCA = (TClonesArray*)mgr->GetObject("Mwpc1HitData");
+    fMwpc2HitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc1HitData");
     if (!fMwpc2HitDataCA)
     {
         LOG(ERROR) << "R3BSofTrackingOnlineSpectra: Mwpc1HitData not found";
         return kFATAL;
     }
 
-    fMwpc3HitDataCA = (TClonesArray*)mgr->GetObject("Mwpc3HitData");
+    fMwpc3HitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc3HitData");
     if (!fMwpc3HitDataCA)
     {
         LOG(ERROR) << "R3BSofTrackingOnlineSpectra: Mwpc3HitData not found";
         return kFATAL;
     }
 
-    fTrackingDataCA = (TClonesArray*)mgr->GetObject("SofTrackingData");
+    fTrackingDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("SofTrackingData");
     if (!fTrackingDataCA)
     {
         LOG(ERROR) << "R3BSofTrackingOnlineSpectra: SofTrackingData not found";
         // return kFATAL;
     }
 
-    fTwimHitDataCA = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fTwimHitDataCA = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fTwimHitDataCA)
     {
         LOG(ERROR) << "R3BSofTrackingOnlineSpectra: TwimHitData not found";
@@ -366,6 +393,15 @@ InitStatus R3BSofTrackingOnlineSpectra::Init()
     cZvsBeta->cd();
     fh2_ZvsBeta->Draw("colz");
 
+    fs1_beta = R3BSofHistBackend::Book(fh1_beta);
+    fs1_brho = R3BSofHistBackend::Book(fh1_brho);
+    fs2_Aqvsq = R3BSofHistBackend::Book(fh2_Aqvsq);
+    fs2_Mwpc3vsbeta = R3BSofHistBackend::Book(fh2_Mwpc3vsbeta);
+    fs2_tracking_planeXZ = R3BSofHistBackend::Book(fh2_tracking_planeXZ);
+    fs2_tracking_planeYZ = R3BSofHistBackend::Book(fh2_tracking_planeYZ);
+    fs2_target_PosXY = R3BSofHistBackend::Book(fh2_target_PosXY);
+    fs2_ZvsBeta = R3BSofHistBackend::Book(fh2_ZvsBeta);
+
     // MAIN FOLDER
     TFolder* mainfol = new TFolder("Tracking_Cave", "Tracking info");
     mainfol->Add(cTrackingXZ);
@@ -388,14 +424,14 @@ void R3BSofTrackingOnlineSpectra::Reset_Histo()
 {
     LOG(INFO) << "R3BSofTrackingOnlineSpectra::Reset_Histo";
 
-    fh1_beta->Reset();
-    fh1_brho->Reset();
-    fh2_Aqvsq->Reset();
-    fh2_Mwpc3vsbeta->Reset();
-    fh2_tracking_planeXZ->Reset();
-    fh2_tracking_planeYZ->Reset();
-    fh2_target_PosXY->Reset();
-    fh2_ZvsBeta->Reset();
+    fs1_beta->Reset();
+    fs1_brho->Reset();
+    fs2_Aqvsq->Reset();
+    fs2_Mwpc3vsbeta->Reset();
+    fs2_tracking_planeXZ->Reset();
+    fs2_tracking_planeYZ->Reset();
+    fs2_target_PosXY->Reset();
+    fs2_ZvsBeta->Reset();
 }
 
 void R3BSofTrackingOnlineSpectra::Exec(Option_t* option)
@@ -435,9 +471,9 @@ void R3BSofTrackingOnlineSpectra::Exec(Option_t* option)
                 {
                     mwpc1y = hit->GetY() - 6.0;
                     zrand = gRandom->Uniform(0., fDist_acelerator_glad);
-                    fh2_tracking_planeYZ->Fill(zrand, mwpc0y + (mwpc1y - mwpc0y) / 2835. * zrand);
+                    fs2_tracking_planeYZ->Fill(zrand, mwpc0y + (mwpc1y - mwpc0y) / 2835. * zrand);
                     ytarget = mwpc0y + (hit->GetY() - mwpc0y) / 2835. * fPosTarget;
-                    fh2_tracking_planeXZ->Fill(zrand, mwpc0x + (hit->GetX() - mwpc0x) / 2835. * zrand);
+                    fs2_tracking_planeXZ->Fill(zrand, mwpc0x + (hit->GetX() - mwpc0x) / 2835. * zrand);
                     xtarget = mwpc0x + (hit->GetX() - mwpc0x) / 2835. * fPosTarget;
                 }
             }
@@ -454,12 +490,12 @@ void R3BSofTrackingOnlineSpectra::Exec(Option_t* option)
                             anglemus = hit->GetTheta();
                         }
                         zrand = gRandom->Uniform(0., fDist_acelerator_glad);
-                        fh2_tracking_planeXZ->Fill(zrand, mwpc0x + anglemus * zrand);
+                        fs2_tracking_planeXZ->Fill(zrand, mwpc0x + anglemus * zrand);
                         xtarget = mwpc0x + anglemus * fPosTarget;
                     }
             */
             if (xtarget > -500. && ytarget > -500.)
-                fh2_target_PosXY->Fill(xtarget, ytarget);
+                fs2_target_PosXY->Fill(xtarget, ytarget);
         }
     }
 
@@ -486,16 +522,16 @@ void R3BSofTrackingOnlineSpectra::Exec(Option_t* option)
             R3BSofTrackingData* hit = (R3BSofTrackingData*)fTrackingDataCA->At(ihit);
             if (!hit)
                 continue;
-            fh1_beta->Fill(hit->GetBeta());
-            fh1_brho->Fill(hit->GetBrho());
-            fh2_Aqvsq->Fill(hit->GetAq(), hit->GetZ());
+            fs1_beta->Fill(hit->GetBeta());
+            fs1_brho->Fill(hit->GetBrho());
+            fs2_Aqvsq->Fill(hit->GetAq(), hit->GetZ());
             if (mwpc3x > -10000.)
             {
-                fh2_Mwpc3vsbeta->Fill(mwpc3x, hit->GetBeta());
+                fs2_Mwpc3vsbeta->Fill(mwpc3x, hit->GetBeta());
                 if (nHitsTwim == 1)
                 {
                     R3BSofTwimHitData* hitTwim = (R3BSofTwimHitData*)fTwimHitDataCA->At(0);
-                    fh2_ZvsBeta->Fill(hit->GetBeta(), hitTwim->GetZcharge());
+                    fs2_ZvsBeta->Fill(hit->GetBeta(), hitTwim->GetZcharge());
                 }
             }
         }
@@ -549,6 +585,7 @@ void R3BSofTrackingOnlineSpectra::FinishEvent()
 
 void R3BSofTrackingOnlineSpectra::FinishTask()
 {
+    R3BSofHistBackend::Flush();
     if (fTrackingDataCA)
     {
         cBeta->Write();
@@ -20,6 +20,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads FRS data and plots online histograms
@@ -128,6 +129,16 @@ class R3BSofTrackingOnlineSpectra : public FairTask
     TH2F* fh2_target_PosXY;
     TH2F* fh2_ZvsBeta;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs1_beta;             //!
+    R3BSofShardedHist* fs1_brho;             //!
+    R3BSofShardedHist* fs2_Aqvsq;            //!
+    R3BSofShardedHist* fs2_Mwpc3vsbeta;      //!
+    R3BSofShardedHist* fs2_tracking_planeXZ; //!
+    R3BSofShardedHist* fs2_tracking_planeYZ; //!
+    R3BSofShardedHist* fs2_target_PosXY;     //!
+    R3BSofShardedHist* fs2_ZvsBeta;          //!
+
   public:
     ClassDef(R3BSofTrackingOnlineSpectra, 1)
 };
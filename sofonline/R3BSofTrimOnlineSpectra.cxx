@@ -3,6 +3,7 @@
  */
 
 #include "R3BSofTrimOnlineSpectra.h"
+#include "R3BSofOnlinePipeline.h"
 #include "R3BEventHeader.h"
 #include "R3BSofTrimCalData.h"
 #include "R3BSofTrimHitData.h"
@@ -84,13 +85,13 @@ InitStatus R3BSofTrimOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofTrimOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
     // === get access to mapped data of the Triple-MUSIC
-    fMappedItemsTrim = (TClonesArray*)mgr->GetObject("TrimMappedData");
+    fMappedItemsTrim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TrimMappedData");
     if (!fMappedItemsTrim)
     {
         LOG(FATAL) << " R3BSofTrimOnlineSpectra::Init(), TrimMappedData not found";
@@ -98,7 +99,7 @@ InitStatus R3BSofTrimOnlineSpectra::Init()
     }
 
     // === get access to cal data of the Triple-MUSIC === //
-    fCalItemsTrim = (TClonesArray*)mgr->GetObject("TrimCalData");
+    fCalItemsTrim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TrimCalData");
     if (!fCalItemsTrim)
     {
         LOG(FATAL) << " R3BSofTrimOnlineSpectra::Init(), TrimCalData not found";
@@ -106,7 +107,7 @@ InitStatus R3BSofTrimOnlineSpectra::Init()
     }
 
     // === get access to hit data of the Triple-MUSIC === //
-    fHitItemsTrim = (TClonesArray*)mgr->GetObject("TrimHitData");
+    fHitItemsTrim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TrimHitData");
     if (!fHitItemsTrim)
     {
         LOG(FATAL) << " R3BSofTrimOnlineSpectra::Init(), TrimHitData not found";
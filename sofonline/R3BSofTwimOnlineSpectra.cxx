@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofTwimOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BSofMwpcHitData.h"
 #include "R3BSofTwimCalData.h"
@@ -48,6 +51,22 @@ R3BSofTwimOnlineSpectra::R3BSofTwimOnlineSpectra()
     , fHitItemsTwim(NULL)
     , fHitItemsMwpc3(NULL)
     , fNEvents(0)
+    , fs1_twimmap_E()
+    , fs1_twimmap_DT()
+    , fs2_twim_EneRawVsDriftTime()
+    , fs1_Twimcal_Pos()
+    , fs2_twim_DTvsDT()
+    , fs1_twimmap_DeltaTrefTrig()
+    , fs1_Twimmap_mult()
+    , fs2_twim_ESum_vs_diffDT()
+    , fs2_twim_EneRawSumVsDriftTime()
+    , fs1_twim_ESum()
+    , fs2_twim_ESum(NULL)
+    , fs1_Twimhit_z(NULL)
+    , fs1_Twimhit_theta(NULL)
+    , fs2_Twimhit_zvstheta(NULL)
+    , fs2_TwimTheta_vs_mwpc3x(NULL)
+    , fs2_TwimZ_vs_mwpc3x(NULL)
 {
 }
 
@@ -58,6 +77,22 @@ R3BSofTwimOnlineSpectra::R3BSofTwimOnlineSpectra(const TString& name, Int_t iVer
     , fHitItemsTwim(NULL)
     , fHitItemsMwpc3(NULL)
     , fNEvents(0)
+    , fs1_twimmap_E()
+    , fs1_twimmap_DT()
+    , fs2_twim_EneRawVsDriftTime()
+    , fs1_Twimcal_Pos()
+    , fs2_twim_DTvsDT()
+    , fs1_twimmap_DeltaTrefTrig()
+    , fs1_Twimmap_mult()
+    , fs2_twim_ESum_vs_diffDT()
+    , fs2_twim_EneRawSumVsDriftTime()
+    , fs1_twim_ESum()
+    , fs2_twim_ESum(NULL)
+    , fs1_Twimhit_z(NULL)
+    , fs1_Twimhit_theta(NULL)
+    , fs2_Twimhit_zvstheta(NULL)
+    , fs2_TwimTheta_vs_mwpc3x(NULL)
+    , fs2_TwimZ_vs_mwpc3x(NULL)
 {
 }
 
@@ -72,6 +107,34 @@ R3BSofTwimOnlineSpectra::~R3BSofTwimOnlineSpectra()
         delete fHitItemsTwim;
     if (fHitItemsMwpc3)
         delete fHitItemsMwpc3;
+    for (Int_t i = 0; i < NbSections; i++)
+        for (Int_t j = 0; j < NbAnodes; j++)
+        {
+            delete fs1_twimmap_E[i][j];
+            delete fs1_twimmap_DT[i][j];
+            delete fs2_twim_EneRawVsDriftTime[i][j];
+            delete fs1_Twimcal_Pos[i][j];
+        }
+    for (Int_t i = 0; i < NbSections; i++)
+        for (Int_t j = 0; j < NbAnodes - 1; j++)
+            delete fs2_twim_DTvsDT[i][j];
+    for (Int_t i = 0; i < NbSections; i++)
+        for (Int_t j = 0; j < NbTref; j++)
+            delete fs1_twimmap_DeltaTrefTrig[i][j];
+    for (Int_t i = 0; i < NbSections; i++)
+    {
+        delete fs1_Twimmap_mult[i];
+        delete fs2_twim_ESum_vs_diffDT[i];
+        delete fs2_twim_EneRawSumVsDriftTime[i];
+    }
+    for (Int_t i = 0; i < 3; i++)
+        delete fs1_twim_ESum[i];
+    delete fs2_twim_ESum;
+    delete fs1_Twimhit_z;
+    delete fs1_Twimhit_theta;
+    delete fs2_Twimhit_zvstheta;
+    delete fs2_TwimTheta_vs_mwpc3x;
+    delete fs2_TwimZ_vs_mwpc3x;
 }
 
 InitStatus R3BSofTwimOnlineSpectra::Init()
@@ -85,30 +148,30 @@ InitStatus R3BSofTwimOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofTwimOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
     // get access to mapped data of the TWIM
-    fMappedItemsTwim = (TClonesArray*)mgr->GetObject("TwimMappedData");
+    fMappedItemsTwim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimMappedData");
     if (!fMappedItemsTwim)
     {
         return kFATAL;
     }
 
     // get access to cal data of the TWIM
-    fCalItemsTwim = (TClonesArray*)mgr->GetObject("TwimCalData");
+    fCalItemsTwim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimCalData");
     if (!fCalItemsTwim)
         LOG(WARNING) << "R3BSofTwimOnlineSpectra: TwimCalData not found";
 
     // get access to hit data of the TWIM
-    fHitItemsTwim = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fHitItemsTwim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fHitItemsTwim)
         LOG(WARNING) << "R3BSofTwimOnlineSpectra: TwimHitData not found";
 
     // get access to hit data of the MWPC3
-    fHitItemsMwpc3 = (TClonesArray*)mgr->GetObject("Mwpc3HitData");
+    fHitItemsMwpc3 = (TClonesArray*)R3BSofOnlinePipeline::GetObject("Mwpc3HitData");
     if (!fHitItemsMwpc3)
         LOG(WARNING) << "R3BSofTwimOnlineSpectra: Mwpc3HitData not found";
 
@@ -488,6 +551,35 @@ InitStatus R3BSofTwimOnlineSpectra::Init()
     fh2_TwimZ_vs_mwpc3x->GetYaxis()->SetTitleSize(0.045);
     fh2_TwimZ_vs_mwpc3x->Draw("colz");
 
+    for (Int_t i = 0; i < NbSections; i++)
+        for (Int_t j = 0; j < NbAnodes; j++)
+        {
+            fs1_twimmap_E[i][j] = R3BSofHistBackend::Book(fh1_twimmap_E[i][j]);
+            fs1_twimmap_DT[i][j] = R3BSofHistBackend::Book(fh1_twimmap_DT[i][j]);
+            fs2_twim_EneRawVsDriftTime[i][j] = R3BSofHistBackend::Book(fh2_twim_EneRawVsDriftTime[i][j]);
+            fs1_Twimcal_Pos[i][j] = R3BSofHistBackend::Book(fh1_Twimcal_Pos[i][j]);
+        }
+    for (Int_t i = 0; i < NbSections; i++)
+        for (Int_t j = 0; j < NbAnodes - 1; j++)
+            fs2_twim_DTvsDT[i][j] = R3BSofHistBackend::Book(fh2_twim_DTvsDT[i][j]);
+    for (Int_t i = 0; i < NbSections; i++)
+        for (Int_t j = 0; j < NbTref; j++)
+            fs1_twimmap_DeltaTrefTrig[i][j] = R3BSofHistBackend::Book(fh1_twimmap_DeltaTrefTrig[i][j]);
+    for (Int_t i = 0; i < NbSections; i++)
+    {
+        fs1_Twimmap_mult[i] = R3BSofHistBackend::Book(fh1_Twimmap_mult[i]);
+        fs2_twim_ESum_vs_diffDT[i] = R3BSofHistBackend::Book(fh2_twim_ESum_vs_diffDT[i]);
+        fs2_twim_EneRawSumVsDriftTime[i] = R3BSofHistBackend::Book(fh2_twim_EneRawSumVsDriftTime[i]);
+    }
+    for (Int_t i = 0; i < 3; i++)
+        fs1_twim_ESum[i] = R3BSofHistBackend::Book(fh1_twim_ESum[i]);
+    fs2_twim_ESum = R3BSofHistBackend::Book(fh2_twim_ESum);
+    fs1_Twimhit_z = R3BSofHistBackend::Book(fh1_Twimhit_z);
+    fs1_Twimhit_theta = R3BSofHistBackend::Book(fh1_Twimhit_theta);
+    fs2_Twimhit_zvstheta = R3BSofHistBackend::Book(fh2_Twimhit_zvstheta);
+    fs2_TwimTheta_vs_mwpc3x = R3BSofHistBackend::Book(fh2_TwimTheta_vs_mwpc3x);
+    fs2_TwimZ_vs_mwpc3x = R3BSofHistBackend::Book(fh2_TwimZ_vs_mwpc3x);
+
     // MAIN FOLDER-Twim
     TFolder* mainfolTwim = new TFolder("TWIM", "TWIM info");
     for (Int_t i = 0; i < NbSections; i++)
@@ -538,47 +630,47 @@ void R3BSofTwimOnlineSpectra::Reset_Histo()
     // Map data
     for (Int_t i = 0; i < NbSections; i++)
     {
-        fh1_Twimmap_mult[i]->Reset();
-        fh2_twim_EneRawSumVsDriftTime[i]->Reset();
-        fh2_twim_ESum_vs_diffDT[i]->Reset();
+        fs1_Twimmap_mult[i]->Reset();
+        fs2_twim_EneRawSumVsDriftTime[i]->Reset();
+        fs2_twim_ESum_vs_diffDT[i]->Reset();
         for (Int_t j = 0; j < NbAnodes; j++)
         {
-            fh1_twimmap_E[i][j]->Reset();
-            fh1_twimmap_DT[i][j]->Reset();
-            fh2_twim_EneRawVsDriftTime[i][j]->Reset();
+            fs1_twimmap_E[i][j]->Reset();
+            fs1_twimmap_DT[i][j]->Reset();
+            fs2_twim_EneRawVsDriftTime[i][j]->Reset();
         }
         for (Int_t j = 0; j < NbAnodes - 1; j++)
         {
-            fh2_twim_DTvsDT[i][j]->Reset();
+            fs2_twim_DTvsDT[i][j]->Reset();
         }
         for (Int_t j = 0; j < NbTref; j++)
         {
-            fh1_twimmap_DeltaTrefTrig[i][j]->Reset();
+            fs1_twimmap_DeltaTrefTrig[i][j]->Reset();
         }
     }
-    fh1_twim_ESum[0]->Reset();
-    fh1_twim_ESum[1]->Reset();
-    fh1_twim_ESum[2]->Reset();
-    fh2_twim_ESum->Reset();
+    fs1_twim_ESum[0]->Reset();
+    fs1_twim_ESum[1]->Reset();
+    fs1_twim_ESum[2]->Reset();
+    fs2_twim_ESum->Reset();
 
     // Cal data
     if (fCalItemsTwim)
     {
         for (Int_t i = 0; i < NbSections; i++)
             for (Int_t j = 0; j < NbAnodes; j++)
-                fh1_Twimcal_Pos[i][j]->Reset();
+                fs1_Twimcal_Pos[i][j]->Reset();
     }
 
     // Hit data
     if (fHitItemsTwim)
     {
-        fh1_Twimhit_z->Reset();
-        fh1_Twimhit_theta->Reset();
-        fh2_Twimhit_zvstheta->Reset();
+        fs1_Twimhit_z->Reset();
+        fs1_Twimhit_theta->Reset();
+        fs2_Twimhit_zvstheta->Reset();
         if (fHitItemsMwpc3)
         {
-            fh2_TwimTheta_vs_mwpc3x->Reset();
-            fh2_TwimZ_vs_mwpc3x->Reset();
+            fs2_TwimTheta_vs_mwpc3x->Reset();
+            fs2_TwimZ_vs_mwpc3x->Reset();
         }
     }
 }
@@ -613,7 +705,7 @@ void R3BSofTwimOnlineSpectra::Exec(Option_t* option)
             R3BSofTwimMappedData* hit = (R3BSofTwimMappedData*)fMappedItemsTwim->At(ihit);
             if (!hit)
                 continue;
-            fh1_Twimmap_mult[hit->GetSecID()]->Fill(hit->GetAnodeID());
+            fs1_Twimmap_mult[hit->GetSecID()]->Fill(hit->GetAnodeID());
             mult[hit->GetSecID()][hit->GetAnodeID()]++;
             if (Traw[hit->GetSecID()][hit->GetAnodeID()] == 0)
             {
@@ -629,7 +721,7 @@ void R3BSofTwimOnlineSpectra::Exec(Option_t* option)
             {
                 if (mult[j][16 + i] == 1 && mult[j][18 + i] == 1)
                 {
-                    fh1_twimmap_DeltaTrefTrig[j][i]->Fill(Traw[j][16 + i] - Traw[j][18 + i]);
+                    fs1_twimmap_DeltaTrefTrig[j][i]->Fill(Traw[j][16 + i] - Traw[j][18 + i]);
                 }
             }
             for (Int_t i = 0; i < NbAnodes; i++)
@@ -638,9 +730,9 @@ void R3BSofTwimOnlineSpectra::Exec(Option_t* option)
                 idTref = NbAnodes + i / 8;
                 if ((mult[j][i] == 1) && (mult[j][idTref] == 1))
                 {
-                    fh1_twimmap_E[j][i]->Fill(Eraw[j][i]);
-                    fh1_twimmap_DT[j][i]->Fill(Traw[j][i] - Traw[j][idTref]);
-                    fh2_twim_EneRawVsDriftTime[j][i]->Fill(Eraw[j][i], Traw[j][i] - Traw[j][idTref]);
+                    fs1_twimmap_E[j][i]->Fill(Eraw[j][i]);
+                    fs1_twimmap_DT[j][i]->Fill(Traw[j][i] - Traw[j][idTref]);
+                    fs2_twim_EneRawVsDriftTime[j][i]->Fill(Eraw[j][i], Traw[j][i] - Traw[j][idTref]);
 
                     if (i < NbAnodes / 2)
                     {
@@ -659,23 +751,23 @@ void R3BSofTwimOnlineSpectra::Exec(Option_t* option)
                 idTref = NbAnodes + i / 8;
                 if ((mult[j][i] == 1) && (mult[j][i + 1] == 1) && (mult[j][idTref] == 1))
                 {
-                    fh2_twim_DTvsDT[j][i]->Fill(Traw[j][i] - Traw[j][idTref], Traw[j][i + 1] - Traw[j][idTref]);
+                    fs2_twim_DTvsDT[j][i]->Fill(Traw[j][i] - Traw[j][idTref], Traw[j][i + 1] - Traw[j][idTref]);
                 }
             }
             if ((mult[j][15] == 1) && (mult[j][0] == 1) && (mult[j][16] == 1) && (mult[j][17] == 1))
             {
-                fh2_twim_ESum_vs_diffDT[j]->Fill((Traw[j][15] - Traw[j][17]) - (Traw[j][0] - Traw[j][16]),
+                fs2_twim_ESum_vs_diffDT[j]->Fill((Traw[j][15] - Traw[j][17]) - (Traw[j][0] - Traw[j][16]),
                                                  (e1 + e2) / (n1 + n2));
             }
             if ((mult[j][5] == 1) && (mult[j][16] == 1))
             {
-                fh2_twim_EneRawSumVsDriftTime[j]->Fill(Traw[j][5] - Traw[j][16], (e1 + e2) / (n1 + n2));
+                fs2_twim_EneRawSumVsDriftTime[j]->Fill(Traw[j][5] - Traw[j][16], (e1 + e2) / (n1 + n2));
             }
         }
-        fh1_twim_ESum[0]->Fill(e1 / n1);
-        fh1_twim_ESum[1]->Fill(e2 / n2);
-        fh1_twim_ESum[2]->Fill((e1 + e2) / (n1 + n2));
-        fh2_twim_ESum->Fill(e1 / n1, e2 / n2);
+        fs1_twim_ESum[0]->Fill(e1 / n1);
+        fs1_twim_ESum[1]->Fill(e2 / n2);
+        fs1_twim_ESum[2]->Fill((e1 + e2) / (n1 + n2));
+        fs2_twim_ESum->Fill(e1 / n1, e2 / n2);
     }
 
     // Fill cal data
@@ -687,7 +779,7 @@ void R3BSofTwimOnlineSpectra::Exec(Option_t* option)
             R3BSofTwimCalData* hit = (R3BSofTwimCalData*)fCalItemsTwim->At(ihit);
             if (!hit)
                 continue;
-            fh1_Twimcal_Pos[hit->GetSecID()][hit->GetAnodeID()]->Fill(hit->GetDTime());
+            fs1_Twimcal_Pos[hit->GetSecID()][hit->GetAnodeID()]->Fill(hit->GetDTime());
         }
     }
 
@@ -714,13 +806,13 @@ void R3BSofTwimOnlineSpectra::Exec(Option_t* option)
             R3BSofTwimHitData* hit = (R3BSofTwimHitData*)fHitItemsTwim->At(ihit);
             if (!hit)
                 continue;
-            fh1_Twimhit_z->Fill(hit->GetZcharge());
-            fh1_Twimhit_theta->Fill(hit->GetTheta() * 1000.);
-            fh2_Twimhit_zvstheta->Fill(hit->GetTheta() * 1000., hit->GetZcharge());
+            fs1_Twimhit_z->Fill(hit->GetZcharge());
+            fs1_Twimhit_theta->Fill(hit->GetTheta() * 1000.);
+            fs2_Twimhit_zvstheta->Fill(hit->GetTheta() * 1000., hit->GetZcharge());
             if (mwpc3x > -500)
             {
-                fh2_TwimTheta_vs_mwpc3x->Fill(hit->GetTheta() * 1000., mwpc3x);
-                fh2_TwimZ_vs_mwpc3x->Fill(mwpc3x, hit->GetZcharge());
+                fs2_TwimTheta_vs_mwpc3x->Fill(hit->GetTheta() * 1000., mwpc3x);
+                fs2_TwimZ_vs_mwpc3x->Fill(mwpc3x, hit->GetZcharge());
             }
         }
     }
@@ -750,6 +842,7 @@ void R3BSofTwimOnlineSpectra::FinishEvent()
 
 void R3BSofTwimOnlineSpectra::FinishTask()
 {
+    R3BSofHistBackend::Flush();
     if (fMappedItemsTwim)
     {
         for (Int_t i = 0; i < NbSections; i++)
@@ -25,6 +25,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads TWIM data and plots online histograms
@@ -130,6 +131,24 @@ class R3BSofTwimOnlineSpectra : public FairTask
     TH2F* fh2_TwimTheta_vs_mwpc3x;
     TH2F* fh2_TwimZ_vs_mwpc3x;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs1_twimmap_E[NbSections][NbAnodes];              //!
+    R3BSofShardedHist* fs1_twimmap_DT[NbSections][NbAnodes];             //!
+    R3BSofShardedHist* fs2_twim_EneRawVsDriftTime[NbSections][NbAnodes]; //!
+    R3BSofShardedHist* fs1_Twimcal_Pos[NbSections][NbAnodes];            //!
+    R3BSofShardedHist* fs2_twim_DTvsDT[NbSections][NbAnodes - 1];        //!
+    R3BSofShardedHist* fs1_twimmap_DeltaTrefTrig[NbSections][NbTref];    //!
+    R3BSofShardedHist* fs1_Twimmap_mult[NbSections];                     //!
+    R3BSofShardedHist* fs2_twim_ESum_vs_diffDT[NbSections];              //!
+    R3BSofShardedHist* fs2_twim_EneRawSumVsDriftTime[NbSections];        //!
+    R3BSofShardedHist* fs1_twim_ESum[3];                                 //!
+    R3BSofShardedHist* fs2_twim_ESum;                                    //!
+    R3BSofShardedHist* fs1_Twimhit_z;                                    //!
+    R3BSofShardedHist* fs1_Twimhit_theta;                                //!
+    R3BSofShardedHist* fs2_Twimhit_zvstheta;                             //!
+    R3BSofShardedHist* fs2_TwimTheta_vs_mwpc3x;                          //!
+    R3BSofShardedHist* fs2_TwimZ_vs_mwpc3x;                              //!
+
   public:
     ClassDef(R3BSofTwimOnlineSpectra, 1)
 };
@@ -9,6 +9,9 @@
  */
 
 #include "R3BSofTwimvsMusicOnlineSpectra.h"
+#include "R3BSofHistBackend.h"
+#include "R3BSofOnlinePipeline.h"
+#include "R3BSofShardedHist.h"
 #include "R3BEventHeader.h"
 #include "R3BMusicHitData.h"
 #include "R3BSofTwimHitData.h"
@@ -42,6 +45,9 @@ R3BSofTwimvsMusicOnlineSpectra::R3BSofTwimvsMusicOnlineSpectra()
     , fHitItemsMusic(NULL)
     , fHitItemsTwim(NULL)
     , fNEvents(0)
+    , fs2_hit_e(NULL)
+    , fs2_hit_z(NULL)
+    , fs2_hit_theta(NULL)
 {
 }
 
@@ -50,6 +56,9 @@ R3BSofTwimvsMusicOnlineSpectra::R3BSofTwimvsMusicOnlineSpectra(const TString& na
     , fHitItemsMusic(NULL)
     , fHitItemsTwim(NULL)
     , fNEvents(0)
+    , fs2_hit_e(NULL)
+    , fs2_hit_z(NULL)
+    , fs2_hit_theta(NULL)
 {
 }
 
@@ -60,6 +69,9 @@ R3BSofTwimvsMusicOnlineSpectra::~R3BSofTwimvsMusicOnlineSpectra()
         delete fHitItemsMusic;
     if (fHitItemsTwim)
         delete fHitItemsTwim;
+    delete fs2_hit_e;
+    delete fs2_hit_z;
+    delete fs2_hit_theta;
 }
 
 InitStatus R3BSofTwimvsMusicOnlineSpectra::Init()
@@ -73,13 +85,13 @@ InitStatus R3BSofTwimvsMusicOnlineSpectra::Init()
     FairRootManager* mgr = FairRootManager::Instance();
     if (NULL == mgr)
         LOG(FATAL) << "R3BSofTwimvsMusicOnlineSpectra::Init FairRootManager not found";
-    // header = (R3BEventHeader*)mgr->GetObject("R3BEventHeader");
+    // header = (R3BEventHeader*)R3BSofOnlinePipeline::GetObject("R3BEventHeader");
 
     FairRunOnline* run = FairRunOnline::Instance();
     run->GetHttpServer()->Register("", this);
 
     // get access to hit data of the MUSIC detector
-    fHitItemsMusic = (TClonesArray*)mgr->GetObject("MusicHitData");
+    fHitItemsMusic = (TClonesArray*)R3BSofOnlinePipeline::GetObject("MusicHitData");
     if (!fHitItemsMusic)
     {
         LOG(WARNING) << "R3BSofTwimvsMusicOnlineSpectra: MusicHitData not found";
@@ -87,7 +99,7 @@ InitStatus R3BSofTwimvsMusicOnlineSpectra::Init()
     }
 
     // get access to hit data of the TWIM
-    fHitItemsTwim = (TClonesArray*)mgr->GetObject("TwimHitData");
+    fHitItemsTwim = (TClonesArray*)R3BSofOnlinePipeline::GetObject("TwimHitData");
     if (!fHitItemsTwim)
         LOG(WARNING) << "R3BSofTwimvsMusicOnlineSpectra: TwimHitData not found";
 
@@ -140,6 +152,10 @@ InitStatus R3BSofTwimvsMusicOnlineSpectra::Init()
     fh2_hit_theta->SetLineColor(1);
     fh2_hit_theta->Draw("col");
 
+    fs2_hit_e = R3BSofHistBackend::Book(fh2_hit_e);
+    fs2_hit_z = R3BSofHistBackend::Book(fh2_hit_z);
+    fs2_hit_theta = R3BSofHistBackend::Book(fh2_hit_theta);
+
     // MAIN FOLDER-Twim-Music
     TFolder* mainfolTwim = new TFolder("TWIM_vs_MUSIC", "TWIM vs MUSIC info");
     if (fHitItemsTwim && fHitItemsMusic)
@@ -162,9 +178,9 @@ void R3BSofTwimvsMusicOnlineSpectra::Reset_Histo()
 
     if (fHitItemsTwim && fHitItemsMusic)
     {
-        fh2_hit_e->Reset();
-        fh2_hit_z->Reset();
-        fh2_hit_theta->Reset();
+        fs2_hit_e->Reset();
+        fs2_hit_z->Reset();
+        fs2_hit_theta->Reset();
     }
 }
 
@@ -201,9 +217,9 @@ void R3BSofTwimvsMusicOnlineSpectra::Exec(Option_t* option)
             theta2 = hit->GetTheta() * 1000.; // mrad
         }
         // Fill histograms
-        fh2_hit_e->Fill(TMath::Sqrt(e1), TMath::Sqrt(e2));
-        fh2_hit_z->Fill(z1, z2);
-        fh2_hit_theta->Fill(theta1, theta2);
+        fs2_hit_e->Fill(TMath::Sqrt(e1), TMath::Sqrt(e2));
+        fs2_hit_z->Fill(z1, z2);
+        fs2_hit_theta->Fill(theta1, theta2);
     }
 
     fNEvents += 1;
@@ -223,6 +239,7 @@ void R3BSofTwimvsMusicOnlineSpectra::FinishEvent()
 
 void R3BSofTwimvsMusicOnlineSpectra::FinishTask()
 {
+    R3BSofHistBackend::Flush();
     if (fHitItemsTwim && fHitItemsMusic)
     {
         fh2_hit_e->Write();
@@ -20,6 +20,7 @@
 
 class TClonesArray;
 class R3BEventHeader;
+class R3BSofShardedHist;
 
 /**
  * This taks reads TWIM data and plots online histograms
@@ -94,6 +95,11 @@ class R3BSofTwimvsMusicOnlineSpectra : public FairTask
     TH2F* fh2_hit_z;
     TH2F* fh2_hit_theta;
 
+    // Filling of the histograms, through R3BSofHistBackend if any
+    R3BSofShardedHist* fs2_hit_e;     //!
+    R3BSofShardedHist* fs2_hit_z;     //!
+    R3BSofShardedHist* fs2_hit_theta; //!
+
   public:
     ClassDef(R3BSofTwimvsMusicOnlineSpectra, 1)
 };
@@ -2,6 +2,7 @@
 
 #include "FairRootManager.h"
 #include "R3BSofMwpcMappedData.h"
+#include "R3BSofMwpcPadImage.h"
 #include "R3BSofMwpcReader.h"
 
 extern "C"
@@ -26,7 +27,16 @@ R3BSofMwpcReader::R3BSofMwpcReader(EXT_STR_h101_SOFMWPC* data, UInt_t offset)
     , fArrayMwpc2(new TClonesArray("R3BSofMwpcMappedData")) // class name
     , fArrayMwpc3(new TClonesArray("R3BSofMwpcMappedData")) // class name
     , fNumEntries(0)
+    , fMappedData(kTRUE)
+    , fPadImages(kFALSE)
 {
+    // Default planes as in the calibration parameters
+    SetPadImagePlanes(0, 64, 0, 64);
+    SetPadImagePlanes(1, 64, 64, 40);
+    SetPadImagePlanes(2, 64, 64, 40);
+    SetPadImagePlanes(3, 288, 0, 120);
+    for (Int_t d = 0; d < NUM_SOFMWPC_DETECTORS; d++)
+        fPadImage[d] = NULL;
 }
 
 R3BSofMwpcReader::~R3BSofMwpcReader()
@@ -48,6 +58,9 @@ R3BSofMwpcReader::~R3BSofMwpcReader()
     {
         delete fArrayMwpc3;
     }
+    for (Int_t d = 0; d < NUM_SOFMWPC_DETECTORS; d++)
+        if (fPadImage[d])
+            delete fPadImage[d];
 }
 
 Bool_t R3BSofMwpcReader::Init(ext_data_struct_info* a_struct_info)
@@ -63,20 +76,35 @@ Bool_t R3BSofMwpcReader::Init(ext_data_struct_info* a_struct_info)
     }
 
     // Register output array in tree
-    if (!fOnline)
+    if (fMappedData && !fOnline)
     {
         FairRootManager::Instance()->Register("Mwpc0MappedData", "MWPC0", fArrayMwpc0, kTRUE);
         FairRootManager::Instance()->Register("Mwpc1MappedData", "MWPC1", fArrayMwpc1, kTRUE);
         FairRootManager::Instance()->Register("Mwpc2MappedData", "MWPC2", fArrayMwpc2, kTRUE);
         FairRootManager::Instance()->Register("Mwpc3MappedData", "MWPC3", fArrayMwpc3, kTRUE);
     }
-    else
+    else if (fMappedData)
     {
         FairRootManager::Instance()->Register("Mwpc0MappedData", "MWPC0", fArrayMwpc0, kFALSE);
         FairRootManager::Instance()->Register("Mwpc1MappedData", "MWPC1", fArrayMwpc1, kFALSE);
         FairRootManager::Instance()->Register("Mwpc2MappedData", "MWPC2", fArrayMwpc2, kFALSE);
         FairRootManager::Instance()->Register("Mwpc3MappedData", "MWPC3", fArrayMwpc3, kFALSE);
     }
+
+    // Pad images are used by the Mapped2Cal tasks instead of the mapped data, never stored
+    if (fPadImages)
+    {
+        char name[100], folder[100];
+        for (Int_t d = 0; d < NUM_SOFMWPC_DETECTORS; d++)
+        {
+            sprintf(name, "Mwpc%dPadImage", d);
+            sprintf(folder, "MWPC%d", d);
+            if (fPadImage[d])
+                delete fPadImage[d];
+            fPadImage[d] = new R3BSofMwpcPadImage(name, fImagePads[d][0], fImagePads[d][1], fImagePads[d][2]);
+            FairRootManager::Instance()->Register(name, folder, fPadImage[d], kFALSE);
+        }
+    }
     fArrayMwpc0->Clear();
     fArrayMwpc1->Clear();
     fArrayMwpc2->Clear();
@@ -97,34 +125,43 @@ Bool_t R3BSofMwpcReader::Read()
     // Convert plain raw data to multi-dimensional array
     EXT_STR_h101_SOFMWPC_onion* data = (EXT_STR_h101_SOFMWPC_onion*)fData;
 
+    TClonesArray* arrays[NUM_SOFMWPC_DETECTORS] = { fArrayMwpc0, fArrayMwpc1, fArrayMwpc2, fArrayMwpc3 };
+
     // loop over all detectors
     for (int d = 0; d < NUM_SOFMWPC_DETECTORS; d++)
     {
         for (int p = 0; p < NUM_SOFMWPC_PLANES_MAX; p++)
         {
             uint32_t numberOfPadsPerPlane = data->SOFMWPC[d].Plane[p].Q;
-            for (int mult = 0; mult < numberOfPadsPerPlane; mult++)
+            const uint32_t* padIndex = data->SOFMWPC[d].Plane[p].QI;
+            const uint32_t* padQ = data->SOFMWPC[d].Plane[p].Qv;
+
+            // Direct copy of the charges into the image of the chamber
+            if (fPadImages)
             {
-                uint16_t pad = data->SOFMWPC[d].Plane[p].QI[mult] - 1;
-                uint16_t qval = data->SOFMWPC[d].Plane[p].Qv[mult];
-                switch (d)
+                R3BSofMwpcPadImage* image = fPadImage[d];
+                Int_t numPads = image->GetNumPads(p + 1);
+                Int_t offset = image->GetIndex(p + 1, 0);
+                for (int mult = 0; mult < numberOfPadsPerPlane; mult++)
                 {
-                    case 0:
-                        new ((*fArrayMwpc0)[fArrayMwpc0->GetEntriesFast()]) R3BSofMwpcMappedData(p + 1, pad, qval);
-                        break;
-                    case 1:
-                        new ((*fArrayMwpc1)[fArrayMwpc1->GetEntriesFast()]) R3BSofMwpcMappedData(p + 1, pad, qval);
-                        break;
-                    case 2:
-                        new ((*fArrayMwpc2)[fArrayMwpc2->GetEntriesFast()]) R3BSofMwpcMappedData(p + 1, pad, qval);
-                        break;
-                    case 3:
-                        new ((*fArrayMwpc3)[fArrayMwpc3->GetEntriesFast()]) R3BSofMwpcMappedData(p + 1, pad, qval);
-                        break;
-                    default:
-                        break;
+                    Int_t pad = (Int_t)padIndex[mult] - 1;
+                    if (pad >= 0 && pad < numPads)
+                        image->SetQ(offset + pad, padQ[mult]);
+                    else
+                        LOG(ERROR) << "R3BSofMwpcReader: plane " << p + 1 << " and pad " << pad
+                                   << " do not exist in MWPC" << d;
                 }
             }
+
+            if (!fMappedData)
+                continue;
+            TClonesArray& array = *arrays[d];
+            for (int mult = 0; mult < numberOfPadsPerPlane; mult++)
+            {
+                uint16_t pad = padIndex[mult] - 1;
+                uint16_t qval = padQ[mult];
+                new (array[array.GetEntriesFast()]) R3BSofMwpcMappedData(p + 1, pad, qval);
+            }
         }
     }
     return kTRUE;
@@ -137,6 +174,10 @@ void R3BSofMwpcReader::Reset()
     fArrayMwpc1->Clear();
     fArrayMwpc2->Clear();
     fArrayMwpc3->Clear();
+    // Only the fired pads of the images are reset
+    for (Int_t d = 0; d < NUM_SOFMWPC_DETECTORS; d++)
+        if (fPadImage[d])
+            fPadImage[d]->Clear();
     fNumEntries = 0;
 }
 
@@ -7,6 +7,7 @@
 struct EXT_STR_h101_SOFMWPC_t;
 typedef struct EXT_STR_h101_SOFMWPC_t EXT_STR_h101_SOFMWPC;
 class FairLogger;
+class R3BSofMwpcPadImage;
 
 class R3BSofMwpcReader : public R3BReader
 {
@@ -21,6 +22,20 @@ class R3BSofMwpcReader : public R3BReader
     /** Accessor to select online mode **/
     void SetOnline(Bool_t option) { fOnline = option; }
 
+    /** Accessor to write the pad charges into one dense image per chamber (MwpcNPadImage) **/
+    void SetPadImages(Bool_t option) { fPadImages = option; }
+
+    /** Accessor to fill the TClonesArrays with the mapped data (default) **/
+    void SetMappedData(Bool_t option) { fMappedData = option; }
+
+    /** Accessor to the number of pads per plane of the images of chamber det (0-3) **/
+    void SetPadImagePlanes(Int_t det, Int_t pads1, Int_t pads2, Int_t pads3)
+    {
+        fImagePads[det][0] = pads1;
+        fImagePads[det][1] = pads2;
+        fImagePads[det][2] = pads3;
+    }
+
   private:
     /* Reader specific data structure from ucesb */
     EXT_STR_h101_SOFMWPC* fData;
@@ -34,6 +49,12 @@ class R3BSofMwpcReader : public R3BReader
     TClonesArray* fArrayMwpc2; /**< Output array. */
     TClonesArray* fArrayMwpc3; /**< Output array. */
     UInt_t fNumEntries;
+    // Fill the output arrays
+    Bool_t fMappedData;
+    // Dense images of the pad charges, plane 1, 2 and 3 of each chamber
+    Bool_t fPadImages;
+    Int_t fImagePads[4][3];
+    R3BSofMwpcPadImage* fPadImage[4];
 
   public:
     ClassDef(R3BSofMwpcReader, 0);
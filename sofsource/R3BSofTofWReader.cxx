@@ -1,6 +1,7 @@
 #include "FairLogger.h"
 
 #include "FairRootManager.h"
+#include "R3BSofTofWFiredPaddles.h"
 #include "R3BSofTofWMappedData.h"
 #include "R3BSofTofWReader.h"
 
@@ -21,6 +22,7 @@ R3BSofTofWReader::R3BSofTofWReader(EXT_STR_h101_SOFTOFW* data, UInt_t offset)
     , fOnline(kFALSE)
     , fArray(new TClonesArray("R3BSofTofWMappedData"))
     , fNumPaddles(28)
+    , fFired(new R3BSofTofWFiredPaddles("SofTofWFiredPaddles"))
 {
 }
 
@@ -31,6 +33,7 @@ R3BSofTofWReader::R3BSofTofWReader(EXT_STR_h101_SOFTOFW* data, UInt_t offset, In
     , fOnline(kFALSE)
     , fArray(new TClonesArray("R3BSofTofWMappedData"))
     , fNumPaddles(num)
+    , fFired(new R3BSofTofWFiredPaddles("SofTofWFiredPaddles"))
 {
 }
 
@@ -41,6 +44,10 @@ R3BSofTofWReader::~R3BSofTofWReader()
     {
         delete fArray;
     }
+    if (fFired)
+    {
+        delete fFired;
+    }
 }
 
 Bool_t R3BSofTofWReader::Init(ext_data_struct_info* a_struct_info)
@@ -66,6 +73,15 @@ Bool_t R3BSofTofWReader::Init(ext_data_struct_info* a_struct_info)
     }
     fArray->Clear();
 
+    // Fired paddles, only used by the next tasks
+    if (fNumPaddles > 64)
+    {
+        LOG(ERROR) << "R3BSofTofWReader::Init() the mask of fired paddles cannot hold " << fNumPaddles << " paddles";
+        return kFALSE;
+    }
+    FairRootManager::Instance()->Register("SofTofWFiredPaddles", "SofTofW", fFired, kFALSE);
+    fFired->Clear();
+
     // clear struct_writer's output struct. Seems ucesb doesn't do that
     // for channels that are unknown to the current ucesb config.
     EXT_STR_h101_SOFTOFW_onion* data = (EXT_STR_h101_SOFTOFW_onion*)fData;
@@ -112,7 +128,10 @@ Bool_t R3BSofTofWReader::Read()
     {
 
         uint32_t NumberOfPMTsWithHits = data->SOFTOFW_P[d].TFM; // could also be data->SOFTOFW_P[d].TCM;
-        uint32_t TotalNumberOfHits = data->SOFTOFW_P[d].TF;     // could also be data->SOFTOFW_P[d].TC
+        if (NumberOfPMTsWithHits == 0)
+            continue;
+        fFired->SetFired(d);
+        uint32_t TotalNumberOfHits = data->SOFTOFW_P[d].TF; // could also be data->SOFTOFW_P[d].TC
         Bool_t FLAG_P;
 
         FLAG_P = kFALSE;
@@ -152,6 +171,7 @@ void R3BSofTofWReader::Reset()
 {
     // Reset the output array
     fArray->Clear();
+    fFired->Clear();
 }
 
 ClassImp(R3BSofTofWReader)
@@ -7,6 +7,7 @@
 struct EXT_STR_h101_SOFTOFW_t;
 typedef struct EXT_STR_h101_SOFTOFW_t EXT_STR_h101_SOFTOFW;
 class FairLogger;
+class R3BSofTofWFiredPaddles;
 
 class R3BSofTofWReader : public R3BReader
 {
@@ -32,6 +33,8 @@ class R3BSofTofWReader : public R3BReader
     /* the structs of type R3BSofTofWMapped Item */
     TClonesArray* fArray; /**< Output array. */
     Int_t fNumPaddles;
+    /* Paddles with hits in the event */
+    R3BSofTofWFiredPaddles* fFired;
 
   public:
     ClassDef(R3BSofTofWReader, 0);
@@ -1,4 +1,5 @@
 #include "R3BSofTofWMapped2Tcal.h"
+#include "R3BSofTofWFiredPaddles.h"
 #include "R3BSofTofWMappedData.h"
 
 #include "FairLogger.h"
@@ -10,6 +11,7 @@
 R3BSofTofWMapped2Tcal::R3BSofTofWMapped2Tcal()
     : FairTask("R3BSofTofWMapped2Tcal", 1)
     , fMapped(NULL)
+    , fFiredPaddles(NULL)
     , fTcalPar(NULL)
     , fTcal(new TClonesArray("R3BSofTofWTcalData"))
     , fNumTcal(0)
@@ -52,6 +54,9 @@ InitStatus R3BSofTofWMapped2Tcal::Init()
     else
         LOG(INFO) << " R3BSofTofWMapped2Tcal::Init() SofTofWMappedData items found";
 
+    // events without any fired paddle are skipped, when the reader publishes them
+    fFiredPaddles = (R3BSofTofWFiredPaddles*)rm->GetObject("SofTofWFiredPaddles");
+
     // --- -------------------------- --- //
     // --- CHECK THE TCALPAR VALIDITY --- //
     // --- -------------------------- --- //
@@ -113,6 +118,9 @@ void R3BSofTofWMapped2Tcal::Exec(Option_t* option)
     UInt_t iTc;
     Double_t tns;
 
+    if (fFiredPaddles && fFiredPaddles->GetMask() == 0)
+        return;
+
     Int_t nHitsPerEvent_SofTofW = fMapped->GetEntries();
     for (int ihit = 0; ihit < nHitsPerEvent_SofTofW; ihit++)
     {
@@ -136,7 +144,7 @@ void R3BSofTofWMapped2Tcal::Exec(Option_t* option)
             continue;
         }
         tns = CalculateTimeNs(iDet, iCh, iTf, iTc);
-        new ((*fTcal)[fNumTcal++]) R3BSofTofWTcalData(iDet, iCh, tns);
+        new ((*fTcal)[fNumTcal++]) R3BSofTofWTcalData(iDet, iCh, tns, hit->GetEnergy());
     }
 
     ++fNevent;
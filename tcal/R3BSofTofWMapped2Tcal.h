@@ -16,6 +16,7 @@
 #include "TMath.h"
 #include "TRandom.h"
 class TRandom3;
+class R3BSofTofWFiredPaddles;
 
 class R3BSofTofWMapped2Tcal : public FairTask
 {
@@ -42,9 +43,10 @@ class R3BSofTofWMapped2Tcal : public FairTask
     void SetOnline(Bool_t option) { fOnline = option; }
 
   private:
-    TClonesArray* fMapped;   // input data - SofTofWMappedData
-    R3BSofTcalPar* fTcalPar; // tcal parameters container
-    TClonesArray* fTcal;     // output data
+    TClonesArray* fMapped;                 // input data - SofTofWMappedData
+    R3BSofTofWFiredPaddles* fFiredPaddles; // paddles with hits from the reader, optional
+    R3BSofTcalPar* fTcalPar;               // tcal parameters container
+    TClonesArray* fTcal;                   // output data
 
     Bool_t fOnline; // Don't store data for online
 
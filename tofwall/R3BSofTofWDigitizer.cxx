@@ -10,23 +10,31 @@
 #include "FairRuntimeDb.h"
 #include "TClonesArray.h"
 
-// includes for modeling
-#include "TGeoManager.h"
-#include "TParticle.h"
-#include "TVirtualMC.h"
-
 #include "TMath.h"
-#include "TVector3.h"
 #include <iostream>
 #include <string>
 
-#include "R3BMCTrack.h"
 #include "R3BSofTofWPoint.h"
+#include "R3BTGeoPar.h"
+
+namespace
+{
+    // Counter-based generator: splitmix64 of the key and the counter
+    inline ULong64_t Hash(ULong64_t key, ULong64_t counter)
+    {
+        ULong64_t z = key + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in ]0,1] from the 53 upper bits
+    inline Double_t Uniform(ULong64_t r) { return ((r >> 11) + 1) * (1. / 9007199254740992.); }
+} // namespace
 
 // R3BSofTofWDigitizer: Default Constructor --------------------------
 R3BSofTofWDigitizer::R3BSofTofWDigitizer()
     : FairTask("R3BSof Tof Digitization scheme", 1)
-    , fMCTrack(NULL)
     , fTofPoints(NULL)
     , fTofHits(NULL)
     , fsigma_y(0.1)   // sigma=1mm
@@ -35,14 +43,18 @@ R3BSofTofWDigitizer::R3BSofTofWDigitizer()
     , fPosZ(0.)
     , fangle(0.)
     , fsigma_ELoss(0.)
+    , fTofWGeoPar(NULL)
+    , fUseGeoPar(kFALSE)
+    , fCosAngle(1.)
+    , fSinAngle(0.)
+    , fSeed(0)
+    , fNumEvent(0)
 {
-    rand = new TRandom1();
 }
 
 // R3BSofTofWDigitizer: Standard Constructor --------------------------
 R3BSofTofWDigitizer::R3BSofTofWDigitizer(const char* name, Int_t iVerbose)
     : FairTask(name, iVerbose)
-    , fMCTrack(NULL)
     , fTofPoints(NULL)
     , fTofHits(NULL)
     , fsigma_y(0.1)
@@ -51,8 +63,13 @@ R3BSofTofWDigitizer::R3BSofTofWDigitizer(const char* name, Int_t iVerbose)
     , fPosZ(0.)
     , fangle(0.)
     , fsigma_ELoss(0.)
+    , fTofWGeoPar(NULL)
+    , fUseGeoPar(kFALSE)
+    , fCosAngle(1.)
+    , fSinAngle(0.)
+    , fSeed(0)
+    , fNumEvent(0)
 {
-    rand = new TRandom1();
 }
 
 // Virtual R3BSofTofWDigitizer: Destructor ----------------------------
@@ -65,6 +82,31 @@ R3BSofTofWDigitizer::~R3BSofTofWDigitizer()
         delete fTofHits;
 }
 
+// ----   Public method SetParContainers   ----------------------------
+void R3BSofTofWDigitizer::SetParContainers()
+{
+    if (!fUseGeoPar)
+        return;
+    FairRuntimeDb* rtdb = FairRuntimeDb::instance();
+    fTofWGeoPar = (R3BTGeoPar*)rtdb->getContainer("tofwGeoPar");
+    if (!fTofWGeoPar)
+        LOG(ERROR) << "R3BSofTofWDigitizer::SetParContainers() : Could not get access to tofwGeoPar container.";
+}
+
+// ----   Private method SetGeometry   --------------------------------
+void R3BSofTofWDigitizer::SetGeometry()
+{
+    if (fUseGeoPar && fTofWGeoPar)
+    {
+        fPosX = fTofWGeoPar->GetPosX();
+        fPosZ = fTofWGeoPar->GetPosZ();
+        fangle = fTofWGeoPar->GetRotY();
+    }
+    fCosAngle = TMath::Cos(fangle * TMath::DegToRad());
+    fSinAngle = TMath::Sin(fangle * TMath::DegToRad());
+    LOG(INFO) << "R3BSofTofWDigitizer: wall at x = " << fPosX << ", z = " << fPosZ << ", angle " << fangle;
+}
+
 // ----   Public method Init  -----------------------------------------
 InitStatus R3BSofTofWDigitizer::Init()
 {
@@ -76,13 +118,13 @@ InitStatus R3BSofTofWDigitizer::Init()
     if (!ioman)
         LOG(fatal) << "Init: No FairRootManager";
 
-    fMCTrack = (TClonesArray*)ioman->GetObject("MCTrack");
     fTofPoints = (TClonesArray*)ioman->GetObject("SofTofWPoint");
 
     // Register output array fTofHits
     fTofHits = new TClonesArray("R3BSofTofWHitData", 10);
     ioman->Register("TofWHit", "Digital response in TofW", fTofHits, kTRUE);
 
+    SetGeometry();
     return kSUCCESS;
 }
 
@@ -90,54 +132,56 @@ InitStatus R3BSofTofWDigitizer::Init()
 void R3BSofTofWDigitizer::Exec(Option_t* opt)
 {
     Reset();
+    const ULong64_t event = fNumEvent++;
     // Reading the Input -- Point Data --
-    Int_t nHits = fTofPoints->GetEntries();
+    Int_t nHits = fTofPoints->GetEntriesFast();
     if (!nHits)
         return;
-    // Data from Point level
-    R3BSofTofWPoint** pointData;
-    pointData = new R3BSofTofWPoint*[nHits];
-    Int_t paddle = 0;
-    Int_t TrackId = 0, PID = 0, mother = -1;
-    Double_t x = 0., y = 0., z = 0., time = 0.;
+
+    // Gathering of the points
+    fPaddle.resize(nHits);
+    fX.resize(nHits);
+    fY.resize(nHits);
+    fZ.resize(nHits);
+    fTime.resize(nHits);
+    fKeep.resize(nHits);
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofTofWPoint* point = (R3BSofTofWPoint*)(fTofPoints->At(i));
+        fPaddle[i] = point->GetDetCopyID();
+        fX[i] = 0.5 * (point->GetXIn() + point->GetXOut());
+        fY[i] = 0.5 * (point->GetYIn() + point->GetYOut());
+        fZ[i] = 0.5 * (point->GetZIn() + point->GetZOut());
+        fTime[i] = point->GetTime();
+        fKeep[i] = point->GetZFF() > 10;
+    }
+
+    // Smearing of y and time, rotation of x into the frame of the wall
+    const ULong64_t key = Hash(fSeed, event);
     for (Int_t i = 0; i < nHits; i++)
     {
-        pointData[i] = (R3BSofTofWPoint*)(fTofPoints->At(i));
-        TrackId = pointData[i]->GetTrackID();
-
-        // R3BMCTrack* Track = (R3BMCTrack*)fMCTrack->At(TrackId);
-        // PID = Track->GetPdgCode();
-        // mother = Track->GetMotherId();
-
-        // if (PID > 1000080160 && mother < 0) // Z=8 and A=16
-        //{
-        Double_t fX_in = pointData[i]->GetXIn();
-        Double_t fY_in = pointData[i]->GetYIn();
-        Double_t fZ_in = pointData[i]->GetZIn();
-        Double_t fX_out = pointData[i]->GetXOut();
-        Double_t fY_out = pointData[i]->GetYOut();
-        Double_t fZ_out = pointData[i]->GetZOut();
-        paddle = pointData[i]->GetDetCopyID();
-
-        x = ((fX_in + fX_out) / 2.);
-        y = ((fY_in + fY_out) / 2.) + rand->Gaus(0., fsigma_y);
-        z = ((fZ_in + fZ_out) / 2.);
-
-        x = (((x - fPosX) * cos(fangle * TMath::DegToRad())) - ((z - fPosZ) * sin(fangle * TMath::DegToRad())));
-
-        time = pointData[i]->GetTime() + rand->Gaus(0., fsigma_t);
-
-        if (pointData[i]->GetZFF() > 10)
-            AddHitData(paddle, x, y, time);
-        //}
+        Double_t u1 = Uniform(Hash(key, 2 * i));
+        Double_t u2 = Uniform(Hash(key, 2 * i + 1));
+        Double_t r = TMath::Sqrt(-2. * TMath::Log(u1));
+        Double_t phi = TMath::TwoPi() * u2;
+        fY[i] += fsigma_y * r * TMath::Cos(phi);
+        fTime[i] += fsigma_t * r * TMath::Sin(phi);
+        fX[i] = (fX[i] - fPosX) * fCosAngle - (fZ[i] - fPosZ) * fSinAngle;
     }
-    if (pointData)
-        delete pointData;
+
+    for (Int_t i = 0; i < nHits; i++)
+        if (fKeep[i])
+            AddHitData(fPaddle[i], fX[i], fY[i], fTime[i]);
     return;
 }
 
 // -----   Public method ReInit   ----------------------------------------------
-InitStatus R3BSofTofWDigitizer::ReInit() { return kSUCCESS; }
+InitStatus R3BSofTofWDigitizer::ReInit()
+{
+    SetParContainers();
+    SetGeometry();
+    return kSUCCESS;
+}
 
 // -----   Public method Reset   -----------------------------------------------
 void R3BSofTofWDigitizer::Reset()
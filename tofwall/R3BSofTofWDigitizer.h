@@ -8,12 +8,24 @@
 
 #include "FairTask.h"
 #include "R3BSofTofWHitData.h"
-#include "TRandom1.h"
 #include <map>
 #include <string>
+#include <vector>
 
 class TClonesArray;
-
+class R3BTGeoPar;
+
+/**
+ * Digitizer of the ToF wall, the points of an event are processed in one
+ * batch: the coordinates are first gathered in contiguous arrays, then
+ * smeared and rotated into the frame of the wall in one loop, with the
+ * sin/cos of the angle computed at Init. The gaussian smearing uses a
+ * counter-based generator keyed by (seed, event, point), two normal numbers
+ * per point from one Box-Muller transform, so that the result of each point
+ * does not depend on the order of processing.
+ * The position and angle of the wall are those of the setters, or of the
+ * tofwGeoPar container with UseGeoPar(kTRUE).
+ **/
 class R3BSofTofWDigitizer : public FairTask
 {
 
@@ -46,25 +58,46 @@ class R3BSofTofWDigitizer : public FairTask
     void SetPosZ(Float_t z) { fPosZ = z; }
     void SetAngle(Float_t a) { fangle = a; }
     void SetSigma_ELoss(Float_t sigma_ELoss) { fsigma_ELoss = sigma_ELoss; }
+    void SetSeed(ULong64_t seed) { fSeed = seed; }
+    void UseGeoPar(Bool_t use) { fUseGeoPar = use; }
+
+    // Fair specific
+    virtual void SetParContainers();
 
   private:
-    TClonesArray* fMCTrack;
     TClonesArray* fTofPoints;
     TClonesArray* fTofHits;
-    TRandom1* rand;
     Float_t fsigma_y;
     Float_t fsigma_t;
     Float_t fsigma_ELoss;
     Float_t fangle;
     Float_t fPosX, fPosZ;
 
+    R3BTGeoPar* fTofWGeoPar;
+    Bool_t fUseGeoPar;
+    Double_t fCosAngle;
+    Double_t fSinAngle;
+    ULong64_t fSeed;
+    ULong64_t fNumEvent;
+
+    // Batch of the points of the event
+    std::vector<Int_t> fPaddle;  //!
+    std::vector<Double_t> fX;    //!
+    std::vector<Double_t> fY;    //!
+    std::vector<Double_t> fZ;    //!
+    std::vector<Double_t> fTime; //!
+    std::vector<Bool_t> fKeep;   //!
+
+    /** Private method to cache the geometry **/
+    void SetGeometry();
+
     /** Private method AddHitData **/
     // Adds a R3BSofTofWHitData to the TofWHitCollection
     R3BSofTofWHitData* AddHitData(Int_t paddle, Double_t x, Double_t y, Double_t time);
 
   public:
     // Class definition
-    ClassDef(R3BSofTofWDigitizer, 1);
+    ClassDef(R3BSofTofWDigitizer, 2);
 };
 
 #endif
@@ -0,0 +1,42 @@
+#include "R3BSofTofWHitCorrection.h"
+#include "R3BSofTofWHitPar.h"
+
+#include "FairLogger.h"
+
+R3BSofTofWHitCorrection::R3BSofTofWHitCorrection()
+    : TObject()
+    , fNumPaddles(0)
+{
+}
+
+R3BSofTofWHitCorrection::~R3BSofTofWHitCorrection() {}
+
+void R3BSofTofWHitCorrection::Init(R3BSofTofWHitPar* par)
+{
+    fNumPaddles = par->GetNumSci();
+    fInUse.assign(fNumPaddles, kFALSE);
+    fTof.assign(fNumPaddles, 0.);
+    fPos.assign(fNumPaddles, 0.);
+    fWalkUp.assign(fNumPaddles, 0.);
+    fWalkDown.assign(fNumPaddles, 0.);
+    fLight1.assign(fNumPaddles, 0.);
+    fLight2.assign(fNumPaddles, 0.);
+
+    Int_t nwalk = 0;
+    for (Int_t p = 0; p < fNumPaddles; p++)
+    {
+        fInUse[p] = par->GetInUse(p + 1) == 1;
+        fTof[p] = par->GetTofPar(p + 1);
+        fPos[p] = par->GetPosPar(p + 1);
+        fWalkUp[p] = par->GetWalkPar(p + 1, 1);
+        fWalkDown[p] = par->GetWalkPar(p + 1, 2);
+        fLight1[p] = par->GetLightPar(p + 1, 1);
+        fLight2[p] = par->GetLightPar(p + 1, 2);
+        if (fWalkUp[p] != 0. || fWalkDown[p] != 0. || fLight1[p] != 0. || fLight2[p] != 0.)
+            nwalk++;
+    }
+    LOG(INFO) << "R3BSofTofWHitCorrection::Init() " << fNumPaddles << " paddles, " << nwalk
+              << " with walk or light propagation corrections";
+}
+
+ClassImp(R3BSofTofWHitCorrection)
@@ -0,0 +1,75 @@
+// *** *************************************************************** *** //
+// ***                  R3BSofTofWHitCorrection                          *** //
+// ***   per paddle tables of the time corrections of the ToF wall       *** //
+// *** *************************************************************** *** //
+
+#ifndef R3BSOFTOFW_HITCORRECTION
+#define R3BSOFTOFW_HITCORRECTION
+
+#include "TMath.h"
+#include "TObject.h"
+
+#include <vector>
+
+class R3BSofTofWHitPar;
+
+/**
+ * Copy of the tofwHitPar parameters in contiguous per paddle tables, built
+ * once at Init/ReInit, and the correction kernel of the raw ToF and position:
+ *   walk of each pmt:  w = W / sqrt(E)  (0 if the energy is unknown)
+ *   ToF:               tof = RawTof - TofPar - (wUp + wDown) / 2 - L1 * p - L2 * p^2
+ *   position:          pos = p - (wDown - wUp)
+ * with p = RawPos - PosPar, the position used by the calibration of L1 and L2.
+ * The kernel has no branch, the paddles not in use are flagged by the table.
+ **/
+class R3BSofTofWHitCorrection : public TObject
+{
+
+  public:
+    // --- Default constructor --- //
+    R3BSofTofWHitCorrection();
+
+    // --- Destructor --- //
+    virtual ~R3BSofTofWHitCorrection();
+
+    /** Method to fill the tables from the parameter container **/
+    void Init(R3BSofTofWHitPar* par);
+
+    Int_t GetNumPaddles() const { return fNumPaddles; }
+
+    /** In use flag of the paddle, 0-based **/
+    Bool_t IsInUse(Int_t paddle) const { return fInUse[paddle]; }
+
+    /** Corrected ToF and position [ns] of the paddle, 0-based **/
+    inline void Correct(Int_t paddle,
+                        Double_t rawTof,
+                        Double_t rawPos,
+                        UInt_t eUp,
+                        UInt_t eDown,
+                        Double_t& tof,
+                        Double_t& pos) const
+    {
+        Double_t xUp = (eUp > 0) / TMath::Sqrt(TMath::Max(1., (Double_t)eUp));
+        Double_t xDown = (eDown > 0) / TMath::Sqrt(TMath::Max(1., (Double_t)eDown));
+        Double_t wUp = fWalkUp[paddle] * xUp;
+        Double_t wDown = fWalkDown[paddle] * xDown;
+        Double_t p = rawPos - fPos[paddle];
+        tof = rawTof - fTof[paddle] - 0.5 * (wUp + wDown) - (fLight1[paddle] + fLight2[paddle] * p) * p;
+        pos = p - (wDown - wUp);
+    }
+
+  private:
+    Int_t fNumPaddles;
+    std::vector<Bool_t> fInUse;      //!
+    std::vector<Double_t> fTof;      //!
+    std::vector<Double_t> fPos;      //!
+    std::vector<Double_t> fWalkUp;   //!
+    std::vector<Double_t> fWalkDown; //!
+    std::vector<Double_t> fLight1;   //!
+    std::vector<Double_t> fLight2;   //!
+
+  public:
+    ClassDef(R3BSofTofWHitCorrection, 1)
+};
+
+#endif // R3BSOFTOFW_HITCORRECTION
@@ -22,6 +22,8 @@ R3BSofTofWHitPar::R3BSofTofWHitPar(const char* name, const char* title, const ch
     fSci_tof = new TArrayF(fNumSci);
     fSci_pos = new TArrayF(fNumSci);
     fIn_use = new TArrayI(fNumSci);
+    fSci_walk = new TArrayF(2 * fNumSci);
+    fSci_light = new TArrayF(2 * fNumSci);
 }
 
 // ----  Destructor ------------------------------------------------------------
@@ -34,6 +36,10 @@ R3BSofTofWHitPar::~R3BSofTofWHitPar()
         delete fSci_pos;
     if (fSci_tof)
         delete fSci_tof;
+    if (fSci_walk)
+        delete fSci_walk;
+    if (fSci_light)
+        delete fSci_light;
 }
 
 // ----  Method clear ----------------------------------------------------------
@@ -61,6 +67,10 @@ void R3BSofTofWHitPar::putParams(FairParamList* list)
     list->add("tofwPosPar", *fSci_pos);
     fSci_tof->Set(array_sci);
     list->add("tofwTofPar", *fSci_tof);
+    fSci_walk->Set(2 * array_sci);
+    list->add("tofwWalkPar", *fSci_walk);
+    fSci_light->Set(2 * array_sci);
+    list->add("tofwLightPar", *fSci_light);
 }
 
 // ----  Method getParams ------------------------------------------------------
@@ -100,6 +110,21 @@ Bool_t R3BSofTofWHitPar::getParams(FairParamList* list)
         return kFALSE;
     }
 
+    // Optional, the files without them give no walk and light propagation corrections
+    fSci_walk->Set(2 * array_sci);
+    if (!(list->fill("tofwWalkPar", fSci_walk)))
+    {
+        LOG(INFO) << "---Could not initialize tofwWalkPar, set to 0";
+        fSci_walk->Reset();
+    }
+
+    fSci_light->Set(2 * array_sci);
+    if (!(list->fill("tofwLightPar", fSci_light)))
+    {
+        LOG(INFO) << "---Could not initialize tofwLightPar, set to 0";
+        fSci_light->Reset();
+    }
+
     return kTRUE;
 }
 
@@ -114,5 +139,7 @@ void R3BSofTofWHitPar::printParams()
 
         LOG(INFO) << "Sci " << s + 1 << " in use " << fIn_use->GetAt(s) << ", Position: " << fSci_pos->GetAt(s)
                   << ", Tof: " << fSci_tof->GetAt(s);
+        LOG(INFO) << "    Walk up: " << fSci_walk->GetAt(2 * s) << ", Walk down: " << fSci_walk->GetAt(2 * s + 1)
+                  << ", Light: " << fSci_light->GetAt(2 * s) << " " << fSci_light->GetAt(2 * s + 1);
     }
 }
@@ -45,11 +45,17 @@ class R3BSofTofWHitPar : public FairParGenericSet
     const Int_t GetInUse(Int_t sci) { return fIn_use->GetAt(sci - 1); }
     const Float_t GetPosPar(Int_t sci) { return fSci_pos->GetAt(sci - 1); }
     const Float_t GetTofPar(Int_t sci) { return fSci_tof->GetAt(sci - 1); }
+    // Walk coefficient of the pmt (1: up, 2: down) [ns x sqrt(channel)], Tcorr = T - walk / sqrt(E)
+    const Float_t GetWalkPar(Int_t sci, Int_t pmt) { return fSci_walk->GetAt(2 * (sci - 1) + pmt - 1); }
+    // Light propagation, coefficients of the order 1 or 2 of the Tof residual versus the position [ns/ns^order]
+    const Float_t GetLightPar(Int_t sci, Int_t order) { return fSci_light->GetAt(2 * (sci - 1) + order - 1); }
 
     void SetNumSci(Int_t nb) { fNumSci = nb; }
     void SetInUse(Int_t value, Int_t sci) { fIn_use->AddAt(value, sci - 1); }
     void SetTofPar(Float_t value, Int_t sci) { fSci_tof->AddAt(value, sci - 1); }
     void SetPosPar(Float_t value, Int_t sci) { fSci_pos->AddAt(value, sci - 1); }
+    void SetWalkPar(Float_t value, Int_t sci, Int_t pmt) { fSci_walk->AddAt(value, 2 * (sci - 1) + pmt - 1); }
+    void SetLightPar(Float_t value, Int_t sci, Int_t order) { fSci_light->AddAt(value, 2 * (sci - 1) + order - 1); }
 
     // Create more Methods if you need them!
 
@@ -57,13 +63,15 @@ class R3BSofTofWHitPar : public FairParGenericSet
     TArrayF* fSci_tof; // Calibration Parameters for tof
     TArrayF* fSci_pos; // Calibration Parameters for pos
     TArrayI* fIn_use;  // 1: in use, 0:otherwise
+    TArrayF* fSci_walk;  // Walk coefficients, up and down pmts
+    TArrayF* fSci_light; // Light propagation coefficients, orders 1 and 2
     Int_t fNumSci;
 
     const R3BSofTofWHitPar& operator=(const R3BSofTofWHitPar&); /*< an assignment operator>*/
 
     R3BSofTofWHitPar(const R3BSofTofWHitPar&); /*< a copy constructor >*/
 
-    ClassDef(R3BSofTofWHitPar, 1);
+    ClassDef(R3BSofTofWHitPar, 2);
 };
 
 #endif
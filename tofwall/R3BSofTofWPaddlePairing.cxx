@@ -0,0 +1,188 @@
+#include "R3BSofTofWPaddlePairing.h"
+
+#include "FairLogger.h"
+#include "TMath.h"
+
+#include <algorithm>
+
+R3BSofTofWPaddlePairing::R3BSofTofWPaddlePairing()
+    : TObject()
+    , fNumPaddles(0)
+    , fPosHalfWidth(1.e6)
+    , fTofMin(-100.)
+    , fTofMax(100.)
+    , fMaxCandidates(0)
+    , fFired(0)
+    , fFiredSet(kFALSE)
+{
+}
+
+R3BSofTofWPaddlePairing::R3BSofTofWPaddlePairing(Int_t numPaddles)
+    : TObject()
+    , fNumPaddles(0)
+    , fPosHalfWidth(1.e6)
+    , fTofMin(-100.)
+    , fTofMax(100.)
+    , fMaxCandidates(0)
+    , fFired(0)
+    , fFiredSet(kFALSE)
+{
+    SetNumPaddles(numPaddles);
+}
+
+R3BSofTofWPaddlePairing::~R3BSofTofWPaddlePairing() {}
+
+void R3BSofTofWPaddlePairing::SetNumPaddles(Int_t n)
+{
+    if (n > 64)
+    {
+        LOG(ERROR) << "R3BSofTofWPaddlePairing::SetNumPaddles() at most 64 paddles, " << n << " requested";
+        n = 64;
+    }
+    fNumPaddles = n;
+    fPosCentre.assign(n, 0.);
+    fTimes.assign(2 * n, std::vector<std::pair<Double_t, UInt_t>>());
+    fFired = 0;
+    fFiredSet = kFALSE;
+}
+
+void R3BSofTofWPaddlePairing::Clear(Option_t*)
+{
+    // only the paddles with hits are reset
+    for (ULong64_t m = fFired; m; m &= m - 1)
+    {
+        Int_t p = __builtin_ctzll(m);
+        fTimes[2 * p].clear();
+        fTimes[2 * p + 1].clear();
+    }
+    fFired = 0;
+    fFiredSet = kFALSE;
+    fStart.clear();
+    fCandPaddle.clear();
+    fCandTime.clear();
+    fCandTof.clear();
+    fCandPos.clear();
+    fCandRank.clear();
+    fCandEUp.clear();
+    fCandEDown.clear();
+}
+
+void R3BSofTofWPaddlePairing::SetFiredMask(ULong64_t mask)
+{
+    // bits past the last paddle are dropped
+    if (fNumPaddles < 64)
+        mask &= (1ULL << fNumPaddles) - 1;
+    fFired = mask;
+    fFiredSet = kTRUE;
+}
+
+void R3BSofTofWPaddlePairing::AddTime(Int_t paddle, Int_t pmt, Double_t time, UInt_t energy)
+{
+    if (paddle < 0 || paddle >= fNumPaddles || pmt < 0 || pmt > 1)
+    {
+        LOG(ERROR) << "R3BSofTofWPaddlePairing::AddTime() paddle " << paddle + 1 << " and pmt " << pmt + 1
+                   << " do not exist";
+        return;
+    }
+    if (fFiredSet)
+    {
+        if (!((fFired >> paddle) & 1))
+            return;
+    }
+    else
+        fFired |= 1ULL << paddle;
+    fTimes[2 * paddle + pmt].push_back(std::make_pair(time, energy));
+}
+
+Int_t R3BSofTofWPaddlePairing::Process()
+{
+    if (fStart.empty())
+        return 0;
+
+    const Double_t tofCentre = 0.5 * (fTofMin + fTofMax);
+
+    // the bits are visited in increasing paddle order
+    for (ULong64_t m = fFired; m; m &= m - 1)
+    {
+        Int_t p = __builtin_ctzll(m);
+        std::vector<std::pair<Double_t, UInt_t>>& up = fTimes[2 * p];
+        std::vector<std::pair<Double_t, UInt_t>>& down = fTimes[2 * p + 1];
+        if (up.empty() || down.empty())
+            continue;
+        std::sort(up.begin(), up.end());
+        std::sort(down.begin(), down.end());
+
+        fUsed.assign(down.size(), kFALSE);
+        fOrder.clear();
+        fAmbig.clear();
+        fDist.clear();
+        fTime.clear();
+        fTof.clear();
+        fPos.clear();
+        fEUp.clear();
+        fEDown.clear();
+
+        // --- pairing in time order, the window of the up hits moves forward --- //
+        const Double_t posMin = fPosCentre[p] - fPosHalfWidth;
+        const Double_t posMax = fPosCentre[p] + fPosHalfWidth;
+        size_t lo = 0;
+        for (size_t u = 0; u < up.size(); u++)
+        {
+            while (lo < down.size() && down[lo].first - up[u].first < posMin)
+                lo++;
+            Int_t selected = -1;
+            Int_t inWindow = 0;
+            for (size_t d = lo; d < down.size() && down[d].first - up[u].first <= posMax; d++)
+            {
+                inWindow++;
+                if (selected < 0 && !fUsed[d])
+                    selected = d;
+            }
+            if (selected < 0)
+                continue;
+            fUsed[selected] = kTRUE;
+
+            // RawPos = Tdown - Tup
+            Double_t pos = down[selected].first - up[u].first;
+            Double_t time = 0.5 * (up[u].first + down[selected].first);
+            for (size_t s = 0; s < fStart.size(); s++)
+            {
+                Double_t tof = time - fStart[s];
+                if (tof < fTofMin || tof > fTofMax)
+                    continue;
+                fOrder.push_back(fOrder.size());
+                fAmbig.push_back(inWindow - 1);
+                fDist.push_back(TMath::Abs(tof - tofCentre));
+                fTime.push_back(time);
+                fTof.push_back(tof);
+                fPos.push_back(pos);
+                fEUp.push_back(up[u].second);
+                fEDown.push_back(down[selected].second);
+            }
+        }
+
+        // --- ranking of the candidates of the paddle --- //
+        std::sort(fOrder.begin(),
+                  fOrder.end(),
+                  [this](Int_t a, Int_t b) {
+                      return fAmbig[a] != fAmbig[b] ? fAmbig[a] < fAmbig[b] : fDist[a] < fDist[b];
+                  });
+        Int_t nCand = fOrder.size();
+        if (fMaxCandidates > 0 && nCand > fMaxCandidates)
+            nCand = fMaxCandidates;
+        for (Int_t r = 0; r < nCand; r++)
+        {
+            Int_t c = fOrder[r];
+            fCandPaddle.push_back(p);
+            fCandTime.push_back(fTime[c]);
+            fCandTof.push_back(fTof[c]);
+            fCandPos.push_back(fPos[c]);
+            fCandRank.push_back(r);
+            fCandEUp.push_back(fEUp[c]);
+            fCandEDown.push_back(fEDown[c]);
+        }
+    }
+    return fCandPaddle.size();
+}
+
+ClassImp(R3BSofTofWPaddlePairing)
@@ -0,0 +1,125 @@
+// *** *************************************************************** *** //
+// ***                  R3BSofTofWPaddlePairing                          *** //
+// ***      pairing of the up and down PMT hits of the TofW paddles      *** //
+// *** *************************************************************** *** //
+
+#ifndef R3BSOFTOFW_PADDLEPAIRING
+#define R3BSOFTOFW_PADDLEPAIRING
+
+#include "TObject.h"
+
+#include <utility>
+#include <vector>
+
+/**
+ * Builds the paddle hits of the ToF wall from any multiplicity of the PMTs.
+ * The hits of the up and down PMTs of each paddle are sorted in time and
+ * paired one to one in time order, a pair being accepted only if
+ * Tdown - Tup lies within the raw position window of the paddle (bounded by
+ * the paddle length over the light velocity). Each pair is then combined with
+ * every start time of the SofSci at Cave C whose raw ToF lies within the ToF
+ * window. The candidates of a paddle are ranked (0 = best): first by the
+ * number of alternative down hits found in the window of the up hit, then by
+ * the distance of the ToF to the center of the ToF window.
+ * The pmt energies of each pair are kept for the walk correction.
+ * Only the fired paddles are visited, through a bitmask (at most 64 paddles).
+ * The containers keep their capacity from one event to the next.
+ **/
+class R3BSofTofWPaddlePairing : public TObject
+{
+
+  public:
+    // --- Default constructor --- //
+    R3BSofTofWPaddlePairing();
+
+    // --- Standard constructor --- //
+    R3BSofTofWPaddlePairing(Int_t numPaddles);
+
+    // --- Destructor --- //
+    virtual ~R3BSofTofWPaddlePairing();
+
+    /** Method to set the number of paddles (at most 64), 2 PMTs each (up = 0, down = 1) **/
+    void SetNumPaddles(Int_t n);
+
+    /** Method to reset the hits of the event **/
+    void Clear(Option_t* option = "");
+
+    /** Methods to add the hits of the event, paddle and pmt are 0-based **/
+    void AddTime(Int_t paddle, Int_t pmt, Double_t time, UInt_t energy = 0);
+    void AddStart(Double_t time) { fStart.push_back(time); }
+
+    /** Paddles with hits in the event, bit d for the paddle d **/
+    ULong64_t GetFiredMask() const { return fFired; }
+
+    /** Paddles with hits published by the reader (SofTofWFiredPaddles), after Clear
+     *  and before AddTime, the hits of the other paddles are then ignored **/
+    void SetFiredMask(ULong64_t mask);
+
+    /** Method to build the candidates, returns their number **/
+    Int_t Process();
+
+    /** Accessors to the candidates, ordered by paddle and rank **/
+    Int_t GetNumCandidates() const { return fCandPaddle.size(); }
+    Int_t GetPaddle(Int_t i) const { return fCandPaddle[i]; } // 0-based
+    Double_t GetTime(Int_t i) const { return fCandTime[i]; }
+    Double_t GetTof(Int_t i) const { return fCandTof[i]; }
+    Double_t GetPos(Int_t i) const { return fCandPos[i]; }
+    Int_t GetRank(Int_t i) const { return fCandRank[i]; }
+    UInt_t GetEnergyUp(Int_t i) const { return fCandEUp[i]; }
+    UInt_t GetEnergyDown(Int_t i) const { return fCandEDown[i]; }
+
+    /** Raw position window Tdown - Tup of a paddle, centre +- half width [ns] **/
+    void SetRawPosWindow(Double_t halfWidth) { fPosHalfWidth = halfWidth; }
+    void SetRawPosCentre(Int_t paddle, Double_t centre) { fPosCentre[paddle] = centre; }
+    /** Window from the paddle length [mm] and the effective light velocity [mm/ns] **/
+    void SetPaddleLength(Double_t length, Double_t velocity, Double_t margin = 1.)
+    {
+        fPosHalfWidth = length / velocity + margin;
+    }
+    /** Raw ToF window [ns], by default the range of the raw ToF spectra, -100 to 100 ns **/
+    void SetTofWindow(Double_t min, Double_t max)
+    {
+        fTofMin = min;
+        fTofMax = max;
+    }
+    /** Maximum number of candidates per paddle, 0 for all **/
+    void SetMaxCandidates(Int_t n) { fMaxCandidates = n; }
+
+  private:
+    Int_t fNumPaddles;
+    Double_t fPosHalfWidth;
+    Double_t fTofMin;
+    Double_t fTofMax;
+    Int_t fMaxCandidates;
+    ULong64_t fFired; // paddles with hits, bit d for the paddle d
+    Bool_t fFiredSet; // fFired set by SetFiredMask for the event
+
+    std::vector<Double_t> fPosCentre;          //!
+    std::vector<std::vector<std::pair<Double_t, UInt_t>>> fTimes; //! (time, energy) per paddle and PMT
+    std::vector<Double_t> fStart;                                  //! SofSci start times
+    std::vector<Bool_t> fUsed;                                     //! down hits already paired
+
+    // Candidates of the paddle in progress
+    std::vector<Int_t> fOrder;   //!
+    std::vector<Int_t> fAmbig;   //!
+    std::vector<Double_t> fDist; //!
+    std::vector<Double_t> fTime; //!
+    std::vector<Double_t> fTof;  //!
+    std::vector<Double_t> fPos;  //!
+    std::vector<UInt_t> fEUp;    //!
+    std::vector<UInt_t> fEDown;  //!
+
+    // Output candidates
+    std::vector<Int_t> fCandPaddle;  //!
+    std::vector<Double_t> fCandTime; //!
+    std::vector<Double_t> fCandTof;  //!
+    std::vector<Double_t> fCandPos;  //!
+    std::vector<Int_t> fCandRank;    //!
+    std::vector<UInt_t> fCandEUp;    //!
+    std::vector<UInt_t> fCandEDown;  //!
+
+  public:
+    ClassDef(R3BSofTofWPaddlePairing, 1)
+};
+
+#endif // R3BSOFTOFW_PADDLEPAIRING
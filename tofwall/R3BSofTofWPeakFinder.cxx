@@ -0,0 +1,163 @@
+#include "R3BSofTofWPeakFinder.h"
+
+#include "FairLogger.h"
+#include "TH1F.h"
+#include "TMath.h"
+
+#include <thread>
+
+R3BSofTofWPeakFinder::R3BSofTofWPeakFinder()
+    : TObject()
+    , fNumPaddles(0)
+    , fNbins(0)
+    , fMin(0.)
+    , fBinWidth(1.)
+    , fInvBinWidth(1.)
+    , fCoarse(1)
+    , fNbinsCoarse(0)
+    , fNumThreads(0)
+    , fSmooth(2)
+    , fHalfWidth(1.)
+    , fFraction(0.2)
+    , fNumIterations(2)
+{
+}
+
+R3BSofTofWPeakFinder::R3BSofTofWPeakFinder(Int_t numPaddles,
+                                           Double_t min,
+                                           Double_t max,
+                                           Double_t binWidth,
+                                           Int_t coarse)
+    : TObject()
+    , fNumPaddles(numPaddles)
+    , fNbins(TMath::Max(1, TMath::Nint((max - min) / binWidth)))
+    , fMin(min)
+    , fBinWidth(binWidth)
+    , fInvBinWidth(1. / binWidth)
+    , fCoarse(TMath::Max(1, coarse))
+    , fNbinsCoarse((fNbins + fCoarse - 1) / fCoarse)
+    , fNumThreads(0)
+    , fSmooth(2)
+    , fHalfWidth(1.)
+    , fFraction(0.2)
+    , fNumIterations(2)
+{
+    fCounts.assign((size_t)numPaddles * fNbins, 0);
+    fCoarseCounts.assign((size_t)numPaddles * fNbinsCoarse, 0);
+    fEntries.assign(numPaddles, 0);
+    fFound.assign(numPaddles, kFALSE);
+    fPeak.assign(numPaddles, 0.);
+}
+
+R3BSofTofWPeakFinder::~R3BSofTofWPeakFinder() {}
+
+Int_t R3BSofTofWPeakFinder::Find(Int_t minStatistics)
+{
+    for (Int_t p = 0; p < fNumPaddles; p++)
+    {
+        fFound[p] = fEntries[p] > minStatistics;
+        fPeak[p] = 0.;
+    }
+
+    Int_t nThreads = fNumThreads > 0 ? fNumThreads : (Int_t)std::thread::hardware_concurrency();
+    nThreads = TMath::Max(1, TMath::Min(nThreads, fNumPaddles));
+    if (nThreads == 1)
+        FindPeaks(0, 1);
+    else
+    {
+        std::vector<std::thread> workers;
+        for (Int_t t = 0; t < nThreads; t++)
+            workers.push_back(std::thread(&R3BSofTofWPeakFinder::FindPeaks, this, t, nThreads));
+        for (Int_t t = 0; t < nThreads; t++)
+            workers[t].join();
+    }
+
+    Int_t nfound = 0;
+    for (Int_t p = 0; p < fNumPaddles; p++)
+        if (fFound[p])
+            nfound++;
+    return nfound;
+}
+
+void R3BSofTofWPeakFinder::FindPeaks(Int_t first, Int_t stride)
+{
+    for (Int_t p = first; p < fNumPaddles; p += stride)
+    {
+        if (!fFound[p])
+            continue;
+        const UInt_t* c = &fCounts[(size_t)p * fNbins];
+        const UInt_t* cc = &fCoarseCounts[(size_t)p * fNbinsCoarse];
+
+        // Coarse mode, sliding sum over 2*fSmooth+1 coarse bins
+        const Int_t w = TMath::Min(2 * fSmooth + 1, fNbinsCoarse);
+        Long64_t sum = 0;
+        for (Int_t b = 0; b < w; b++)
+            sum += cc[b];
+        Long64_t best = sum;
+        Int_t wfirst = 0;
+        for (Int_t b = w; b < fNbinsCoarse; b++)
+        {
+            sum += (Long64_t)cc[b] - cc[b - w];
+            if (sum > best)
+            {
+                best = sum;
+                wfirst = b - w + 1;
+            }
+        }
+
+        // Mode in the fine bins of the window only, sliding sum over fCoarse bins
+        const Int_t fmin = wfirst * fCoarse;
+        const Int_t fmax = TMath::Min(fNbins, (wfirst + w) * fCoarse);
+        const Int_t wf = TMath::Min(fCoarse, fmax - fmin);
+        sum = 0;
+        UInt_t cmax = 0;
+        for (Int_t b = fmin; b < fmax; b++)
+            cmax = TMath::Max(cmax, c[b]);
+        for (Int_t b = fmin; b < fmin + wf; b++)
+            sum += c[b];
+        best = sum;
+        Int_t mode = fmin + wf / 2;
+        for (Int_t b = fmin + wf; b < fmax; b++)
+        {
+            sum += (Long64_t)c[b] - c[b - wf];
+            if (sum > best)
+            {
+                best = sum;
+                mode = b - wf / 2;
+            }
+        }
+
+        // Local weighted means, the bins below the threshold are ignored
+        const Double_t threshold = fFraction * cmax;
+        const Int_t hw = TMath::Max(1, TMath::Nint(fHalfWidth * fInvBinWidth));
+        Double_t centre = mode + 0.5;
+        for (Int_t it = 0; it < fNumIterations; it++)
+        {
+            Int_t bmin = TMath::Max(0, (Int_t)centre - hw);
+            Int_t bmax = TMath::Min(fNbins - 1, (Int_t)centre + hw);
+            Double_t s0 = 0., s1 = 0.;
+            for (Int_t b = bmin; b <= bmax; b++)
+            {
+                Double_t y = c[b] >= threshold ? c[b] : 0.;
+                s0 += y;
+                s1 += y * (b + 0.5);
+            }
+            if (!(s0 > 0.))
+                break;
+            centre = s1 / s0;
+        }
+        fPeak[p] = fMin + centre * fBinWidth;
+    }
+}
+
+TH1F* R3BSofTofWPeakFinder::MakeHisto(Int_t paddle, const char* name) const
+{
+    TH1F* h = new TH1F(name, name, fNbins, fMin, fMin + fNbins * fBinWidth);
+    const UInt_t* c = &fCounts[(size_t)paddle * fNbins];
+    for (Int_t b = 0; b < fNbins; b++)
+        h->SetBinContent(b + 1, c[b]);
+    h->SetEntries(fEntries[paddle]);
+    return h;
+}
+
+ClassImp(R3BSofTofWPeakFinder)
@@ -0,0 +1,100 @@
+// *** *************************************************************** *** //
+// ***                    R3BSofTofWPeakFinder                           *** //
+// ***      per paddle accumulator and robust peak estimator             *** //
+// *** *************************************************************** *** //
+
+#ifndef R3BSOFTOFW_PEAKFINDER
+#define R3BSOFTOFW_PEAKFINDER
+
+#include "TObject.h"
+
+#include <vector>
+
+class TH1F;
+
+/**
+ * Accumulates the spectra of all the paddles in one contiguous array of
+ * counts, together with coarse spectra of fCoarse bins per coarse bin, and
+ * estimates the position of the main peak of each spectrum:
+ *  - the coarse mode is the maximum of the coarse counts summed over a
+ *    sliding window of 2*fSmooth+1 coarse bins,
+ *  - the mode is then searched in the fine bins of this window only, as the
+ *    maximum of the counts summed over fCoarse bins,
+ *  - the peak is the weighted mean of the bins within +-fHalfWidth around
+ *    the mode, the bins below fFraction of the maximum of the window being
+ *    ignored, repeated fNumIterations times around the last mean.
+ * The paddles are shared out among several threads in Find().
+ **/
+class R3BSofTofWPeakFinder : public TObject
+{
+
+  public:
+    // --- Default constructor --- //
+    R3BSofTofWPeakFinder();
+
+    // --- Standard constructor --- //
+    R3BSofTofWPeakFinder(Int_t numPaddles, Double_t min, Double_t max, Double_t binWidth, Int_t coarse = 10);
+
+    // --- Destructor --- //
+    virtual ~R3BSofTofWPeakFinder();
+
+    /** Method to add a value to the spectrum of the paddle, 0-based **/
+    inline void Fill(Int_t paddle, Double_t x)
+    {
+        Double_t b = (x - fMin) * fInvBinWidth;
+        if (b >= 0. && b < fNbins)
+        {
+            Int_t ib = (Int_t)b;
+            fCounts[paddle * fNbins + ib]++;
+            fCoarseCounts[paddle * fNbinsCoarse + ib / fCoarse]++;
+            fEntries[paddle]++;
+        }
+    }
+
+    /** Method to estimate the peaks, returns the number of paddles with enough statistics **/
+    Int_t Find(Int_t minStatistics);
+
+    /** Results of the last Find(), paddle is 0-based **/
+    Long64_t GetEntries(Int_t paddle) const { return fEntries[paddle]; }
+    Bool_t IsFound(Int_t paddle) const { return fFound[paddle]; }
+    Double_t GetPeak(Int_t paddle) const { return fPeak[paddle]; }
+
+    /** Spectrum of the paddle as a histogram, owned by the caller **/
+    TH1F* MakeHisto(Int_t paddle, const char* name) const;
+
+    /** Modifiers **/
+    void SetNumThreads(Int_t n) { fNumThreads = n; }
+    void SetSmooth(Int_t nbins) { fSmooth = nbins; }
+    void SetHalfWidth(Double_t hw) { fHalfWidth = hw; }
+    void SetFraction(Double_t f) { fFraction = f; }
+    void SetNumIterations(Int_t n) { fNumIterations = n; }
+
+  private:
+    Int_t fNumPaddles;
+    Int_t fNbins;
+    Double_t fMin;
+    Double_t fBinWidth;
+    Double_t fInvBinWidth;
+    Int_t fCoarse; // Bins per coarse bin
+    Int_t fNbinsCoarse;
+
+    Int_t fNumThreads;    // 0 for the number of cores
+    Int_t fSmooth;        // Half width of the window of the mode [coarse bins]
+    Double_t fHalfWidth;  // Half width of the local mean around the mode
+    Double_t fFraction;   // Bins below this fraction of the maximum are ignored
+    Int_t fNumIterations; // Local means around the previous one
+
+    std::vector<UInt_t> fCounts;       //! [fNumPaddles * fNbins]
+    std::vector<UInt_t> fCoarseCounts; //! [fNumPaddles * fNbinsCoarse]
+    std::vector<Long64_t> fEntries;    //!
+    std::vector<Bool_t> fFound;        //!
+    std::vector<Double_t> fPeak;       //!
+
+    /** Estimate of the paddles first, first+stride, ... **/
+    void FindPeaks(Int_t first, Int_t stride);
+
+  public:
+    ClassDef(R3BSofTofWPeakFinder, 1)
+};
+
+#endif // R3BSOFTOFW_PEAKFINDER
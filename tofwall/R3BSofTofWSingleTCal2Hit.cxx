@@ -3,6 +3,8 @@
 // -----    Created 15/02/20  by J.L. Rodriguez-Sanchez        -----
 // -----------------------------------------------------------------
 #include "R3BSofTofWSingleTCal2Hit.h"
+#include "R3BSofTofWHitCorrection.h"
+#include "R3BSofTofWTcal2SingleTcal.h"
 #include "R3BTGeoPar.h"
 
 // R3BSofTofWSingleTCal2Hit: Default Constructor --------------------------
@@ -13,6 +15,10 @@ R3BSofTofWSingleTCal2Hit::R3BSofTofWSingleTCal2Hit()
     , fExpId(467)
     , fOnline(kFALSE)
     , fTof_lise(43.)
+    , fMaxFragments(1)
+    , fProfileName("")
+    , fProfile()
+    , fCorrection(NULL)
 {
 }
 
@@ -24,6 +30,10 @@ R3BSofTofWSingleTCal2Hit::R3BSofTofWSingleTCal2Hit(const char* name, Int_t iVerb
     , fExpId(467)
     , fOnline(kFALSE)
     , fTof_lise(43.)
+    , fMaxFragments(1)
+    , fProfileName("")
+    , fProfile()
+    , fCorrection(NULL)
 {
 }
 
@@ -35,6 +45,8 @@ R3BSofTofWSingleTCal2Hit::~R3BSofTofWSingleTCal2Hit()
         delete fTCalDataCA;
     if (fHitDataCA)
         delete fHitDataCA;
+    if (fCorrection)
+        delete fCorrection;
 }
 
 void R3BSofTofWSingleTCal2Hit::SetParContainers()
@@ -92,97 +104,156 @@ InitStatus R3BSofTofWSingleTCal2Hit::Init()
         rootManager->Register("TofWHitData", "TofW-Hit", fHitDataCA, kFALSE);
     }
     // fTofWHitPar->printParams();
+
+    // Experiment profile, chosen once
+    if (fProfileName.IsNull())
+        fProfileName = TString::Format("s%d", fExpId);
+    std::map<TString, Profile>::const_iterator it = Profiles().find(fProfileName);
+    if (it == Profiles().end())
+    {
+        LOG(ERROR) << "R3BSofTofWSingleTCal2Hit::Init() : no reconstruction profile " << fProfileName;
+        return kFATAL;
+    }
+    fProfile = it->second;
+    LOG(INFO) << "R3BSofTofWSingleTCal2Hit::Init() : reconstruction profile " << fProfileName;
+    if (fMaxFragments < 1)
+    {
+        LOG(ERROR) << "R3BSofTofWSingleTCal2Hit::Init() : at most " << fMaxFragments << " fragments per event";
+        return kFATAL;
+    }
+
+    // Several candidates per paddle would count as several paddles and reject every event
+    if (SingleHitProfiles().count(fProfileName) > 0)
+    {
+        R3BSofTofWTcal2SingleTcal* pairing =
+            dynamic_cast<R3BSofTofWTcal2SingleTcal*>(FairRun::Instance()->GetTask("R3BSofTofWTcal2SingleTcal"));
+        if (pairing && pairing->GetMaxCandidates() != 1)
+        {
+            LOG(ERROR) << "R3BSofTofWSingleTCal2Hit::Init() : the profile " << fProfileName
+                       << " keeps only the events with one paddle hit, R3BSofTofWTcal2SingleTcal must keep one "
+                          "candidate per paddle instead of "
+                       << pairing->GetMaxCandidates();
+            return kFATAL;
+        }
+    }
+
+    // Per paddle tables of the corrections
+    fCorrection = new R3BSofTofWHitCorrection();
+    fCorrection->Init(fTofWHitPar);
     return kSUCCESS;
 }
 
 // -----   Public method ReInit   ----------------------------------------------
-InitStatus R3BSofTofWSingleTCal2Hit::ReInit() { return kSUCCESS; }
+InitStatus R3BSofTofWSingleTCal2Hit::ReInit()
+{
+    fCorrection->Init(fTofWHitPar);
+    return kSUCCESS;
+}
+
+// -----   Registry of the experiment profiles   --------------------------------
+std::map<TString, R3BSofTofWSingleTCal2Hit::Profile>& R3BSofTofWSingleTCal2Hit::Profiles()
+{
+    static std::map<TString, Profile> profiles = { { "s444", &R3BSofTofWSingleTCal2Hit::S467 },
+                                                   { "s455", &R3BSofTofWSingleTCal2Hit::S455 },
+                                                   { "s467", &R3BSofTofWSingleTCal2Hit::S467 } };
+    return profiles;
+}
+
+std::set<TString>& R3BSofTofWSingleTCal2Hit::SingleHitProfiles()
+{
+    static std::set<TString> profiles = { "s444", "s467" };
+    return profiles;
+}
+
+void R3BSofTofWSingleTCal2Hit::RegisterProfile(const TString& name, Profile profile, Bool_t singleHit)
+{
+    Profiles()[name] = profile;
+    if (singleHit)
+        SingleHitProfiles().insert(name);
+    else
+        SingleHitProfiles().erase(name);
+}
 
 // -----   Public method Execution   --------------------------------------------
 void R3BSofTofWSingleTCal2Hit::Exec(Option_t* option)
 {
-    // At the moment we will use the expid to select the reconstruction
-    // this should be changed in the future because expid is not necessary
-    if (fExpId == 467 || fExpId == 444)
-        S467();
-    else if (fExpId == 455)
-        S455();
-
-    return;
+    // Reset entries in output arrays, local arrays
+    Reset();
+
+    if (fTCalDataCA->GetEntriesFast() < 1)
+        return;
+
+    // Reconstruction of the experiment, selected at Init
+    fProfile(this);
 }
 
 // -----   Public method Experiment S455   --------------------------------------
 void R3BSofTofWSingleTCal2Hit::S455()
 {
-    // Reset entries in output arrays, local arrays
-    Reset();
-
     // Reading the Input -- SingleTCal Data
-    Int_t nHits = fTCalDataCA->GetEntries();
-    if (nHits < 1)
-        return;
+    Int_t nHits = fTCalDataCA->GetEntriesFast();
 
-    // Data from cal level
-    calDat = new R3BSofTofWSingleTcalData*[nHits];
     Int_t fPaddleId = 0; // from 1 to 28
     Double_t tofw = 0., posx = 0., posy = 0.;
 
     for (Int_t i = 0; i < nHits; i++)
     {
-        calDat[i] = (R3BSofTofWSingleTcalData*)(fTCalDataCA->At(i));
-        fPaddleId = calDat[i]->GetDetector();
-        tofw = calDat[i]->GetRawTofNs();
-        posy = calDat[i]->GetRawPosNs();
+        R3BSofTofWSingleTcalData* hit = (R3BSofTofWSingleTcalData*)(fTCalDataCA->At(i));
+        fPaddleId = hit->GetDetector();
 
         posx = fTofWGeoPar->GetDimX() / 2.0 - 15. - (Double_t)(fPaddleId - 1) * 30.;
-        posy = posy - fTofWHitPar->GetPosPar(fPaddleId);
-        tofw = tofw - fTofWHitPar->GetTofPar(fPaddleId) + fTof_lise;
+        fCorrection->Correct(fPaddleId - 1,
+                             hit->GetRawTofNs(),
+                             hit->GetRawPosNs(),
+                             hit->GetEnergyUp(),
+                             hit->GetEnergyDown(),
+                             tofw,
+                             posy);
+        tofw = tofw + fTof_lise;
 
         AddHitData(fPaddleId, posx, posy, tofw);
     }
-    if (calDat)
-        delete calDat;
 }
 
 // -----   Public method Experiment S467   --------------------------------------
 void R3BSofTofWSingleTCal2Hit::S467()
 {
-    // Reset entries in output arrays, local arrays
-    Reset();
-
     // Reading the Input -- Cal Data --
-    Int_t nHits = fTCalDataCA->GetEntries();
-    if (nHits < 1)
-        return;
+    Int_t nHits = fTCalDataCA->GetEntriesFast();
 
-    // Data from cal level
-    calDat = new R3BSofTofWSingleTcalData*[nHits];
     Int_t fPaddleId = 0; // from 1 to 28
     Double_t tofw = 0., posx = 0., posy = 0.;
     Int_t mult = 0;
 
     for (Int_t i = 0; i < nHits; i++)
     {
-        calDat[i] = (R3BSofTofWSingleTcalData*)(fTCalDataCA->At(i));
-        fPaddleId = calDat[i]->GetDetector();
-        if (fTofWHitPar->GetInUse(fPaddleId) != 1)
-            continue;
-        mult++;
-        tofw = calDat[i]->GetRawTofNs();
-        posy = calDat[i]->GetRawPosNs();
+        R3BSofTofWSingleTcalData* calDat = (R3BSofTofWSingleTcalData*)(fTCalDataCA->At(i));
+        if (fCorrection->IsInUse(calDat->GetDetector() - 1))
+            mult++;
     }
+    // One fragment per paddle, events with more paddles hit are rejected
+    if (mult < 1 || mult > fMaxFragments)
+        return;
 
-    if (mult == 1)
+    for (Int_t i = 0; i < nHits; i++)
     {
+        R3BSofTofWSingleTcalData* hit = (R3BSofTofWSingleTcalData*)(fTCalDataCA->At(i));
+        if (!fCorrection->IsInUse(hit->GetDetector() - 1))
+            continue;
+        fPaddleId = hit->GetDetector();
         posx = fTofWGeoPar->GetDimX() / 2.0 - 15. - (Double_t)(fPaddleId - 1) * 30.; // x=0 at the gap of bars 14 and 15
-        posy = posy - fTofWHitPar->GetPosPar(fPaddleId);
-        tofw = tofw - fTofWHitPar->GetTofPar(fPaddleId) + fTof_lise;
+        fCorrection->Correct(fPaddleId - 1,
+                             hit->GetRawTofNs(),
+                             hit->GetRawPosNs(),
+                             hit->GetEnergyUp(),
+                             hit->GetEnergyDown(),
+                             tofw,
+                             posy);
+        tofw = tofw + fTof_lise;
         // TofPar is adjusted to align the time 0 with motor sweep runs,
         // And the Tof_lise is to adjust the difference of the flight path from sofsci to target setting-by-setting.
         AddHitData(fPaddleId, posx, posy, tofw);
     }
-    if (calDat)
-        delete calDat;
 }
 
 // -----   Public method Finish  ------------------------------------------------
@@ -198,7 +269,7 @@ void R3BSofTofWSingleTCal2Hit::Reset()
         fHitDataCA->Clear();
 }
 
-// -----   Private method AddHitData  -------------------------------------------
+// -----   Public method AddHitData  --------------------------------------------
 R3BSofTofWHitData* R3BSofTofWSingleTCal2Hit::AddHitData(Int_t paddle, Double_t x, Double_t y, Double_t tof)
 {
     // It fills the R3BSofTofWHitData
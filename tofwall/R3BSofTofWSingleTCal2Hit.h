@@ -19,7 +19,10 @@
 #include "FairRuntimeDb.h"
 #include "FairTask.h"
 
+#include <functional>
 #include <iomanip>
+#include <map>
+#include <set>
 
 // TofW headers
 #include "R3BSofTofWHitData.h"
@@ -29,11 +32,32 @@
 
 class TClonesArray;
 class R3BTGeoPar;
-
+class R3BSofTofWHitCorrection;
+
+/**
+ * The reconstruction of the experiment is selected once at Init, from a
+ * registry of profiles keyed by name ("s444", "s455", "s467", ...). By
+ * default the name is "s" followed by the experiment number. A new setup is
+ * added with RegisterProfile() before the run is initialised, from any
+ * function of the task, e.g. in a macro:
+ *   void S999(R3BSofTofWSingleTCal2Hit* task)
+ *   {
+ *       TClonesArray* input = task->GetSingleTcalData();
+ *       ... task->GetCorrection()->Correct(...); task->AddHitData(...);
+ *   }
+ *   R3BSofTofWSingleTCal2Hit::RegisterProfile("s999", S999);
+ **/
 class R3BSofTofWSingleTCal2Hit : public FairTask
 {
 
   public:
+    /** Reconstruction of one event, the output array is already reset: a member function or any callable **/
+    typedef std::function<void(R3BSofTofWSingleTCal2Hit*)> Profile;
+
+    /** Method to add or replace a profile of the registry,
+     *  singleHit for a profile keeping only the events with one paddle hit (as s444/s467) **/
+    static void RegisterProfile(const TString& name, Profile profile, Bool_t singleHit = kFALSE);
+
     /** Default constructor **/
     R3BSofTofWSingleTCal2Hit();
 
@@ -70,10 +94,23 @@ class R3BSofTofWSingleTCal2Hit : public FairTask
 
     void SetOnline(Bool_t option) { fOnline = option; }
     void SetExpId(Int_t exp) { fExpId = exp; }
+    void SetProfile(const TString& name) { fProfileName = name; }
     void SetTofLISE(Double_t tof) { fTof_lise = tof; }
 
+    /** Events kept by the s444/s467 profiles: 1 to n paddles hit, 1 by default,
+     *  2 for the pairing of the fission fragments in R3BSofFragmentAnalysis **/
+    void SetMaxFragments(Int_t n) { fMaxFragments = n; }
+
     Double_t GetTofLISE() { return fTof_lise; }
 
+    /** Accessors for the profiles **/
+    TClonesArray* GetSingleTcalData() const { return fTCalDataCA; }
+    const R3BSofTofWHitCorrection* GetCorrection() const { return fCorrection; }
+    R3BTGeoPar* GetGeoPar() const { return fTofWGeoPar; }
+
+    /** Adds a SofTofWHitData to the HitCollection **/
+    R3BSofTofWHitData* AddHitData(Int_t paddle, Double_t x, Double_t y, Double_t tof);
+
   private:
     Bool_t fOnline; // Don't store data for online
     Int_t fExpId;
@@ -81,14 +118,16 @@ class R3BSofTofWSingleTCal2Hit : public FairTask
     TClonesArray* fTCalDataCA; /**< Array with Cal input data. >*/
     TClonesArray* fHitDataCA;  /**< Array with Hit output data. >*/
     Double_t fTof_lise;
-    R3BSofTofWSingleTcalData** calDat;
+    Int_t fMaxFragments;
+    TString fProfileName;
+    Profile fProfile; //! selected at Init
 
     R3BTGeoPar* fTofWGeoPar;
     R3BSofTofWHitPar* fTofWHitPar;
+    R3BSofTofWHitCorrection* fCorrection; // Tables of the offsets, walk and light propagation
 
-    /** Private method AddHitData **/
-    // Adds a SofTofWHitData to the HitCollection
-    R3BSofTofWHitData* AddHitData(Int_t paddle, Double_t x, Double_t y, Double_t tof);
+    static std::map<TString, Profile>& Profiles();
+    static std::set<TString>& SingleHitProfiles();
 
   public:
     // Class definition
@@ -5,11 +5,8 @@
 
 // ROOT headers
 #include "TClonesArray.h"
-#include "TF1.h"
-#include "TGraph.h"
+#include "TH1F.h"
 #include "TMath.h"
-#include "TRandom.h"
-#include "TVector3.h"
 
 // Fair headers
 #include "FairLogger.h"
@@ -19,6 +16,7 @@
 
 // TofW headers
 #include "R3BSofTofWHitPar.h"
+#include "R3BSofTofWPeakFinder.h"
 #include "R3BSofTofWSingleTCal2HitPar.h"
 #include "R3BSofTofWSingleTcalData.h"
 
@@ -33,13 +31,16 @@ R3BSofTofWSingleTCal2HitPar::R3BSofTofWSingleTCal2HitPar()
     , fLimit_right_tof(100.)
     , fLimit_left_pos(-50.)
     , fLimit_right_pos(50)
-    , fNbBinsTof(2000)
-    , fNbBinsPos(2000)
     , fMaxSigma(200)
+    , fNumThreads(0)
+    , fPeakHalfWidthTof(1.)
+    , fPeakHalfWidthPos(1.)
     , TofParams(NULL)
     , PosParams(NULL)
     , fHit_Par(NULL)
     , fTofCalDataCA(NULL)
+    , fTofPeaks(NULL)
+    , fPosPeaks(NULL)
 {
 }
 
@@ -52,13 +53,16 @@ R3BSofTofWSingleTCal2HitPar::R3BSofTofWSingleTCal2HitPar(const TString& name, In
     , fLimit_right_tof(100.)
     , fLimit_left_pos(-50.)
     , fLimit_right_pos(50)
-    , fNbBinsTof(2000)
-    , fNbBinsPos(2000)
     , fMaxSigma(200)
+    , fNumThreads(0)
+    , fPeakHalfWidthTof(1.)
+    , fPeakHalfWidthPos(1.)
     , TofParams(NULL)
     , PosParams(NULL)
     , fHit_Par(NULL)
     , fTofCalDataCA(NULL)
+    , fTofPeaks(NULL)
+    , fPosPeaks(NULL)
 {
 }
 
@@ -68,6 +72,10 @@ R3BSofTofWSingleTCal2HitPar::~R3BSofTofWSingleTCal2HitPar()
     LOG(INFO) << "R3BSofTofWSingleTCal2HitPar: Delete instance";
     if (fTofCalDataCA)
         delete fTofCalDataCA;
+    if (fTofPeaks)
+        delete fTofPeaks;
+    if (fPosPeaks)
+        delete fPosPeaks;
 }
 
 // -----   Public method Init   --------------------------------------------
@@ -102,19 +110,13 @@ InitStatus R3BSofTofWSingleTCal2HitPar::Init()
         return kFATAL;
     }
 
-    // Define histograms
-    char Name1[255];
-    htof = new TH1F*[fNumSci];
-    hpos = new TH1F*[fNumSci];
-    fNbBinsTof = (int)(fLimit_right_tof-fLimit_left_tof)*100.;
-    fNbBinsPos = (int)(fLimit_right_pos-fLimit_left_pos)*100.;
-    for (Int_t i = 0; i < fNumSci; i++)
-    {
-        sprintf(Name1, "htof_%d", i + 1);
-        htof[i] = new TH1F(Name1, Name1, fNbBinsTof, fLimit_left_tof, fLimit_right_tof);
-        sprintf(Name1, "hpos_%d", i + 1);
-        hpos[i] = new TH1F(Name1, Name1, fNbBinsPos, fLimit_left_pos, fLimit_right_pos);
-    }
+    // Define the spectra
+    fTofPeaks = new R3BSofTofWPeakFinder(fNumSci, fLimit_left_tof, fLimit_right_tof, 0.01);
+    fTofPeaks->SetNumThreads(fNumThreads);
+    fTofPeaks->SetHalfWidth(fPeakHalfWidthTof);
+    fPosPeaks = new R3BSofTofWPeakFinder(fNumSci, fLimit_left_pos, fLimit_right_pos, 0.01);
+    fPosPeaks->SetNumThreads(fNumThreads);
+    fPosPeaks->SetHalfWidth(fPeakHalfWidthPos);
 
     return kSUCCESS;
 }
@@ -131,17 +133,13 @@ void R3BSofTofWSingleTCal2HitPar::Exec(Option_t* option)
     if (nHits == 0)
         return;
 
-    R3BSofTofWSingleTcalData** calData = new R3BSofTofWSingleTcalData*[nHits];
-    Int_t sciId = 0;
     for (Int_t i = 0; i < nHits; i++)
     {
-        calData[i] = (R3BSofTofWSingleTcalData*)(fTofCalDataCA->At(i));
-        sciId = calData[i]->GetDetector();
-        htof[sciId-1]->Fill(calData[i]->GetRawTofNs());
-        hpos[sciId-1]->Fill(calData[i]->GetRawPosNs());
+        R3BSofTofWSingleTcalData* calData = (R3BSofTofWSingleTcalData*)(fTofCalDataCA->At(i));
+        Int_t sciId = calData->GetDetector();
+        fTofPeaks->Fill(sciId - 1, calData->GetRawTofNs());
+        fPosPeaks->Fill(sciId - 1, calData->GetRawPosNs());
     }
-    if (calData)
-        delete calData;
 
     return;
 }
@@ -156,56 +154,40 @@ void R3BSofTofWSingleTCal2HitPar::FinishTask()
 {
     fHit_Par->SetNumSci(fNumSci);
 
-    TF1* fit1 = new TF1("fit1", "gaus", fLimit_left_pos, fLimit_right_pos);
-    TF1* fit2 = new TF1("fit2", "gaus", fLimit_left_tof, fLimit_right_tof);
+    fTofPeaks->Find(fMinStatistics);
+    fPosPeaks->Find(fMinStatistics);
+    Int_t nfound = 0;
     for (Int_t s = 0; s < fNumSci; s++)
     {
-        if (htof[s]->GetEntries() > fMinStatistics && htof[s]->GetEntries() > fMinStatistics)
+        if (fTofPeaks->IsFound(s) && fPosPeaks->IsFound(s))
         {
-        
-        //std::cout << s<< " " << htof[s]->GetMaximum() <<std::endl;
-        
-                        // Bins with a number of counts less than 20% of the maximum are set to zero
-                for (Int_t k2 = 0; k2 < fNbBinsPos; k2++)
-                {
-                    
-                    if (hpos[s]->GetBinContent(k2 + 1) < 0.2 * hpos[s]->GetMaximum())
-                        hpos[s]->SetBinContent(k2 + 1, 0);
-                }
-        
-        
             fHit_Par->SetInUse(1, s + 1);
-            hpos[s]->Fit("fit1", "QR0");
-            Double_t par1[3];
-            fit1->GetParameters(&par1[0]);
-            fHit_Par->SetPosPar(par1[1], s + 1);
-            
-                for (Int_t k2 = 0; k2 < fNbBinsTof; k2++)
-                {
-                    
-                    if (htof[s]->GetBinContent(k2 + 1) < 0.2 * htof[s]->GetMaximum())
-                        htof[s]->SetBinContent(k2 + 1, 0);
-                }
-
-            htof[s]->Fit("fit2", "QR0");
-            Double_t par2[3];
-            fit2->GetParameters(&par2[0]);
-            fHit_Par->SetTofPar(par2[1], s + 1);
+            fHit_Par->SetPosPar(fPosPeaks->GetPeak(s), s + 1);
+            fHit_Par->SetTofPar(fTofPeaks->GetPeak(s), s + 1);
+            nfound++;
         }
         else
         {
             fHit_Par->SetInUse(0, s + 1);
         }
     }
+    LOG(INFO) << "R3BSofTofWSingleTCal2HitPar: " << nfound << " of " << fNumSci << " paddles calibrated";
 
     // Set parameters
     fHit_Par->setChanged();
-    
-    for (Int_t s = 0; s < fNumSci; s++){
-    hpos[s]->Write();
-                    htof[s]->Write();
+
+    char Name1[255];
+    for (Int_t s = 0; s < fNumSci; s++)
+    {
+        sprintf(Name1, "hpos_%d", s + 1);
+        TH1F* hpos = fPosPeaks->MakeHisto(s, Name1);
+        hpos->Write();
+        delete hpos;
+        sprintf(Name1, "htof_%d", s + 1);
+        TH1F* htof = fTofPeaks->MakeHisto(s, Name1);
+        htof->Write();
+        delete htof;
     }
-    
 }
 
 ClassImp(R3BSofTofWSingleTCal2HitPar)
@@ -8,11 +8,17 @@
 #define R3BSofTofWSingleTCal2HitPar_H
 
 #include "FairTask.h"
-#include "TH1F.h"
 
 class TClonesArray;
 class R3BSofTofWHitPar;
-
+class R3BSofTofWPeakFinder;
+
+/**
+ * Calibration of the ToF and position offsets of tofwHitPar: the offset of
+ * each paddle is the main peak of its raw ToF (or position) spectrum, found
+ * by R3BSofTofWPeakFinder (mode and local weighted mean) in parallel over
+ * the paddles at FinishTask.
+ **/
 class R3BSofTofWSingleTCal2HitPar : public FairTask
 {
   public:
@@ -59,24 +65,34 @@ class R3BSofTofWSingleTCal2HitPar : public FairTask
 
     void SetMinStatistics(Int_t minstat) { fMinStatistics = minstat; }
 
+    /** Number of threads of the peak finding, 0 for the number of cores **/
+    void SetNumThreads(Int_t n) { fNumThreads = n; }
+
+    /** Half width of the local mean around the mode [ns] **/
+    void SetPeakHalfWidth(Double_t tof, Double_t pos)
+    {
+        fPeakHalfWidthTof = tof;
+        fPeakHalfWidthPos = pos;
+    }
+
   private:
     Int_t fNumSci;
     Int_t fMinStatistics;
     Int_t fLimit_left_tof;
     Int_t fLimit_right_tof;
-    Int_t fNbBinsTof;
     Int_t fLimit_left_pos;
     Int_t fLimit_right_pos;
-    Int_t fNbBinsPos;
     Int_t fMaxSigma;
+    Int_t fNumThreads;
+    Double_t fPeakHalfWidthTof;
+    Double_t fPeakHalfWidthPos;
     TArrayF* TofParams;
     TArrayF* PosParams;
 
-    TH1F** htof;
-    TH1F** hpos;
-
-    R3BSofTofWHitPar* fHit_Par;  /**< Parameter container. >*/
-    TClonesArray* fTofCalDataCA; /**< Array with Tof-Tcal data. >*/
+    R3BSofTofWHitPar* fHit_Par;      /**< Parameter container. >*/
+    TClonesArray* fTofCalDataCA;     /**< Array with Tof-Tcal data. >*/
+    R3BSofTofWPeakFinder* fTofPeaks; /**< Raw ToF spectra, 100 bins per ns >*/
+    R3BSofTofWPeakFinder* fPosPeaks; /**< Raw position spectra, 100 bins per ns >*/
 
   public:
     // Class definition
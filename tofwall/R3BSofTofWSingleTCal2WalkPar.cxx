@@ -0,0 +1,216 @@
+// ---------------------------------------------------------------------
+// -----         R3BSofTofWSingleTCal2WalkPar source file          -----
+// ---------------------------------------------------------------------
+
+// ROOT headers
+#include "TClonesArray.h"
+#include "TMath.h"
+
+// Fair headers
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include "FairRuntimeDb.h"
+
+// TofW headers
+#include "R3BSofTofWHitPar.h"
+#include "R3BSofTofWSingleTCal2WalkPar.h"
+#include "R3BSofTofWSingleTcalData.h"
+
+// R3BSofTofWSingleTCal2WalkPar: Default Constructor --------------------------
+R3BSofTofWSingleTCal2WalkPar::R3BSofTofWSingleTCal2WalkPar()
+    : FairTask("R3BSof TofW Walk Calibrator", 1)
+    , fNumSci(28)
+    , fMinStatistics(1000)
+    , fMinEnergy(1)
+    , fTofMin(-5.)
+    , fTofMax(5.)
+    , fSumFF(NULL)
+    , fSumFY(NULL)
+    , fHit_Par(NULL)
+    , fTofCalDataCA(NULL)
+{
+}
+
+// R3BSofTofWSingleTCal2WalkPar: Standard Constructor --------------------------
+R3BSofTofWSingleTCal2WalkPar::R3BSofTofWSingleTCal2WalkPar(const TString& name, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+    , fNumSci(28)
+    , fMinStatistics(1000)
+    , fMinEnergy(1)
+    , fTofMin(-5.)
+    , fTofMax(5.)
+    , fSumFF(NULL)
+    , fSumFY(NULL)
+    , fHit_Par(NULL)
+    , fTofCalDataCA(NULL)
+{
+}
+
+// Virtual R3BSofTofWSingleTCal2WalkPar: Destructor
+R3BSofTofWSingleTCal2WalkPar::~R3BSofTofWSingleTCal2WalkPar()
+{
+    LOG(INFO) << "R3BSofTofWSingleTCal2WalkPar: Delete instance";
+    if (fSumFF)
+        delete[] fSumFF;
+    if (fSumFY)
+        delete[] fSumFY;
+}
+
+// -----   Public method Init   --------------------------------------------
+InitStatus R3BSofTofWSingleTCal2WalkPar::Init()
+{
+    LOG(INFO) << "R3BSofTofWSingleTCal2WalkPar: Init";
+
+    FairRootManager* rootManager = FairRootManager::Instance();
+    if (!rootManager)
+    {
+        return kFATAL;
+    }
+
+    fTofCalDataCA = (TClonesArray*)rootManager->GetObject("SofTofWSingleTcalData");
+    if (!fTofCalDataCA)
+    {
+        LOG(ERROR) << "R3BSofTofWSingleTCal2WalkPar: SofTofWSingleTcalData not found";
+        return kFATAL;
+    }
+
+    FairRuntimeDb* rtdb = FairRuntimeDb::instance();
+    if (!rtdb)
+    {
+        return kFATAL;
+    }
+
+    fHit_Par = (R3BSofTofWHitPar*)rtdb->getContainer("tofwHitPar");
+    if (!fHit_Par)
+    {
+        LOG(ERROR) << "R3BSofTofWSingleTCal2WalkPar:: Couldn't get handle on tofwHitPar container";
+        return kFATAL;
+    }
+    fNumSci = fHit_Par->GetNumSci();
+
+    fSumFF = new Double_t[fNumSci * kNumTerms * kNumTerms];
+    fSumFY = new Double_t[fNumSci * kNumTerms];
+    for (Int_t i = 0; i < fNumSci * kNumTerms * kNumTerms; i++)
+        fSumFF[i] = 0.;
+    for (Int_t i = 0; i < fNumSci * kNumTerms; i++)
+        fSumFY[i] = 0.;
+
+    return kSUCCESS;
+}
+
+// -----   Public method ReInit   ----------------------------------------------
+InitStatus R3BSofTofWSingleTCal2WalkPar::ReInit() { return kSUCCESS; }
+
+// -----   Public method Execution   --------------------------------------------
+void R3BSofTofWSingleTCal2WalkPar::Exec(Option_t* option)
+{
+    Int_t nHits = fTofCalDataCA->GetEntriesFast();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        R3BSofTofWSingleTcalData* hit = (R3BSofTofWSingleTcalData*)fTofCalDataCA->At(i);
+        Int_t s = hit->GetDetector() - 1;
+        if (hit->GetRank() != 0 || s < 0 || s >= fNumSci || fHit_Par->GetInUse(s + 1) != 1)
+            continue;
+        if (hit->GetEnergyUp() < fMinEnergy || hit->GetEnergyDown() < fMinEnergy)
+            continue;
+        Double_t y = hit->GetRawTofNs() - fHit_Par->GetTofPar(s + 1);
+        if (y < fTofMin || y > fTofMax)
+            continue;
+
+        Double_t pos = hit->GetRawPosNs() - fHit_Par->GetPosPar(s + 1);
+        Double_t f[kNumTerms] = { 1.,
+                                  0.5 / TMath::Sqrt((Double_t)hit->GetEnergyUp()),
+                                  0.5 / TMath::Sqrt((Double_t)hit->GetEnergyDown()),
+                                  pos,
+                                  pos * pos };
+        Double_t* ff = fSumFF + s * kNumTerms * kNumTerms;
+        Double_t* fy = fSumFY + s * kNumTerms;
+        for (Int_t k = 0; k < kNumTerms; k++)
+        {
+            fy[k] += f[k] * y;
+            for (Int_t l = 0; l <= k; l++)
+                ff[k * kNumTerms + l] += f[k] * f[l];
+        }
+    }
+}
+
+// -----   Private method Solve   ------------------------------------------------
+Bool_t R3BSofTofWSingleTCal2WalkPar::Solve(Int_t s, Double_t* coef)
+{
+    // Gaussian elimination with partial pivoting of the symmetric system
+    Double_t a[kNumTerms][kNumTerms + 1];
+    const Double_t* ff = fSumFF + s * kNumTerms * kNumTerms;
+    const Double_t* fy = fSumFY + s * kNumTerms;
+    for (Int_t k = 0; k < kNumTerms; k++)
+    {
+        for (Int_t l = 0; l < kNumTerms; l++)
+            a[k][l] = l <= k ? ff[k * kNumTerms + l] : ff[l * kNumTerms + k];
+        a[k][kNumTerms] = fy[k];
+    }
+    for (Int_t c = 0; c < kNumTerms; c++)
+    {
+        Int_t piv = c;
+        for (Int_t r = c + 1; r < kNumTerms; r++)
+            if (TMath::Abs(a[r][c]) > TMath::Abs(a[piv][c]))
+                piv = r;
+        if (!(TMath::Abs(a[piv][c]) > 1.e-12 * TMath::Abs(a[0][0])))
+            return kFALSE;
+        for (Int_t l = 0; l <= kNumTerms; l++)
+        {
+            Double_t tmp = a[c][l];
+            a[c][l] = a[piv][l];
+            a[piv][l] = tmp;
+        }
+        for (Int_t r = c + 1; r < kNumTerms; r++)
+        {
+            Double_t m = a[r][c] / a[c][c];
+            for (Int_t l = c; l <= kNumTerms; l++)
+                a[r][l] -= m * a[c][l];
+        }
+    }
+    for (Int_t c = kNumTerms - 1; c >= 0; c--)
+    {
+        Double_t v = a[c][kNumTerms];
+        for (Int_t l = c + 1; l < kNumTerms; l++)
+            v -= a[c][l] * coef[l];
+        coef[c] = v / a[c][c];
+    }
+    return kTRUE;
+}
+
+void R3BSofTofWSingleTCal2WalkPar::FinishTask()
+{
+    Int_t nfit = 0;
+    for (Int_t s = 0; s < fNumSci; s++)
+    {
+        Double_t n = fSumFF[s * kNumTerms * kNumTerms];
+        Double_t coef[kNumTerms];
+        if (n < fMinStatistics || !Solve(s, coef))
+        {
+            LOG(WARNING) << "R3BSofTofWSingleTCal2WalkPar: paddle " << s + 1 << " with " << n
+                         << " entries, no walk correction";
+            fHit_Par->SetWalkPar(0., s + 1, 1);
+            fHit_Par->SetWalkPar(0., s + 1, 2);
+            fHit_Par->SetLightPar(0., s + 1, 1);
+            fHit_Par->SetLightPar(0., s + 1, 2);
+            continue;
+        }
+
+        // Shift of TofPar by c - mean residual, the mean corrected ToF is unchanged
+        Double_t mean = fSumFY[s * kNumTerms] / n;
+        fHit_Par->SetTofPar(fHit_Par->GetTofPar(s + 1) + coef[0] - mean, s + 1);
+        fHit_Par->SetWalkPar(coef[1], s + 1, 1);
+        fHit_Par->SetWalkPar(coef[2], s + 1, 2);
+        fHit_Par->SetLightPar(coef[3], s + 1, 1);
+        fHit_Par->SetLightPar(coef[4], s + 1, 2);
+        nfit++;
+        LOG(INFO) << "R3BSofTofWSingleTCal2WalkPar: paddle " << s + 1 << ", walk " << coef[1] << " " << coef[2]
+                  << ", light " << coef[3] << " " << coef[4];
+    }
+    LOG(INFO) << "R3BSofTofWSingleTCal2WalkPar: " << nfit << " of " << fNumSci << " paddles calibrated";
+
+    // Set parameters
+    fHit_Par->setChanged();
+}
+
+ClassImp(R3BSofTofWSingleTCal2WalkPar)
@@ -0,0 +1,89 @@
+// -----------------------------------------------------------------
+// -----                                                       -----
+// -----                R3BSofTofWSingleTCal2WalkPar           -----
+// -----                                                       -----
+// -----------------------------------------------------------------
+
+#ifndef R3BSofTofWSingleTCal2WalkPar_H
+#define R3BSofTofWSingleTCal2WalkPar_H
+
+#include "FairTask.h"
+
+class TClonesArray;
+class R3BSofTofWHitPar;
+
+/**
+ * Calibration of the walk and light propagation corrections of tofwHitPar.
+ * The ToF and position offsets must already be calibrated, and the data
+ * taken with a beam of constant velocity. For each paddle, the ToF residual
+ * y = RawTof - TofPar is fitted by linear least squares to
+ *   y = c + (Wup / sqrt(Eup) + Wdown / sqrt(Edown)) / 2 + L1 * pos + L2 * pos^2
+ * with pos = RawPos - PosPar. Only the sums of the products of these terms
+ * are accumulated event by event (no histogram), the 5x5 normal equations
+ * are solved at FinishTask. TofPar is shifted by c minus the mean residual,
+ * so that the mean corrected ToF does not change.
+ **/
+class R3BSofTofWSingleTCal2WalkPar : public FairTask
+{
+  public:
+    /** Default constructor **/
+    R3BSofTofWSingleTCal2WalkPar();
+
+    /** Standard constructor **/
+    R3BSofTofWSingleTCal2WalkPar(const TString& name, Int_t iVerbose = 1);
+
+    /** Destructor **/
+    virtual ~R3BSofTofWSingleTCal2WalkPar();
+
+    /** Virtual method Exec **/
+    virtual void Exec(Option_t* option);
+
+    /** Virtual method FinishTask **/
+    virtual void FinishTask();
+
+    /** Virtual method Init **/
+    virtual InitStatus Init();
+
+    /** Virtual method ReInit **/
+    virtual InitStatus ReInit();
+
+    /** Window of the ToF residual RawTof - TofPar used in the fit [ns] **/
+    void SetTofWindow(Double_t min, Double_t max)
+    {
+        fTofMin = min;
+        fTofMax = max;
+    }
+
+    /** Lower energy threshold of both pmts **/
+    void SetMinEnergy(UInt_t e) { fMinEnergy = e; }
+
+    void SetMinStatistics(Int_t minstat) { fMinStatistics = minstat; }
+
+  private:
+    enum
+    {
+        kNumTerms = 5 // 1, 1/sqrt(Eup)/2, 1/sqrt(Edown)/2, pos, pos^2
+    };
+
+    Int_t fNumSci;
+    Int_t fMinStatistics;
+    UInt_t fMinEnergy;
+    Double_t fTofMin;
+    Double_t fTofMax;
+
+    // Per paddle, lower triangle of sum f_i f_j and sum f_i y
+    Double_t* fSumFF; //! [fNumSci * kNumTerms * kNumTerms]
+    Double_t* fSumFY; //! [fNumSci * kNumTerms]
+
+    R3BSofTofWHitPar* fHit_Par;  /**< Parameter container. >*/
+    TClonesArray* fTofCalDataCA; /**< Array with Tof-SingleTcal data. >*/
+
+    /** Solution of the normal equations of a paddle, kFALSE if singular **/
+    Bool_t Solve(Int_t s, Double_t* coef);
+
+  public:
+    // Class definition
+    ClassDef(R3BSofTofWSingleTCal2WalkPar, 1)
+};
+
+#endif
@@ -1,4 +1,6 @@
 #include "R3BSofTofWTcal2SingleTcal.h"
+#include "R3BSofTofWFiredPaddles.h"
+#include "R3BSofTofWPaddlePairing.h"
 
 #include "FairLogger.h"
 #include "FairRootManager.h"
@@ -10,24 +12,38 @@ R3BSofTofWTcal2SingleTcal::R3BSofTofWTcal2SingleTcal()
     : FairTask("R3BSofTofWTcal2SingleTcal", 1)
     , fSciSingleTcal(NULL)
     , fTofWTcal(NULL)
+    , fFiredPaddles(NULL)
     , fTofWSingleTcal(NULL)
     , fSciRawTofPar(NULL)
+    , fTofWHitPar(NULL)
+    , fPairing(NULL)
     , fOnline(kFALSE)
     , fNevent(0)
     , fNumPaddles(28)
     , fNumPmts(2)
+    , fPosHalfWidth(1.e6)
+    , fTofMin(-100.)
+    , fTofMax(100.)
+    , fMaxCandidates(1)
 {
 }
 R3BSofTofWTcal2SingleTcal::R3BSofTofWTcal2SingleTcal(Int_t nPaddles, Int_t nPmts)
     : FairTask("R3BSofTofWTcal2SingleTcal", 1)
     , fSciSingleTcal(NULL)
     , fTofWTcal(NULL)
+    , fFiredPaddles(NULL)
     , fTofWSingleTcal(NULL)
     , fSciRawTofPar(NULL)
+    , fTofWHitPar(NULL)
+    , fPairing(NULL)
     , fOnline(kFALSE)
     , fNevent(0)
     , fNumPaddles(nPaddles)
     , fNumPmts(nPmts)
+    , fPosHalfWidth(1.e6)
+    , fTofMin(-100.)
+    , fTofMax(100.)
+    , fMaxCandidates(1)
 {
 }
 
@@ -45,6 +61,10 @@ R3BSofTofWTcal2SingleTcal::~R3BSofTofWTcal2SingleTcal()
     {
         delete fTofWSingleTcal;
     }
+    if (fPairing)
+    {
+        delete fPairing;
+    }
 }
 
 void R3BSofTofWTcal2SingleTcal::SetParContainers()
@@ -60,6 +80,15 @@ void R3BSofTofWTcal2SingleTcal::SetParContainers()
     else
         LOG(INFO) << "R3BSofTofWTcal2SingleTcal::SetParContainers() : SofSciRawTofPar-Container found with "
                   << fSciRawTofPar->GetNumSignals() << " signals";
+
+    // the position offsets are only needed to centre a closed pairing window
+    if (fPosHalfWidth < 1.e6)
+    {
+        fTofWHitPar = (R3BSofTofWHitPar*)FairRuntimeDb::instance()->getContainer("tofwHitPar");
+        if (!fTofWHitPar)
+            LOG(WARNING) << "R3BSofTofWTcal2SingleTcal::SetParContainers() : Could not get access to "
+                            "tofwHitPar-Container, the raw position windows are centred at 0";
+    }
 }
 
 InitStatus R3BSofTofWTcal2SingleTcal::Init()
@@ -85,6 +114,9 @@ InitStatus R3BSofTofWTcal2SingleTcal::Init()
         return kFATAL;
     }
 
+    // Optional, events without hit in the TofW are skipped
+    fFiredPaddles = (R3BSofTofWFiredPaddles*)rm->GetObject("SofTofWFiredPaddles");
+
     // --- --------------------------------- --- //
     // --- INPUT SINGLETCAL DATA FROM SofSci --- //
     // --- --------------------------------- --- //
@@ -112,6 +144,34 @@ InitStatus R3BSofTofWTcal2SingleTcal::Init()
         rm->Register("SofTofWSingleTcalData", "SofTofW", fTofWSingleTcal, kFALSE);
     }
 
+    // --- ------------------------------ --- //
+    // --- PAIRING OF THE UP AND DOWN PMTs --- //
+    // --- ------------------------------ --- //
+
+    if (fNumPmts != 2)
+        LOG(WARNING) << "R3BSofTofWTcal2SingleTcal::Init() only the PMTs 1 (up) and 2 (down) are paired";
+    if (!(fTofMin < fTofMax) || fTofMax - fTofMin > 1000.)
+    {
+        // the candidates of several starts are ranked by their distance to the centre of the window
+        LOG(ERROR) << "R3BSofTofWTcal2SingleTcal::Init() the raw ToF window [" << fTofMin << ", " << fTofMax
+                   << "] ns is not around the ToF from the SofSci at Cave C";
+        return kFATAL;
+    }
+    if (fMaxCandidates < 0)
+    {
+        LOG(ERROR) << "R3BSofTofWTcal2SingleTcal::Init() " << fMaxCandidates << " candidates per paddle";
+        return kFATAL;
+    }
+    LOG(INFO) << "R3BSofTofWTcal2SingleTcal::Init() raw ToF window [" << fTofMin << ", " << fTofMax << "] ns, "
+              << fMaxCandidates << " candidate(s) per paddle (0 for all)";
+    fPairing = new R3BSofTofWPaddlePairing(fNumPaddles);
+    fPairing->SetRawPosWindow(fPosHalfWidth);
+    fPairing->SetTofWindow(fTofMin, fTofMax);
+    fPairing->SetMaxCandidates(fMaxCandidates);
+    if (fTofWHitPar)
+        for (Int_t d = 0; d < fNumPaddles && d < fTofWHitPar->GetNumSci(); d++)
+            fPairing->SetRawPosCentre(d, fTofWHitPar->GetPosPar(d + 1));
+
     LOG(INFO) << "R3BSofTofWTcal2SingleTcal::Init DONE";
 
     return kSUCCESS;
@@ -128,77 +188,49 @@ void R3BSofTofWTcal2SingleTcal::Exec(Option_t* option)
 
     // Reset entries in output arrays, local arrays
     Reset();
+    if (fFiredPaddles)
+    {
+        if (fFiredPaddles->GetMask() == 0)
+            return;
+        // only the paddles fired in the reader are paired
+        fPairing->SetFiredMask(fFiredPaddles->GetMask());
+    }
 
-    UShort_t iDet; // 0-based
-    UShort_t iPmt; // 0-based
-    Double_t iTraw[fNumPaddles * fNumPmts][16];
-    UShort_t mult[fNumPaddles * fNumPmts];
-    UShort_t mult_max = 0;
-
-    for (UShort_t i = 0; i < fNumPaddles * fNumPmts; i++)
-        mult[i] = 0;
-
-    // --- ------------------------------------------- --- //
-    // --- SOFSCI: GET THE Traw FROM THE SCI AT CAVE C --- //
-    // --- ------------------------------------------- --- //
-    UInt_t mult_SofSciCaveC = 0;
-    Double_t iRawTime_SofSci = -1000000.;
+    // --- ----------------------------------------------------------- --- //
+    // --- SOFSCI: GET ALL THE START CANDIDATES FROM THE SCI AT CAVE C --- //
+    // --- ----------------------------------------------------------- --- //
     UInt_t nHitsPerEvent_SofSci = fSciSingleTcal->GetEntries();
-
     for (UInt_t i = 0; i < nHitsPerEvent_SofSci; i++)
     {
         R3BSofSciSingleTcalData* hitSci = (R3BSofSciSingleTcalData*)fSciSingleTcal->At(i);
         if (hitSci->GetDetector() == fSciRawTofPar->GetDetIdCaveC())
-        {
-            mult_SofSciCaveC++;
-            iRawTime_SofSci = hitSci->GetRawTimeNs();
-        }
+            fPairing->AddStart(hitSci->GetRawTimeNs());
     }
 
     // --- ------------------------------------------------------------------------- --- //
     // --- SOFTOFW: CALCULATE THE RAW TIME, TOF AND POSITION FOR THE PLASTICS HITTED --- //
     // --- ------------------------------------------------------------------------- --- //
-    if (mult_SofSciCaveC == 1)
-    {
-        Int_t nHitsPerEvent_SofTofW = fTofWTcal->GetEntries();
-        // get the multiplicity per PMT
-        for (int ihit = 0; ihit < nHitsPerEvent_SofTofW; ihit++)
-        {
-            R3BSofTofWTcalData* hit = (R3BSofTofWTcalData*)fTofWTcal->At(ihit);
-            if (!hit)
-                continue;
-            iDet = hit->GetDetector() - 1;
-            iPmt = hit->GetPmt() - 1;
-            if (mult_max >= 16)
-                continue; // if multiplicity in a Pmt is higher than 16 are discarded, this code cannot handle it
-            iTraw[iDet * fNumPmts + iPmt][mult[iDet * fNumPmts + iPmt]] = hit->GetRawTimeNs();
-            mult[iDet * fNumPmts + iPmt]++;
-            if (mult[iDet * fNumPmts + iPmt] > mult_max)
-                mult_max = mult[iDet * fNumPmts + iPmt];
-        } // end of loop over the TClonesArray of Tcal data
-
-        if (nHitsPerEvent_SofTofW > 0)
-        {
-            Double_t iRawPos;
-            Double_t iRawTime;
-            Double_t iRawTof;
-            for (UShort_t d = 0; d < fNumPaddles; d++)
-            {
-                iRawPos = -1000000.;
-                iRawTime = -1000000.;
-                iRawTof = -1000000.;
-                // check mult==1 for the PMTup and PMTdown
-                if ((mult[d * fNumPmts + 1] == 1) && (mult[d * fNumPmts] == 1))
-                {
-                    iRawPos = iTraw[d * fNumPmts + 1][0] - iTraw[d * fNumPmts][0]; // Raw position = Tdown - Tup
-                    iRawTime = 0.5 * (iTraw[d * fNumPmts][0] + iTraw[d * fNumPmts + 1][0]);
-                    iRawTof = (iRawTime - iRawTime_SofSci);
-                    AddHitData(d + 1, iRawTime, iRawTof, iRawPos);
-                }
-            }
-            ++fNevent;
-        }
-    }
+    Int_t nHitsPerEvent_SofTofW = fTofWTcal->GetEntries();
+    for (Int_t ihit = 0; ihit < nHitsPerEvent_SofTofW; ihit++)
+    {
+        R3BSofTofWTcalData* hit = (R3BSofTofWTcalData*)fTofWTcal->At(ihit);
+        if (!hit)
+            continue;
+        fPairing->AddTime(hit->GetDetector() - 1, hit->GetPmt() - 1, hit->GetRawTimeNs(), hit->GetEnergy());
+    } // end of loop over the TClonesArray of Tcal data
+
+    // Raw position = Tdown - Tup, raw time = mean of Tup and Tdown, raw ToF with respect to each start
+    Int_t nCand = fPairing->Process();
+    for (Int_t i = 0; i < nCand; i++)
+        AddHitData(fPairing->GetPaddle(i) + 1,
+                   fPairing->GetTime(i),
+                   fPairing->GetTof(i),
+                   fPairing->GetPos(i),
+                   fPairing->GetRank(i),
+                   fPairing->GetEnergyUp(i),
+                   fPairing->GetEnergyDown(i));
+    if (nHitsPerEvent_SofTofW > 0 && nHitsPerEvent_SofSci > 0)
+        ++fNevent;
 }
 
 // -----   Public method Reset   ------------------------------------------------
@@ -207,6 +239,8 @@ void R3BSofTofWTcal2SingleTcal::Reset()
     LOG(DEBUG) << "Clearing SofTofWSingleTcalData structure";
     if (fTofWSingleTcal)
         fTofWSingleTcal->Clear();
+    if (fPairing)
+        fPairing->Clear();
 }
 
 void R3BSofTofWTcal2SingleTcal::Finish() {}
@@ -215,12 +249,15 @@ void R3BSofTofWTcal2SingleTcal::Finish() {}
 R3BSofTofWSingleTcalData* R3BSofTofWTcal2SingleTcal::AddHitData(Int_t plastic,
                                                                 Double_t time,
                                                                 Double_t tof,
-                                                                Double_t pos)
+                                                                Double_t pos,
+                                                                Int_t rank,
+                                                                UInt_t eUp,
+                                                                UInt_t eDown)
 {
     // It fills the R3BSofTofWSingleTcalData
     TClonesArray& clref = *fTofWSingleTcal;
     Int_t size = clref.GetEntriesFast();
-    return new (clref[size]) R3BSofTofWSingleTcalData(plastic, time, tof, pos);
+    return new (clref[size]) R3BSofTofWSingleTcalData(plastic, time, tof, pos, rank, eUp, eDown);
 }
 
 ClassImp(R3BSofTofWTcal2SingleTcal)
@@ -8,6 +8,7 @@
 #include "FairTask.h"
 
 #include "R3BSofSciRawTofPar.h"
+#include "R3BSofTofWHitPar.h"
 
 #include "TClonesArray.h"
 #include "TMath.h"
@@ -18,6 +19,9 @@ class TRandom3;
 #include "R3BSofTofWSingleTcalData.h"
 #include "R3BSofTofWTcalData.h"
 
+class R3BSofTofWPaddlePairing;
+class R3BSofTofWFiredPaddles;
+
 class R3BSofTofWTcal2SingleTcal : public FairTask
 {
 
@@ -51,11 +55,33 @@ class R3BSofTofWTcal2SingleTcal : public FairTask
     void SetNumPaddles(Int_t n) { fNumPaddles = n; }
     void SetNumPmts(Int_t n) { fNumPmts = n; }
 
+    // --- Pairing of the up and down PMTs --- //
+    // Window of Tdown - Tup [ns] around the position offset of tofwHitPar, open by default
+    void SetRawPosWindow(Double_t halfWidth) { fPosHalfWidth = halfWidth; }
+    // Same window from the paddle length [mm] and the effective light velocity [mm/ns]
+    void SetPaddleLength(Double_t length, Double_t velocity, Double_t margin = 1.)
+    {
+        fPosHalfWidth = length / velocity + margin;
+    }
+    // Window of the raw ToF with respect to the SofSci at Cave C [ns], -100 to 100 ns by default,
+    // at most 1 us wide: the candidates of several starts are ranked by their distance to its centre
+    void SetTofWindow(Double_t min, Double_t max)
+    {
+        fTofMin = min;
+        fTofMax = max;
+    }
+    // Number of ranked candidates kept per paddle, 0 for all; 1 for the s444/s467 hit reconstruction
+    void SetMaxCandidates(Int_t n) { fMaxCandidates = n; }
+    Int_t GetMaxCandidates() const { return fMaxCandidates; }
+
   private:
-    TClonesArray* fSciSingleTcal;      // input data
-    TClonesArray* fTofWTcal;           // input data
-    TClonesArray* fTofWSingleTcal;     // output data
-    R3BSofSciRawTofPar* fSciRawTofPar; // needed to get the Cave C Sci ID
+    TClonesArray* fSciSingleTcal;          // input data
+    TClonesArray* fTofWTcal;               // input data
+    R3BSofTofWFiredPaddles* fFiredPaddles; // paddles with hits from the reader, optional
+    TClonesArray* fTofWSingleTcal;         // output data
+    R3BSofSciRawTofPar* fSciRawTofPar;     // needed to get the Cave C Sci ID
+    R3BSofTofWHitPar* fTofWHitPar;         // position offsets, centres of the pairing windows
+    R3BSofTofWPaddlePairing* fPairing;     // up/down pairing engine
 
     Bool_t fOnline; // Don't store data for online
 
@@ -63,10 +89,20 @@ class R3BSofTofWTcal2SingleTcal : public FairTask
     UInt_t fNevent;
     Int_t fNumPaddles;
     Int_t fNumPmts;
+    Double_t fPosHalfWidth;
+    Double_t fTofMin;
+    Double_t fTofMax;
+    Int_t fMaxCandidates;
 
     TRandom rand;
 
-    R3BSofTofWSingleTcalData* AddHitData(Int_t plastic, Double_t time, Double_t tof, Double_t pos);
+    R3BSofTofWSingleTcalData* AddHitData(Int_t plastic,
+                                         Double_t time,
+                                         Double_t tof,
+                                         Double_t pos,
+                                         Int_t rank,
+                                         UInt_t eUp,
+                                         UInt_t eDown);
 
   public:
     ClassDef(R3BSofTofWTcal2SingleTcal, 1)
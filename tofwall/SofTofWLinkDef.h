@@ -9,10 +9,14 @@
 
 #pragma link C++ class R3BSofTofWContFact + ;
 
+#pragma link C++ class R3BSofTofWPaddlePairing + ;
 #pragma link C++ class R3BSofTofWTcal2SingleTcal + ;
+#pragma link C++ class R3BSofTofWHitCorrection + ;
 #pragma link C++ class R3BSofTofWSingleTCal2Hit + ;
 
 #pragma link C++ class R3BSofTofWHitPar + ;
+#pragma link C++ class R3BSofTofWPeakFinder + ;
 #pragma link C++ class R3BSofTofWSingleTCal2HitPar + ;
+#pragma link C++ class R3BSofTofWSingleTCal2WalkPar + ;
 
 #endif